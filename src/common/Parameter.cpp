@@ -249,6 +249,17 @@ bool Parameter::can_temposync()
     return false;
 }
 
+void Parameter::set_extend_range(bool er)
+{
+    extend_range = er;
+
+    if (ctrltype == ct_vocoder_bandcount)
+    {
+        val_max.i = er ? n_vocoder_bands : n_vocoder_default_bands;
+        val.i = limit_range(val.i, val_min.i, val_max.i);
+    }
+}
+
 bool Parameter::can_extend_range()
 {
     switch (ctrltype)
@@ -273,6 +284,7 @@ bool Parameter::can_extend_range()
     case ct_freq_audible_with_very_low_lowerbound:
     case ct_percent_oscdrift:
     case ct_twist_aux_mix:
+    case ct_vocoder_bandcount:
         return true;
     }
     return false;
@@ -326,6 +338,7 @@ bool Parameter::has_deformoptions()
     case ct_lfodeform:
     case ct_modern_trimix:
     case ct_alias_mask:
+    case ct_fxtype: // the slot's fx_oversampling
         return true;
     default:
         break;
@@ -972,10 +985,11 @@ void Parameter::set_type(int ctrltype)
         val_default.f = 0.75f;
         break;
     case ct_vocoder_bandcount:
+        // Extend Range takes this to n_vocoder_bands; see set_extend_range
         val_min.i = 4;
-        val_max.i = 20;
+        val_max.i = n_vocoder_default_bands;
         valtype = vt_int;
-        val_default.i = 20;
+        val_default.i = n_vocoder_default_bands;
         break;
     case ct_vocoder_modulator_mode:
         val_min.i = 0;
@@ -346,6 +346,8 @@ class Parameter
 
     bool can_temposync();
     bool can_extend_range();
+    // sets extend_range, and the range of the types whose maximum depends on it
+    void set_extend_range(bool er);
     bool can_be_absolute();
     bool can_deactivate();
     bool can_setvalue_from_string();
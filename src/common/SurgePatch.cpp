@@ -950,8 +950,9 @@ void SurgePatch::load_patch(const void *data, int datasize, bool preset)
 
                     void *d = (void *)((char *)dr + sizeof(wt_header));
 
+                    storage->build_and_publish_wt(&scene[sc].osc[osc].wt, d, *wth, false);
+
                     storage->waveTableDataMutex.lock();
-                    scene[sc].osc[osc].wt.BuildWT(d, *wth, false);
                     if (scene[sc].osc[osc].wavetable_display_name[0] == '\0')
                     {
                         if (scene[sc].osc[osc].wt.flags & wtf_is_sample)
@@ -2113,6 +2114,48 @@ void SurgePatch::load_xml(const void *data, int datasize, bool is_preset)
             }
         }
     }
+
+    tableLookupWaveshapers = streamingRevision <= 16;
+    if (compat)
+    {
+        auto ws = TINYXML_SAFE_TO_ELEMENT(compat->FirstChild("tableLookupWaveshapers"));
+        if (ws)
+        {
+            int i;
+            if (ws->QueryIntAttribute("v", &i) == TIXML_SUCCESS)
+            {
+                tableLookupWaveshapers = i != 0;
+            }
+        }
+    }
+
+    libmFMSine = streamingRevision <= 17;
+    if (compat)
+    {
+        auto fms = TINYXML_SAFE_TO_ELEMENT(compat->FirstChild("libmFMSine"));
+        if (fms)
+        {
+            int i;
+            if (fms->QueryIntAttribute("v", &i) == TIXML_SUCCESS)
+            {
+                libmFMSine = i != 0;
+            }
+        }
+    }
+
+    legacyRotaryHornTaps = streamingRevision <= 18;
+    if (compat)
+    {
+        auto rot = TINYXML_SAFE_TO_ELEMENT(compat->FirstChild("legacyRotaryHornTaps"));
+        if (rot)
+        {
+            int i;
+            if (rot->QueryIntAttribute("v", &i) == TIXML_SUCCESS)
+            {
+                legacyRotaryHornTaps = i != 0;
+            }
+        }
+    }
 }
 
 struct srge_header
@@ -2368,6 +2411,18 @@ unsigned int SurgePatch::save_xml(void **data) // allocates mem, must be freed b
         comb.SetAttribute("v", correctlyTuneCombFilter ? 1 : 0);
         compat.InsertEndChild(comb);
 
+        TiXmlElement ws("tableLookupWaveshapers");
+        ws.SetAttribute("v", tableLookupWaveshapers ? 1 : 0);
+        compat.InsertEndChild(ws);
+
+        TiXmlElement fms("libmFMSine");
+        fms.SetAttribute("v", libmFMSine ? 1 : 0);
+        compat.InsertEndChild(fms);
+
+        TiXmlElement rot("legacyRotaryHornTaps");
+        rot.SetAttribute("v", legacyRotaryHornTaps ? 1 : 0);
+        compat.InsertEndChild(rot);
+
         patch.InsertEndChild(compat);
     }
 
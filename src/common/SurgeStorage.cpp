@@ -50,6 +50,9 @@
 
 // FIXME probably remove this when we remove the hardcoded hack below
 #include "MSEGModulationHelper.h"
+#include "OscillatorPreview.h"
+#include "ModulatorPreview.h"
+#include "effect/DelayMemoryPool.h"
 // FIXME
 
 #if __cplusplus < 201703L
@@ -99,6 +102,7 @@ std::string getDLLPath()
 SurgeStorage::SurgeStorage(std::string suppliedDataPath) : otherscene_clients(0)
 {
     _patch.reset(new SurgePatch(this));
+    delayMemory = std::make_unique<DelayMemoryPool>();
 
     float cutoff = 0.455f;
     float cutoff1X = 0.85f;
@@ -929,8 +933,21 @@ void SurgeStorage::refresh_wtlistAddDir(bool userDir, std::string subdir)
         wt_list, wt_category);
 }
 
+namespace
+{
+// set while perform_queued_wtloads runs, which it does on the audio thread from processControl
+thread_local bool loadingQueuedWavetables = false;
+} // namespace
+
 void SurgeStorage::perform_queued_wtloads()
 {
+    // so the mip builds below stay on this thread rather than locking and waiting on the workers
+    struct QueuedLoads
+    {
+        QueuedLoads() { loadingQueuedWavetables = true; }
+        ~QueuedLoads() { loadingQueuedWavetables = false; }
+    } queued;
+
     SurgePatch &patch =
         getPatch(); // Change here is for performance and ease of debugging, simply not calling
                     // getPatch so many times. Code should behave identically.
@@ -1022,6 +1039,22 @@ void SurgeStorage::load_wt(string filename, Wavetable *wt, OscillatorStorage *os
     }
 }
 
+bool SurgeStorage::build_and_publish_wt(Wavetable *wt, void *wdata, wt_header &wh,
+                                       bool AppendSilence)
+{
+    /*
+     * Conversion and mip generation take tens of milliseconds on large tables, so do them
+     * off to the side and only hold the lock while swapping the finished data in
+     */
+    auto built = std::make_unique<Wavetable>();
+    if (!built->BuildWT(wdata, wh, AppendSilence, !loadingQueuedWavetables))
+        return false;
+
+    std::lock_guard<std::mutex> g(waveTableDataMutex);
+    wt->publish(*built);
+    return true;
+}
+
 bool SurgeStorage::load_wt_wt(string filename, Wavetable *wt)
 {
     std::filebuf f;
@@ -1049,9 +1082,7 @@ bool SurgeStorage::load_wt_wt(string filename, Wavetable *wt)
     read = f.sgetn(data.get(), ds);
     // FIXME - error if read != ds
 
-    waveTableDataMutex.lock();
-    bool wasBuilt = wt->BuildWT(data.get(), wh, false);
-    waveTableDataMutex.unlock();
+    bool wasBuilt = build_and_publish_wt(wt, data.get(), wh, false);
 
     if (!wasBuilt)
     {
@@ -1504,7 +1535,13 @@ void SurgeStorage::load_midi_controllers()
     }
 }
 
-SurgeStorage::~SurgeStorage() { deinitialize_oddsound(); }
+SurgeStorage::~SurgeStorage()
+{
+    // the preview workers read the rest of storage so stop them first
+    oscillatorPreviews.reset();
+    lfoPreviews.reset();
+    deinitialize_oddsound();
+}
 
 double shafted_tanh(double x) { return (exp(x) - exp(-x * 1.2)) / (exp(x) + exp(-x)); }
 
@@ -53,12 +53,17 @@ const int n_lfos = n_lfos_voice + n_lfos_scene;
 const int n_osc_params = 7;
 const int n_fx_params = 12;
 const int n_fx_slots = 8;
+const int n_send_slots = 2;
 const int FIRipol_M = 256;
 const int FIRipol_M_bits = 8;
 const int FIRipol_N = 12;
 const int FIRoffset = FIRipol_N >> 1;
 const int FIRipolI16_N = 8;
 const int FIRoffsetI16 = FIRipolI16_N >> 1;
+// The vocoder band count is any multiple of 4 up to n_vocoder_bands. Without Extend Range it
+// keeps its old 4..20 range, so saved values and host automation map as they always did.
+const int n_vocoder_bands = 64;
+const int n_vocoder_default_bands = 20;
 
 // XML storage fileformat revision
 // 0 -> 1 new EG attack shapes (0>1, 1>2, 2>2)
@@ -84,8 +89,11 @@ const int FIRoffsetI16 = FIRipolI16_N >> 1;
 // 14 -> 15 (1.8.0 release) apply the great filter remap (GitHub issue #3006)
 // 15 -> 16 (1.9.0 release) implement oscillator retrigger consistently (GitHub issue #3171)
 //                          add tuningApplicationMode to patch
+// 16 -> 17 (1.9.0 release) asym and sine waveshapers computed rather than looked up in a table
+// 17 -> 18 (1.9.0 release) FM2/FM3 operator sine computed in SSE rather than with libm
+// 18 -> 19 (1.9.0 release) rotary speaker horn taps use their own sinc coefficients
 
-const int ff_revision = 16;
+const int ff_revision = 19;
 
 extern float sinctable alignas(16)[(FIRipol_M + 1) * FIRipol_N * 2];
 extern float sinctable1X alignas(16)[(FIRipol_M + 1) * FIRipol_N];
@@ -104,6 +112,7 @@ const int n_total_params = n_global_params + 2 * n_scene_params + n_global_postp
 const int metaparam_offset = 20480; // has to be bigger than total + 16 * 130 for fake VST3 mapping
 const int n_scenes = 2;
 const int n_filterunits_per_scene = 2;
+const int n_inserts_per_scene = 2;
 const int n_max_filter_subtypes = 16;
 
 enum scene_mode
@@ -254,6 +263,11 @@ const char fxslot_names[8][NAMECHARS] = {
     "Send FX 1",     "Send FX 2",     "Global FX 1",   "Global FX 2",
 };
 
+// The fx slots each scene runs through, in order, and the send slots
+const int fxslot_scene_inserts[n_scenes][n_inserts_per_scene] = {{fxslot_ains1, fxslot_ains2},
+                                                                  {fxslot_bins1, fxslot_bins2}};
+const int fxslot_sends[n_send_slots] = {fxslot_send1, fxslot_send2};
+
 enum fx_type
 {
     fxt_off = 0,
@@ -297,6 +311,26 @@ const char fx_type_shortnames[n_fx_types][8] = {
     "RM",  "AW",  "NEU", "GEQ", "RES", "CHW",  "XCT", "ENS", "CMB", "NIM", "TAPE", "TM",
 };
 
+/*
+ * The oversampling of the effects which offer a choice (see fx_type_has_oversampling). It is
+ * kept in the deform_type of the slot's type parameter, so it streams with the patch, and
+ * fxos_default leaves the choice to the effect.
+ */
+enum fx_oversampling
+{
+    fxos_default = 0,
+    fxos_1x,
+    fxos_2x,
+    fxos_4x,
+    fxos_8x,
+
+    n_fx_oversampling,
+};
+
+const char fx_oversampling_names[n_fx_oversampling][16] = {
+    "Default", "None", "2x", "4x", "8x",
+};
+
 enum fx_bypass
 {
     fxb_all_fx = 0,
@@ -553,7 +587,7 @@ struct SurgeSceneStorage
     Parameter polymode;
     Parameter portamento;
     Parameter volume, pan, width;
-    Parameter send_level[2];
+    Parameter send_level[n_send_slots];
 
     FilterStorage filterunit[2];
     Parameter f2_cutoff_is_offset, f2_link_resonance;
@@ -653,6 +687,9 @@ struct MSEGStorage
     float durationLoopStartToLoopEnd;
     float envelopeModeDuration = -1, envelopeModeNV1 = -2; // -2 as sentinel since NV1 is -1/1
 
+    // Bumped by every rebuildCache, so previews can tell when the segments have changed
+    unsigned int version = 0;
+
     /*
      * These "UI" type things we decided, late in 1.8, are actually a critical part of
      * the modelling experience, so even if they aren't required to actually evaluate
@@ -741,6 +778,19 @@ struct PatchTuningStorage
 };
 
 class SurgeStorage;
+class DelayMemoryPool;
+
+namespace Surge
+{
+namespace Oscillator
+{
+class PreviewCache;
+}
+namespace ModulatorPreview
+{
+class LFOCurveCache;
+}
+} // namespace Surge
 
 class SurgePatch
 {
@@ -816,6 +866,25 @@ class SurgePatch
      */
     bool correctlyTuneCombFilter = true;
 
+    /*
+     * Before streaming revision 17 the asym and sine waveshapers interpolated a table, which
+     * is a touch off the curve they now compute. Older patches keep the tables so they sound
+     * the same, bit for bit.
+     */
+    bool tableLookupWaveshapers = false;
+
+    /*
+     * Before streaming revision 18 the FM2 and FM3 operators used libm's sin, which the SSE
+     * kernels don't match bit for bit. Older patches keep it.
+     */
+    bool libmFMSine = false;
+
+    /*
+     * Before streaming revision 19 the rotary speaker paired each horn delay sample with the
+     * sinc coefficient after its own. Older patches keep that so they sound the same.
+     */
+    bool legacyRotaryHornTaps = false;
+
     FilterSelectorMapper patchFilterSelectorMapper;
 };
 
@@ -917,6 +986,8 @@ class alignas(16) SurgeStorage
     bool load_wt_wt(std::string filename, Wavetable *wt);
     // void load_wt_wav(std::string filename, Wavetable* wt);
     bool load_wt_wav_portable(std::string filename, Wavetable *wt);
+    // Build wdata into a scratch table, then publish it to wt under waveTableDataMutex
+    bool build_and_publish_wt(Wavetable *wt, void *wdata, wt_header &wh, bool AppendSilence);
     void export_wt_wav_portable(std::string fbase, Wavetable *wt);
     void clipboard_copy(int type, int scene, int entry);
     void clipboard_paste(int type, int scene, int entry);
@@ -958,6 +1029,14 @@ class alignas(16) SurgeStorage
     std::recursive_mutex modRoutingMutex;
     Wavetable WindowWT;
 
+    // background renders of the oscillator display, see OscillatorPreview.h
+    std::unique_ptr<Surge::Oscillator::PreviewCache> oscillatorPreviews;
+    // and of the LFO display, see ModulatorPreview.h
+    std::unique_ptr<Surge::ModulatorPreview::LFOCurveCache> lfoPreviews;
+
+    // delay lines for the effects, see DelayMemoryPool.h
+    std::unique_ptr<DelayMemoryPool> delayMemory;
+
     // hardclip
     enum HardClipMode
     {
@@ -967,6 +1046,18 @@ class alignas(16) SurgeStorage
     } hardclipMode = HARDCLIP_TO_18DBFS,
       sceneHardclipMode[n_scenes] = {HARDCLIP_TO_18DBFS, HARDCLIP_TO_18DBFS};
 
+    /*
+     * Sine kernel used by the FM2/FM3 operators; see Surge::Oscillator::fmOperatorSine. This is
+     * the "fmSinePrecision" user default. Patches with SurgePatch::libmFMSine set use libm
+     * whatever this says.
+     */
+    enum FMSinePrecision
+    {
+        FM_SINE_LIBM = 0, // scalar libm sin, the pre-1.9 behavior
+        FM_SINE_ACCURATE, // SSE polynomial, max error < 3e-7
+        FM_SINE_FAST      // SSE Pade approximation, error 1e-5 near zero phase
+    } fmSinePrecision = FM_SINE_ACCURATE;
+
     float note_to_pitch(float x);
     float note_to_pitch_inv(float x);
     float note_to_pitch_ignoring_tuning(float x);
@@ -62,9 +62,14 @@ using namespace std;
 
 SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, std::string suppliedDataPath)
     //: halfband_AL(false),halfband_AR(false),halfband_BL(false),halfband_BR(false),
-    : storage(suppliedDataPath), hpA(&storage), hpB(&storage), _parent(parent), halfbandA(6, true),
-      halfbandB(6, true), halfbandIN(6, true)
+    : storage(suppliedDataPath), _parent(parent), halfbandIN(6, true)
 {
+    for (int s = 0; s < n_scenes; ++s)
+    {
+        sceneHalfband[s] = std::make_unique<HalfRateFilter>(6, true);
+        sceneLowcut[s].storage = &storage;
+    }
+
     switch_toggled_queued = false;
     audio_processing_active = false;
     halt_engine = false;
@@ -82,9 +87,8 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, std::string suppliedData
     // TODO: FIX NUMBER OF FX ASSUMPTION
     memset(fx, 0, sizeof(void *) * 8);
     srand((unsigned)time(nullptr));
-    // TODO: FIX SCENE ASSUMPTION
-    memset(storage.getPatch().scenedata[0], 0, sizeof(pdata) * n_scene_params);
-    memset(storage.getPatch().scenedata[1], 0, sizeof(pdata) * n_scene_params);
+    for (int s = 0; s < n_scenes; ++s)
+        memset(storage.getPatch().scenedata[s], 0, sizeof(pdata) * n_scene_params);
     memset(storage.getPatch().globaldata, 0, sizeof(pdata) * n_global_params);
     memset(mControlInterpolatorUsed, 0, sizeof(bool) * num_controlinterpolators);
     memset((void *)fxsync, 0, sizeof(FxStorage) * n_fx_slots);
@@ -94,15 +98,16 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, std::string suppliedData
         memcpy((void *)&fxsync[i], (void *)&storage.getPatch().fx[i], sizeof(FxStorage));
         fx_reload[i] = false;
         fx_reload_mod[i] = false;
+        fx_reload_defaults[i] = false;
+        fxSpawnWaitBlocks[i] = 0;
     }
+    fxSpawner = std::make_unique<FxSpawner>(&storage, fxsync);
 
     allNotesOff();
 
-    for (int i = 0; i < MAX_VOICES; i++)
-    {
-        voices_usedby[0][i] = 0;
-        voices_usedby[1][i] = 0;
-    }
+    for (int s = 0; s < n_scenes; s++)
+        for (int i = 0; i < MAX_VOICES; i++)
+            voices_usedby[s][i] = 0;
 
     for (int sc = 0; sc < n_scenes; sc++)
     {
@@ -113,6 +118,7 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, std::string suppliedData
         {
             InitQuadFilterChainStateToZero(&(FBQ[sc][i]));
         }
+        FBQlanes[sc] = 0;
     }
 
     SurgePatch &patch = storage.getPatch();
@@ -124,6 +130,10 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, std::string suppliedData
         (ControllerModulationSource::SmoothingMode)(int)Surge::Storage::getUserDefaultValue(
             &storage, "pitchSmoothingMode",
             (int)(ControllerModulationSource::SmoothingMode::DIRECT));
+    storage.fmSinePrecision = (SurgeStorage::FMSinePrecision)limit_range(
+        Surge::Storage::getUserDefaultValue(&storage, "fmSinePrecision",
+                                            (int)SurgeStorage::FM_SINE_ACCURATE),
+        (int)SurgeStorage::FM_SINE_LIBM, (int)SurgeStorage::FM_SINE_FAST);
 
     patch.polylimit.val.i = DEFAULT_POLYLIMIT;
 
@@ -194,13 +204,12 @@ SurgeSynthesizer::SurgeSynthesizer(PluginLayer *parent, std::string suppliedData
     }
 
     amp.set_blocksize(BLOCK_SIZE);
-    // TODO: FIX SCENE ASSUMPTION
-    FX1.set_blocksize(BLOCK_SIZE);
-    FX2.set_blocksize(BLOCK_SIZE);
-    send[0][0].set_blocksize(BLOCK_SIZE);
-    send[0][1].set_blocksize(BLOCK_SIZE);
-    send[1][0].set_blocksize(BLOCK_SIZE);
-    send[1][1].set_blocksize(BLOCK_SIZE);
+    for (int i = 0; i < n_send_slots; i++)
+    {
+        sendReturn[i].set_blocksize(BLOCK_SIZE);
+        for (int s = 0; s < n_scenes; s++)
+            send[i][s].set_blocksize(BLOCK_SIZE);
+    }
 
     polydisplay = 0;
     refresh_editor = false;
@@ -381,16 +390,13 @@ void SurgeSynthesizer::playNote(char channel, char key, char velocity, char detu
 
     int channelmask = calculateChannelMask(channel, key);
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (channelmask & 1)
-    {
-        midiKeyPressedForScene[0][key] = ++orderedMidiKey;
-        playVoice(0, channel, key, velocity, detune);
-    }
-    if (channelmask & 2)
+    for (int s = 0; s < n_scenes; s++)
     {
-        midiKeyPressedForScene[1][key] = ++orderedMidiKey;
-        playVoice(1, channel, key, velocity, detune);
+        if (channelmask & (1 << s))
+        {
+            midiKeyPressedForScene[s][key] = ++orderedMidiKey;
+            playVoice(s, channel, key, velocity, detune);
+        }
     }
 
     channelState[channel].keyState[key].keystate = velocity;
@@ -538,17 +544,49 @@ SurgeVoice *SurgeSynthesizer::getUnusedVoice(int scene)
     return 0;
 }
 
-void SurgeSynthesizer::freeVoice(SurgeVoice *v)
+void SurgeSynthesizer::bindVoiceLane(SurgeVoice *v, int scene)
 {
-    for (int i = 0; i < MAX_VOICES; i++)
+    int e = FBQlanes[scene]++;
+    FBQvoice[scene][e] = v;
+    v->bindLane(&FBQ[scene][e >> 2], e & 3);
+}
+
+void SurgeSynthesizer::releaseVoiceLane(SurgeVoice *v)
+{
+    if (!v->hasLane())
+        return;
+
+    int s = v->state.scene_id;
+    int last = FBQlanes[s] - 1;
+    for (int e = 0; e <= last; e++)
     {
-        if (voices_usedby[0][i] && (v == &voices_array[0][i]))
+        if (FBQvoice[s][e] == v)
         {
-            voices_usedby[0][i] = 0;
+            // keep the lanes in use contiguous
+            if (e != last)
+            {
+                FBQvoice[s][e] = FBQvoice[s][last];
+                FBQvoice[s][e]->moveLane(&FBQ[s][e >> 2], e & 3);
+            }
+            FBQlanes[s] = last;
+            break;
         }
-        if (voices_usedby[1][i] && (v == &voices_array[1][i]))
+    }
+    v->unbindLane();
+}
+
+void SurgeSynthesizer::freeVoice(SurgeVoice *v)
+{
+    releaseVoiceLane(v);
+
+    for (int s = 0; s < n_scenes; s++)
+    {
+        for (int i = 0; i < MAX_VOICES; i++)
         {
-            voices_usedby[1][i] = 0;
+            if (voices_usedby[s][i] && (v == &voices_array[s][i]))
+            {
+                voices_usedby[s][i] = 0;
+            }
         }
     }
     v->freeAllocatedElements();
@@ -1769,12 +1807,13 @@ void SurgeSynthesizer::allNotesOff()
     }
     holdbuffer[0].clear();
     holdbuffer[1].clear();
-    halfbandA.reset();
-    halfbandB.reset();
     halfbandIN.reset();
 
-    hpA.suspend();
-    hpB.suspend();
+    for (int s = 0; s < n_scenes; s++)
+    {
+        sceneHalfband[s]->reset();
+        sceneLowcut[s].suspend();
+    }
 
     for (int i = 0; i < n_fx_slots; i++)
     {
@@ -2031,19 +2070,17 @@ bool SurgeSynthesizer::setParameter01(long index, float value, bool external, bo
                 int cge = p->ctrlgroup_entry;
 
                 fxsync[cge].type.val.i = p->val.i;
+                fxsync[cge].type.deform_type = fxos_default;
                 p->val.i = oldval.i; // so funnily we want to set the value *back* so the loadFX
                                      // picks up the change in fxsync
-                Effect *t_fx = spawn_effect(fxsync[cge].type.val.i, &storage, &fxsync[cge], 0);
-                if (t_fx)
-                {
-                    t_fx->init_ctrltypes();
-                    t_fx->init_default_values();
-                    delete t_fx;
-                }
 
+                // Under automation this is the audio thread, so rather than spawn an effect here
+                // to write its defaults into fxsync, loadFx sets them on the effect it binds
+                prepareFx(cge, true);
                 switch_toggled_queued = true;
                 load_fx_needed = true;
                 fx_reload[cge] = true;
+                fx_reload_defaults[cge] = true;
             }
             break;
         }
@@ -2149,10 +2186,29 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
         bool something_changed = false;
         if ((fxsync[s].type.val.i != storage.getPatch().fx[s].type.val.i) || force_reload_all)
         {
+            /*
+             * If the helper thread is still building this effect, keep the old one running a
+             * little longer rather than build it here. Patch loads and an idle engine don't
+             * wait, and neither do we after about a quarter second.
+             */
+            int newType = fxsync[s].type.val.i;
+            if (!force_reload_all && audio_processing_active &&
+                fxSpawner->isPreparing(s, newType) &&
+                fxSpawnWaitBlocks[s] < samplerate * 0.25f / BLOCK_SIZE)
+            {
+                fxSpawnWaitBlocks[s]++;
+                load_fx_needed = true;
+                continue;
+            }
+            fxSpawnWaitBlocks[s] = 0;
+
             fx_reload[s] = false;
 
-            fx[s].reset();
+            fxSpawner->retire(fx[s].release());
             /*if (!force_reload_all)*/ storage.getPatch().fx[s].type.val.i = fxsync[s].type.val.i;
+            // the oversampling choice goes with the type: the patch's, the one a reorder
+            // carries over, or fxos_default for a type picked anew
+            storage.getPatch().fx[s].type.deform_type = fxsync[s].type.deform_type;
             // else fxsync[s].type.val.i = storage.getPatch().fx[s].type.val.i;
 
             for (int j = 0; j < n_fx_params; j++)
@@ -2173,13 +2229,34 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
             // fxsync[s].type.val.i << std::endl;
             std::lock_guard<std::mutex> g(fxSpawnMutex);
 
-            fx[s].reset(spawn_effect(storage.getPatch().fx[s].type.val.i, &storage,
-                                     &storage.getPatch().fx[s], storage.getPatch().globaldata));
+            int type = storage.getPatch().fx[s].type.val.i;
+            auto *prepared = fxSpawner->take(s, type);
+            if (prepared)
+            {
+                prepared->bind(&storage.getPatch().fx[s], storage.getPatch().globaldata);
+                fx[s].reset(prepared);
+            }
+            else
+            {
+                /*
+                 * Patch loads, an idle engine, a spawner that isn't up yet or one that took
+                 * longer than the wait above. With the engine running this allocates the effect
+                 * on the audio thread.
+                 */
+                fx[s].reset(spawn_effect(type, &storage, &storage.getPatch().fx[s],
+                                         storage.getPatch().globaldata));
+            }
             if (fx[s])
             {
+                // the spawner already ran init on a prepared effect, this just sets up the patch
                 fx[s]->init_ctrltypes();
-                if (initp)
+                if (initp || fx_reload_defaults[s])
+                {
                     fx[s]->init_default_values();
+                    // and keep fxsync in step, as it is what a later reload copies from
+                    memcpy((void *)&fxsync[s].p, (void *)&storage.getPatch().fx[s].p,
+                           sizeof(Parameter) * n_fx_params);
+                }
                 else
                 {
                     for (int j = 0; j < n_fx_params; j++)
@@ -2218,7 +2295,16 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
                     storage.getPatch().fx[s].p[j].val.f;
                 }*/
 
-                fx[s]->init();
+                /*
+                 * A patch load spawns every effect here anyway, usually on the loader thread
+                 * with the engine halted, so it brings the delay lines along too. A single type
+                 * change on a running engine leaves them to the pool's helper and passes the dry
+                 * signal until they arrive.
+                 */
+                if (!prepared && (!audio_processing_active || force_reload_all))
+                    fx[s]->allocate_memory();
+                if (!prepared || initp)
+                    fx[s]->init();
 
                 /*
                 ** Clear modulation onto FX otherwise it hangs around from old ones, often with
@@ -2261,6 +2347,7 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
                 }
             }
 
+            fx_reload_defaults[s] = false;
             something_changed = true;
             refresh_editor = true;
         }
@@ -2279,6 +2366,7 @@ bool SurgeSynthesizer::loadFx(bool initp, bool force_reload_all)
             }
             fx_reload[s] = false;
             fx_reload_mod[s] = false;
+            fx_reload_defaults[s] = false;
             refresh_editor = true;
             something_changed = true;
         }
@@ -3183,38 +3271,38 @@ void SurgeSynthesizer::processControl()
 
     storage.perform_queued_wtloads();
     int sm = storage.getPatch().scenemode.val.i;
-    // TODO: FIX SCENE ASSUMPTION
-    bool playA = (sm == sm_split) || (sm == sm_dual) || (sm == sm_chsplit) ||
-                 (storage.getPatch().scene_active.val.i == 0);
-    bool playB = (sm == sm_split) || (sm == sm_dual) || (sm == sm_chsplit) ||
-                 (storage.getPatch().scene_active.val.i == 1);
+    bool playScene[n_scenes];
+    int playMask = 0;
+    for (int s = 0; s < n_scenes; s++)
+    {
+        playScene[s] = (sm == sm_split) || (sm == sm_dual) || (sm == sm_chsplit) ||
+                       (storage.getPatch().scene_active.val.i == s);
+        if (playScene[s])
+            playMask |= 1 << s;
+    }
 
     storage.songpos = time_data.ppqPos;
     storage.temposyncratio = time_data.tempo / 120.f;
     storage.temposyncratio_inv = 1.f / storage.temposyncratio;
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (release_if_latched[0])
+    for (int s = 0; s < n_scenes; s++)
     {
-        if (!playA || release_anyway[0])
-            releaseScene(0);
-        release_if_latched[0] = false;
-        release_anyway[0] = false;
+        if (release_if_latched[s])
+        {
+            if (!playScene[s] || release_anyway[s])
+                releaseScene(s);
+            release_if_latched[s] = false;
+            release_anyway[s] = false;
+        }
     }
-    if (release_if_latched[1])
+
+    for (int s = 0; s < n_scenes; s++)
     {
-        if (!playB || release_anyway[1])
-            releaseScene(1);
-        release_if_latched[1] = false;
-        release_anyway[1] = false;
+        if (playScene[s] && (storage.getPatch().scene[s].polymode.val.i == pm_latch) &&
+            voices[s].empty())
+            playNote(s + 1, 60, 100, 0);
     }
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (playA && (storage.getPatch().scene[0].polymode.val.i == pm_latch) && voices[0].empty())
-        playNote(1, 60, 100, 0);
-    if (playB && (storage.getPatch().scene[1].polymode.val.i == pm_latch) && voices[1].empty())
-        playNote(2, 60, 100, 0);
-
     // interpolate MIDI controllers
     for (int i = 0; i < num_controlinterpolators; i++)
     {
@@ -3235,19 +3323,19 @@ void SurgeSynthesizer::processControl()
         storage.getPatch()
             .globaldata); // Drains a great deal of CPU while in Debug mode.. optimize?
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (playA)
-        storage.getPatch().copy_scenedata(storage.getPatch().scenedata[0], 0); // -""-
-    if (playB)
-        storage.getPatch().copy_scenedata(storage.getPatch().scenedata[1], 1);
+    for (int s = 0; s < n_scenes; s++)
+    {
+        if (playScene[s])
+            storage.getPatch().copy_scenedata(storage.getPatch().scenedata[s], s); // -""-
+    }
 
     //	if(sm == sm_morph) storage.getPatch().do_morph();
 
-    prepareModsourceDoProcess((playA ? 1 : 0) | (playB ? 2 : 0));
+    prepareModsourceDoProcess(playMask);
 
     for (int s = 0; s < n_scenes; s++)
     {
-        if (((s == 0) && playA) || ((s == 1) && playB))
+        if (playScene[s])
         {
             if (storage.getPatch().scene[s].modsource_doprocess[ms_modwheel])
                 storage.getPatch().scene[s].modsources[ms_modwheel]->process_block();
@@ -3351,6 +3439,150 @@ void SurgeSynthesizer::processControl()
     }
 }
 
+void SurgeSynthesizer::renderOscillatorsBatched(int s)
+{
+    /*
+     * Render each oscillator slot for every voice of the scene with one batch call per run of
+     * voices sharing an oscillator type, so oscillators which support it can put voices in
+     * their SIMD lanes. Slots go 3, 2, 1 so FM modulators are ready before their carriers.
+     */
+    Oscillator *oscs[MAX_VOICES];
+    float pitch[MAX_VOICES], drift[MAX_VOICES], fmdepth[MAX_VOICES];
+
+    for (int i = n_oscs - 1; i >= 0; --i)
+    {
+        int n = 0, batchType = -1;
+        bool batchStereo = false, batchFM = false;
+
+        auto flush = [&]() {
+            if (n > 0)
+                oscs[0]->process_block_batch(oscs, n, pitch, drift, batchStereo, batchFM,
+                                             fmdepth);
+            n = 0;
+        };
+
+        for (auto v : voices[s])
+        {
+            auto o = v->oscillator(i);
+            if (!o || !v->osc_block_needed(i))
+                continue;
+
+            auto a = v->prepare_osc_block(i);
+            if (n > 0 &&
+                (v->osctype[i] != batchType || a.stereo != batchStereo || a.FM != batchFM))
+                flush();
+
+            batchType = v->osctype[i];
+            batchStereo = a.stereo;
+            batchFM = a.FM;
+            oscs[n] = o;
+            pitch[n] = a.pitch;
+            drift[n] = a.drift;
+            fmdepth[n] = a.FMdepth;
+            n++;
+        }
+        flush();
+    }
+}
+
+int SurgeSynthesizer::renderScene(int scene)
+{
+    int vcount = 0;
+
+    for (auto v : voices[scene])
+    {
+        assert(v);
+        if (!v->hasLane())
+            bindVoiceLane(v, scene);
+        v->begin_block();
+    }
+
+    renderOscillatorsBatched(scene);
+
+    // voices which end still have their last block filtered, so free them after that
+    SurgeVoice *ended[MAX_VOICES];
+    int n_ended = 0;
+
+    auto iter = voices[scene].begin();
+    while (iter != voices[scene].end())
+    {
+        SurgeVoice *v = *iter;
+        assert(v);
+        bool resume = v->end_block();
+
+        vcount++;
+
+        if (!resume)
+        {
+            ended[n_ended++] = v;
+            iter = voices[scene].erase(iter);
+        }
+        else
+            iter++;
+    }
+
+    // a filter unit which no voice can move away from the others makes its coefficients
+    // once for the scene. Otherwise the voices sharing a quad of the filter bank make theirs
+    // together
+    for (int u = 0; u < n_filterunits_per_scene; u++)
+    {
+        bool invariant = SurgeVoice::filterCoeffsVoiceInvariant(
+            &storage.getPatch().scene[scene], storage.getPatch().scenedata[scene], mpeEnabled, u);
+        SurgeVoice::makeSharedFilterCoeffs(FBQvoice[scene], FBQlanes[scene], u, invariant,
+                                           sharedFilterCoeffs[scene][u]);
+    }
+
+    for (int e = 0; e < FBQlanes[scene]; e += 4)
+    {
+        SurgeVoice *qv[4];
+        for (int i = 0; i < 4; i++)
+            qv[i] = (e + i < FBQlanes[scene]) ? FBQvoice[scene][e + i] : nullptr;
+        SurgeVoice::makeFilterCoeffsQuad(qv, FBQ[scene][e >> 2], sharedFilterCoeffs[scene]);
+    }
+
+    storage.modRoutingMutex.unlock();
+
+    fbq_global g;
+    g.FU1ptr = GetQFPtrFilterUnit(storage.getPatch().scene[scene].filterunit[0].type.val.i,
+                                  storage.getPatch().scene[scene].filterunit[0].subtype.val.i);
+    g.FU2ptr = GetQFPtrFilterUnit(storage.getPatch().scene[scene].filterunit[1].type.val.i,
+                                  storage.getPatch().scene[scene].filterunit[1].subtype.val.i);
+    g.WSptr = GetQFPtrWaveshaper(storage.getPatch().scene[scene].wsunit.type.val.i,
+                                 storage.getPatch().tableLookupWaveshapers);
+
+    FBQFPtr ProcessQuadFB =
+        GetFBQPointer(storage.getPatch().scene[scene].filterblock_configuration.val.i,
+                      g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
+
+    for (int e = 0; e < FBQlanes[scene]; e += 4)
+    {
+        int units = FBQlanes[scene] - e;
+        for (int i = units; i < 4; i++)
+        {
+            FBQ[scene][e >> 2].FU[0].active[i] = 0;
+            FBQ[scene][e >> 2].FU[1].active[i] = 0;
+            FBQ[scene][e >> 2].FU[2].active[i] = 0;
+            FBQ[scene][e >> 2].FU[3].active[i] = 0;
+        }
+        ProcessQuadFB(FBQ[scene][e >> 2], g, sceneout[scene][0], sceneout[scene][1]);
+    }
+
+    if (scene == 0 && storage.otherscene_clients > 0)
+    {
+        // Make available for scene B
+        copy_block(sceneout[0][0], storage.audio_otherscene[0], BLOCK_SIZE_OS_QUAD);
+        copy_block(sceneout[0][1], storage.audio_otherscene[1], BLOCK_SIZE_OS_QUAD);
+    }
+
+    for (int i = 0; i < n_ended; i++)
+    {
+        freeVoice(ended[i]);
+    }
+    storage.modRoutingMutex.lock();
+
+    return vcount;
+}
+
 void SurgeSynthesizer::process()
 {
 #if DEBUG_RNG_THREADING
@@ -3421,7 +3653,8 @@ void SurgeSynthesizer::process()
         hardclip_block8(input[1], BLOCK_SIZE_QUAD);
         copy_block(input[0], storage.audio_in_nonOS[0], BLOCK_SIZE_QUAD);
         copy_block(input[1], storage.audio_in_nonOS[1], BLOCK_SIZE_QUAD);
-        halfbandIN.process_block_U2(input[0], input[1], storage.audio_in[0], storage.audio_in[1]);
+        halfbandIN.process_block_U2(input[0], input[1], storage.audio_in[0], storage.audio_in[1],
+                                    BLOCK_SIZE_OS);
     }
     else
     {
@@ -3431,20 +3664,19 @@ void SurgeSynthesizer::process()
         clear_block_antidenormalnoise(storage.audio_in_nonOS[1], BLOCK_SIZE_QUAD);
     }
 
-    // TODO: FIX SCENE ASSUMPTION
-    float fxsendout alignas(16)[2][2][BLOCK_SIZE];
+    float fxsendout alignas(16)[n_send_slots][2][BLOCK_SIZE];
     bool play_scene[n_scenes];
 
+    for (int s = 0; s < n_scenes; s++)
     {
-        clear_block_antidenormalnoise(sceneout[0][0], BLOCK_SIZE_OS_QUAD);
-        clear_block_antidenormalnoise(sceneout[0][1], BLOCK_SIZE_OS_QUAD);
-        clear_block_antidenormalnoise(sceneout[1][0], BLOCK_SIZE_OS_QUAD);
-        clear_block_antidenormalnoise(sceneout[1][1], BLOCK_SIZE_OS_QUAD);
+        clear_block_antidenormalnoise(sceneout[s][0], BLOCK_SIZE_OS_QUAD);
+        clear_block_antidenormalnoise(sceneout[s][1], BLOCK_SIZE_OS_QUAD);
+    }
 
-        clear_block_antidenormalnoise(fxsendout[0][0], BLOCK_SIZE_QUAD);
-        clear_block_antidenormalnoise(fxsendout[0][1], BLOCK_SIZE_QUAD);
-        clear_block_antidenormalnoise(fxsendout[1][0], BLOCK_SIZE_QUAD);
-        clear_block_antidenormalnoise(fxsendout[1][1], BLOCK_SIZE_QUAD);
+    for (int i = 0; i < n_send_slots; i++)
+    {
+        clear_block_antidenormalnoise(fxsendout[i][0], BLOCK_SIZE_QUAD);
+        clear_block_antidenormalnoise(fxsendout[i][1], BLOCK_SIZE_QUAD);
     }
 
     storage.modRoutingMutex.lock();
@@ -3457,178 +3689,96 @@ void SurgeSynthesizer::process()
 
     if (fx_bypass == fxb_all_fx)
     {
-        if (fx[fxslot_send1])
-        {
-            FX1.set_target_smoothed(
-                amp_to_linear(storage.getPatch()
-                                  .globaldata[storage.getPatch().fx[fxslot_send1].return_level.id]
-                                  .f));
-            send[0][0].set_target_smoothed(amp_to_linear(
-                storage.getPatch()
-                    .scenedata[0][storage.getPatch().scene[0].send_level[0].param_id_in_scene]
-                    .f));
-            send[0][1].set_target_smoothed(amp_to_linear(
-                storage.getPatch()
-                    .scenedata[1][storage.getPatch().scene[1].send_level[0].param_id_in_scene]
-                    .f));
-        }
-        if (fx[fxslot_send2])
-        {
-            FX2.set_target_smoothed(
-                amp_to_linear(storage.getPatch()
-                                  .globaldata[storage.getPatch().fx[fxslot_send2].return_level.id]
-                                  .f));
-            send[1][0].set_target_smoothed(amp_to_linear(
-                storage.getPatch()
-                    .scenedata[0][storage.getPatch().scene[0].send_level[1].param_id_in_scene]
-                    .f));
-            send[1][1].set_target_smoothed(amp_to_linear(
-                storage.getPatch()
-                    .scenedata[1][storage.getPatch().scene[1].send_level[1].param_id_in_scene]
-                    .f));
+        for (int i = 0; i < n_send_slots; i++)
+        {
+            int slot = fxslot_sends[i];
+            if (!fx[slot])
+                continue;
+
+            sendReturn[i].set_target_smoothed(amp_to_linear(
+                storage.getPatch().globaldata[storage.getPatch().fx[slot].return_level.id].f));
+
+            for (int s = 0; s < n_scenes; s++)
+            {
+                send[i][s].set_target_smoothed(amp_to_linear(
+                    storage.getPatch()
+                        .scenedata[s][storage.getPatch().scene[s].send_level[i].param_id_in_scene]
+                        .f));
+            }
         }
     }
 
-    list<SurgeVoice *>::iterator iter;
-
     for (int sc = 0; sc < n_scenes; sc++)
     {
         play_scene[sc] = (!voices[sc].empty());
     }
 
-    int FBentry[n_scenes];
     int vcount = 0;
 
     for (int s = 0; s < n_scenes; s++)
     {
-        FBentry[s] = 0;
-        iter = voices[s].begin();
-        while (iter != voices[s].end())
-        {
-            SurgeVoice *v = *iter;
-            assert(v);
-            bool resume = v->process_block(FBQ[s][FBentry[s] >> 2], FBentry[s] & 3);
-            FBentry[s]++;
-
-            vcount++;
-
-            if (!resume)
-            {
-                //_aligned_free(v);
-                freeVoice(v);
-                iter = voices[s].erase(iter);
-            }
-            else
-                iter++;
-        }
-
-        storage.modRoutingMutex.unlock();
-
-        fbq_global g;
-        g.FU1ptr = GetQFPtrFilterUnit(storage.getPatch().scene[s].filterunit[0].type.val.i,
-                                      storage.getPatch().scene[s].filterunit[0].subtype.val.i);
-        g.FU2ptr = GetQFPtrFilterUnit(storage.getPatch().scene[s].filterunit[1].type.val.i,
-                                      storage.getPatch().scene[s].filterunit[1].subtype.val.i);
-        g.WSptr = GetQFPtrWaveshaper(storage.getPatch().scene[s].wsunit.type.val.i);
-
-        FBQFPtr ProcessQuadFB =
-            GetFBQPointer(storage.getPatch().scene[s].filterblock_configuration.val.i,
-                          g.FU1ptr != 0, g.WSptr != 0, g.FU2ptr != 0);
-
-        for (int e = 0; e < FBentry[s]; e += 4)
-        {
-            int units = FBentry[s] - e;
-            for (int i = units; i < 4; i++)
-            {
-                FBQ[s][e >> 2].FU[0].active[i] = 0;
-                FBQ[s][e >> 2].FU[1].active[i] = 0;
-                FBQ[s][e >> 2].FU[2].active[i] = 0;
-                FBQ[s][e >> 2].FU[3].active[i] = 0;
-            }
-            ProcessQuadFB(FBQ[s][e >> 2], g, sceneout[s][0], sceneout[s][1]);
-        }
-
-        if (s == 0 && storage.otherscene_clients > 0)
-        {
-            // Make available for scene B
-            copy_block(sceneout[0][0], storage.audio_otherscene[0], BLOCK_SIZE_OS_QUAD);
-            copy_block(sceneout[0][1], storage.audio_otherscene[1], BLOCK_SIZE_OS_QUAD);
-        }
-
-        iter = voices[s].begin();
-        while (iter != voices[s].end())
-        {
-            SurgeVoice *v = *iter;
-            assert(v);
-            v->GetQFB(); // save filter state in voices after quad processing is done
-            iter++;
-        }
-        storage.modRoutingMutex.lock();
+        vcount += renderScene(s);
     }
 
     storage.modRoutingMutex.unlock();
     polydisplay = vcount;
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (play_scene[0])
+    // Decimate the playing scenes together, with the hard clips around that folded into the
+    // halfband passes. The clip after happens after the lowcut instead, when that's on
+    HalfRateFilter *hbFilters[n_scenes];
+    HalfRateFilter::D2Block hbBlocks[n_scenes];
+    bool clippedAfterHalfband[n_scenes];
+    int nhb = 0;
+
+    for (int s = 0; s < n_scenes; ++s)
     {
-        switch (storage.sceneHardclipMode[0])
+        clippedAfterHalfband[s] = false;
+        if (!play_scene[s])
+            continue;
+
+        float clip = 0.f;
+        switch (storage.sceneHardclipMode[s])
         {
         case SurgeStorage::HARDCLIP_TO_18DBFS:
-            hardclip_block8(sceneout[0][0], BLOCK_SIZE_OS_QUAD);
-            hardclip_block8(sceneout[0][1], BLOCK_SIZE_OS_QUAD);
+            clip = 8.f;
             break;
         case SurgeStorage::HARDCLIP_TO_0DBFS:
-            hardclip_block(sceneout[0][0], BLOCK_SIZE_OS_QUAD);
-            hardclip_block(sceneout[0][1], BLOCK_SIZE_OS_QUAD);
+            clip = 1.f;
             break;
         case SurgeStorage::BYPASS_HARDCLIP:
             break;
         }
 
-        halfbandA.process_block_D2(sceneout[0][0], sceneout[0][1]);
-    }
-
-    if (play_scene[1])
-    {
-        switch (storage.sceneHardclipMode[1])
+        auto &b = hbBlocks[nhb];
+        b.L = sceneout[s][0];
+        b.R = sceneout[s][1];
+        b.clipIn = clip;
+        if (storage.getPatch().scene[s].lowcut.deactivated)
         {
-        case SurgeStorage::HARDCLIP_TO_18DBFS:
-            hardclip_block8(sceneout[1][0], BLOCK_SIZE_OS_QUAD);
-            hardclip_block8(sceneout[1][1], BLOCK_SIZE_OS_QUAD);
-            break;
-        case SurgeStorage::HARDCLIP_TO_0DBFS:
-            hardclip_block(sceneout[1][0], BLOCK_SIZE_OS_QUAD);
-            hardclip_block(sceneout[1][1], BLOCK_SIZE_OS_QUAD);
-            break;
-        case SurgeStorage::BYPASS_HARDCLIP:
-            break;
+            b.clipOut = clip;
+            clippedAfterHalfband[s] = true;
         }
-
-        halfbandB.process_block_D2(sceneout[1][0], sceneout[1][1]);
+        hbFilters[nhb++] = sceneHalfband[s].get();
     }
 
-    // TODO: FIX SCENE ASSUMPTION
-    if (storage.getPatch().scene[0].lowcut.deactivated == false)
-    {
-        auto freq =
-            storage.getPatch().scenedata[0][storage.getPatch().scene[0].lowcut.param_id_in_scene].f;
+    HalfRateFilter::process_block_D2_fused(hbFilters, hbBlocks, nhb, BLOCK_SIZE_OS);
 
-        hpA.coeff_HP(hpA.calc_omega(freq / 12.0), 0.4);    // var 0.707
-        hpA.process_block(sceneout[0][0], sceneout[0][1]); // TODO: quadify
-    }
-
-    if (storage.getPatch().scene[1].lowcut.deactivated == false)
+    for (int s = 0; s < n_scenes; ++s)
     {
-        auto freq =
-            storage.getPatch().scenedata[1][storage.getPatch().scene[1].lowcut.param_id_in_scene].f;
+        auto &lowcut = storage.getPatch().scene[s].lowcut;
 
-        hpB.coeff_HP(hpB.calc_omega(freq / 12.0), 0.4);
-        hpB.process_block(sceneout[1][0], sceneout[1][1]);
+        if (!lowcut.deactivated)
+        {
+            auto freq = storage.getPatch().scenedata[s][lowcut.param_id_in_scene].f;
+            sceneLowcut[s].process_block(sceneout[s][0], sceneout[s][1], freq);
+        }
     }
 
     for (int cls = 0; cls < n_scenes; ++cls)
     {
+        if (clippedAfterHalfband[cls])
+            continue;
+
         switch (storage.sceneHardclipMode[cls])
         {
         case SurgeStorage::HARDCLIP_TO_18DBFS:
@@ -3644,7 +3794,6 @@ void SurgeSynthesizer::process()
         }
     }
 
-    // TODO: FIX SCENE ASSUMPTION
     bool sc_state[n_scenes];
 
     for (int i = 0; i < n_scenes; i++)
@@ -3652,31 +3801,22 @@ void SurgeSynthesizer::process()
         sc_state[i] = play_scene[i];
     }
 
+    int fx_disable = storage.getPatch().fx_disable.val.i;
+
     // apply insert effects
     if (fx_bypass != fxb_no_fx)
     {
-        if (fx[fxslot_ains1] && !(storage.getPatch().fx_disable.val.i & (1 << 0)))
+        for (int s = 0; s < n_scenes; s++)
         {
-            sc_state[0] =
-                fx[fxslot_ains1]->process_ringout(sceneout[0][0], sceneout[0][1], sc_state[0]);
-        }
-
-        if (fx[fxslot_ains2] && !(storage.getPatch().fx_disable.val.i & (1 << 1)))
-        {
-            sc_state[0] =
-                fx[fxslot_ains2]->process_ringout(sceneout[0][0], sceneout[0][1], sc_state[0]);
-        }
-
-        if (fx[fxslot_bins1] && !(storage.getPatch().fx_disable.val.i & (1 << 2)))
-        {
-            sc_state[1] =
-                fx[fxslot_bins1]->process_ringout(sceneout[1][0], sceneout[1][1], sc_state[1]);
-        }
-
-        if (fx[fxslot_bins2] && !(storage.getPatch().fx_disable.val.i & (1 << 3)))
-        {
-            sc_state[1] =
-                fx[fxslot_bins2]->process_ringout(sceneout[1][0], sceneout[1][1], sc_state[1]);
+            for (int i = 0; i < n_inserts_per_scene; i++)
+            {
+                int slot = fxslot_scene_inserts[s][i];
+                if (fx[slot] && !(fx_disable & (1 << slot)))
+                {
+                    sc_state[s] =
+                        fx[slot]->process_ringout(sceneout[s][0], sceneout[s][1], sc_state[s]);
+                }
+            }
         }
     }
 
@@ -3698,52 +3838,52 @@ void SurgeSynthesizer::process()
     }
 
     // sum scenes
-    // TODO: FIX SCENE ASSUMPTION
     copy_block(sceneout[0][0], output[0], BLOCK_SIZE_QUAD);
     copy_block(sceneout[0][1], output[1], BLOCK_SIZE_QUAD);
-    accumulate_block(sceneout[1][0], output[0], BLOCK_SIZE_QUAD);
-    accumulate_block(sceneout[1][1], output[1], BLOCK_SIZE_QUAD);
+    bool anyScene = sc_state[0];
 
-    bool send1 = false, send2 = false;
+    for (int s = 1; s < n_scenes; s++)
+    {
+        accumulate_block(sceneout[s][0], output[0], BLOCK_SIZE_QUAD);
+        accumulate_block(sceneout[s][1], output[1], BLOCK_SIZE_QUAD);
+        anyScene = anyScene || sc_state[s];
+    }
+
+    bool anySend = false;
     // add send effects
-    // TODO: FIX SCENE ASSUMPTION
     if (fx_bypass == fxb_all_fx)
     {
-        if (fx[fxslot_send1] && !(storage.getPatch().fx_disable.val.i & (1 << 4)))
+        for (int i = 0; i < n_send_slots; i++)
         {
-            send[0][0].MAC_2_blocks_to(sceneout[0][0], sceneout[0][1], fxsendout[0][0],
-                                       fxsendout[0][1], BLOCK_SIZE_QUAD);
-            send[0][1].MAC_2_blocks_to(sceneout[1][0], sceneout[1][1], fxsendout[0][0],
-                                       fxsendout[0][1], BLOCK_SIZE_QUAD);
-            send1 = fx[fxslot_send1]->process_ringout(fxsendout[0][0], fxsendout[0][1],
-                                                      sc_state[0] || sc_state[1]);
-            FX1.MAC_2_blocks_to(fxsendout[0][0], fxsendout[0][1], output[0], output[1],
-                                BLOCK_SIZE_QUAD);
-        }
-        if (fx[fxslot_send2] && !(storage.getPatch().fx_disable.val.i & (1 << 5)))
-        {
-            send[1][0].MAC_2_blocks_to(sceneout[0][0], sceneout[0][1], fxsendout[1][0],
-                                       fxsendout[1][1], BLOCK_SIZE_QUAD);
-            send[1][1].MAC_2_blocks_to(sceneout[1][0], sceneout[1][1], fxsendout[1][0],
-                                       fxsendout[1][1], BLOCK_SIZE_QUAD);
-            send2 = fx[fxslot_send2]->process_ringout(fxsendout[1][0], fxsendout[1][1],
-                                                      sc_state[0] || sc_state[1]);
-            FX2.MAC_2_blocks_to(fxsendout[1][0], fxsendout[1][1], output[0], output[1],
-                                BLOCK_SIZE_QUAD);
+            int slot = fxslot_sends[i];
+            if (!fx[slot] || (fx_disable & (1 << slot)))
+                continue;
+
+            for (int s = 0; s < n_scenes; s++)
+            {
+                send[i][s].MAC_2_blocks_to(sceneout[s][0], sceneout[s][1], fxsendout[i][0],
+                                           fxsendout[i][1], BLOCK_SIZE_QUAD);
+            }
+
+            if (fx[slot]->process_ringout(fxsendout[i][0], fxsendout[i][1], anyScene))
+                anySend = true;
+
+            sendReturn[i].MAC_2_blocks_to(fxsendout[i][0], fxsendout[i][1], output[0], output[1],
+                                          BLOCK_SIZE_QUAD);
         }
     }
 
     // apply global effects
     if ((fx_bypass == fxb_all_fx) || (fx_bypass == fxb_no_sends))
     {
-        bool glob = sc_state[0] || sc_state[1] || send1 || send2;
+        bool glob = anyScene || anySend;
 
-        if (fx[fxslot_global1] && !(storage.getPatch().fx_disable.val.i & (1 << 6)))
+        if (fx[fxslot_global1] && !(fx_disable & (1 << fxslot_global1)))
         {
             glob = fx[fxslot_global1]->process_ringout(output[0], output[1], glob);
         }
 
-        if (fx[fxslot_global2] && !(storage.getPatch().fx_disable.val.i & (1 << 7)))
+        if (fx[fxslot_global2] && !(fx_disable & (1 << fxslot_global2)))
         {
             glob = fx[fxslot_global2]->process_ringout(output[0], output[1], glob);
         }
@@ -4020,6 +4160,7 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
     fxmodsync[target].clear();
 
     fxsync[target].type.val.i = so.type.val.i;
+    fxsync[target].type.deform_type = so.type.deform_type;
     Effect *t_fx = spawn_effect(fxsync[target].type.val.i, &storage, &fxsync[target], 0);
     if (t_fx)
     {
@@ -4035,6 +4176,7 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
     else if (m == FXReorderMode::SWAP)
     {
         fxsync[source].type.val.i = to.type.val.i;
+        fxsync[source].type.deform_type = to.type.deform_type;
         t_fx = spawn_effect(fxsync[source].type.val.i, &storage, &fxsync[source], 0);
         if (t_fx)
         {
@@ -4107,12 +4249,24 @@ void SurgeSynthesizer::reorderFx(int source, int target, FXReorderMode m)
         }
     }
 
+    prepareFx(source);
+    prepareFx(target);
     load_fx_needed = true;
     fx_reload[source] = true;
     fx_reload[target] = true;
     refresh_editor = true;
 }
 
+void SurgeSynthesizer::prepareFx(int slot, bool defaults)
+{
+    if (slot < 0 || slot >= n_fx_slots)
+        return;
+
+    // a preset for the same type just reloads parameters, no new effect needed
+    if (fxsync[slot].type.val.i != storage.getPatch().fx[slot].type.val.i)
+        fxSpawner->prepare(slot, fxsync[slot].type.val.i, defaults);
+}
+
 bool SurgeSynthesizer::getParameterIsBoolean(const ID &id)
 {
     auto index = id.getSynthSideId();
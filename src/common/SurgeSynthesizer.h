@@ -17,6 +17,7 @@
 #include "SurgeStorage.h"
 #include "SurgeVoice.h"
 #include "effect/Effect.h"
+#include "effect/FxSpawner.h"
 #include "BiquadFilter.h"
 #include "UserInteractions.h"
 
@@ -80,9 +81,8 @@ class alignas(16) SurgeSynthesizer
 
     // aligned stuff
     SurgeStorage storage alignas(16);
-    lipol_ps FX1 alignas(16), // TODO: FIX SCENE ASSUMPTION
-        FX2 alignas(16),      // TODO: FIX SCENE ASSUMPTION
-        amp alignas(16), amp_mute alignas(16), send alignas(16)[2][2];
+    lipol_ps sendReturn alignas(16)[n_send_slots], amp alignas(16), amp_mute alignas(16),
+        send alignas(16)[n_send_slots][n_scenes];
 
     // methods
   public:
@@ -136,6 +136,14 @@ class alignas(16) SurgeSynthesizer
         int source, int target,
         FXReorderMode m); // This is safe to call from the UI thread since it just edits the sync
 
+    /*
+     * Have the spawner start building the effect fxsync[slot] asks for. Anything that changes
+     * an fxsync type calls this before setting load_fx_needed, and loadFx holds the swap for a
+     * few blocks while it is in flight rather than build the effect on the audio thread. With
+     * defaults, the new effect and the patch start from the type's default values.
+     */
+    void prepareFx(int slot, bool defaults = false);
+
     void playVoice(int scene, char channel, char key, char velocity, char detune);
     void releaseScene(int s);
     int calculateChannelMask(int channel, int key);
@@ -146,9 +154,14 @@ class alignas(16) SurgeSynthesizer
 
     SurgeVoice *getUnusedVoice(int scene);
     void freeVoice(SurgeVoice *);
-    std::array<std::array<SurgeVoice, MAX_VOICES>, 2> voices_array;
-    unsigned int voices_usedby[2][MAX_VOICES]; // 0 indicates no user, 1 is scene A & 2 is scene B
-                                               // // TODO: FIX SCENE ASSUMPTION!
+    void renderOscillatorsBatched(int scene);
+    /*
+     * Runs a scene's voices and filter blocks into sceneout, at the oversampled rate. This is
+     * called, and returns, with modRoutingMutex held. Returns the number of voices played
+     */
+    int renderScene(int scene);
+    std::array<std::array<SurgeVoice, MAX_VOICES>, n_scenes> voices_array;
+    unsigned int voices_usedby[n_scenes][MAX_VOICES]; // 0 indicates no user, otherwise scene + 1
     int64_t voiceCounter = 1L;
 
   public:
@@ -367,10 +380,12 @@ class alignas(16) SurgeSynthesizer
   public:
     int CC0, CC32, PCH, patchid;
     float masterfade = 0;
-    HalfRateFilter halfbandA, halfbandB,
-        halfbandIN; // TODO: FIX SCENE ASSUMPTION (for halfbandA/B - use std::array)
+    HalfRateFilter halfbandIN;
+    std::array<std::unique_ptr<HalfRateFilter>, n_scenes> sceneHalfband;
     std::list<SurgeVoice *> voices[n_scenes];
     std::unique_ptr<Effect> fx[n_fx_slots];
+    std::unique_ptr<FxSpawner> fxSpawner;
+    int fxSpawnWaitBlocks[n_fx_slots];
     std::atomic<bool> halt_engine;
     MidiChannelState channelState[16];
     bool mpeEnabled = false;
@@ -386,11 +401,12 @@ class alignas(16) SurgeSynthesizer
 
     bool switch_toggled_queued, release_if_latched[n_scenes], release_anyway[n_scenes];
     void setParameterSmoothed(long index, float value);
-    BiquadFilter hpA, hpB; // TODO: FIX SCENE ASSUMPTION (use std::array)
+    std::array<SceneLowcutFilter, n_scenes> sceneLowcut;
 
     bool fx_reload[n_fx_slots];   // if true, reload new effect parameters from fxsync
     FxStorage fxsync[n_fx_slots]; // used for synchronisation of parameter init
     bool fx_reload_mod[n_fx_slots];
+    bool fx_reload_defaults[n_fx_slots]; // if true, loadFx resets the new effect to its defaults
     std::array<std::vector<std::tuple<int, int, float>>, n_fx_slots> fxmodsync;
     int fx_suspend_bitmask;
 
@@ -402,6 +418,14 @@ class alignas(16) SurgeSynthesizer
     int demo_counter = 0;
 
     QuadFilterChainState *FBQ[n_scenes];
+    // The voice playing in each lane of FBQ. Lanes [0, FBQlanes) are in use; a voice gets the
+    // next lane before its first block, and the last lane's voice fills the gap when one ends
+    SurgeVoice *FBQvoice[n_scenes][MAX_VOICES];
+    int FBQlanes[n_scenes];
+    // the filter units which make their coefficients once for the whole scene this block
+    SharedFilterCoeffs sharedFilterCoeffs[n_scenes][n_filterunits_per_scene];
+    void bindVoiceLane(SurgeVoice *v, int scene);
+    void releaseVoiceLane(SurgeVoice *v);
 
     std::string hostProgram = "Unknown Host";
     bool activateExtraOutputs = true;
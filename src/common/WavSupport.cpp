@@ -459,9 +459,7 @@ bool SurgeStorage::load_wt_wav_portable(std::string fn, Wavetable *wt)
 
     if (wavdata && wt)
     {
-        waveTableDataMutex.lock();
-        wt->BuildWT(wavdata, wh, wh.flags & wtf_is_sample);
-        waveTableDataMutex.unlock();
+        build_and_publish_wt(wt, wavdata, wh, wh.flags & wtf_is_sample);
         free(wavdata);
     }
     return true;
@@ -0,0 +1,231 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#pragma once
+
+#include "BiquadFilter.h"
+
+/*
+ * N biquads in series on a stereo signal, with L and R in the two lanes of one register.
+ *
+ * Each coefficient is stored for all sections together, per lane, so the two channels can have
+ * different filters (as the phaser's stages do) or the same one (as an EQ's bands do). The
+ * coefficients are designed with a BiquadFilter's coeff_ functions and copied in with set_coef,
+ * and glide to their new values with the same lag as a BiquadFilter.
+ *
+ * A section which is not enabled passes its input through by selecting it with a mask, so
+ * switching bands in and out doesn't branch in the sample loop.
+ *
+ * Each section's output is rounded to float before it feeds the next, as it is when chaining
+ * BiquadFilters, so a cascade produces the same output as the filters it replaces.
+ */
+template <int N> class alignas(16) BiquadCascade
+{
+  public:
+    BiquadCascade() { suspend(); }
+
+    // Clear the state and coefficients. The next set_coef for each section starts without a glide.
+    void suspend()
+    {
+        for (int s = 0; s < N; s++)
+        {
+            a1[s] = a2[s] = b0[s] = b1[s] = b2[s] = _mm_setzero_pd();
+            ta1[s] = ta2[s] = tb0[s] = tb1[s] = tb2[s] = _mm_setzero_pd();
+            reg0[s] = reg1[s] = _mm_setzero_pd();
+            first_run[s][0] = first_run[s][1] = true;
+            set_enabled(s, true);
+        }
+    }
+
+    // Clear the state of section, and start its next set_coef without a glide
+    void reset(int section)
+    {
+        reg0[section] = reg1[section] = _mm_setzero_pd();
+        first_run[section][0] = first_run[section][1] = true;
+    }
+
+    // Take from's target coefficients for channel (0 is L, 1 is R) of section
+    void set_coef(int section, int channel, const BiquadFilter &from)
+    {
+        set_lane(ta1[section], channel, from.a1.target_v.d[0]);
+        set_lane(ta2[section], channel, from.a2.target_v.d[0]);
+        set_lane(tb0[section], channel, from.b0.target_v.d[0]);
+        set_lane(tb1[section], channel, from.b1.target_v.d[0]);
+        set_lane(tb2[section], channel, from.b2.target_v.d[0]);
+
+        if (first_run[section][channel])
+        {
+            set_lane(a1[section], channel, from.a1.target_v.d[0]);
+            set_lane(a2[section], channel, from.a2.target_v.d[0]);
+            set_lane(b0[section], channel, from.b0.target_v.d[0]);
+            set_lane(b1[section], channel, from.b1.target_v.d[0]);
+            set_lane(b2[section], channel, from.b2.target_v.d[0]);
+            first_run[section][channel] = false;
+        }
+    }
+
+    void set_coef(int section, const BiquadFilter &from)
+    {
+        set_coef(section, 0, from);
+        set_coef(section, 1, from);
+    }
+
+    void set_enabled(int section, bool e)
+    {
+        enabled[section] = e ? _mm_castsi128_pd(_mm_set1_epi32(-1)) : _mm_setzero_pd();
+    }
+
+    void coeff_instantize()
+    {
+        for (int s = 0; s < N; s++)
+        {
+            a1[s] = ta1[s];
+            a2[s] = ta2[s];
+            b0[s] = tb0[s];
+            b1[s] = tb1[s];
+            b2[s] = tb2[s];
+        }
+    }
+
+    // One sample through the first sections sections
+    inline void process_sample(float &L, float &R, int sections = N)
+    {
+        __m128d x = _mm_cvtps_pd(_mm_unpacklo_ps(_mm_load_ss(&L), _mm_load_ss(&R)));
+
+        for (int s = 0; s < sections; s++)
+        {
+            Section st;
+            load(s, st);
+            x = tick(st, x);
+            store(s, st);
+        }
+
+        __m128 r = _mm_cvtpd_ps(x);
+        _mm_store_ss(&L, r);
+        _mm_store_ss(&R, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1)));
+    }
+
+    // A block through the first sections sections, a section at a time
+    void process_block(float *dataL, float *dataR, int sections = N)
+    {
+        __m128d x[BLOCK_SIZE];
+
+        for (int k = 0; k < BLOCK_SIZE; k += 4)
+        {
+            __m128 vl = _mm_loadu_ps(dataL + k), vr = _mm_loadu_ps(dataR + k);
+            __m128 lo = _mm_unpacklo_ps(vl, vr), hi = _mm_unpackhi_ps(vl, vr);
+            x[k] = _mm_cvtps_pd(lo);
+            x[k + 1] = _mm_cvtps_pd(_mm_movehl_ps(lo, lo));
+            x[k + 2] = _mm_cvtps_pd(hi);
+            x[k + 3] = _mm_cvtps_pd(_mm_movehl_ps(hi, hi));
+        }
+
+        for (int s = 0; s < sections; s++)
+        {
+            Section st;
+            load(s, st);
+            for (int k = 0; k < BLOCK_SIZE; k++)
+                x[k] = tick(st, x[k]);
+            store(s, st);
+            flush_denormals(s);
+        }
+
+        for (int k = 0; k < BLOCK_SIZE; k += 4)
+        {
+            __m128 o01 = _mm_movelh_ps(_mm_cvtpd_ps(x[k]), _mm_cvtpd_ps(x[k + 1]));
+            __m128 o23 = _mm_movelh_ps(_mm_cvtpd_ps(x[k + 2]), _mm_cvtpd_ps(x[k + 3]));
+            _mm_storeu_ps(dataL + k, _mm_shuffle_ps(o01, o23, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(dataR + k, _mm_shuffle_ps(o01, o23, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+
+    void flush_denormals(int section)
+    {
+        const __m128d thresh = _mm_set1_pd(1e-30);
+        const __m128d absmask = _mm_castsi128_pd(_mm_set_epi32(0x7fffffff, -1, 0x7fffffff, -1));
+        reg0[section] = _mm_and_pd(reg0[section],
+                                   _mm_cmpge_pd(_mm_and_pd(reg0[section], absmask), thresh));
+        reg1[section] = _mm_and_pd(reg1[section],
+                                   _mm_cmpge_pd(_mm_and_pd(reg1[section], absmask), thresh));
+    }
+
+  private:
+    static void set_lane(__m128d &v, int lane, double d)
+    {
+        vdouble t;
+        t.v = v;
+        t.d[lane] = d;
+        v = t.v;
+    }
+
+    // a section's coefficients and state, worked on in registers
+    struct Section
+    {
+        __m128d a1, a2, b0, b1, b2, ta1, ta2, tb0, tb1, tb2, reg0, reg1, enabled;
+    };
+
+    inline void load(int s, Section &st) const
+    {
+        st.a1 = a1[s];
+        st.a2 = a2[s];
+        st.b0 = b0[s];
+        st.b1 = b1[s];
+        st.b2 = b2[s];
+        st.ta1 = ta1[s];
+        st.ta2 = ta2[s];
+        st.tb0 = tb0[s];
+        st.tb1 = tb1[s];
+        st.tb2 = tb2[s];
+        st.reg0 = reg0[s];
+        st.reg1 = reg1[s];
+        st.enabled = enabled[s];
+    }
+
+    inline void store(int s, const Section &st)
+    {
+        a1[s] = st.a1;
+        a2[s] = st.a2;
+        b0[s] = st.b0;
+        b1[s] = st.b1;
+        b2[s] = st.b2;
+        reg0[s] = st.reg0;
+        reg1[s] = st.reg1;
+    }
+
+    static inline __m128d tick(Section &st, __m128d in)
+    {
+        const __m128d lp = _mm_set1_pd(d_lp), lpinv = _mm_set1_pd(d_lpinv);
+
+        st.a1 = _mm_add_pd(_mm_mul_pd(st.a1, lpinv), _mm_mul_pd(st.ta1, lp));
+        st.a2 = _mm_add_pd(_mm_mul_pd(st.a2, lpinv), _mm_mul_pd(st.ta2, lp));
+        st.b0 = _mm_add_pd(_mm_mul_pd(st.b0, lpinv), _mm_mul_pd(st.tb0, lp));
+        st.b1 = _mm_add_pd(_mm_mul_pd(st.b1, lpinv), _mm_mul_pd(st.tb1, lp));
+        st.b2 = _mm_add_pd(_mm_mul_pd(st.b2, lpinv), _mm_mul_pd(st.tb2, lp));
+
+        __m128d op = _mm_add_pd(_mm_mul_pd(in, st.b0), st.reg0);
+        st.reg0 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(in, st.b1), _mm_mul_pd(st.a1, op)), st.reg1);
+        st.reg1 = _mm_sub_pd(_mm_mul_pd(in, st.b2), _mm_mul_pd(st.a2, op));
+
+        op = _mm_cvtps_pd(_mm_cvtpd_ps(op));
+        return _mm_or_pd(_mm_and_pd(st.enabled, op), _mm_andnot_pd(st.enabled, in));
+    }
+
+    // lane 0 is L and lane 1 is R throughout
+    __m128d a1[N], a2[N], b0[N], b1[N], b2[N];
+    __m128d ta1[N], ta2[N], tb0[N], tb1[N], tb2[N];
+    __m128d reg0[N], reg1[N];
+    __m128d enabled[N];
+    bool first_run[N][2];
+};
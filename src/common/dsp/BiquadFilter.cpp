@@ -327,115 +327,92 @@ void BiquadFilter::process_block_to(float *__restrict data, float *__restrict da
     }
 }
 
-void BiquadFilter::process_block_slowlag(float *__restrict dataL, float *__restrict dataR)
+template <bool slowlag>
+void BiquadFilter::process_block_stereo(float *dataL, float *dataR, float *dstL, float *dstR)
 {
-    /*if(storage->SSE2) process_block_slowlag_SSE2(dataL,dataR);
-    else*/
+    /*
+     * L and R sit in lanes 0 and 1 of one register with the coefficients broadcast across
+     * both. The coefficients are lagged in pairs. The arithmetic is the same, in the same order,
+     * as the scalar version, so the results are too.
+     */
+    const __m128d lp = _mm_set1_pd(d_lp), lpinv = _mm_set1_pd(d_lpinv);
+
+    __m128d A = _mm_set_pd(a2.v.d[0], a1.v.d[0]);
+    __m128d B = _mm_set_pd(b1.v.d[0], b0.v.d[0]);
+    __m128d B2 = _mm_set_sd(b2.v.d[0]);
+    __m128d tA = _mm_set_pd(a2.target_v.d[0], a1.target_v.d[0]);
+    __m128d tB = _mm_set_pd(b1.target_v.d[0], b0.target_v.d[0]);
+    __m128d tB2 = _mm_set_sd(b2.target_v.d[0]);
+    __m128d r0 = reg0.v, r1 = reg1.v;
+
+    auto lag = [&]() {
+        A = _mm_add_pd(_mm_mul_pd(A, lpinv), _mm_mul_pd(tA, lp));
+        B = _mm_add_pd(_mm_mul_pd(B, lpinv), _mm_mul_pd(tB, lp));
+        B2 = _mm_add_pd(_mm_mul_pd(B2, lpinv), _mm_mul_pd(tB2, lp));
+    };
+
+    if (slowlag)
+        lag();
+
+    for (int k = 0; k < BLOCK_SIZE; k += 4)
     {
-        a1.process();
-        a2.process();
-        b0.process();
-        b1.process();
-        b2.process();
+        __m128 vl = _mm_loadu_ps(dataL + k), vr = _mm_loadu_ps(dataR + k);
+        __m128 lo = _mm_unpacklo_ps(vl, vr), hi = _mm_unpackhi_ps(vl, vr); // L0 R0 L1 R1 ...
+        __m128d in[4] = {_mm_cvtps_pd(lo), _mm_cvtps_pd(_mm_movehl_ps(lo, lo)), _mm_cvtps_pd(hi),
+                         _mm_cvtps_pd(_mm_movehl_ps(hi, hi))};
+        __m128 out[4];
 
-        int k;
-        for (k = 0; k < BLOCK_SIZE; k++)
+        for (int j = 0; j < 4; j++)
         {
-            double input = dataL[k];
-            double op;
-
-            op = input * b0.v.d[0] + reg0.d[0];
-            reg0.d[0] = input * b1.v.d[0] - a1.v.d[0] * op + reg1.d[0];
-            reg1.d[0] = input * b2.v.d[0] - a2.v.d[0] * op;
-
-            dataL[k] = op;
+            if (!slowlag)
+                lag();
 
-            input = dataR[k];
-            op = input * b0.v.d[0] + reg0.d[1];
-            reg0.d[1] = input * b1.v.d[0] - a1.v.d[0] * op + reg1.d[1];
-            reg1.d[1] = input * b2.v.d[0] - a2.v.d[0] * op;
+            __m128d ca1 = _mm_unpacklo_pd(A, A), ca2 = _mm_unpackhi_pd(A, A);
+            __m128d cb0 = _mm_unpacklo_pd(B, B), cb1 = _mm_unpackhi_pd(B, B);
+            __m128d cb2 = _mm_unpacklo_pd(B2, B2);
 
-            dataR[k] = op;
+            __m128d op = _mm_add_pd(_mm_mul_pd(in[j], cb0), r0);
+            r0 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(in[j], cb1), _mm_mul_pd(ca1, op)), r1);
+            r1 = _mm_sub_pd(_mm_mul_pd(in[j], cb2), _mm_mul_pd(ca2, op));
+            out[j] = _mm_cvtpd_ps(op);
         }
-        flush_denormal(reg0.d[0]);
-        flush_denormal(reg1.d[0]);
-        flush_denormal(reg0.d[1]);
-        flush_denormal(reg1.d[1]);
+
+        __m128 o01 = _mm_movelh_ps(out[0], out[1]), o23 = _mm_movelh_ps(out[2], out[3]);
+        _mm_storeu_ps(dstL + k, _mm_shuffle_ps(o01, o23, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(dstR + k, _mm_shuffle_ps(o01, o23, _MM_SHUFFLE(3, 1, 3, 1)));
     }
+
+    vdouble t;
+    t.v = A;
+    a1.v.d[0] = t.d[0];
+    a2.v.d[0] = t.d[1];
+    t.v = B;
+    b0.v.d[0] = t.d[0];
+    b1.v.d[0] = t.d[1];
+    t.v = B2;
+    b2.v.d[0] = t.d[0];
+    reg0.v = r0;
+    reg1.v = r1;
+
+    flush_denormal(reg0.d[0]);
+    flush_denormal(reg1.d[0]);
+    flush_denormal(reg0.d[1]);
+    flush_denormal(reg1.d[1]);
 }
 
-void BiquadFilter::process_block(float *dataL, float *dataR)
+void BiquadFilter::process_block_slowlag(float *__restrict dataL, float *__restrict dataR)
 {
-    /*if(storage->SSE2) process_block_SSE2(dataL,dataR);
-    else*/
-    {
-        int k;
-        for (k = 0; k < BLOCK_SIZE; k++)
-        {
-            a1.process();
-            a2.process();
-            b0.process();
-            b1.process();
-            b2.process();
-
-            double input = dataL[k];
-            double op;
-
-            op = input * b0.v.d[0] + reg0.d[0];
-            reg0.d[0] = input * b1.v.d[0] - a1.v.d[0] * op + reg1.d[0];
-            reg1.d[0] = input * b2.v.d[0] - a2.v.d[0] * op;
-
-            dataL[k] = op;
-
-            input = dataR[k];
-            op = input * b0.v.d[0] + reg0.d[1];
-            reg0.d[1] = input * b1.v.d[0] - a1.v.d[0] * op + reg1.d[1];
-            reg1.d[1] = input * b2.v.d[0] - a2.v.d[0] * op;
+    process_block_stereo<true>(dataL, dataR, dataL, dataR);
+}
 
-            dataR[k] = op;
-        }
-        flush_denormal(reg0.d[0]);
-        flush_denormal(reg1.d[0]);
-        flush_denormal(reg0.d[1]);
-        flush_denormal(reg1.d[1]);
-    }
+void BiquadFilter::process_block(float *dataL, float *dataR)
+{
+    process_block_stereo<false>(dataL, dataR, dataL, dataR);
 }
 
 void BiquadFilter::process_block_to(float *dataL, float *dataR, float *dstL, float *dstR)
 {
-    /*if(storage->SSE2) process_block_to_SSE2(dataL,dataR,dstL,dstR);
-    else*/
-    {
-        int k;
-        for (k = 0; k < BLOCK_SIZE; k++)
-        {
-            a1.process();
-            a2.process();
-            b0.process();
-            b1.process();
-            b2.process();
-
-            double input = dataL[k];
-            double op;
-
-            op = input * b0.v.d[0] + reg0.d[0];
-            reg0.d[0] = input * b1.v.d[0] - a1.v.d[0] * op + reg1.d[0];
-            reg1.d[0] = input * b2.v.d[0] - a2.v.d[0] * op;
-
-            dstL[k] = op;
-
-            input = dataR[k];
-            op = input * b0.v.d[0] + reg0.d[1];
-            reg0.d[1] = input * b1.v.d[0] - a1.v.d[0] * op + reg1.d[1];
-            reg1.d[1] = input * b2.v.d[0] - a2.v.d[0] * op;
-
-            dstR[k] = op;
-        }
-        flush_denormal(reg0.d[0]);
-        flush_denormal(reg1.d[0]);
-        flush_denormal(reg0.d[1]);
-        flush_denormal(reg1.d[1]);
-    }
+    process_block_stereo<false>(dataL, dataR, dstL, dstR);
 }
 
 void BiquadFilter::process_block(double *data)
@@ -13,7 +13,7 @@ const double d_lpinv = 1.0 - 0.004;
 
 union vdouble
 {
-    //__m128d v;
+    __m128d v;
     double d[2];
 };
 
@@ -51,6 +51,8 @@ class vlag
     }
 };
 
+template <int N> class BiquadCascade;
+
 class BiquadFilter
 {
     // alignas(16) lag<double,false> a1,a2,b0,b1,b2;
@@ -79,13 +81,11 @@ class BiquadFilter
 
     void process_block(float *data);
     // void process_block_SSE2(float *data);
+    // The stereo blocks run L and R in the two lanes of one register
     void process_block(float *dataL, float *dataR);
-    // void process_block_SSE2(float *dataL,float *dataR);
     void process_block_to(float *, float *);
     void process_block_to(float *dataL, float *dataR, float *dstL, float *dstR);
-    // void process_block_to_SSE2(float *dataL,float *dataR, float *dstL,float *dstR);
     void process_block_slowlag(float *dataL, float *dataR);
-    // void process_block_slowlag_SSE2(float *dataL,float *dataR);
     void process_block(double *data);
     // void process_block_SSE2(double *data);
 
@@ -222,5 +222,41 @@ class BiquadFilter
 
   protected:
     void set_coef(double a0, double a1, double a2, double b0, double b1, double b2);
+    template <bool slowlag>
+    void process_block_stereo(float *dataL, float *dataR, float *dstL, float *dstR);
     bool first_run;
+
+    // takes its coefficients from the targets set by our coeff_ functions
+    template <int N> friend class BiquadCascade;
+};
+
+/*
+ * The scene low cut. A stereo highpass which only recomputes its coefficients when the cutoff
+ * (including its modulation) or the sample rate moves. In between, the coefficient lag keeps
+ * gliding towards the same targets, so the output is the same as recomputing every block.
+ */
+class SceneLowcutFilter : public BiquadFilter
+{
+  public:
+    SceneLowcutFilter() : BiquadFilter() {}
+    SceneLowcutFilter(SurgeStorage *storage) : BiquadFilter(storage) {}
+
+    using BiquadFilter::process_block;
+
+    // freq is the lowcut parameter value, in semitones from A440
+    void process_block(float *dataL, float *dataR, float freq)
+    {
+        double omega = calc_omega(freq / 12.0);
+
+        if (first_run || omega != lastOmega)
+        {
+            coeff_HP(omega, 0.4); // var 0.707
+            lastOmega = omega;
+        }
+
+        BiquadFilter::process_block(dataL, dataR);
+    }
+
+  private:
+    double lastOmega = 0;
 };
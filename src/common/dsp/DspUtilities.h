@@ -55,6 +55,39 @@ class quadr_osc
         i = dr * li + di * lr;
     }
 
+    /*
+     * Write the r of the next n calls to process into rOut (16 byte aligned, n a multiple of
+     * 4) and leave the state where they would. Four lanes start a step apart and all turn by
+     * four steps a pass, so the result differs from stepping only in rounding.
+     */
+    inline void process_block(float *__restrict rOut, int n)
+    {
+        float lr alignas(16)[4], li alignas(16)[4];
+        for (int m = 0; m < 4; ++m)
+        {
+            process();
+            lr[m] = r;
+            li[m] = i;
+        }
+
+        float r2 = dr * dr - di * di, i2 = 2.f * dr * di;
+        __m128 wr = _mm_set1_ps(r2 * r2 - i2 * i2), wi = _mm_set1_ps(2.f * r2 * i2);
+        __m128 vr = _mm_load_ps(lr), vi = _mm_load_ps(li);
+        for (int k = 0;; k += 4)
+        {
+            _mm_store_ps(rOut + k, vr);
+            if (k + 4 >= n)
+                break;
+            __m128 t = vr;
+            vr = _mm_sub_ps(_mm_mul_ps(wr, t), _mm_mul_ps(wi, vi));
+            vi = _mm_add_ps(_mm_mul_ps(wr, vi), _mm_mul_ps(wi, t));
+        }
+        _mm_store_ps(lr, vr);
+        _mm_store_ps(li, vi);
+        r = lr[3];
+        i = li[3];
+    }
+
   public:
     float r, i;
 
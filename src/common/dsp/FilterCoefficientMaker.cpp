@@ -1,4 +1,5 @@
 #include "FilterCoefficientMaker.h"
+#include "QuadFilterUnit.h"
 #include "SurgeStorage.h"
 #include <vt_dsp/basic_dsp.h>
 
@@ -17,10 +18,8 @@ const float smooth = 0.2f;
 
 FilterCoefficientMaker::FilterCoefficientMaker() { Reset(); }
 
-void FilterCoefficientMaker::MakeCoeffs(float Freq, float Reso, int Type, int SubType,
-                                        SurgeStorage *storageI, bool tuningAdjusted)
+static float retuneFreq(float Freq, SurgeStorage *storage, bool tuningAdjusted)
 {
-    storage = storageI;
     if (storage)
     {
         if (tuningAdjusted && storage->tuningApplicationMode == SurgeStorage::RETUNE_ALL)
@@ -39,6 +38,14 @@ void FilterCoefficientMaker::MakeCoeffs(float Freq, float Reso, int Type, int Su
             Freq = q - 69;
         }
     }
+    return Freq;
+}
+
+void FilterCoefficientMaker::MakeCoeffs(float Freq, float Reso, int Type, int SubType,
+                                        SurgeStorage *storageI, bool tuningAdjusted)
+{
+    storage = storageI;
+    Freq = retuneFreq(Freq, storage, tuningAdjusted);
     // Force compiler to error out if I miss one
     fu_type fType = (fu_type)Type;
 
@@ -680,3 +687,410 @@ void FilterCoefficientMaker::Reset()
 
     storage = nullptr;
 }
+
+/*
+ * The four wide makers below keep the scalar makers' arithmetic, including where they round to
+ * float, with each group of four lanes held in a pair of SSE2 double registers.
+ */
+namespace
+{
+struct D4
+{
+    __m128d lo, hi;
+};
+
+inline D4 d4(double x)
+{
+    auto v = _mm_set1_pd(x);
+    return {v, v};
+}
+inline D4 d4(__m128 v) { return {_mm_cvtps_pd(v), _mm_cvtps_pd(_mm_movehl_ps(v, v))}; }
+inline __m128 ps(D4 a) { return _mm_movelh_ps(_mm_cvtpd_ps(a.lo), _mm_cvtpd_ps(a.hi)); }
+
+inline D4 operator+(D4 a, D4 b) { return {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)}; }
+inline D4 operator-(D4 a, D4 b) { return {_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)}; }
+inline D4 operator*(D4 a, D4 b) { return {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)}; }
+inline D4 operator/(D4 a, D4 b) { return {_mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi)}; }
+inline D4 operator-(D4 a) { return d4(0.0) - a; }
+inline D4 min(D4 a, D4 b) { return {_mm_min_pd(a.lo, b.lo), _mm_min_pd(a.hi, b.hi)}; }
+inline D4 max(D4 a, D4 b) { return {_mm_max_pd(a.lo, b.lo), _mm_max_pd(a.hi, b.hi)}; }
+inline D4 sqrt(D4 a) { return {_mm_sqrt_pd(a.lo), _mm_sqrt_pd(a.hi)}; }
+inline D4 fabs(D4 a)
+{
+    auto sign = _mm_set1_pd(-0.0);
+    return {_mm_andnot_pd(sign, a.lo), _mm_andnot_pd(sign, a.hi)};
+}
+inline D4 limit_range(D4 x, double low, double high) { return max(min(x, d4(high)), d4(low)); }
+
+// sin(x) for |x| below 0.35, where the Taylor series to x^15 is good to double precision
+inline D4 sin_small(D4 x)
+{
+    auto x2 = x * x;
+    auto r = d4(1.0 / 1307674368000.0);
+    r = d4(-1.0 / 6227020800.0) + x2 * r;
+    r = d4(1.0 / 39916800.0) + x2 * r;
+    r = d4(-1.0 / 362880.0) + x2 * r;
+    r = d4(1.0 / 5040.0) + x2 * r;
+    r = d4(-1.0 / 120.0) + x2 * r;
+    r = d4(1.0 / 6.0) + x2 * r;
+    return x - x * x2 * r;
+}
+
+inline D4 squareReso(__m128 reso) // the 1 - (1 - reso)^2 of the biquad resonance maps
+{
+    auto omr = d4(1.0) - d4(reso);
+    return d4(1.0) - omr * omr;
+}
+
+D4 map2PoleResonance(__m128 reso, __m128 freq, int subtype)
+{
+    auto scaled = [&]() {
+        auto r = d4(reso) * max(d4(0.0), d4(1.0) - max(d4(0.0), (d4(freq) - d4(58.0)) * d4(0.05)));
+        return d4(1.0) - (d4(1.0) - r) * (d4(1.0) - r);
+    };
+    switch (subtype)
+    {
+    case st_Medium:
+        return d4(0.99) - d4(1.0) * limit_range(scaled(), 0.0, 1.0);
+    case st_Rough:
+        return d4(1.0) - d4(1.05) * limit_range(scaled(), 0.001, 1.0);
+    default:
+        return d4(2.5) - d4(2.45) * limit_range(squareReso(reso), 0.0, 1.0);
+    }
+}
+
+D4 map4PoleResonance(__m128 reso, __m128 freq, int subtype)
+{
+    auto scaled = [&]() {
+        return d4(reso) * max(d4(0.0), d4(1.0) - max(d4(0.0), (d4(freq) - d4(58.0)) * d4(0.05)));
+    };
+    switch (subtype)
+    {
+    case st_Medium:
+        return d4(0.99) - d4(0.9949) * limit_range(scaled(), 0.0, 1.0);
+    case st_Rough:
+        return d4(1.0) - d4(1.05) * limit_range(scaled(), 0.001, 1.0);
+    default:
+        return d4(2.5) - d4(2.3) * limit_range(d4(reso), 0.0, 1.0);
+    }
+}
+
+D4 resoscaleQuad(__m128 reso, int subtype)
+{
+    auto r = d4(reso);
+    switch (subtype)
+    {
+    case st_Medium:
+        return d4(1.0) - d4(0.75) * r * r;
+    case st_Rough:
+        return d4(1.0) - d4(0.5) * r * r;
+    case st_Smooth:
+        return d4(1.0) - d4(0.25) * r * r;
+    }
+    return d4(1.0);
+}
+
+void toNormalizedLattice(D4 a0inv, D4 a1, D4 a2, D4 b0, D4 b1, D4 b2, D4 g, __m128 N[])
+{
+    b0 = b0 * a0inv;
+    b1 = b1 * a0inv;
+    b2 = b2 * a0inv;
+    a1 = a1 * a0inv;
+    a2 = a2 * a0inv;
+
+    auto k1 = a1 / (d4(1.0) + a2);
+    auto k2 = a2;
+    auto q1 = sqrt(fabs(d4(1.0) - k1 * k1));
+    auto q2 = sqrt(fabs(d4(1.0) - k2 * k2));
+
+    auto v3 = b2;
+    auto v2 = (b1 - a1 * v3) / q2;
+    auto v1 = (b0 - k1 * v2 * q2 - k2 * v3) / (q1 * q2);
+
+    N[0] = ps(k1);
+    N[1] = ps(k2);
+    N[2] = ps(q1);
+    N[3] = ps(q2);
+    N[4] = ps(v1);
+    N[5] = ps(v2);
+    N[6] = ps(v3);
+    N[7] = ps(g);
+}
+
+void toCoupledForm(D4 a0inv, D4 a1, D4 a2, D4 b0, D4 b1, D4 b2, D4 g, __m128 N[])
+{
+    b0 = b0 * a0inv;
+    b1 = b1 * a0inv;
+    b2 = b2 * a0inv;
+    a1 = a1 * a0inv;
+    a2 = a2 * a0inv;
+
+    auto sq = a1 * a1 - d4(4.0) * a2;
+    auto ar = d4(0.5) * -a1;
+    sq = min(d4(0.0), sq);
+    auto ai = d4(0.5) * sqrt(-sq);
+    ai = max(ai, d4(8.0 * 1.192092896e-07F));
+
+    auto bb1 = b1 - a1 * b0;
+    auto bb2 = b2 - a2 * b0;
+
+    N[0] = ps(ar);
+    N[1] = ps(ai);
+    N[2] = _mm_set1_ps(1.f);
+    N[3] = _mm_setzero_ps();
+    N[4] = ps(bb1);
+    N[5] = ps((bb1 * ar + bb2) / ai);
+    N[6] = ps(b0);
+    N[7] = ps(g);
+}
+
+// the n_cm_coeffs values at src of each of four makers, as one vector per coefficient
+void gatherLanes(const float *src[4], __m128 *dst)
+{
+    for (int h = 0; h < n_cm_coeffs; h += 4)
+    {
+        auto a = _mm_loadu_ps(src[0] + h), b = _mm_loadu_ps(src[1] + h);
+        auto c = _mm_loadu_ps(src[2] + h), d = _mm_loadu_ps(src[3] + h);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        dst[h] = a;
+        dst[h + 1] = b;
+        dst[h + 2] = c;
+        dst[h + 3] = d;
+    }
+}
+
+void scatterLanes(const __m128 *src, float *dst[4])
+{
+    for (int h = 0; h < n_cm_coeffs; h += 4)
+    {
+        auto a = src[h], b = src[h + 1], c = src[h + 2], d = src[h + 3];
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        _mm_storeu_ps(dst[0] + h, a);
+        _mm_storeu_ps(dst[1] + h, b);
+        _mm_storeu_ps(dst[2] + h, c);
+        _mm_storeu_ps(dst[3] + h, d);
+    }
+}
+} // namespace
+
+bool FilterCoefficientMaker::SolveQuad(FilterCoefficientMaker *cm[4], const float Freq[4],
+                                       const float Reso[4], int Type, int SubType,
+                                       SurgeStorage *storage, __m128 N[n_cm_coeffs])
+{
+    enum
+    {
+        LP,
+        HP,
+        BP,
+        NOTCH,
+        AP
+    } shape;
+    bool fourPole = false;
+
+    switch (Type)
+    {
+    case fut_lp12:
+    case fut_lp24:
+        shape = LP;
+        fourPole = Type == fut_lp24;
+        break;
+    case fut_hp12:
+    case fut_hp24:
+        shape = HP;
+        fourPole = Type == fut_hp24;
+        break;
+    case fut_bp24:
+        // not fut_bp12, which carries on into the fut_bp24 maker in MakeCoeffs
+        shape = BP;
+        fourPole = true;
+        break;
+    case fut_notch12:
+    case fut_notch24:
+        shape = NOTCH;
+        break;
+    case fut_apf:
+        shape = AP;
+        break;
+    default:
+        return false;
+    }
+
+    float freq alignas(16)[4], sinu alignas(16)[4], cosi alignas(16)[4];
+    auto reso = _mm_loadu_ps(Reso);
+
+    if (SubType == st_SVF && shape != NOTCH && shape != AP)
+    {
+        float pitch alignas(16)[4];
+        for (int i = 0; i < 4; ++i)
+            pitch[i] = 440.f * storage->note_to_pitch_ignoring_tuning(Freq[i]);
+
+        auto f = d4(_mm_load_ps(pitch));
+        auto F1 = d4(2.0) * sin_small(d4(M_PI) * min(d4(0.11), f * d4(0.25 * samplerate_inv)));
+
+        auto r = d4(_mm_sqrt_ps(_mm_min_ps(_mm_max_ps(reso, _mm_setzero_ps()), _mm_set1_ps(1.f))));
+        // MakeCoeffs only asks for the four pole SVF for the Low and High 24 types
+        double overshoot = (fourPole && shape != BP) ? 0.1 : 0.15;
+
+        auto Q1 = d4(2.0) - r * d4(2.0 + overshoot) + F1 * F1 * d4(overshoot) * d4(0.9);
+        Q1 = min(Q1, min(d4(2.0), d4(2.0) - d4(1.52) * F1));
+
+        N[0] = ps(F1);
+        N[1] = ps(Q1);
+        N[2] = ps(d4(0.1) * r * F1);
+        N[3] = ps(d4(1.0) - d4(0.65) * r);
+        for (int i = 4; i < n_cm_coeffs; ++i)
+            N[i] = _mm_setzero_ps();
+        return true;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        freq[i] = Freq[i];
+        boundfreq(freq[i]) storage->note_to_omega_ignoring_tuning(freq[i], sinu[i], cosi[i]);
+    }
+    auto vfreq = _mm_load_ps(freq), vsinu = _mm_load_ps(sinu), vcosi = _mm_load_ps(cosi);
+    auto one = _mm_set1_ps(1.f);
+
+    auto a1 = d4(-2.0) * d4(vcosi);
+
+    if (shape == NOTCH || shape == AP)
+    {
+        // the float (1 - (1 - Reso) * (1 - Reso)) of Coeff_Notch and Coeff_APF
+        auto omr = _mm_sub_ps(one, reso);
+        auto sq = limit_range(d4(_mm_sub_ps(one, _mm_mul_ps(omr, omr))), 0.0, 1.0);
+        auto Q2inv = (shape == NOTCH && SubType == st_NotchMild) ? d4(1.00) - d4(0.99) * sq
+                                                                  : d4(2.5) - d4(2.49) * sq;
+        auto alpha = d4(vsinu) * Q2inv;
+        auto a0inv = d4(1.0) / (d4(1.0) + alpha);
+
+        if (shape == NOTCH)
+            toNormalizedLattice(a0inv, a1, d4(1.0) - alpha, d4(1.0), a1, d4(1.0), d4(0.005), N);
+        else
+            toNormalizedLattice(a0inv, a1, d4(1.0) - alpha, d4(1.0) - alpha, a1,
+                                d4(1.0) + alpha, d4(0.005), N);
+        return true;
+    }
+
+    auto gain = d4(ps(resoscaleQuad(reso, SubType)));
+    if (shape == BP && SubType == st_Rough)
+        gain = gain * d4(2.0);
+
+    auto Q2inv = fourPole ? map4PoleResonance(reso, vfreq, SubType)
+                          : map2PoleResonance(reso, vfreq, SubType);
+    auto alpha = d4(vsinu) * Q2inv;
+
+    // the lowpasses leave Smooth unclamped, the others clamp every biquad subtype
+    if (shape != LP || SubType != st_Smooth)
+    {
+        alpha = min(alpha, sqrt(d4(1.0) - d4(_mm_mul_ps(vcosi, vcosi))) - d4(0.0001));
+    }
+
+    auto a0inv = d4(1.0) / (d4(1.0) + alpha), a2 = d4(1.0) - alpha;
+    D4 b0, b1, b2;
+    switch (shape)
+    {
+    case LP:
+        b1 = d4(_mm_sub_ps(one, vcosi));
+        b0 = b2 = b1 * d4(0.5);
+        break;
+    case HP:
+        b1 = d4(_mm_add_ps(one, vcosi));
+        b0 = b2 = b1 * d4(0.5);
+        b1 = -b1;
+        break;
+    default:
+    {
+        auto Q = d4(0.5) / Q2inv;
+        b0 = Q * alpha;
+        b1 = d4(0.0);
+        b2 = -Q * alpha;
+        break;
+    }
+    }
+
+    float g alignas(16)[4];
+    for (int i = 0; i < 4; ++i)
+        g[i] = clipscale(freq[i], SubType);
+
+    if (SubType == st_Smooth)
+        toNormalizedLattice(a0inv, a1, a2, b0 * gain, b1 * gain, b2 * gain, d4(_mm_load_ps(g)), N);
+    else
+        toCoupledForm(a0inv, a1, a2, b0 * gain, b1 * gain, b2 * gain, d4(_mm_load_ps(g)), N);
+    return true;
+}
+
+void FilterCoefficientMaker::FromDirectQuad(FilterCoefficientMaker *cm[4],
+                                            const __m128 N[n_cm_coeffs], QuadFilterUnitState &Q)
+{
+    /*
+     * A maker run four wide starts each block where its last ramp ended (C == tC), so only tC is
+     * gathered, and the ramp (dC) is only kept in the lanes
+     */
+    auto isFirst = _mm_castsi128_ps(_mm_set_epi32(-(int)cm[3]->FirstRun, -(int)cm[2]->FirstRun,
+                                                  -(int)cm[1]->FirstRun, -(int)cm[0]->FirstRun));
+    const float *src[4] = {cm[0]->tC, cm[1]->tC, cm[2]->tC, cm[3]->tC};
+    float *dst[4] = {cm[0]->tC, cm[1]->tC, cm[2]->tC, cm[3]->tC};
+
+    __m128 tC[n_cm_coeffs];
+    gatherLanes(src, tC);
+
+    for (int i = 0; i < n_cm_coeffs; i++)
+    {
+        auto t = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.f - smooth), tC[i]),
+                            _mm_mul_ps(_mm_set1_ps(smooth), N[i]));
+        auto c = _mm_or_ps(_mm_and_ps(isFirst, N[i]), _mm_andnot_ps(isFirst, tC[i]));
+        tC[i] = _mm_or_ps(_mm_and_ps(isFirst, N[i]), _mm_andnot_ps(isFirst, t));
+
+        Q.C[i] = c;
+        Q.dC[i] = _mm_mul_ps(_mm_sub_ps(tC[i], c), _mm_set1_ps(BLOCK_SIZE_OS_INV));
+    }
+
+    scatterLanes(tC, dst);
+    for (int i = 0; i < 4; ++i)
+    {
+        memcpy(cm[i]->C, cm[i]->tC, sizeof(float) * n_cm_coeffs);
+        cm[i]->FirstRun = false;
+    }
+}
+
+void FilterCoefficientMaker::MakeCoeffsQuad(FilterCoefficientMaker *cm[4], const float Freq[4],
+                                            const float Reso[4], int Type, int SubType,
+                                            SurgeStorage *storage, bool tuningAdjusted,
+                                            QuadFilterUnitState &Q)
+{
+    FilterCoefficientMaker idle; // stands in for the idle lanes
+    FilterCoefficientMaker *m[4];
+    float freq[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        m[i] = cm[i] ? cm[i] : &idle;
+        m[i]->storage = storage;
+        freq[i] = retuneFreq(Freq[i], storage, tuningAdjusted);
+    }
+
+    __m128 N[n_cm_coeffs];
+    if (SolveQuad(m, freq, Reso, Type, SubType, storage, N))
+    {
+        FromDirectQuad(m, N, Q);
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        m[i]->MakeCoeffs(Freq[i], Reso[i], Type, SubType, storage, tuningAdjusted);
+    }
+
+    const float *C[4], *dC[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        C[i] = m[i]->C;
+        dC[i] = m[i]->dC;
+    }
+    gatherLanes(C, Q.C);
+    gatherLanes(dC, Q.dC);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        memcpy(m[i]->C, m[i]->tC, sizeof(float) * n_cm_coeffs);
+    }
+}
@@ -3,6 +3,8 @@
 
 const int n_cm_coeffs = 8;
 
+struct QuadFilterUnitState;
+
 class FilterCoefficientMaker
 {
   public:
@@ -13,6 +15,17 @@ class FilterCoefficientMaker
     float C[n_cm_coeffs], dC[n_cm_coeffs], tC[n_cm_coeffs]; // K1,K2,Q1,Q2,V1,V2,V3,etc
     void FromDirect(float N[n_cm_coeffs]);
 
+    /*
+     * MakeCoeffs for the four voices sharing a quad of the filter bank, with the coefficients and
+     * their per-sample steps set straight into the lanes of Q. The biquads (except the Band 12
+     * types) and the SVFs are solved four at a time, in double precision like the scalar
+     * makers, and the other types run each lane's MakeCoeffs. A nullptr maker is an idle lane.
+     * Each maker's next ramp starts from its target, which its lane reaches over the block.
+     */
+    static void MakeCoeffsQuad(FilterCoefficientMaker *cm[4], const float Freq[4],
+                               const float Reso[4], int Type, int SubType, SurgeStorage *storage,
+                               bool tuningAdjusted, QuadFilterUnitState &Q);
+
   private:
     void ToCoupledForm(double A0inv, double A1, double A2, double B0, double B1, double B2,
                        double G);
@@ -31,6 +44,11 @@ class FilterCoefficientMaker
     void Coeff_SNH(float Freq, float Reso, int SubType);
     void Coeff_SVF(float Freq, float Reso, bool);
 
+    static bool SolveQuad(FilterCoefficientMaker *cm[4], const float Freq[4], const float Reso[4],
+                          int Type, int SubType, SurgeStorage *storage, __m128 N[n_cm_coeffs]);
+    static void FromDirectQuad(FilterCoefficientMaker *cm[4], const __m128 N[n_cm_coeffs],
+                               QuadFilterUnitState &Q);
+
     bool FirstRun;
 
     SurgeStorage *storage;
@@ -37,8 +37,9 @@ struct LanczosResampler
     static constexpr double dx = 1.0 / (tableObs);
 
     // Fixme: Make this static and shared
-    static float lanczosTable alignas(16)[tableObs][filterWidth], lanczosTableDX
-        alignas(16)[tableObs][filterWidth];
+    // One row more than tableObs, since a read landing exactly on an input sample uses x0 = 1
+    static float lanczosTable alignas(16)[tableObs + 1][filterWidth], lanczosTableDX
+        alignas(16)[tableObs + 1][filterWidth];
     static bool tablesInitialized;
 
     // This is a stereo resampler
@@ -54,18 +55,13 @@ struct LanczosResampler
         return A * std::sin(M_PI * x) * std::sin(M_PI * x / A) / (M_PI * M_PI * x * x);
     }
 
-    LanczosResampler(float inputRate, float outputRate) : sri(inputRate), sro(outputRate)
+    LanczosResampler(float inputRate, float outputRate)
     {
-        phaseI = 0;
-        phaseO = 0;
-
-        dPhaseI = 1.0;
-        dPhaseO = sri / sro;
+        reset(inputRate, outputRate);
 
-        memset(input, 0, 2 * BUFFER_SZ * sizeof(float));
         if (!tablesInitialized)
         {
-            for (int t = 0; t < tableObs; ++t)
+            for (int t = 0; t <= tableObs; ++t)
             {
                 double x0 = dx * t;
                 for (int i = 0; i < filterWidth; ++i)
@@ -78,14 +74,31 @@ struct LanczosResampler
             {
                 for (int i = 0; i < filterWidth; ++i)
                 {
-                    lanczosTableDX[t][i] =
-                        lanczosTable[(t + 1) & (tableObs - 1)][i] - lanczosTable[t][i];
+                    lanczosTableDX[t][i] = lanczosTable[t + 1][i] - lanczosTable[t][i];
                 }
             }
+            for (int i = 0; i < filterWidth; ++i)
+                lanczosTableDX[tableObs][i] = 0;
             tablesInitialized = true;
         }
     }
 
+    // Forget the input and start again between these rates
+    void reset(float inputRate, float outputRate)
+    {
+        sri = inputRate;
+        sro = outputRate;
+
+        phaseI = 0;
+        phaseO = 0;
+
+        dPhaseI = 1.0;
+        dPhaseO = sri / sro;
+
+        wp = 0;
+        memset(input, 0, sizeof(input));
+    }
+
     inline void push(float fL, float fR)
     {
         input[0][wp] = fL;
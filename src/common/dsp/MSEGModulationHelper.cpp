@@ -14,6 +14,7 @@
 */
 
 #include "MSEGModulationHelper.h"
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include "DebugHelpers.h"
@@ -27,6 +28,10 @@ namespace MSEG
 
 void rebuildCache(MSEGStorage *ms)
 {
+    // Versions are unique across storages so a copied MSEG never aliases another's version
+    static std::atomic<unsigned int> versionCounter{0};
+    ms->version = ++versionCounter;
+
     if (ms->loop_start > ms->n_activeSegments - 1)
         ms->loop_start = -1;
     if (ms->loop_end > ms->n_activeSegments - 1)
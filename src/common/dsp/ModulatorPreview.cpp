@@ -0,0 +1,257 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#include "ModulatorPreview.h"
+#include "LfoModulationSource.h"
+#include "MSEGModulationHelper.h"
+
+#include <cmath>
+
+namespace Surge
+{
+namespace ModulatorPreview
+{
+static void hashParameter(size_t &seed, const Parameter &p, const std::vector<pdata> &localcopy)
+{
+    hashCombine(seed, p.val.i);
+    if (p.param_id_in_scene >= 0 && p.param_id_in_scene < (int)localcopy.size())
+        hashCombine(seed, localcopy[p.param_id_in_scene].i);
+    hashCombine(seed, p.temposync);
+    hashCombine(seed, p.deactivated);
+    hashCombine(seed, p.extend_range);
+    hashCombine(seed, p.absolute);
+    hashCombine(seed, p.deform_type);
+}
+
+LFOCurve renderLFOCurve(SurgeStorage *storage, const LFOCurveSpec &spec)
+{
+    // The sources hold on to these, so work from our own copies
+    LFOStorage lfo = spec.lfo, wavelfo = spec.lfo;
+    StepSequencerStorage ss = spec.ss;
+    MSEGStorage ms = spec.ms;
+    FormulaModulatorStorage fs;
+    std::vector<pdata> tp = spec.localcopy, tpw = spec.localcopy;
+    tp.resize(n_scene_params);
+    tpw.resize(n_scene_params);
+
+    LFOCurve res;
+
+    LfoModulationSource tlfo, tFullWave;
+    tlfo.assign(storage, &lfo, tp.data(), 0, &ss, &ms, &fs, true);
+    tlfo.attack();
+
+    res.hasFullWave = spec.fullWave != LFOCurveSpec::NO_FULL_WAVE;
+    if (spec.fullWave == LFOCurveSpec::DEACTIVATED_RATE)
+    {
+        auto desiredRate = log2(1.f / spec.totalEnvTime);
+        if (lfo.shape.val.i == lt_mseg)
+        {
+            desiredRate = log2(ms.totalDuration / spec.totalEnvTime);
+        }
+
+        wavelfo.rate.deactivated = false;
+        wavelfo.rate.val.f = desiredRate;
+        wavelfo.start_phase.val.f = 0;
+        tpw[lfo.start_phase.param_id_in_scene].f = 0;
+        tpw[lfo.rate.param_id_in_scene].f = desiredRate;
+    }
+    else if (spec.fullWave == LFOCurveSpec::FULL_MAGNITUDE)
+    {
+        wavelfo.magnitude.val.f = 1.f;
+        tpw[lfo.magnitude.param_id_in_scene].f = 1.f;
+    }
+
+    if (res.hasFullWave)
+    {
+        tFullWave.assign(storage, &wavelfo, tpw.data(), 0, &ss, &ms, &fs, true);
+        tFullWave.attack();
+    }
+
+    int averagingWindow = std::max(spec.averagingWindow, 1);
+    res.totalSamples = spec.totalSamples;
+    res.averagingWindow = averagingWindow;
+    int points = (spec.totalSamples + averagingWindow - 1) / averagingWindow;
+    res.mean.reserve(points);
+    res.min.reserve(points);
+    res.max.reserve(points);
+    res.env.reserve(points);
+    if (res.hasFullWave)
+    {
+        res.waveMean.reserve(points);
+        res.waveMin.reserve(points);
+        res.waveMax.reserve(points);
+    }
+
+    float envScale = lfo.magnitude.get_extended(lfo.magnitude.val.f);
+    int susCountdown = -1;
+
+    for (int i = 0; i < spec.totalSamples; i += averagingWindow)
+    {
+        float val = 0, wval = 0, eval = 0;
+        float minval = 1000000, minwval = 1000000;
+        float maxval = -1000000, maxwval = -1000000;
+
+        for (int s = 0; s < averagingWindow; s++)
+        {
+            tlfo.process_block();
+            if (res.hasFullWave)
+                tFullWave.process_block();
+            if (susCountdown < 0 && tlfo.env_state == lenv_stuck)
+            {
+                susCountdown = spec.susTime * samplerate / BLOCK_SIZE;
+            }
+            else if (susCountdown == 0 && tlfo.env_state == lenv_stuck)
+            {
+                tlfo.release();
+                if (res.hasFullWave)
+                    tFullWave.release();
+            }
+            else if (susCountdown > 0)
+            {
+                susCountdown--;
+            }
+
+            val += tlfo.output;
+            minval = std::min(tlfo.output, minval);
+            maxval = std::max(tlfo.output, maxval);
+            eval += tlfo.env_val * envScale;
+
+            if (res.hasFullWave)
+            {
+                auto v = tFullWave.output;
+                wval += v;
+                minwval = std::min(v, minwval);
+                maxwval = std::max(v, maxwval);
+            }
+        }
+
+        res.mean.push_back(val / averagingWindow);
+        res.min.push_back(minval);
+        res.max.push_back(maxval);
+        res.env.push_back(eval / averagingWindow);
+
+        if (res.hasFullWave)
+        {
+            res.waveMean.push_back(wval / averagingWindow);
+            res.waveMin.push_back(minwval);
+            res.waveMax.push_back(maxwval);
+        }
+    }
+
+    return res;
+}
+
+size_t lfoCurveKey(SurgeStorage *storage, const LFOCurveSpec &spec)
+{
+    size_t seed = 0;
+    hashCombine(seed, spec.totalSamples);
+    hashCombine(seed, spec.averagingWindow);
+    hashCombine(seed, spec.susTime);
+    hashCombine(seed, (int)spec.fullWave);
+    hashCombine(seed, spec.totalEnvTime);
+    hashCombine(seed, samplerate);
+    hashCombine(seed, storage->temposyncratio);
+
+    auto &lfo = spec.lfo;
+    for (auto *p = &lfo.rate; p <= &lfo.release; ++p)
+        hashParameter(seed, *p, spec.localcopy);
+
+    if (lfo.shape.val.i == lt_stepseq)
+    {
+        for (int i = 0; i < n_stepseqsteps; ++i)
+            hashCombine(seed, spec.ss.steps[i]);
+        hashCombine(seed, spec.ss.loop_start);
+        hashCombine(seed, spec.ss.loop_end);
+        hashCombine(seed, spec.ss.shuffle);
+        hashCombine(seed, spec.ss.trigmask);
+    }
+
+    if (lfo.shape.val.i == lt_mseg)
+    {
+        // every segment edit goes through rebuildCache which bumps the version
+        hashCombine(seed, spec.ms.version);
+        hashCombine(seed, (int)spec.ms.loopMode);
+        hashCombine(seed, (int)spec.ms.editMode);
+        hashCombine(seed, (int)spec.ms.endpointMode);
+        hashCombine(seed, spec.ms.loop_start);
+        hashCombine(seed, spec.ms.loop_end);
+    }
+
+    return seed;
+}
+
+void LFOCurveCache::request(size_t key, const void *owner, const LFOCurveSpec &spec)
+{
+    auto storage = this->storage;
+    auto copy = std::make_shared<LFOCurveSpec>(spec);
+    BackgroundRenderCache::request(key, owner,
+                                   [storage, copy]() { return renderLFOCurve(storage, *copy); });
+}
+
+static size_t hashTimes(const std::vector<float> &times)
+{
+    size_t seed = times.size();
+    for (auto t : times)
+        hashCombine(seed, t);
+    return seed;
+}
+
+bool MSEGCurve::matches(const MSEGStorage *ms, float deform,
+                        const std::vector<float> &times) const
+{
+    return ms->version == version && deform == this->deform && hashTimes(times) == timesHash;
+}
+
+MSEGCurve renderMSEGCurve(MSEGStorage *ms, float deform, const std::vector<float> &times)
+{
+    MSEGCurve res;
+    res.version = ms->version;
+    res.deform = deform;
+    res.timesHash = hashTimes(times);
+
+    res.value.reserve(times.size());
+    res.deformed.reserve(times.size());
+    res.segment.reserve(times.size());
+
+    Surge::MSEG::EvaluatorState es, esdf;
+    es.seed(8675309); // This is different from the number in LFOMS::assign in draw mode on purpose
+    esdf.seed(8675309);
+
+    for (auto up : times)
+    {
+        float iup = (int)up;
+        float fup = up - iup;
+        float v = Surge::MSEG::valueAt(iup, fup, 0, ms, &es, true);
+        float vdef = Surge::MSEG::valueAt(iup, fup, deform, ms, &esdf, true);
+
+        // Brownian doesn't deform and the second display is confusing since it is
+        // independently random
+        if (es.lastEval >= 0 && es.lastEval <= ms->n_activeSegments - 1 &&
+            ms->segments[es.lastEval].type == MSEGStorage::segment::Type::BROWNIAN)
+            vdef = v;
+
+        res.value.push_back(v);
+        res.deformed.push_back(vdef);
+        res.segment.push_back(es.lastEval);
+
+        // this slightly odd construct means we always draw beyond the last point
+        if (up > ms->totalDuration)
+            break;
+    }
+
+    return res;
+}
+} // namespace ModulatorPreview
+} // namespace Surge
@@ -0,0 +1,98 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#pragma once
+
+#include "SurgeStorage.h"
+#include "util/BackgroundRenderCache.h"
+
+namespace Surge
+{
+namespace ModulatorPreview
+{
+/*
+ * What the LFO display draws. The spec holds copies of the LFO, step sequencer and MSEG
+ * storage so it can be rendered on the worker while the UI keeps editing the originals.
+ */
+struct LFOCurveSpec
+{
+    LFOStorage lfo;
+    StepSequencerStorage ss;
+    MSEGStorage ms;
+    std::vector<pdata> localcopy; // n_scene_params entries
+
+    int totalSamples = 0;    // in blocks
+    int averagingWindow = 1; // blocks per point
+    float susTime = 0.5;     // seconds the gate is held once the envelope reaches sustain
+
+    /*
+     * The ghosted reference wave. DEACTIVATED_RATE shows one cycle over totalEnvTime when the
+     * rate is deactivated and FULL_MAGNITUDE shows the wave at full amplitude
+     */
+    enum FullWave
+    {
+        NO_FULL_WAVE,
+        DEACTIVATED_RATE,
+        FULL_MAGNITUDE
+    } fullWave = NO_FULL_WAVE;
+    float totalEnvTime = 1;
+};
+
+// One entry per point, in LFO output units
+struct LFOCurve
+{
+    int totalSamples = 0, averagingWindow = 1;
+    std::vector<float> mean, min, max, env;
+    bool hasFullWave = false;
+    std::vector<float> waveMean, waveMin, waveMax;
+};
+
+LFOCurve renderLFOCurve(SurgeStorage *storage, const LFOCurveSpec &spec);
+size_t lfoCurveKey(SurgeStorage *storage, const LFOCurveSpec &spec);
+
+// LFO display curves, rendered on a worker thread; see BackgroundRenderCache
+class LFOCurveCache : public BackgroundRenderCache<LFOCurve>
+{
+  public:
+    LFOCurveCache(SurgeStorage *storage) : storage(storage) {}
+
+    // owner is the LFOStorage being drawn, spec is copied
+    void request(size_t key, const void *owner, const LFOCurveSpec &spec);
+
+  private:
+    SurgeStorage *storage;
+};
+
+/*
+ * The MSEG editor curve, evaluated at each of times with and without deform the way the
+ * editor draws it. Evaluation stops one point past the end of the MSEG, so the curve can be
+ * shorter than times. segment is the segment each point fell in.
+ */
+struct MSEGCurve
+{
+    unsigned int version = 0;
+    float deform = 0;
+    size_t timesHash = 0;
+
+    std::vector<float> value, deformed;
+    std::vector<int> segment;
+
+    // true if this was rendered from the MSEG, deform and times given
+    bool matches(const MSEGStorage *ms, float deform, const std::vector<float> &times) const;
+};
+
+MSEGCurve renderMSEGCurve(MSEGStorage *ms, float deform, const std::vector<float> &times);
+} // namespace ModulatorPreview
+} // namespace Surge
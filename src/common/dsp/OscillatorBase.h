@@ -38,6 +38,22 @@ class alignas(16) Oscillator
                                float FMdepth = 0.f)
     {
     }
+
+    /*
+     * Render the same oscillator slot for n voices at once. It is called on voices[0] and
+     * every entry of voices is an oscillator of the same type, so overrides can interleave
+     * voice state and fill their SIMD lanes with voices rather than unison. stereo and FM
+     * are per scene; pitch, drift and FMdepth are per voice. The default renders each voice
+     * in turn.
+     */
+    virtual void process_block_batch(Oscillator **voices, int n, const float *pitch,
+                                     const float *drift, bool stereo, bool FM,
+                                     const float *FMdepth)
+    {
+        for (int i = 0; i < n; ++i)
+            voices[i]->process_block(pitch[i], drift[i], stereo, FM, FMdepth[i]);
+    }
+
     virtual void assign_fm(float *master_osc) { this->master_osc = master_osc; }
     virtual bool allow_display() { return true; }
     inline double pitch_to_omega(float x)
@@ -18,6 +18,7 @@
 
 #include "DspUtilities.h"
 #include "SurgeStorage.h"
+#include "FastMath.h"
 
 namespace Surge
 {
@@ -208,6 +209,45 @@ template <typename valtype> struct UnisonSetup
     double sqrt_uni, sqrt_uni_inv;
 };
 
+/*
+ * The operator sine for the FM oscillators. The block version evaluates four samples per
+ * SSE pass and is used when no operator feedback makes the samples depend on each other;
+ * the scalar version runs the same kernel in one lane so switching between the two paths
+ * does not introduce a discontinuity.
+ */
+template <SurgeStorage::FMSinePrecision P> inline __m128 fmOperatorSineSSE(__m128 x)
+{
+    switch (P)
+    {
+    case SurgeStorage::FM_SINE_LIBM:
+    {
+        float v alignas(16)[4];
+        _mm_store_ps(v, x);
+        for (int i = 0; i < 4; ++i)
+            v[i] = sin(v[i]);
+        return _mm_load_ps(v);
+    }
+    case SurgeStorage::FM_SINE_FAST:
+        return Surge::DSP::fastsinSSE(Surge::DSP::clampToPiRangeSSE(x));
+    case SurgeStorage::FM_SINE_ACCURATE:
+    default:
+        return Surge::DSP::sinFullRangeSSE(x);
+    }
+}
+
+template <SurgeStorage::FMSinePrecision P> inline float fmOperatorSine(float x)
+{
+    if (P == SurgeStorage::FM_SINE_LIBM)
+        return sin(x);
+    return _mm_cvtss_f32(fmOperatorSineSSE<P>(_mm_set_ss(x)));
+}
+
+template <SurgeStorage::FMSinePrecision P> inline void fmOperatorSineBlock(float *__restrict x)
+{
+    for (int k = 0; k < BLOCK_SIZE_OS; k += 4)
+        _mm_store_ps(x + k, fmOperatorSineSSE<P>(_mm_load_ps(x + k)));
+}
+
 } // namespace Oscillator
 } // namespace Surge
 
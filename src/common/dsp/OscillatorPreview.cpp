@@ -0,0 +1,156 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#include "OscillatorPreview.h"
+#include "Oscillator.h"
+
+#include <cstring>
+
+namespace Surge
+{
+namespace Oscillator
+{
+std::vector<float> renderPreview(SurgeStorage *storage, OscillatorStorage *oscdata, int type,
+                                 pdata *localcopy, float pitch, int totalSamples,
+                                 int averagingWindow)
+{
+    std::vector<float> res;
+
+    std::unique_ptr<::Oscillator> osc(spawn_osc(type, storage, oscdata, localcopy));
+    if (!osc || !osc->allow_display())
+        return res;
+
+    // Mis-install check #2
+    bool wt = uses_wavetabledata(type);
+    if (wt && storage->wt_list.size() == 0)
+        return res;
+
+    // the wavetable oscillators read the table in init too
+    if (wt)
+    {
+        std::lock_guard<std::mutex> g(storage->waveTableDataMutex);
+        osc->init(pitch, true, true);
+    }
+    else
+    {
+        osc->init(pitch, true, true);
+    }
+
+    res.reserve(totalSamples / averagingWindow);
+
+    // the display has always skipped a sample after each window, so keep that
+    int block_pos = BLOCK_SIZE_OS;
+    for (int i = 0; i < totalSamples; i += averagingWindow)
+    {
+        if (block_pos >= BLOCK_SIZE_OS)
+        {
+            if (wt)
+            {
+                std::lock_guard<std::mutex> g(storage->waveTableDataMutex);
+                osc->process_block(pitch);
+            }
+            else
+            {
+                osc->process_block(pitch);
+            }
+            block_pos = 0;
+        }
+
+        float val = 0.f;
+        for (int j = 0; j < averagingWindow; ++j)
+        {
+            val += osc->output[block_pos];
+            block_pos++;
+        }
+        res.push_back(val / averagingWindow);
+        block_pos++;
+    }
+
+    return res;
+}
+
+size_t previewKey(SurgeStorage *storage, OscillatorStorage *oscdata, int type,
+                  const pdata *localcopy, float pitch, int totalSamples, int averagingWindow)
+{
+    size_t seed = 0;
+    hashCombine(seed, type);
+    hashCombine(seed, pitch);
+    hashCombine(seed, totalSamples);
+    hashCombine(seed, averagingWindow);
+    hashCombine(seed, samplerate);
+
+    for (int i = 0; i < n_osc_params; i++)
+    {
+        auto &p = oscdata->p[i];
+        hashCombine(seed, localcopy[p.param_id_in_scene].i);
+        hashCombine(seed, p.extend_range);
+        hashCombine(seed, p.absolute);
+        hashCombine(seed, p.deform_type);
+    }
+    hashCombine(seed, oscdata->retrigger.val.i);
+    hashCombine(seed, storage->getPatch().character.val.i);
+
+    hashCombine(seed, oscdata->wt.generation);
+
+    for (int i = 0; i < oscdata->extraConfig.nData; i++)
+        hashCombine(seed, oscdata->extraConfig.data[i]);
+
+    if (!storage->isStandardTuning)
+    {
+        hashCombine(seed, storage->currentScale.rawText);
+        hashCombine(seed, storage->currentMapping.rawText);
+    }
+
+    return seed;
+}
+
+// Everything renderPreview reads from oscdata, so the worker never touches the patch
+static std::shared_ptr<OscillatorStorage> copyForPreview(SurgeStorage *storage,
+                                                         OscillatorStorage *oscdata, int type)
+{
+    auto copy = std::make_shared<OscillatorStorage>();
+    copy->type = oscdata->type;
+    copy->pitch = oscdata->pitch;
+    copy->octave = oscdata->octave;
+    for (int i = 0; i < n_osc_params; i++)
+        copy->p[i] = oscdata->p[i];
+    copy->keytrack = oscdata->keytrack;
+    copy->retrigger = oscdata->retrigger;
+    copy->extraConfig = oscdata->extraConfig;
+    copy->queue_xmldata = nullptr;
+    copy->queue_type = -1;
+
+    if (uses_wavetabledata(type))
+    {
+        std::lock_guard<std::mutex> g(storage->waveTableDataMutex);
+        copy->wt.Copy(&oscdata->wt);
+    }
+    return copy;
+}
+
+void PreviewCache::request(size_t key, OscillatorStorage *oscdata, int type,
+                           const pdata *localcopy, float pitch, int totalSamples,
+                           int averagingWindow)
+{
+    std::vector<pdata> params(localcopy, localcopy + n_scene_params);
+    auto copy = copyForPreview(storage, oscdata, type);
+    auto storage = this->storage;
+    BackgroundRenderCache::request(key, oscdata, [=]() mutable {
+        return renderPreview(storage, copy.get(), type, params.data(), pitch, totalSamples,
+                             averagingWindow);
+    });
+}
+} // namespace Oscillator
+} // namespace Surge
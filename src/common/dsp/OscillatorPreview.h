@@ -0,0 +1,55 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#pragma once
+
+#include "SurgeStorage.h"
+#include "util/BackgroundRenderCache.h"
+
+namespace Surge
+{
+namespace Oscillator
+{
+/*
+ * The oscillator display trace. The oscillator is rendered at the display pitch and each of the
+ * totalSamples / averagingWindow points is the mean of averagingWindow output samples. The trace
+ * is empty if the oscillator doesn't allow display. There are no GUI dependencies here, so this
+ * runs on the preview worker as well as in headless tests and benchmarks.
+ */
+std::vector<float> renderPreview(SurgeStorage *storage, OscillatorStorage *oscdata, int type,
+                                 pdata *localcopy, float pitch, int totalSamples,
+                                 int averagingWindow);
+
+// Hash of everything renderPreview reads, used as the preview cache key
+size_t previewKey(SurgeStorage *storage, OscillatorStorage *oscdata, int type,
+                  const pdata *localcopy, float pitch, int totalSamples, int averagingWindow);
+
+// Oscillator display traces, rendered on a worker thread; see BackgroundRenderCache
+class PreviewCache : public BackgroundRenderCache<std::vector<float>>
+{
+  public:
+    typedef result_t trace_t;
+
+    PreviewCache(SurgeStorage *storage) : storage(storage) {}
+
+    // oscdata names the owner; it and localcopy are copied, its wavetable included
+    void request(size_t key, OscillatorStorage *oscdata, int type, const pdata *localcopy,
+                 float pitch, int totalSamples, int averagingWindow);
+
+  private:
+    SurgeStorage *storage;
+};
+} // namespace Oscillator
+} // namespace Surge
@@ -0,0 +1,170 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <vt_dsp/basic_dsp.h>
+#include <vt_dsp/halfratefilter.h>
+
+/*
+** Oversampling for the nonlinear effects. Each factor of two is a HalfRateFilter, which runs
+** the allpass chains of both channels in the lanes of SSE registers, so the up and down
+** sampling is a cascade of those.
+**
+** @param: MaxOSFactor  the largest oversampling the instance offers, as a power of two. The
+**                      ratio in use is 2^getOSFactor(), from 1x up to 2^MaxOSFactor
+** @param: block_size   size of the blocks of audio before upsampling
+** @param: FilterOrd    sets the order of the anti-imaging/anti-aliasing filters
+** @param: steep        sets whether to use the filters in "steep" mode (see
+**                      vt_dsp/halfratefilter.h)
+** @param: steepBase    the same for the stage to and from the base rate
+**
+** Each upsampling stage stuffs zeros without making up for them, so the upsampled audio is
+** 2^-factor of the input. The effects were voiced with that at their default factor, and pass
+** upsample a gain to keep the same level at the others (see upGain).
+**
+** The filters for MaxOSFactor are all built in the constructor, so setOSFactor doesn't
+** allocate and can be called from process. The class should be used as follows:
+** @code
+** Oversampling<3, BLOCK_SIZE> os;
+** void process(float* dataL, float* dataR)
+** {
+**     os.setOSFactor(2); // 4x
+**     os.upsample(dataL, dataR);
+**     process_samples(os.leftUp, os.rightUp, os.getUpBlockSize());
+**     os.downsample(dataL, dataR);
+** }
+** @endcode
+*/
+template <int MaxOSFactor, int block_size, int FilterOrd = 3, bool steep = false,
+          bool steepBase = steep>
+class Oversampling
+{
+    std::unique_ptr<HalfRateFilter> hr_filts_up alignas(16)[MaxOSFactor];
+    std::unique_ptr<HalfRateFilter> hr_filts_down alignas(16)[MaxOSFactor];
+
+    static constexpr int max_up_block_size = block_size << MaxOSFactor;
+    static constexpr int block_size_quad = block_size / 4;
+
+    int osFactor = MaxOSFactor;
+
+    // the input of the upsampling stages which are longer than hr_BLOCK_SIZE
+    float leftStage alignas(16)[max_up_block_size / 2];
+    float rightStage alignas(16)[max_up_block_size / 2];
+
+  public:
+    static constexpr int maxOSFactor = MaxOSFactor;
+
+    Oversampling()
+    {
+        for (int i = 0; i < MaxOSFactor; ++i)
+        {
+            bool st = (i == 0) ? steepBase : steep;
+            hr_filts_up[i] = std::make_unique<HalfRateFilter>(FilterOrd, st);
+            hr_filts_down[i] = std::make_unique<HalfRateFilter>(FilterOrd, st);
+        }
+    }
+
+    /** Resets the processing pipeline */
+    void reset()
+    {
+        for (int i = 0; i < MaxOSFactor; ++i)
+        {
+            hr_filts_up[i]->reset();
+            hr_filts_down[i]->reset();
+        }
+
+        std::fill(leftUp, &leftUp[max_up_block_size], 0.0f);
+        std::fill(rightUp, &rightUp[max_up_block_size], 0.0f);
+    }
+
+    /** Sets the oversampling ratio to 2^factor, clamped to what the instance offers. A change
+     * resets the filters, as the stages which were idle hold stale state */
+    void setOSFactor(int factor)
+    {
+        factor = std::max(0, std::min(factor, MaxOSFactor));
+        if (factor != osFactor)
+        {
+            osFactor = factor;
+            reset();
+        }
+    }
+
+    inline int getOSFactor() const noexcept { return osFactor; }
+
+    /** Upsamples the audio in the input arrays, times gain, and stores the upsampled audio
+     * internally */
+    inline void upsample(float *leftIn, float *rightIn, float gain = 1.f) noexcept
+    {
+        if (gain == 1.f)
+        {
+            copy_block(leftIn, leftUp, block_size_quad);
+            copy_block(rightIn, rightUp, block_size_quad);
+        }
+        else
+        {
+            mul_block(leftIn, gain, leftUp, block_size_quad);
+            mul_block(rightIn, gain, rightUp, block_size_quad);
+        }
+
+        // stage i goes from 2^i to 2^(i+1) times the base rate
+        for (int i = 0; i < osFactor; ++i)
+        {
+            auto numSamples = block_size * (1 << (i + 1));
+            if (numSamples > (int)hr_BLOCK_SIZE)
+            {
+                // too long for the filter to upsample in place
+                copy_block(leftUp, leftStage, numSamples >> 3);
+                copy_block(rightUp, rightStage, numSamples >> 3);
+                hr_filts_up[i]->process_block_U2(leftStage, rightStage, leftUp, rightUp,
+                                                 numSamples);
+            }
+            else
+            {
+                hr_filts_up[i]->process_block_U2(leftUp, rightUp, leftUp, rightUp, numSamples);
+            }
+        }
+    }
+
+    /** Downsamples that audio in the internal buffers, and stores the downsampled audio in the
+     * input arrays */
+    inline void downsample(float *leftOut, float *rightOut) noexcept
+    {
+        for (int i = osFactor; i > 0; --i)
+        {
+            auto numSamples = block_size * (1 << i);
+            hr_filts_down[i - 1]->process_block_D2(leftUp, rightUp, numSamples);
+        }
+
+        copy_block(leftUp, leftOut, block_size_quad);
+        copy_block(rightUp, rightOut, block_size_quad);
+    }
+
+    /** Returns the size of the upsampled blocks */
+    inline int getUpBlockSize() const noexcept { return block_size << osFactor; }
+
+    /** Returns the oversampling ratio */
+    inline int getOSRatio() const noexcept { return 1 << osFactor; }
+
+    /** The upsample gain which gives the level the upsampled audio has at voicedFactor */
+    inline float upGain(int voicedFactor) const noexcept
+    {
+        return (float)(1 << osFactor) / (float)(1 << voicedFactor);
+    }
+
+    float leftUp alignas(16)[max_up_block_size];
+    float rightUp alignas(16)[max_up_block_size];
+};
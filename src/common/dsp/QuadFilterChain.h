@@ -53,16 +53,17 @@
  * function of uniform signature (QuadFilterUnitState, _m128) for filter and _m128 for waveshaper.
  *
  * Moreover, you need to load up the voices into the filters before you process the filters. This
- * is done in SurgeVoice. SurgeVoice::process_block takes two arguments. A QuadFilterUnitChainState
- * and a Qe. Importantly, SurgeVoice does *not* take a float in and out. Rather it has as a job
- * to update the Qe'th SSE position in the QuadFilterUnitChainState handed to it. You can see
- * that SurgeSynth processes the voice in scene 's' as:
+ * is done in SurgeVoice. Each voice is bound to one lane of its scene's filter bank for as long as
+ * it plays: the synth gives it the next free lane (FBQlanes) before its first block, with
  *
- * bool resume = v->process_block(FBQ[s][FBentry[s] >> 2], FBentry[s] & 3);
+ * v->bindLane(&FBQ[s][e >> 2], e & 3);
  *
- * that is for a given voice number (which is basically FBentry) modulo it by 3 and update that
- * point in the filter bank. And that FBQ is created with the _aligned_malloc all the way at the
- * outset of SurgeSynth.
+ * and SurgeVoice::process_block then updates the e&3'th SSE position in that
+ * QuadFilterUnitChainState. Importantly, SurgeVoice does *not* take a float in and out. The
+ * filter registers stay in the lane from block to block, so only the input, coefficients and
+ * gains are written each block. When a voice ends the voice in the last lane is moved into its
+ * place, so the lanes in use stay contiguous. And that FBQ is created with the _aligned_malloc
+ * all the way at the outset of SurgeSynth.
  *
  * So cool. We now know how we go from synth to filter. The synth creates QaudFilterChainStates. It
  * then assigns a particular voice to update the input data of that chain state in a block. That
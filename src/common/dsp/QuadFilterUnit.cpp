@@ -3,6 +3,7 @@
 #include <vt_dsp/basic_dsp.h>
 #include <iostream>
 #include "DebugHelpers.h"
+#include "FastMath.h"
 
 #include "filters/VintageLadders.h"
 #include "filters/Obxd.h"
@@ -713,6 +714,43 @@ __m128 ASYM_SSE2(__m128 in, __m128 drive)
     return x;
 }
 
+/*
+ * The asym and sine shapes computed in the lanes, rather than interpolated from the waveshapers
+ * table with a load per lane. They match the tables' shapes, including where those clamp, but
+ * without the interpolation error (3e-4 for asym and 1.4e-5 for sine, against 5e-7 and 2e-7
+ * here), so patches from before streaming revision 17 keep the tables for a bit exact sound
+ * (see SurgePatch::tableLookupWaveshapers).
+ */
+__m128 ASYM_EXP(__m128 in, __m128 drive)
+{
+    // shafted_tanh(u) = (e^u - e^-1.2u) / (e^u + e^-u) = (1 - e^-2.2u) / (1 + e^-2u) at
+    // u = x + 1/2, less its value at x = 0. Both powers come from w = e^-0.2u
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 lim = _mm_set1_ps(16.f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 offset = _mm_set1_ps((float)((1.0 - exp(-1.1)) / (1.0 + exp(-1.0))));
+
+    __m128 x = _mm_mul_ps(in, drive);
+    x = _mm_max_ps(_mm_min_ps(x, lim), _mm_sub_ps(_mm_setzero_ps(), lim));
+    __m128 w = Surge::DSP::expFullRangeSSE(_mm_mul_ps(_mm_add_ps(x, half), _mm_set1_ps(-0.2f)));
+    __m128 w2 = _mm_mul_ps(w, w);
+    __m128 w4 = _mm_mul_ps(w2, w2);
+    __m128 e2 = _mm_mul_ps(_mm_mul_ps(w4, w4), w2);
+    __m128 e22 = _mm_mul_ps(e2, w);
+
+    return _mm_sub_ps(_mm_div_ps(_mm_sub_ps(one, e22), _mm_add_ps(one, e2)), offset);
+}
+
+__m128 SINUS_POLY(__m128 in, __m128 drive)
+{
+    // sin(PI/2 x), which the table holds for |x| < 2 and is 0 past that
+    const __m128 lim = _mm_set1_ps(2.f);
+
+    __m128 x = _mm_mul_ps(in, drive);
+    x = _mm_max_ps(_mm_min_ps(x, lim), _mm_sub_ps(_mm_setzero_ps(), lim));
+    return Surge::DSP::sinFullRangeSSE(_mm_mul_ps(x, _mm_set1_ps(M_PI * 0.5)));
+}
+
 FilterUnitQFPtr GetQFPtrFilterUnit(int type, int subtype)
 {
     // Force compiler to error out if I miss one
@@ -858,7 +896,7 @@ FilterUnitQFPtr GetQFPtrFilterUnit(int type, int subtype)
     return 0;
 }
 
-WaveshaperQFPtr GetQFPtrWaveshaper(int type)
+WaveshaperQFPtr GetQFPtrWaveshaper(int type, bool tableLookup)
 {
     switch (type)
     {
@@ -867,9 +905,9 @@ WaveshaperQFPtr GetQFPtrWaveshaper(int type)
     case wst_hard:
         return CLIP;
     case wst_asym:
-        return ASYM_SSE2;
+        return tableLookup ? ASYM_SSE2 : ASYM_EXP;
     case wst_sine:
-        return SINUS_SSE2;
+        return tableLookup ? SINUS_SSE2 : SINUS_POLY;
     case wst_digital:
         return DIGI_SSE2;
     }
@@ -17,7 +17,8 @@ typedef __m128 (*FilterUnitQFPtr)(QuadFilterUnitState *__restrict, __m128 in);
 typedef __m128 (*WaveshaperQFPtr)(__m128 in, __m128 drive);
 
 FilterUnitQFPtr GetQFPtrFilterUnit(int type, int subtype);
-WaveshaperQFPtr GetQFPtrWaveshaper(int type);
+// tableLookup picks the shapers which interpolate the waveshapers table, for older patches
+WaveshaperQFPtr GetQFPtrWaveshaper(int type, bool tableLookup);
 
 /*
  * Subtypes are integers below 16 - maybe one day go as high as 32. So we have space in the
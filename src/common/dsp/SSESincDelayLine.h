@@ -16,6 +16,10 @@
 /*
  * This is a template class which encapsulates the SSE based SINC
  * interpolation in COMBquad_SSE2,just made available for other uses
+ *
+ * It is also the modulated delay line of the chorus, flanger, ensemble and rotary speaker,
+ * which read several taps a sample. readTaps reads up to four of them, from one line or several,
+ * into the lanes of one register, with the interpolation chosen by the caller.
  */
 
 #ifndef SURGE_SSESINCDELAYLINE_H
@@ -81,6 +85,95 @@ struct SSESincDelayLine
     }
 
     inline void clear() { memset((void *)buffer, 0, (COMB_SIZE + FIRipol_N) * sizeof(float)); }
+
+    enum Interpolation
+    {
+        LINEAR,   // as readLinear
+        LAGRANGE, // third order, through the two samples either side
+        SINC,     // as read, with sinctable
+        SINC_1X,  // as read, but with sinctable1X, which the chorus and delay use
+    };
+
+    /*
+     * Tap t reads lines[t] at delays[t] into lane t of the result, and lanes from taps on are
+     * zero. Delays count back from the next write, as in read; LAGRANGE wants them at least 2.
+     */
+    template <Interpolation I, int taps = 4>
+    static inline __m128 readTaps(const SSESincDelayLine *const *lines, const float *delays)
+    {
+        static_assert(taps >= 1 && taps <= 4, "readTaps reads one to four taps");
+
+        float dl alignas(16)[4] = {0.f, 0.f, 0.f, 0.f};
+        for (int t = 0; t < taps; ++t)
+            dl[t] = delays[t];
+        __m128 d = _mm_load_ps(dl);
+        __m128i id = _mm_cvttps_epi32(d);
+        __m128 frac = _mm_sub_ps(d, _mm_cvtepi32_ps(id));
+        const __m128 one = _mm_set1_ps(1.f);
+
+        int iD alignas(16)[4];
+        _mm_store_si128((__m128i *)iD, id);
+
+        // Each tap's samples or partial sums go in a register, which a transpose turns into a
+        // register per sample or partial sum, with the taps in its lanes
+        __m128 r[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+
+        if (I == LINEAR || I == LAGRANGE)
+        {
+            // readLinear's two samples are at base + 1 and base + 2
+            for (int t = 0; t < taps; ++t)
+            {
+                int base = (lines[t]->wp - iD[t] - 2) & (COMB_SIZE - 1);
+                r[t] = _mm_loadu_ps(&lines[t]->buffer[base]);
+            }
+            _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+
+            if (I == LINEAR)
+                return _mm_add_ps(_mm_mul_ps(r[1], frac), _mm_mul_ps(r[2], _mm_sub_ps(one, frac)));
+
+            // x is the point from base + 1 towards base + 2
+            __m128 x = _mm_sub_ps(one, frac);
+            __m128 xp1 = _mm_add_ps(x, one), xm1 = _mm_sub_ps(x, one);
+            __m128 xm2 = _mm_sub_ps(xm1, one);
+            const __m128 sixth = _mm_set1_ps(1.f / 6.f), half = _mm_set1_ps(0.5f);
+
+            __m128 w0 = _mm_mul_ps(_mm_mul_ps(x, xm1), _mm_mul_ps(xm2, sixth));
+            __m128 w1 = _mm_mul_ps(_mm_mul_ps(xp1, xm1), _mm_mul_ps(xm2, half));
+            __m128 w2 = _mm_mul_ps(_mm_mul_ps(xp1, x), _mm_mul_ps(xm2, half));
+            __m128 w3 = _mm_mul_ps(_mm_mul_ps(xp1, x), _mm_mul_ps(xm1, sixth));
+
+            __m128 o = _mm_sub_ps(_mm_mul_ps(r[1], w1), _mm_mul_ps(r[0], w0));
+            o = _mm_sub_ps(o, _mm_mul_ps(r[2], w2));
+            return _mm_add_ps(o, _mm_mul_ps(r[3], w3));
+        }
+
+        // the table row, kept in the table for delays below zero
+        const __m128 m = _mm_set1_ps((float)FIRipol_M);
+        __m128 rowf = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(one, frac), m), m);
+        int row alignas(16)[4];
+        _mm_store_si128((__m128i *)row, _mm_cvttps_epi32(_mm_max_ps(rowf, _mm_setzero_ps())));
+
+        for (int t = 0; t < taps; ++t)
+        {
+            const float *b =
+                &lines[t]->buffer[(lines[t]->wp - iD[t] - FIRoffset) & (COMB_SIZE - 1)];
+            const float *s = (I == SINC) ? &sinctable[row[t] * FIRipol_N * 2]
+                                         : &sinctable1X[row[t] * FIRipol_N];
+            __m128 o = _mm_mul_ps(_mm_loadu_ps(b), _mm_load_ps(s));
+            o = _mm_add_ps(o, _mm_mul_ps(_mm_loadu_ps(b + 4), _mm_load_ps(s + 4)));
+            o = _mm_add_ps(o, _mm_mul_ps(_mm_loadu_ps(b + 8), _mm_load_ps(s + 8)));
+            r[t] = o;
+        }
+        _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+        return _mm_add_ps(_mm_add_ps(r[0], r[1]), _mm_add_ps(r[2], r[3]));
+    }
+
+    // taps from this line
+    template <Interpolation I, int taps = 4> inline __m128 readTaps(const float *delays) const
+    {
+        const SSESincDelayLine *l[4] = {this, this, this, this};
+        return readTaps<I, taps>(l, delays);
+    }
 };
 
 #endif // SURGE_SSESINCDELAYLINE_H
@@ -725,6 +725,244 @@ void SineOscillator::process_block_internal(float pitch, float drift, float fmde
     applyFilter();
 }
 
+/*
+ * A voice with a single unison voice only fills one lane of process_block_internal. When the
+ * synth hands us several voices at once, process_lanes_internal instead puts up to four voices
+ * (each with unison 1) in the lanes of one SSE pass. Each lane runs the same arithmetic as
+ * lane 0 of process_block_internal, so the result is identical to rendering the voices alone.
+ *
+ * The lanes' state is laid out sample major for the whole block. Nothing a voice's phase and
+ * depths do depends on its output, so a first pass per voice runs them ahead into the lane
+ * blocks. The SSE pass then only carries the feedback value from sample to sample, and the
+ * outputs go back to the voices four samples at a time.
+ */
+template <int mode, bool stereo, bool FM>
+void SineOscillator::process_lanes_internal(SineOscillator **lanes, int n, const float *pitch,
+                                            const float *drift, const float *fmdepth)
+{
+    float fph alignas(16)[BLOCK_SIZE_OS][4], fmp alignas(16)[BLOCK_SIZE_OS][4],
+        fbv alignas(16)[BLOCK_SIZE_OS][4];
+    float outL alignas(16)[BLOCK_SIZE_OS][4], outR alignas(16)[BLOCK_SIZE_OS][4];
+    float fbneg alignas(16)[4] = {0.f, 0.f, 0.f, 0.f};
+    float pL alignas(16)[4] = {0.f, 0.f, 0.f, 0.f}, pR alignas(16)[4] = {0.f, 0.f, 0.f, 0.f};
+    float att alignas(16)[4] = {0.f, 0.f, 0.f, 0.f}, lastv alignas(16)[4] = {0.f, 0.f, 0.f, 0.f};
+
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i >= n)
+        {
+            for (int k = 0; k < BLOCK_SIZE_OS; k++)
+                fph[k][i] = fmp[k][i] = fbv[k][i] = 0.f;
+            continue;
+        }
+
+        auto o = lanes[i];
+        double detune = drift[i] * o->driftLFO[0].next();
+        double omega = std::min(M_PI, o->pitch_to_omega(pitch[i] + detune));
+
+        float fv = 32.0 * M_PI * fmdepth[i] * fmdepth[i] * fmdepth[i];
+        fv = limit_range(fv, -1.0e6f, 1.0e6f);
+
+        o->FMdepth.newValue(fv);
+        o->FB.newValue(abs(o->fb_val));
+
+        // with one unison voice the play ramp is always 1, so firstblock has nothing to ramp
+        o->firstblock = false;
+
+        fbneg[i] = o->fb_val < 0 ? 1.f : 0.f;
+        pL[i] = o->panL[0];
+        pR[i] = o->panR[0];
+        att[i] = o->out_attenuation;
+        lastv[i] = o->lastvalue[0];
+
+        double phase = o->phase[0];
+        for (int k = 0; k < BLOCK_SIZE_OS; k++)
+        {
+            fph[k][i] = (float)phase;
+            fmp[k][i] = FM ? o->FMdepth.v * o->master_osc[k] : 0.f;
+            fbv[k][i] = o->FB.v;
+
+            phase += omega;
+            phase -= (phase > M_PI) * 2.0 * M_PI;
+
+            o->FMdepth.process();
+            o->FB.process();
+        }
+        o->phase[0] = phase;
+    }
+
+    auto fbnegmask = _mm_cmpgt_ps(_mm_load_ps(fbneg), _mm_setzero_ps());
+    auto pl = _mm_load_ps(pL);
+    auto pr = _mm_load_ps(pR);
+    auto outattensse = _mm_load_ps(att);
+    auto lv = _mm_load_ps(lastv);
+    const auto half = _mm_set1_ps(0.5f);
+
+    for (int k = 0; k < BLOCK_SIZE_OS; k++)
+    {
+        auto x = _mm_add_ps(_mm_add_ps(_mm_load_ps(fph[k]), lv), _mm_load_ps(fmp[k]));
+        x = Surge::DSP::clampToPiRangeSSE(x);
+
+        auto sxl = Surge::DSP::fastsinSSE(x);
+        auto cxl = Surge::DSP::fastcosSSE(x);
+
+        auto out_local = valueFromSinAndCosForMode<mode>(sxl, cxl, n);
+
+        auto l = _mm_mul_ps(_mm_mul_ps(pl, out_local), outattensse);
+        auto r = _mm_mul_ps(_mm_mul_ps(pr, out_local), outattensse);
+
+        lv = _mm_mul_ps(_mm_add_ps(_mm_and_ps(fbnegmask, _mm_mul_ps(out_local, out_local)),
+                                   _mm_andnot_ps(fbnegmask, out_local)),
+                        _mm_load_ps(fbv[k]));
+
+        if (stereo)
+        {
+            _mm_store_ps(outL[k], l);
+            _mm_store_ps(outR[k], r);
+        }
+        else
+        {
+            _mm_store_ps(outL[k], _mm_mul_ps(_mm_add_ps(l, r), half));
+        }
+    }
+
+    _mm_store_ps(lastv, lv);
+
+    // back to the voices, transposing four samples of the four lanes at a time
+    auto toVoices = [lanes, n](float(*src)[4], bool right) {
+        for (int k = 0; k < BLOCK_SIZE_OS; k += 4)
+        {
+            __m128 c[4] = {_mm_load_ps(src[k]), _mm_load_ps(src[k + 1]), _mm_load_ps(src[k + 2]),
+                           _mm_load_ps(src[k + 3])};
+            _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+            for (int i = 0; i < n; ++i)
+                _mm_store_ps((right ? lanes[i]->outputR : lanes[i]->output) + k, c[i]);
+        }
+    };
+    toVoices(outL, false);
+    if (stereo)
+        toVoices(outR, true);
+
+    for (int i = 0; i < n; ++i)
+    {
+        auto o = lanes[i];
+        o->lastvalue[0] = lastv[i];
+        o->applyFilter();
+
+        if (o->charFilt.doFilter)
+        {
+            if (stereo)
+            {
+                o->charFilt.process_block_stereo(o->output, o->outputR, BLOCK_SIZE_OS);
+            }
+            else
+            {
+                o->charFilt.process_block(o->output, BLOCK_SIZE_OS);
+            }
+        }
+    }
+}
+
+void SineOscillator::process_lanes(SineOscillator **lanes, int n, const float *pitch,
+                                   const float *drift, bool stereo, bool FM,
+                                   const float *fmdepth)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        lanes[i]->fb_val =
+            lanes[i]->oscdata->p[sine_feedback].get_extended(lanes[i]->localcopy[lanes[i]->id_fb].f);
+    }
+
+#define DOCASE(x)                                                                                  \
+    case x:                                                                                        \
+        if (stereo)                                                                                \
+            if (FM)                                                                                \
+                process_lanes_internal<x, true, true>(lanes, n, pitch, drift, fmdepth);            \
+            else                                                                                   \
+                process_lanes_internal<x, true, false>(lanes, n, pitch, drift, fmdepth);           \
+        else if (FM)                                                                               \
+            process_lanes_internal<x, false, true>(lanes, n, pitch, drift, fmdepth);               \
+        else                                                                                       \
+            process_lanes_internal<x, false, false>(lanes, n, pitch, drift, fmdepth);              \
+        break;
+
+    switch (lanes[0]->localcopy[lanes[0]->id_mode].i)
+    {
+        DOCASE(0)
+        DOCASE(1)
+        DOCASE(2)
+        DOCASE(3)
+        DOCASE(4)
+        DOCASE(5)
+        DOCASE(6)
+        DOCASE(7)
+        DOCASE(8)
+        DOCASE(9)
+        DOCASE(10)
+
+        DOCASE(11)
+        DOCASE(12)
+        DOCASE(13)
+        DOCASE(14)
+        DOCASE(15)
+        DOCASE(16)
+        DOCASE(17)
+        DOCASE(18)
+        DOCASE(19)
+        DOCASE(20)
+        DOCASE(21)
+        DOCASE(22)
+        DOCASE(23)
+        DOCASE(24)
+        DOCASE(25)
+        DOCASE(26)
+        DOCASE(27)
+    }
+#undef DOCASE
+}
+
+void SineOscillator::process_block_batch(Oscillator **voices, int n, const float *pitch,
+                                         const float *drift, bool stereo, bool FM,
+                                         const float *fmdepth)
+{
+    SineOscillator *lanes[4];
+    float lp[4], ld[4], lf[4];
+    int nl = 0, laneMode = -1;
+
+    auto flush = [&]() {
+        if (nl > 0)
+            process_lanes(lanes, nl, lp, ld, stereo, FM, lf);
+        nl = 0;
+    };
+
+    for (int i = 0; i < n; ++i)
+    {
+        auto o = static_cast<SineOscillator *>(voices[i]);
+        auto mode = o->localcopy[o->id_mode].i;
+
+        // Legacy FM and unison voices render on their own
+        if (o->n_unison != 1 || o->localcopy[o->id_fmlegacy].i == 0)
+        {
+            o->process_block(pitch[i], drift[i], stereo, FM, fmdepth[i]);
+            continue;
+        }
+
+        if (nl > 0 && mode != laneMode)
+            flush();
+
+        laneMode = mode;
+        lanes[nl] = o;
+        lp[nl] = pitch[i];
+        ld[nl] = drift[i];
+        lf[nl] = fmdepth[i];
+        nl++;
+
+        if (nl == 4)
+            flush();
+    }
+    flush();
+}
+
 void SineOscillator::applyFilter()
 {
     if (!oscdata->p[sine_lowcut].deactivated)
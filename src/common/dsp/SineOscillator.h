@@ -43,6 +43,15 @@ class SineOscillator : public Oscillator
     template <int mode, bool stereo, bool FM>
     void process_block_internal(float pitch, float drift, float FMdepth);
 
+    virtual void process_block_batch(Oscillator **voices, int n, const float *pitch,
+                                     const float *drift, bool stereo, bool FM,
+                                     const float *FMdepth) override;
+    template <int mode, bool stereo, bool FM>
+    static void process_lanes_internal(SineOscillator **lanes, int n, const float *pitch,
+                                       const float *drift, const float *FMdepth);
+    static void process_lanes(SineOscillator **lanes, int n, const float *pitch,
+                              const float *drift, bool stereo, bool FM, const float *FMdepth);
+
     template <int mode>
     void process_block_legacy(float pitch, float drift = 0.f, bool stereo = false, bool FM = false,
                               float FMdepth = 0.f);
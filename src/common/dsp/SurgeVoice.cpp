@@ -17,6 +17,7 @@
 #include "DspUtilities.h"
 #include "QuadFilterChain.h"
 #include <math.h>
+#include <algorithm>
 #include "libMTSClient.h"
 
 using namespace std;
@@ -421,15 +422,15 @@ void SurgeVoice::switch_toggled()
         if ((scene->filterunit[u].type.val.i != FBP.FU[u].type) ||
             (scene->filterunit[u].subtype.val.i != FBP.FU[u].subtype))
         {
-            memset(&FBP.FU[u], 0, sizeof(FBP.FU[u]));
             FBP.FU[u].type = scene->filterunit[u].type.val.i;
             FBP.FU[u].subtype = scene->filterunit[u].subtype.val.i;
+            clearLaneUnit(u);
 
             if (scene->filterblock_configuration.val.i == fc_wide)
             {
-                memset(&FBP.FU[u + 2], 0, sizeof(FBP.FU[u + 2]));
                 FBP.FU[u + 2].type = scene->filterunit[u].type.val.i;
                 FBP.FU[u + 2].subtype = scene->filterunit[u].subtype.val.i;
+                clearLaneUnit(u + 2);
             }
 
             CM[u].Reset();
@@ -719,21 +720,25 @@ template <bool first> void SurgeVoice::calc_ctrldata(QuadFilterChainState *Q, in
     FBP.OutR = ampR;
 }
 
-bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
+bool SurgeVoice::process_block()
 {
-    calc_ctrldata<0>(&Q, Qe);
+    begin_block();
 
-    bool is_wide = scene->filterblock_configuration.val.i == fc_wide;
-    float tblock alignas(16)[BLOCK_SIZE_OS], tblock2 alignas(16)[BLOCK_SIZE_OS];
-    float *tblockR = is_wide ? tblock2 : tblock;
+    for (int i = n_oscs - 1; i >= 0; --i)
+    {
+        if (osc_block_needed(i))
+        {
+            auto a = prepare_osc_block(i);
+            osc[i]->process_block(a.pitch, a.drift, a.stereo, a.FM, a.FMdepth);
+        }
+    }
 
-    // float ktrkroot = (float)scene->keytrack_root.val.i;
-    float ktrkroot = 60;
-    float drift = localcopy[scene->drift.param_id_in_scene].f;
+    return end_block();
+}
 
-    // clear output
-    clear_block(output[0], BLOCK_SIZE_OS_QUAD);
-    clear_block(output[1], BLOCK_SIZE_OS_QUAD);
+void SurgeVoice::begin_block()
+{
+    calc_ctrldata<0>(fbq, fbqi);
 
     for (int i = 0; i < n_oscs; ++i)
     {
@@ -742,132 +747,82 @@ bool SurgeVoice::process_block(QuadFilterChainState &Q, int Qe)
             osc[i]->setGate(state.gate);
         }
     }
+}
 
-    if (osc3 || ring23 || ((osc1 || osc2 || ring12) && (FMmode == fm_3to2to1)) ||
-        ((osc1 || ring12) && (FMmode == fm_2and3to1)))
+bool SurgeVoice::osc_block_needed(int i) const
+{
+    switch (i)
     {
-        osc[2]->process_block(
-            noteShiftFromPitchParam(
-                (scene->osc[2].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
-                    octaveSize * scene->osc[2].octave.val.i,
-                2),
-            drift, is_wide);
-
-        if (osc3)
-        {
-            if (is_wide)
-            {
-                osclevels[le_osc3].multiply_2_blocks_to(osc[2]->output, osc[2]->outputR, tblock,
-                                                        tblockR, BLOCK_SIZE_OS_QUAD);
-            }
-            else
-            {
-                osclevels[le_osc3].multiply_block_to(osc[2]->output, tblock, BLOCK_SIZE_OS_QUAD);
-            }
-
-            if (route[2] < 2)
-            {
-                accumulate_block(tblock, output[0], BLOCK_SIZE_OS_QUAD);
-            }
-            if (route[2] > 0)
-            {
-                accumulate_block(tblockR, output[1], BLOCK_SIZE_OS_QUAD);
-            }
-        }
+    case 2:
+        return osc3 || ring23 || ((osc1 || osc2 || ring12) && (FMmode == fm_3to2to1)) ||
+               ((osc1 || ring12) && (FMmode == fm_2and3to1));
+    case 1:
+        return osc2 || ring12 || ring23 || (FMmode && osc1);
+    case 0:
+        return osc1 || ring12;
     }
+    return false;
+}
+
+SurgeVoice::OscBlockArgs SurgeVoice::prepare_osc_block(int i)
+{
+    // float ktrkroot = (float)scene->keytrack_root.val.i;
+    float ktrkroot = 60;
 
-    if (osc2 || ring12 || ring23 || (FMmode && osc1))
+    OscBlockArgs a;
+    a.pitch = noteShiftFromPitchParam(
+        (scene->osc[i].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
+            octaveSize * scene->osc[i].octave.val.i,
+        i);
+    a.drift = localcopy[scene->drift.param_id_in_scene].f;
+    a.stereo = scene->filterblock_configuration.val.i == fc_wide;
+    a.FM = (i == 1 && FMmode == fm_3to2to1) || (i == 0 && FMmode);
+    a.FMdepth = a.FM ? db_to_linear(localcopy[scene->fm_depth.param_id_in_scene].f) : 0.f;
+
+    if (i == 0 && FMmode == fm_2and3to1)
     {
-        if (FMmode == fm_3to2to1)
-        {
-            osc[1]->process_block(
-                noteShiftFromPitchParam(
-                    (scene->osc[1].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
-                        octaveSize * scene->osc[1].octave.val.i,
-                    1),
-                drift, is_wide, true, db_to_linear(localcopy[scene->fm_depth.param_id_in_scene].f));
-        }
-        else
-        {
-            osc[1]->process_block(
-                noteShiftFromPitchParam(
-                    (scene->osc[1].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
-                        octaveSize * scene->osc[1].octave.val.i,
-                    1),
-                drift, is_wide);
-        }
+        add_block(osc[1]->output, osc[2]->output, fmbuffer, BLOCK_SIZE_OS_QUAD);
+    }
 
-        if (osc2)
-        {
-            if (is_wide)
-            {
-                osclevels[le_osc2].multiply_2_blocks_to(osc[1]->output, osc[1]->outputR, tblock,
-                                                        tblockR, BLOCK_SIZE_OS_QUAD);
-            }
-            else
-            {
-                osclevels[le_osc2].multiply_block_to(osc[1]->output, tblock, BLOCK_SIZE_OS_QUAD);
-            }
+    return a;
+}
 
-            if (route[1] < 2)
-            {
-                accumulate_block(tblock, output[0], BLOCK_SIZE_OS_QUAD);
-            }
-            if (route[1] > 0)
-            {
-                accumulate_block(tblockR, output[1], BLOCK_SIZE_OS_QUAD);
-            }
-        }
-    }
+bool SurgeVoice::end_block()
+{
+    auto &Q = *fbq;
+    auto Qe = fbqi;
+
+    bool is_wide = scene->filterblock_configuration.val.i == fc_wide;
+    float tblock alignas(16)[BLOCK_SIZE_OS], tblock2 alignas(16)[BLOCK_SIZE_OS];
+    float *tblockR = is_wide ? tblock2 : tblock;
+
+    // clear output
+    clear_block(output[0], BLOCK_SIZE_OS_QUAD);
+    clear_block(output[1], BLOCK_SIZE_OS_QUAD);
 
-    if (osc1 || ring12)
+    // The oscillators have all rendered by now; mix them in the order they used to render in
+    for (int i = n_oscs - 1; i >= 0; --i)
     {
-        if (FMmode == fm_2and3to1)
-        {
-            add_block(osc[1]->output, osc[2]->output, fmbuffer, BLOCK_SIZE_OS_QUAD);
-            osc[0]->process_block(
-                noteShiftFromPitchParam(
-                    (scene->osc[0].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
-                        octaveSize * scene->osc[0].octave.val.i,
-                    0),
-                drift, is_wide, true, db_to_linear(localcopy[scene->fm_depth.param_id_in_scene].f));
-        }
-        else if (FMmode)
-        {
-            osc[0]->process_block(
-                noteShiftFromPitchParam(
-                    (scene->osc[0].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
-                        octaveSize * scene->osc[0].octave.val.i,
-                    0),
-                drift, is_wide, true, db_to_linear(localcopy[scene->fm_depth.param_id_in_scene].f));
-        }
-        else
-        {
-            osc[0]->process_block(
-                noteShiftFromPitchParam(
-                    (scene->osc[0].keytrack.val.b ? state.pitch : ktrkroot + state.scenepbpitch) +
-                        octaveSize * scene->osc[0].octave.val.i,
-                    0),
-                drift, is_wide);
-        }
+        bool audible = (i == 0) ? osc1 : ((i == 1) ? osc2 : osc3);
+        int le = le_osc1 + i;
 
-        if (osc1)
+        if (audible)
         {
             if (is_wide)
             {
-                osclevels[le_osc1].multiply_2_blocks_to(osc[0]->output, osc[0]->outputR, tblock,
-                                                        tblockR, BLOCK_SIZE_OS_QUAD);
+                osclevels[le].multiply_2_blocks_to(osc[i]->output, osc[i]->outputR, tblock,
+                                                   tblockR, BLOCK_SIZE_OS_QUAD);
             }
             else
             {
-                osclevels[le_osc1].multiply_block_to(osc[0]->output, tblock, BLOCK_SIZE_OS_QUAD);
+                osclevels[le].multiply_block_to(osc[i]->output, tblock, BLOCK_SIZE_OS_QUAD);
             }
 
-            if (route[0] < 2)
+            if (route[i] < 2)
             {
                 accumulate_block(tblock, output[0], BLOCK_SIZE_OS_QUAD);
             }
-            if (route[0] > 0)
+            if (route[i] > 0)
             {
                 accumulate_block(tblockR, output[1], BLOCK_SIZE_OS_QUAD);
             }
@@ -988,9 +943,6 @@ void SurgeVoice::set_path(bool osc1, bool osc2, bool osc3, int FMmode, bool ring
 
 void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ialise)
 {
-    fbq = Q;
-    fbqi = e;
-
     float FMix1, FMix2;
     switch (scene->filterblock_configuration.val.i)
     {
@@ -1034,12 +986,10 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
     FBP.Mix1 = FMix1;
     FBP.Mix2 = FMix2;
 
-    // filterunits
+    // filterunits. Their registers stay in our lane from block to block, so only the
+    // coefficients are set here
     if (Q)
     {
-        set1f(Q->wsLPF, e, FBP.wsLPF); // remember state
-        set1f(Q->FBlineL, e, FBP.FBlineL);
-        set1f(Q->FBlineR, e, FBP.FBlineR);
         Q->FU[0].active[e] = 0xffffffff;
         Q->FU[1].active[e] = 0xffffffff;
         Q->FU[2].active[e] = 0xffffffff;
@@ -1055,31 +1005,17 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
         if (scene->f2_cutoff_is_offset.val.b)
             cutoffB += cutoffA;
 
-        CM[0].MakeCoeffs(cutoffA, localcopy[id_resoa].f, scene->filterunit[0].type.val.i,
-                         scene->filterunit[0].subtype.val.i, storage,
-                         scene->filterunit[0].cutoff.extend_range);
-        CM[1].MakeCoeffs(
-            cutoffB, scene->f2_link_resonance.val.b ? localcopy[id_resoa].f : localcopy[id_resob].f,
-            scene->filterunit[1].type.val.i, scene->filterunit[1].subtype.val.i, storage,
-            scene->filterunit[1].cutoff.extend_range);
+        // the coefficients are made for the quad at once, in makeFilterCoeffsQuad
+        FBP.Cutoff[0] = cutoffA;
+        FBP.Cutoff[1] = cutoffB;
+        FBP.Reso[0] = localcopy[id_resoa].f;
+        FBP.Reso[1] =
+            scene->f2_link_resonance.val.b ? localcopy[id_resoa].f : localcopy[id_resob].f;
 
         for (int u = 0; u < n_filterunits_per_scene; u++)
         {
             if (scene->filterunit[u].type.val.i != 0)
             {
-                for (int i = 0; i < n_cm_coeffs; i++)
-                {
-                    set1f(Q->FU[u].C[i], e, CM[u].C[i]);
-                    set1f(Q->FU[u].dC[i], e, CM[u].dC[i]);
-                }
-
-                for (int i = 0; i < n_filter_registers; i++)
-                {
-                    set1f(Q->FU[u].R[i], e, FBP.FU[u].R[i]);
-                }
-
-                Q->FU[u].DB[e] = FBP.Delay[u];
-                Q->FU[u].WP[e] = FBP.FU[u].WP;
                 switch (scene->filterunit[u].type.val.i)
                 {
                 case fut_lpmoog:
@@ -1106,20 +1042,6 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
 
                 if (scene->filterblock_configuration.val.i == fc_wide)
                 {
-                    for (int i = 0; i < n_cm_coeffs; i++)
-                    {
-                        set1f(Q->FU[u + 2].C[i], e, CM[u].C[i]);
-                        set1f(Q->FU[u + 2].dC[i], e, CM[u].dC[i]);
-                    }
-
-                    for (int i = 0; i < n_filter_registers; i++)
-                    {
-                        set1f(Q->FU[u + 2].R[i], e, FBP.FU[u + 2].R[i]);
-                    }
-
-                    Q->FU[u + 2].DB[e] = FBP.Delay[u + 2];
-                    Q->FU[u + 2].WP[e] = FBP.FU[u].WP;
-
                     switch (scene->filterunit[u].type.val.i)
                     {
                     case fut_lpmoog:
@@ -1145,35 +1067,189 @@ void SurgeVoice::SetQFB(QuadFilterChainState *Q, int e) // Q == 0 means init(ial
     }
 }
 
-void SurgeVoice::GetQFB()
+void SurgeVoice::makeFilterCoeffsQuad(SurgeVoice *v[4], QuadFilterChainState &Q,
+                                      const SharedFilterCoeffs sh[n_filterunits_per_scene])
 {
+    auto *scene = v[0]->scene;
+
     for (int u = 0; u < n_filterunits_per_scene; u++)
     {
-        if (scene->filterunit[u].type.val.i != 0)
-        {
-            for (int i = 0; i < n_filter_registers; i++)
-            {
-                FBP.FU[u].R[i] = get1f(fbq->FU[u].R[i], fbqi);
-            }
+        if (scene->filterunit[u].type.val.i == 0)
+            continue;
 
+        if (sh[u].active)
+        {
             for (int i = 0; i < n_cm_coeffs; i++)
             {
-                CM[u].C[i] = get1f(fbq->FU[u].C[i], fbqi);
+                Q.FU[u].C[i] = sh[u].C[i];
+                Q.FU[u].dC[i] = sh[u].dC[i];
             }
-            FBP.FU[u].WP = fbq->FU[u].WP[fbqi];
-
-            if (scene->filterblock_configuration.val.i == fc_wide)
+        }
+        else
+        {
+            FilterCoefficientMaker *cm[4];
+            float freq[4] = {0.f, 0.f, 0.f, 0.f}, reso[4] = {0.f, 0.f, 0.f, 0.f};
+            for (int i = 0; i < 4; i++)
             {
-                for (int i = 0; i < n_filter_registers; i++)
+                cm[i] = v[i] ? &v[i]->CM[u] : nullptr;
+                if (v[i])
                 {
-                    FBP.FU[u + 2].R[i] = get1f(fbq->FU[u + 2].R[i], fbqi);
+                    freq[i] = v[i]->FBP.Cutoff[u];
+                    reso[i] = v[i]->FBP.Reso[u];
                 }
             }
+
+            FilterCoefficientMaker::MakeCoeffsQuad(
+                cm, freq, reso, scene->filterunit[u].type.val.i,
+                scene->filterunit[u].subtype.val.i, v[0]->storage,
+                scene->filterunit[u].cutoff.extend_range, Q.FU[u]);
         }
+
+        if (scene->filterblock_configuration.val.i == fc_wide)
+        {
+            for (int i = 0; i < n_cm_coeffs; i++)
+            {
+                Q.FU[u + 2].C[i] = Q.FU[u].C[i];
+                Q.FU[u + 2].dC[i] = Q.FU[u].dC[i];
+            }
+        }
+    }
+}
+
+bool SurgeVoice::filterCoeffsVoiceInvariant(SurgeSceneStorage *scene, pdata *scenedata,
+                                            bool mpeEnabled, int u)
+{
+    // the parameters which go into the unit's cutoff and resonance in SetQFB
+    int ids[8], n = 0;
+    auto addUnit = [&](int f) {
+        ids[n++] = scene->filterunit[f].cutoff.param_id_in_scene;
+        ids[n++] = scene->filterunit[f].keytrack.param_id_in_scene;
+        ids[n++] = scene->filterunit[f].envmod.param_id_in_scene;
+    };
+    addUnit(u);
+    if (u == 1 && scene->f2_cutoff_is_offset.val.b)
+        addUnit(0);
+    ids[n++] = (u == 1 && !scene->f2_link_resonance.val.b)
+                   ? scene->filterunit[1].resonance.param_id_in_scene
+                   : scene->filterunit[0].resonance.param_id_in_scene;
+
+    auto isInput = [&](int id) { return std::find(ids, ids + n, id) != ids + n; };
+
+    // keytrack and the filter envelope scale with each voice's pitch and envelope
+    for (int f = 0; f < n_filterunits_per_scene; f++)
+    {
+        if ((isInput(scene->filterunit[f].keytrack.param_id_in_scene) &&
+             scenedata[scene->filterunit[f].keytrack.param_id_in_scene].f != 0.f) ||
+            (isInput(scene->filterunit[f].envmod.param_id_in_scene) &&
+             scenedata[scene->filterunit[f].envmod.param_id_in_scene].f != 0.f))
+            return false;
     }
-    FBP.FBlineL = get1f(fbq->FBlineL, fbqi);
-    FBP.FBlineR = get1f(fbq->FBlineR, fbqi);
-    FBP.wsLPF = get1f(fbq->wsLPF, fbqi);
+
+    for (auto &r : scene->modulation_voice)
+    {
+        if (isInput(r.destination_id))
+            return false;
+    }
+
+    if (mpeEnabled)
+    {
+        for (auto &r : scene->modulation_scene)
+        {
+            if (r.source_id == ms_aftertouch && isInput(r.destination_id))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void SurgeVoice::makeSharedFilterCoeffs(SurgeVoice *v[], int n, int u, bool invariant,
+                                        SharedFilterCoeffs &sh)
+{
+    if (n == 0 || !invariant || v[0]->scene->filterunit[u].type.val.i == fut_none)
+    {
+        // a type change resets the voices' makers, so only hand the state back to them when
+        // the type is the one it was made for
+        if (sh.active && n > 0 && sh.type == v[0]->scene->filterunit[u].type.val.i &&
+            sh.subtype == v[0]->scene->filterunit[u].subtype.val.i)
+        {
+            for (int i = 0; i < n; i++)
+                v[i]->CM[u] = sh.CM;
+        }
+        sh.active = false;
+        return;
+    }
+
+    auto *scene = v[0]->scene;
+    int type = scene->filterunit[u].type.val.i, subtype = scene->filterunit[u].subtype.val.i;
+    if (!sh.active || sh.type != type || sh.subtype != subtype)
+    {
+        sh.CM = v[0]->CM[u];
+        sh.active = true;
+        sh.type = type;
+        sh.subtype = subtype;
+    }
+
+    sh.CM.MakeCoeffs(v[0]->FBP.Cutoff[u], v[0]->FBP.Reso[u], type, subtype, v[0]->storage,
+                     scene->filterunit[u].cutoff.extend_range);
+    for (int i = 0; i < n_cm_coeffs; i++)
+    {
+        sh.C[i] = _mm_set1_ps(sh.CM.C[i]);
+        sh.dC[i] = _mm_set1_ps(sh.CM.dC[i]);
+        sh.CM.C[i] = sh.CM.tC[i];
+    }
+}
+
+void SurgeVoice::clearLaneUnit(int u)
+{
+    if (!fbq)
+        return;
+
+    for (int i = 0; i < n_filter_registers; i++)
+    {
+        set1f(fbq->FU[u].R[i], fbqi, 0.f);
+    }
+    fbq->FU[u].WP[fbqi] = 0;
+}
+
+void SurgeVoice::bindLane(QuadFilterChainState *Q, int e)
+{
+    fbq = Q;
+    fbqi = e;
+
+    for (int u = 0; u < 4; u++)
+    {
+        clearLaneUnit(u);
+        Q->FU[u].DB[e] = FBP.Delay[u];
+    }
+    set1f(Q->wsLPF, e, 0.f);
+    set1f(Q->FBlineL, e, 0.f);
+    set1f(Q->FBlineR, e, 0.f);
+}
+
+void SurgeVoice::moveLane(QuadFilterChainState *Q, int e)
+{
+    for (int u = 0; u < 4; u++)
+    {
+        for (int i = 0; i < n_filter_registers; i++)
+        {
+            set1f(Q->FU[u].R[i], e, get1f(fbq->FU[u].R[i], fbqi));
+        }
+        Q->FU[u].DB[e] = fbq->FU[u].DB[fbqi];
+        Q->FU[u].WP[e] = fbq->FU[u].WP[fbqi];
+    }
+    set1f(Q->wsLPF, e, get1f(fbq->wsLPF, fbqi));
+    set1f(Q->FBlineL, e, get1f(fbq->FBlineL, fbqi));
+    set1f(Q->FBlineR, e, get1f(fbq->FBlineR, fbqi));
+
+    fbq = Q;
+    fbqi = e;
+}
+
+void SurgeVoice::unbindLane()
+{
+    fbq = nullptr;
+    fbqi = -1;
 }
 
 void SurgeVoice::freeAllocatedElements()
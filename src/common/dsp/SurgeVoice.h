@@ -26,6 +26,19 @@
 
 struct QuadFilterChainState;
 
+/*
+ * One set of coefficients for a filter unit of every voice in a scene, made once per block
+ * while no voice can move the unit's cutoff or resonance away from the others. The voices'
+ * own makers carry on from its state when that stops.
+ */
+struct alignas(16) SharedFilterCoeffs
+{
+    __m128 C[n_cm_coeffs], dC[n_cm_coeffs];
+    FilterCoefficientMaker CM;
+    bool active = false;
+    int type = 0, subtype = 0;
+};
+
 class alignas(16) SurgeVoice
 {
   public:
@@ -46,8 +59,58 @@ class alignas(16) SurgeVoice
     void release();
     void uber_release();
 
-    bool process_block(QuadFilterChainState &, int);
-    void GetQFB(); // Get the updated registers from the QuadFB
+    /*
+     * A voice keeps its filter registers in one lane of its scene's QuadFilterChainState for as
+     * long as it plays, so they never leave the SSE registers between blocks. The synth binds a
+     * lane before the voice's first block, which clears the lane's state, and moves the voice
+     * to another lane when it compacts the bank after a voice ends.
+     */
+    void bindLane(QuadFilterChainState *Q, int e);
+    void moveLane(QuadFilterChainState *Q, int e);
+    void unbindLane();
+    bool hasLane() const { return fbq != nullptr; }
+
+    bool process_block();
+
+    /*
+     * process_block in phases, so the synth can render each oscillator slot for all the voices
+     * of a scene in one Oscillator::process_block_batch call. Call begin_block, then for
+     * slots 2, 1, 0 render every slot with osc_block_needed using the prepare_osc_block
+     * arguments, then end_block, which mixes and returns whether the voice keeps playing.
+     */
+    struct OscBlockArgs
+    {
+        float pitch, drift, FMdepth;
+        bool stereo, FM;
+    };
+    void begin_block();
+    bool osc_block_needed(int i) const;
+    OscBlockArgs prepare_osc_block(int i);
+    Oscillator *oscillator(int i) { return osc[i].get(); }
+    bool end_block();
+
+    /*
+     * Makes the filter coefficients of the voices sharing a quad of the filter bank together,
+     * after their end_block. Idle lanes are nullptr, and v[0] is always a voice. The units whose
+     * shared coefficients are active take them from sh instead.
+     */
+    static void makeFilterCoeffsQuad(SurgeVoice *v[4], QuadFilterChainState &Q,
+                                     const SharedFilterCoeffs sh[n_filterunits_per_scene]);
+
+    /*
+     * Whether every voice of the scene gets the same cutoff and resonance for filter unit u:
+     * no keytrack or filter envelope depth, and no voice modulation (or MPE aftertouch) on them.
+     */
+    static bool filterCoeffsVoiceInvariant(SurgeSceneStorage *scene, pdata *scenedata,
+                                           bool mpeEnabled, int u);
+
+    /*
+     * Makes sh for the n voices of a scene's filter bank when invariant holds. Otherwise, if sh
+     * was active, hands its state back to the voices' makers and deactivates it.
+     */
+    static void makeSharedFilterCoeffs(SurgeVoice *v[], int n, int u, bool invariant,
+                                       SharedFilterCoeffs &sh);
+
     void legato(int key, int velocity, char detune);
     void switch_toggled();
     void freeAllocatedElements();
@@ -143,18 +206,18 @@ class alignas(16) SurgeVoice
     LfoModulationSource lfo[6];
 
     // Filterblock state storage
-    void SetQFB(QuadFilterChainState *, int); // Set the parameters & registers
-    QuadFilterChainState *fbq;
-    int fbqi;
+    void SetQFB(QuadFilterChainState *, int); // Set the parameters & coefficients
+    void clearLaneUnit(int u);                // Zero the registers of a filter unit in our lane
+    QuadFilterChainState *fbq = nullptr;
+    int fbqi = -1;
 
     struct
     {
-        float Gain, FB, Mix1, Mix2, OutL, OutR, Out2L, Out2R, Drive, wsLPF, FBlineL, FBlineR;
+        float Gain, FB, Mix1, Mix2, OutL, OutR, Out2L, Out2R, Drive;
+        float Cutoff[2], Reso[2];
         float Delay[4][MAX_FB_COMB + FIRipol_N];
         struct
         {
-            float C[n_cm_coeffs], R[n_filter_registers];
-            unsigned int WP;
             int type, subtype; // used for comparison with the last run
         } FU[4];
     } FBP;
@@ -4,6 +4,11 @@
 #include <vt_dsp/basic_dsp.h>
 #include <vt_dsp/vt_dsp_endian.h>
 #include "SurgeStorage.h"
+#include "util/WorkerPool.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #if WINDOWS
 #include <intrin.h>
@@ -75,8 +80,12 @@ int GetWTIndex(int WaveIdx, int WaveSize, int NumWaves, int MipMap, int Padding
     return Index;
 }
 
+// generations are unique across every Wavetable, so no two contents ever share one
+static std::atomic<uint64_t> lastGeneration{0};
+
 Wavetable::Wavetable()
 {
+    generation = ++lastGeneration;
     dataSizes = 35000;
     TableF32Data = (float *)malloc(dataSizes * sizeof(float));
     TableI16Data = (short *)malloc(dataSizes * sizeof(short));
@@ -150,9 +159,26 @@ void Wavetable::Copy(Wavetable *wt)
     }
 
     current_id = wt->current_id;
+    generation = ++lastGeneration;
+}
+
+void Wavetable::publish(Wavetable &built)
+{
+    std::swap(everBuilt, built.everBuilt);
+    std::swap(size, built.size);
+    std::swap(n_tables, built.n_tables);
+    std::swap(size_po2, built.size_po2);
+    std::swap(flags, built.flags);
+    std::swap(dt, built.dt);
+    std::swap(dataSizes, built.dataSizes);
+    std::swap(TableF32Data, built.TableF32Data);
+    std::swap(TableI16Data, built.TableI16Data);
+    std::swap(TableF32WeakPointers, built.TableF32WeakPointers);
+    std::swap(TableI16WeakPointers, built.TableI16WeakPointers);
+    generation = ++lastGeneration;
 }
 
-bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
+bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence, bool parallelMips)
 {
     assert(wdata);
 
@@ -218,29 +244,42 @@ bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
         }
     }
 
+    /*
+    ** Convert straight from the file buffer into both the float and int16 tables in one pass,
+    ** with the same arithmetic as i16toi15_block, i152float_block and float2i15_block
+    */
     if (this->flags & wtf_int16)
     {
+        const float scale = 1.f / 16384.f;
+        int shift = (this->flags & wtf_int16_is_16) ? 1 : 0;
         for (int j = 0; j < wdata_tables; j++)
         {
-            vt_copyblock_W_LE(&this->TableI16WeakPointers[0][j][FIRoffsetI16],
-                              &((short *)wdata)[this->size * j], this->size);
-            if (this->flags & wtf_int16_is_16)
+            const short *src = &((short *)wdata)[this->size * j];
+            short *i16 = &this->TableI16WeakPointers[0][j][FIRoffsetI16];
+            float *f32 = this->TableF32WeakPointers[0][j];
+            for (int i = 0; i < this->size; i++)
             {
-                i16toi15_block(&this->TableI16WeakPointers[0][j][FIRoffsetI16],
-                               &this->TableI16WeakPointers[0][j][FIRoffsetI16], this->size);
+                short v = vt_read_int16LE(src[i]) >> shift;
+                i16[i] = v;
+                f32[i] = (float)v * scale;
             }
-            i152float_block(&this->TableI16WeakPointers[0][j][FIRoffsetI16],
-                            this->TableF32WeakPointers[0][j], this->size);
         }
     }
     else
     {
         for (int j = 0; j < wdata_tables; j++)
         {
-            vt_copyblock_DW_LE((int *)this->TableF32WeakPointers[0][j],
-                               &((int *)wdata)[this->size * j], this->size);
-            float2i15_block(this->TableF32WeakPointers[0][j],
-                            &this->TableI16WeakPointers[0][j][FIRoffsetI16], this->size);
+            const char *src = &((char *)wdata)[this->size * j * sizeof(float)];
+            short *i16 = &this->TableI16WeakPointers[0][j][FIRoffsetI16];
+            float *f32 = this->TableF32WeakPointers[0][j];
+            for (int i = 0; i < this->size; i++)
+            {
+                float v;
+                memcpy(&v, src + i * sizeof(float), sizeof(float));
+                v = vt_read_float32LE(v);
+                f32[i] = v;
+                i16[i] = (short)(int)limit_range((int)(v * 16384.f), -16384, 16383);
+            }
         }
     }
 
@@ -259,82 +298,190 @@ bool Wavetable::BuildWT(void *wdata, wt_header &wh, bool AppendSilence)
                FIRoffsetI16 * sizeof(short));
     }
 
-    MipMapWT();
+    MipMapWT(parallelMips);
 
     everBuilt = true;
     return true;
 }
 
-void Wavetable::MipMapWT()
+namespace
+{
+const int hr_filter_size = 63;
+const int hr_filter_id_of = (hr_filter_size - 1) >> 1;
+
+// below this many output samples handing frames to the workers costs more than it saves
+const size_t min_parallel_mip_work = 1 << 16;
+
+// the workers outlive every build, so loading a wavetable never starts a thread
+WorkerPool &mipWorkers()
+{
+    static WorkerPool pool(std::max(0, (int)std::thread::hardware_concurrency() - 1));
+    return pool;
+}
+
+/*
+** Run f(begin, end) over frames [0, n) split across the mip workers, unless !parallel. Frames of
+** one mip level only read the level above, so callers may split work any way which respects that.
+*/
+template <typename F> void forEachFrameRange(bool parallel, int n, size_t work, F f)
+{
+    if (!parallel || work < min_parallel_mip_work)
+    {
+        f(0, n);
+        return;
+    }
+
+    mipWorkers().forEachRange(n, f);
+}
+
+/*
+** Halfband decimate one wrapping frame of psize floats. The source is unwrapped into even and
+** odd phase buffers so four outputs share each filter tap; taps accumulate in the same order as
+** the scalar loop so the result is identical to it.
+*/
+void decimateFrameF32(const float *src, float *dst, int psize, std::vector<float> &scratch)
+{
+    int lsize = psize >> 1;
+    int half = lsize + hr_filter_id_of + 1;
+    scratch.resize(2 * half);
+    float *even = scratch.data(), *odd = scratch.data() + half;
+    for (int m = 0; m < half; m++)
+    {
+        even[m] = src[((m << 1) - hr_filter_id_of) & (psize - 1)];
+        odd[m] = src[((m << 1) + 1 - hr_filter_id_of) & (psize - 1)];
+    }
+
+    int i = 0;
+    for (; i + 4 <= lsize; i += 4)
+    {
+        __m128 acc = _mm_setzero_ps();
+        for (int a = 0; a < hr_filter_size; a++)
+        {
+            const float *x = ((a & 1) ? odd : even) + i + (a >> 1);
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(hrfilter[a]), _mm_loadu_ps(x)));
+        }
+        _mm_storeu_ps(dst + i, acc);
+    }
+    for (; i < lsize; i++)
+    {
+        float acc = 0;
+        for (int a = 0; a < hr_filter_size; a++)
+            acc += hrfilter[a] * ((a & 1) ? odd : even)[i + (a >> 1)];
+        dst[i] = acc;
+    }
+}
+
+/*
+** The int16 counterpart, src and dst point at the first sample after FIRoffsetI16. Integer
+** sums don't depend on order, so this is a straight 8-wide multiply-add dot product.
+*/
+void decimateFrameI16(const short *src, short *dst, int psize, std::vector<short> &scratch)
+{
+    int lsize = psize >> 1;
+    scratch.resize(psize + 64);
+    short *ext = scratch.data();
+    for (int j = 0; j < psize + 64; j++)
+        ext[j] = src[(j - hr_filter_id_of) & (psize - 1)];
+
+    short taps alignas(16)[64];
+    for (int a = 0; a < 64; a++)
+        taps[a] = (a < hr_filter_size) ? HRFilterI16[a] : 0;
+    __m128i tv[8];
+    for (int c = 0; c < 8; c++)
+        tv[c] = _mm_load_si128((__m128i *)&taps[c << 3]);
+
+    int acc alignas(16)[4];
+    for (int i = 0; i < lsize; i++)
+    {
+        __m128i sum = _mm_setzero_si128();
+        for (int c = 0; c < 8; c++)
+            sum = _mm_add_epi32(
+                sum, _mm_madd_epi16(_mm_loadu_si128((__m128i *)&ext[(i << 1) + (c << 3)]), tv[c]));
+        _mm_store_si128((__m128i *)acc, sum);
+        dst[i] = (acc[0] + acc[1] + acc[2] + acc[3]) >> 16;
+    }
+}
+} // namespace
+
+void Wavetable::MipMapWT(bool parallel)
 {
     int levels = 1;
     while (((1 << levels) < size) & (levels < max_mipmap_levels))
         levels++;
     int ns = this->n_tables;
 
-    const int filter_size = 63;
-    const int filter_id_of = (filter_size - 1) >> 1;
-
     for (int l = 1; l < levels; l++)
     {
-        int psize = size >> (l - 1);
-        int lsize = size >> l;
-
         for (int s = 0; s < ns; s++)
         {
             this->TableF32WeakPointers[l][s] = TableF32Data + GetWTIndex(s, size, n_tables, l);
             this->TableI16WeakPointers[l][s] =
                 TableI16Data + GetWTIndex(s, size, n_tables, l, FIRipolI16_N);
+        }
+    }
 
-            if (this->flags & wtf_is_sample)
-            {
-                for (int i = 0; i < lsize; i++)
+    auto padI16 = [this](int l, int s, int lsize) {
+        memcpy(&this->TableI16WeakPointers[l][s][lsize + FIRoffsetI16],
+               &this->TableI16WeakPointers[l][s][FIRoffsetI16], FIRoffsetI16 * sizeof(short));
+        memcpy(&this->TableI16WeakPointers[l][s][0], &this->TableI16WeakPointers[l][s][lsize],
+               FIRoffsetI16 * sizeof(short));
+    };
+
+    if (this->flags & wtf_is_sample)
+    {
+        // Sample frames filter across their neighbours, so each level waits for the one before
+        for (int l = 1; l < levels; l++)
+        {
+            int psize = size >> (l - 1);
+            int lsize = size >> l;
+
+            forEachFrameRange(parallel, ns, (size_t)ns * lsize * hr_filter_size, [&](int b, int e) {
+                for (int s = b; s < e; s++)
                 {
-                    this->TableF32WeakPointers[l][s][i] = 0;
-                    for (int a = 0; a < filter_size; a++)
+                    for (int i = 0; i < lsize; i++)
                     {
-                        int srcindex = (i << 1) + a - filter_id_of;
-                        int srctable = max(0, s + (srcindex / psize));
-                        srcindex = srcindex & (psize - 1);
-                        if (srctable < ns)
-                            this->TableF32WeakPointers[l][s][i] +=
-                                hrfilter[a] * this->TableF32WeakPointers[l - 1][srctable][srcindex];
+                        this->TableF32WeakPointers[l][s][i] = 0;
+                        for (int a = 0; a < hr_filter_size; a++)
+                        {
+                            int srcindex = (i << 1) + a - hr_filter_id_of;
+                            int srctable = max(0, s + (srcindex / psize));
+                            srcindex = srcindex & (psize - 1);
+                            if (srctable < ns)
+                                this->TableF32WeakPointers[l][s][i] +=
+                                    hrfilter[a] *
+                                    this->TableF32WeakPointers[l - 1][srctable][srcindex];
+                        }
+                        this->TableI16WeakPointers[l][s][i + FIRoffsetI16] =
+                            0; // not supported in int16 atm
                     }
-                    this->TableI16WeakPointers[l][s][i + FIRoffsetI16] =
-                        0; // not supported in int16 atm
+                    padI16(l, s, lsize);
                 }
-            }
-            else
+            });
+        }
+    }
+    else
+    {
+        // Wavetable frames wrap on themselves, so every frame runs its whole mip chain alone
+        forEachFrameRange(parallel, ns, (size_t)ns * size * hr_filter_size, [&](int b, int e) {
+            std::vector<float> scratchF32;
+            std::vector<short> scratchI16;
+            for (int s = b; s < e; s++)
             {
-                for (int i = 0; i < lsize; i++)
+                for (int l = 1; l < levels; l++)
                 {
-                    this->TableF32WeakPointers[l][s][i] = 0;
-                    for (int a = 0; a < filter_size; a++)
-                    {
-                        this->TableF32WeakPointers[l][s][i] +=
-                            hrfilter[a] * this->TableF32WeakPointers[l - 1][s][(
-                                              ((i << 1) + a - filter_id_of) & (psize - 1))];
-                    }
-                    int ival = 0;
-                    for (int a = 0; a < filter_size; a++)
-                    {
-                        ival += HRFilterI16[a] *
-                                this->TableI16WeakPointers[l - 1][s]
-                                                          [(((i << 1) + a - 31) & (psize - 1)) +
-                                                           FIRoffsetI16];
-                    }
-                    this->TableI16WeakPointers[l][s][i + FIRoffsetI16] = ival >> 16;
+                    int psize = size >> (l - 1);
+                    int lsize = size >> l;
+
+                    decimateFrameF32(this->TableF32WeakPointers[l - 1][s],
+                                     this->TableF32WeakPointers[l][s], psize, scratchF32);
+                    decimateFrameI16(&this->TableI16WeakPointers[l - 1][s][FIRoffsetI16],
+                                     &this->TableI16WeakPointers[l][s][FIRoffsetI16], psize,
+                                     scratchI16);
+                    padI16(l, s, lsize);
                 }
             }
-            // float2i16_block(this->TableF32WeakPointers[l][s],this->TableI16WeakPointers[l][s],lsize);
-            memcpy(&this->TableI16WeakPointers[l][s][lsize + FIRoffsetI16],
-                   &this->TableI16WeakPointers[l][s][FIRoffsetI16], FIRoffsetI16 * sizeof(short));
-            memcpy(&this->TableI16WeakPointers[l][s][0], &this->TableI16WeakPointers[l][s][lsize],
-                   FIRoffsetI16 * sizeof(short));
-        }
-        // fwrite(this->TableI16WeakPointers[l][0],lsize*sizeof(short),1,F);
+        });
     }
-    // fclose(F);
 
     // TODO I16 mipmaps end up out of phase
     // The click/knot/bug probably results from the fact that there is no padding in the beginning,
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 const int max_wtable_size = 4096;
 const int max_subtables = 512;
@@ -9,6 +10,11 @@ const int max_mipmap_levels = 16;
 const int max_wtable_samples = 2097152;
 // const int max_wtable_samples =  268000; // delay pops 4 uses the most
 
+// the halfband taps MipMapWT decimates each level with, in float and in int16; the int16 table
+// carries a 64th tap (HRFilterI16[63] == 1) which MipMapWT leaves out, using the first 63 of both
+extern const float hrfilter[63];
+extern const int HRFilterI16[64];
+
 #pragma pack(push, 1)
 struct wt_header
 {
@@ -25,8 +31,14 @@ class Wavetable
     Wavetable();
     ~Wavetable();
     void Copy(Wavetable *wt);
-    bool BuildWT(void *wdata, wt_header &wh, bool AppendSilence);
-    void MipMapWT();
+    // parallelMips spreads large mip builds over a worker pool and waits for it, so pass false
+    // on the audio thread
+    bool BuildWT(void *wdata, wt_header &wh, bool AppendSilence, bool parallelMips = true);
+    void MipMapWT(bool parallel = true);
+
+    // Swap the built table data and layout with built. Loaders build into a scratch
+    // Wavetable without any lock and only hold waveTableDataMutex around this call.
+    void publish(Wavetable &built);
 
     void allocPointers(size_t newSize);
 
@@ -44,6 +56,10 @@ class Wavetable
     float *TableF32Data;
     short *TableI16Data;
 
+    // Changes whenever this table's contents do (publish and Copy), for keying caches of
+    // anything drawn from it
+    uint64_t generation;
+
     int current_id, queue_id;
     bool refresh_display;
     char queue_filename[256];
@@ -372,8 +372,7 @@ template <bool is_init> void WavetableOscillator::update_lagvals()
     }
 }
 
-void WavetableOscillator::process_block(float pitch0, float drift, bool stereo, bool FM,
-                                        float depth)
+void WavetableOscillator::fill_block(float pitch0, float drift, bool stereo, bool FM, float depth)
 {
     pitch_last = pitch_t;
     pitch_t = min(148.f, pitch0);
@@ -472,6 +471,12 @@ void WavetableOscillator::process_block(float pitch0, float drift, bool stereo,
             oscstate[l] -= a;
         }
     }
+}
+
+void WavetableOscillator::process_block(float pitch0, float drift, bool stereo, bool FM,
+                                        float depth)
+{
+    fill_block(pitch0, drift, stereo, FM, depth);
 
     float hpfblock alignas(16)[BLOCK_SIZE_OS];
     li_hpf.store_block(hpfblock, BLOCK_SIZE_OS_QUAD);
@@ -493,6 +498,11 @@ void WavetableOscillator::process_block(float pitch0, float drift, bool stereo,
         }
     }
 
+    advance_block(stereo);
+}
+
+void WavetableOscillator::advance_block(bool stereo)
+{
     clear_block(&oscbuffer[bufpos], BLOCK_SIZE_OS_QUAD);
     if (stereo)
         clear_block(&oscbufferR[bufpos], BLOCK_SIZE_OS_QUAD);
@@ -520,3 +530,99 @@ void WavetableOscillator::process_block(float pitch0, float drift, bool stereo,
         }
     }
 }
+
+/*
+ * The convolution is already SIMD over the FIR taps, but the leaky integrator that turns
+ * oscbuffer into output is a serial scalar recursion per voice. Here fill_block runs per voice
+ * and then up to four voices share the lanes of one integrator pass. Each lane does the same
+ * multiply and add process_block does with _ss ops, so output is unchanged.
+ *
+ * The voices' blocks are read and written four samples at a time and transposed into sample
+ * major registers, so the integrator itself only ever touches registers.
+ */
+void WavetableOscillator::process_block_batch(Oscillator **voices, int n, const float *pitch,
+                                              const float *drift, bool stereo, bool FM,
+                                              const float *FMdepth)
+{
+    static const float silence alignas(16)[BLOCK_SIZE_OS] = {};
+
+    for (int b = 0; b < n; b += 4)
+    {
+        WavetableOscillator *lanes[4];
+        int nl = std::min(n - b, 4);
+
+        float hpfblock alignas(16)[4][BLOCK_SIZE_OS];
+        const float *src[4], *srcR[4];
+        float ol alignas(16)[4] = {0.f, 0.f, 0.f, 0.f}, orr alignas(16)[4] = {0.f, 0.f, 0.f, 0.f};
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (i >= nl)
+            {
+                memset(hpfblock[i], 0, sizeof(hpfblock[i]));
+                src[i] = srcR[i] = silence;
+                continue;
+            }
+
+            auto o = static_cast<WavetableOscillator *>(voices[b + i]);
+            lanes[i] = o;
+            o->fill_block(pitch[b + i], drift[b + i], stereo, FM, FMdepth[b + i]);
+            o->li_hpf.store_block(hpfblock[i], BLOCK_SIZE_OS_QUAD);
+            src[i] = &o->oscbuffer[o->bufpos];
+            srcR[i] = &o->oscbufferR[o->bufpos];
+            ol[i] = _mm_cvtss_f32(o->osc_out);
+            orr[i] = _mm_cvtss_f32(o->osc_outR);
+        }
+
+        auto oo = _mm_load_ps(ol);
+        auto ooR = _mm_load_ps(orr);
+
+        for (int k = 0; k < BLOCK_SIZE_OS; k += 4)
+        {
+            __m128 h[4], x[4], xR[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                h[i] = _mm_load_ps(&hpfblock[i][k]);
+                x[i] = _mm_loadu_ps(src[i] + k);
+                if (stereo)
+                    xR[i] = _mm_loadu_ps(srcR[i] + k);
+            }
+            _MM_TRANSPOSE4_PS(h[0], h[1], h[2], h[3]);
+            _MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+
+            for (int j = 0; j < 4; ++j)
+            {
+                oo = _mm_add_ps(_mm_mul_ps(oo, h[j]), x[j]);
+                x[j] = oo;
+            }
+            _MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+            for (int i = 0; i < nl; ++i)
+                _mm_store_ps(&lanes[i]->output[k], x[i]);
+
+            if (stereo)
+            {
+                _MM_TRANSPOSE4_PS(xR[0], xR[1], xR[2], xR[3]);
+                for (int j = 0; j < 4; ++j)
+                {
+                    ooR = _mm_add_ps(_mm_mul_ps(ooR, h[j]), xR[j]);
+                    xR[j] = ooR;
+                }
+                _MM_TRANSPOSE4_PS(xR[0], xR[1], xR[2], xR[3]);
+                for (int i = 0; i < nl; ++i)
+                    _mm_store_ps(&lanes[i]->outputR[k], xR[i]);
+            }
+        }
+
+        _mm_store_ps(ol, oo);
+        _mm_store_ps(orr, ooR);
+
+        for (int i = 0; i < nl; ++i)
+        {
+            auto o = lanes[i];
+            o->osc_out = _mm_move_ss(o->osc_out, _mm_set_ss(ol[i]));
+            if (stereo)
+                o->osc_outR = _mm_move_ss(o->osc_outR, _mm_set_ss(orr[i]));
+            o->advance_block(stereo);
+        }
+    }
+}
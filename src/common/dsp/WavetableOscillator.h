@@ -42,9 +42,16 @@ class WavetableOscillator : public AbstractBlitOscillator
     virtual void init_default_values() override;
     virtual void process_block(float pitch, float drift = 0.f, bool stereo = false, bool FM = false,
                                float FMdepth = 0.f) override;
+    virtual void process_block_batch(Oscillator **voices, int n, const float *pitch,
+                                     const float *drift, bool stereo, bool FM,
+                                     const float *FMdepth) override;
     virtual ~WavetableOscillator();
 
   private:
+    // process_block is fill_block (lag updates and convolution into oscbuffer), then the
+    // integrator into output, then advance_block. The batch path shares the integrator.
+    void fill_block(float pitch, float drift, bool stereo, bool FM, float FMdepth);
+    void advance_block(bool stereo);
     void convolute(int voice, bool FM, bool stereo);
     template <bool is_init> void update_lagvals();
     inline float distort_level(float);
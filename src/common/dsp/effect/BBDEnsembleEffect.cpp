@@ -190,11 +190,13 @@ void BBDEnsembleEffect::process_sinc_delays(float *dataL, float *dataR, float de
         float rtap1 = t2;
         float rtap2 = t3;
 
+        using Delay = SSESincDelayLine<8192>;
+        const Delay *lines[4] = {&delL, &delL, &delR, &delR};
+        float taps alignas(16)[4] = {ltap1, ltap2, rtap1, rtap2};
+        auto delayOutsVec = Delay::readTaps<Delay::SINC>(lines, taps);
+
         float delayOuts alignas(16)[4];
-        delayOuts[0] = delL.read(ltap1);
-        delayOuts[1] = delL.read(ltap2);
-        delayOuts[2] = delR.read(rtap1);
-        delayOuts[3] = delR.read(rtap2);
+        _mm_store_ps(delayOuts, delayOutsVec);
 
         fbStateL = fbGain * (delayOuts[0] + delayOuts[1]);
         fbStateR = fbGain * (delayOuts[1] + delayOuts[2]);
@@ -202,7 +204,6 @@ void BBDEnsembleEffect::process_sinc_delays(float *dataL, float *dataR, float de
         dc_blocker[0].process_sample_nolag(fbStateL, fbStateR);
         dc_blocker[1].process_sample_nolag(fbStateL, fbStateR);
 
-        auto delayOutsVec = vLoad(delayOuts);
         auto waveshaperOutsVec = bbd_saturation_sse.processSample(delayOutsVec);
 
         float waveshaperOuts alignas(16)[4];
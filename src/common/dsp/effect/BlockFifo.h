@@ -0,0 +1,76 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#pragma once
+
+#include "globals.h"
+#include "vt_dsp/basic_dsp.h"
+
+#include <cstring>
+
+/*
+ * Lets effects which work in BLOCK_SIZE blocks run under hosts which hand over any number of
+ * samples. Stereo audio (and an optional stereo sidechain) goes into in and side; once a
+ * block is full it is copied to out and the block function processes out in place. Audio
+ * comes out exactly latency samples after it went in, whatever the host buffer sizes.
+ */
+class BlockFifo
+{
+  public:
+    static constexpr int latency = BLOCK_SIZE;
+
+    float in alignas(16)[2][BLOCK_SIZE], out alignas(16)[2][BLOCK_SIZE];
+    float side alignas(16)[2][BLOCK_SIZE];
+
+    BlockFifo() { reset(); }
+
+    void reset()
+    {
+        memset(in, 0, sizeof(in));
+        memset(out, 0, sizeof(out));
+        memset(side, 0, sizeof(side));
+        pos = 0;
+    }
+
+    // L and R are processed in place. sideL and sideR may be null.
+    template <typename F>
+    void process(float *L, float *R, const float *sideL, const float *sideR, int n, F block)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            in[0][pos] = L[i];
+            in[1][pos] = R[i];
+            if (sideL && sideR)
+            {
+                side[0][pos] = sideL[i];
+                side[1][pos] = sideR[i];
+            }
+
+            L[i] = out[0][pos];
+            R[i] = out[1][pos];
+
+            if (++pos == BLOCK_SIZE)
+            {
+                copy_block(in[0], out[0], BLOCK_SIZE_QUAD);
+                copy_block(in[1], out[1], BLOCK_SIZE_QUAD);
+                block();
+                pos = 0;
+            }
+        }
+    }
+
+  private:
+    int pos = 0;
+};
@@ -18,6 +18,7 @@
 #include "BiquadFilter.h"
 #include "DspUtilities.h"
 #include "AllpassFilter.h"
+#include "SSESincDelayLine.h"
 
 #include "VectorizedSvfFilter.h"
 
@@ -27,9 +28,8 @@
 template <int v> class ChorusEffect : public Effect
 {
     lipol_ps feedback alignas(16), mix alignas(16), width alignas(16);
-    __m128 voicepanL4 alignas(16)[v], voicepanR4 alignas(16)[v];
-    float buffer alignas(16)[max_delay_length + FIRipol_N]; // Includes padding so we can use SSE
-                                                            // interpolation without wrapping
+    float voicepanL alignas(16)[v], voicepanR alignas(16)[v];
+    SSESincDelayLine<max_delay_length> delay;
 
   public:
     enum chorus_params
@@ -65,7 +65,6 @@ template <int v> class ChorusEffect : public Effect
     lag<float, true> time[v];
     float voicepan[v][2];
     float envf;
-    int wpos;
     BiquadFilter lp, hp;
     double lfophase[v];
 };
@@ -20,8 +20,7 @@ template <int v> ChorusEffect<v>::~ChorusEffect() {}
 
 template <int v> void ChorusEffect<v>::init()
 {
-    memset(buffer, 0, (max_delay_length + FIRipol_N) * sizeof(float));
-    wpos = 0;
+    delay.clear();
     envf = 0;
     const float gainscale = 1 / sqrt((float)v);
 
@@ -34,8 +33,8 @@ template <int v> void ChorusEffect<v>::init()
         x = 2.f * x - 1.f;
         voicepan[i][0] = sqrt(0.5 - 0.5 * x) * gainscale;
         voicepan[i][1] = sqrt(0.5 + 0.5 * x) * gainscale;
-        voicepanL4[i] = _mm_set1_ps(voicepan[i][0]);
-        voicepanR4[i] = _mm_set1_ps(voicepan[i][1]);
+        voicepanL[i] = voicepan[i][0];
+        voicepanR[i] = voicepan[i][1];
     }
 
     setvars(true);
@@ -87,28 +86,28 @@ template <int v> void ChorusEffect<v>::process(float *dataL, float *dataR)
     clear_block(tbufferL, BLOCK_SIZE_QUAD);
     clear_block(tbufferR, BLOCK_SIZE_QUAD);
 
+    static_assert(v % 4 == 0, "the chorus reads its voices four at a time");
+    using Delay = SSESincDelayLine<max_delay_length>;
+
     for (int k = 0; k < BLOCK_SIZE; k++)
     {
         __m128 L = _mm_setzero_ps(), R = _mm_setzero_ps();
+        float dtime alignas(16)[v];
 
         for (int j = 0; j < v; j++)
         {
             time[j].process();
-            float vtime = time[j].v;
-            int i_dtime = max(BLOCK_SIZE, min((int)vtime, max_delay_length - FIRipol_N - 1));
-            int rp = ((wpos - i_dtime + k) - FIRipol_N) & (max_delay_length - 1);
-            int sinc = FIRipol_N * limit_range((int)(FIRipol_M * (float(i_dtime + 1) - vtime)), 0,
-                                               FIRipol_M - 1);
-
-            __m128 vo;
-            vo = _mm_mul_ps(_mm_load_ps(&sinctable1X[sinc]), _mm_loadu_ps(&buffer[rp]));
-            vo = _mm_add_ps(
-                vo, _mm_mul_ps(_mm_load_ps(&sinctable1X[sinc + 4]), _mm_loadu_ps(&buffer[rp + 4])));
-            vo = _mm_add_ps(
-                vo, _mm_mul_ps(_mm_load_ps(&sinctable1X[sinc + 8]), _mm_loadu_ps(&buffer[rp + 8])));
-
-            L = _mm_add_ps(L, _mm_mul_ps(vo, voicepanL4[j]));
-            R = _mm_add_ps(R, _mm_mul_ps(vo, voicepanR4[j]));
+            float vtime = limit_range(time[j].v, (float)BLOCK_SIZE,
+                                      (float)(max_delay_length - FIRipol_N - 1));
+            // this block is written after it is read, so sample k is k samples nearer the write
+            dtime[j] = vtime + FIRoffset - k;
+        }
+
+        for (int j = 0; j < v; j += 4)
+        {
+            __m128 vo = delay.template readTaps<Delay::SINC_1X>(&dtime[j]);
+            L = _mm_add_ps(L, _mm_mul_ps(vo, _mm_load_ps(&voicepanL[j])));
+            R = _mm_add_ps(R, _mm_mul_ps(vo, _mm_load_ps(&voicepanR[j])));
         }
         L = sum_ps_to_ss(L);
         R = sum_ps_to_ss(R);
@@ -132,22 +131,8 @@ template <int v> void ChorusEffect<v>::process(float *dataL, float *dataR)
     accumulate_block(dataL, fbblock, BLOCK_SIZE_QUAD);
     accumulate_block(dataR, fbblock, BLOCK_SIZE_QUAD);
 
-    if (wpos + BLOCK_SIZE >= max_delay_length)
-    {
-        for (int k = 0; k < BLOCK_SIZE; k++)
-        {
-            buffer[(wpos + k) & (max_delay_length - 1)] = fbblock[k];
-        }
-    }
-    else
-    {
-        copy_block(fbblock, &buffer[wpos], BLOCK_SIZE_QUAD);
-    }
-
-    if (wpos == 0)
-        for (int k = 0; k < FIRipol_N; k++)
-            buffer[k + max_delay_length] =
-                buffer[k]; // copy buffer so FIR-core doesn't have to wrap
+    for (int k = 0; k < BLOCK_SIZE; k++)
+        delay.write(fbblock[k]);
 
     // scale width
     float M alignas(16)[BLOCK_SIZE], S alignas(16)[BLOCK_SIZE];
@@ -156,9 +141,6 @@ template <int v> void ChorusEffect<v>::process(float *dataL, float *dataR)
     decodeMS(M, S, tbufferL, tbufferR, BLOCK_SIZE_QUAD);
 
     mix.fade_2_blocks_to(dataL, tbufferL, dataR, tbufferR, dataL, dataR, BLOCK_SIZE_QUAD);
-
-    wpos += BLOCK_SIZE;
-    wpos = wpos & (max_delay_length - 1);
 }
 
 template <int v> void ChorusEffect<v>::suspend() { init(); }
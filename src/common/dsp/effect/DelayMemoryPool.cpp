@@ -0,0 +1,224 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#include "DelayMemoryPool.h"
+#include "globals.h"
+
+#include <chrono>
+#include <cstring>
+
+DelayMemoryPool::DelayMemoryPool()
+{
+    worker = std::thread([this]() { run(); });
+}
+
+DelayMemoryPool::~DelayMemoryPool()
+{
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    worker.join();
+
+    std::lock_guard<std::mutex> g(mutex);
+    drain();
+    for (auto &s : sizes)
+        _aligned_free(s.first);
+    for (auto &f : freeBlocks)
+        _aligned_free(f.second);
+}
+
+float *DelayMemoryPool::allocate(size_t n)
+{
+    std::lock_guard<std::mutex> g(mutex);
+    return allocateLocked(n);
+}
+
+void DelayMemoryPool::release(float *p)
+{
+    if (!p)
+        return;
+
+    std::lock_guard<std::mutex> g(mutex);
+    releaseLocked(p);
+}
+
+float *DelayMemoryPool::allocateLocked(size_t n)
+{
+    // aligned_alloc wants a multiple of the alignment
+    size_t bytes = ((n * sizeof(float) + 15) / 16) * 16;
+    float *res = nullptr;
+
+    auto it = freeBlocks.find(bytes);
+    if (it != freeBlocks.end())
+    {
+        res = it->second;
+        freeBlocks.erase(it);
+        cached -= bytes;
+    }
+    else
+    {
+        res = (float *)_aligned_malloc(bytes, 16);
+        if (!res)
+            return nullptr;
+    }
+
+    // this also faults the pages in, here rather than on the audio thread
+    memset(res, 0, bytes);
+    sizes[res] = bytes;
+    inUse += bytes;
+    return res;
+}
+
+void DelayMemoryPool::releaseLocked(float *p)
+{
+    auto it = sizes.find(p);
+    if (it == sizes.end())
+        return;
+
+    auto bytes = it->second;
+    sizes.erase(it);
+    inUse -= bytes;
+
+    if (cached + bytes <= maxCachedBytes)
+    {
+        freeBlocks.emplace(bytes, p);
+        cached += bytes;
+    }
+    else
+    {
+        _aligned_free(p);
+    }
+}
+
+bool DelayMemoryPool::push(const Op &op)
+{
+    int h = opHead.load(std::memory_order_relaxed);
+    int next = (h + 1) % opCapacity;
+    if (next == opTail.load(std::memory_order_acquire))
+        return false;
+    ops[h] = op;
+    opHead.store(next, std::memory_order_release);
+    return true;
+}
+
+bool DelayMemoryPool::flushRetired(Growth &g)
+{
+    if (g.retired && push({nullptr, 0, g.retired}))
+        g.retired = nullptr;
+    return !g.retired;
+}
+
+void DelayMemoryPool::request(Growth &g, size_t n)
+{
+    if (g.pending || !flushRetired(g))
+        return;
+
+    g.pending = true;
+    if (!push({&g, n, nullptr}))
+    {
+        // the helper is behind; the effect asks again next block
+        g.pending = false;
+    }
+}
+
+float *DelayMemoryPool::collect(Growth &g, size_t &n)
+{
+    // adopting a block retires the old one, so wait until there is room for it
+    if (!flushRetired(g))
+        return nullptr;
+
+    auto *res = g.block.exchange(nullptr);
+    if (res)
+        n = g.size;
+    return res;
+}
+
+void DelayMemoryPool::releaseLater(Growth &g, float *p)
+{
+    if (!p)
+        return;
+
+    // collect hands out nothing while g.retired is taken, so it is free here
+    if (!push({nullptr, 0, p}))
+        g.retired = p;
+}
+
+void DelayMemoryPool::cancel(Growth &g)
+{
+    // nothing queued or waiting for g, so no need to take the lock
+    if (!g.pending && !g.block.load() && !g.retired)
+        return;
+
+    std::lock_guard<std::mutex> lg(mutex);
+    // anything for g still queued is serviced now, so nothing refers to it after this
+    drain();
+    auto *p = g.block.exchange(nullptr);
+    if (p)
+        releaseLocked(p);
+    if (g.retired)
+        releaseLocked(g.retired);
+    g.retired = nullptr;
+    g.pending = false;
+}
+
+void DelayMemoryPool::carryHistory(float *to, int toRows, const float *from, int fromRows,
+                                   int pos, int rowWidth)
+{
+    for (int i = 1; i <= fromRows; i++)
+    {
+        int p = pos - i;
+        memcpy(&to[(p & (toRows - 1)) * rowWidth], &from[(p & (fromRows - 1)) * rowWidth],
+               rowWidth * sizeof(float));
+    }
+}
+
+void DelayMemoryPool::drain()
+{
+    int t = opTail.load(std::memory_order_relaxed);
+    while (t != opHead.load(std::memory_order_acquire))
+    {
+        auto op = ops[t];
+        t = (t + 1) % opCapacity;
+        opTail.store(t, std::memory_order_release);
+
+        if (op.release)
+            releaseLocked(op.release);
+
+        if (op.grow)
+        {
+            auto *p = allocateLocked(op.size);
+            op.grow->size = op.size;
+            auto *old = op.grow->block.exchange(p);
+            if (old)
+                releaseLocked(old);
+            op.grow->pending = false;
+        }
+    }
+}
+
+void DelayMemoryPool::run()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> g(mutex);
+        // the audio thread doesn't signal, so poll
+        cv.wait_for(g, std::chrono::milliseconds(10), [this]() { return stopping; });
+        if (stopping)
+            return;
+        drain();
+    }
+}
@@ -0,0 +1,114 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Delay line memory for the effects of one synth, so a delay or reverb holds what its sample
+ * rate and delay times need rather than a worst case array inside the effect.
+ *
+ * Effects allocate their initial lines in Effect::allocate_memory, sized from the parameters
+ * they start with. When a later change needs a longer line, or an effect was spawned without
+ * allocate_memory, its process asks for a Growth; a helper thread allocates and zeroes it and
+ * the effect collects it on a later block, clamping its delay to what it has until then.
+ * Released blocks are kept and handed out again to the next request of the same size.
+ */
+class DelayMemoryPool
+{
+  public:
+    DelayMemoryPool();
+    ~DelayMemoryPool();
+
+    // A zeroed, 16 byte aligned block of n floats. Not for the audio thread.
+    float *allocate(size_t n);
+    // Return a block from allocate or collect (nullptr is fine). Not for the audio thread.
+    void release(float *p);
+
+    struct Growth
+    {
+        std::atomic<float *> block{nullptr};
+        std::atomic<size_t> size{0};
+        std::atomic<bool> pending{false};
+        // a block releaseLater couldn't queue yet, only touched by the audio thread
+        float *retired{nullptr};
+    };
+
+    /*
+     * The audio thread side, and only for the audio thread: the queue to the helper has a
+     * single producer. request asks the helper for a block of n floats for g and collect
+     * returns it (and its size in n) once it is there, else nullptr. releaseLater returns a
+     * block without freeing on the calling thread; if the queue is full g keeps it and the next
+     * request or collect queues it again. None of these block, allocate or free.
+     *
+     * The owner of a Growth calls cancel, off the audio thread, before destroying it.
+     */
+    void request(Growth &g, size_t n);
+    float *collect(Growth &g, size_t &n);
+    void releaseLater(Growth &g, float *p);
+    void cancel(Growth &g);
+
+    /*
+     * Copy the fromRows rows of rowWidth floats before pos in the ring from to the ring to of
+     * toRows rows. Both are powers of two, so the write position keeps its place and the
+     * history lands where the longer ring reads it.
+     */
+    static void carryHistory(float *to, int toRows, const float *from, int fromRows, int pos,
+                             int rowWidth);
+
+    // bytes handed out and not released, and bytes held for reuse
+    size_t bytesInUse() const { return inUse; }
+    size_t bytesCached() const { return cached; }
+
+  private:
+    struct Op
+    {
+        Growth *grow;
+        size_t size;
+        float *release;
+    };
+
+    bool push(const Op &op);
+    bool flushRetired(Growth &g);
+    void drain(); // with mutex held
+    float *allocateLocked(size_t n);
+    void releaseLocked(float *p);
+    void run();
+
+    // blocks beyond this are freed rather than kept for reuse
+    static constexpr size_t maxCachedBytes = 16 * 1024 * 1024;
+
+    std::unordered_map<float *, size_t> sizes;
+    std::multimap<size_t, float *> freeBlocks;
+    std::atomic<size_t> inUse{0}, cached{0};
+
+    // single producer (the audio thread), drained under the mutex
+    static constexpr int opCapacity = 64;
+    Op ops[opCapacity];
+    std::atomic<int> opHead{0}, opTail{0};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::thread worker;
+};
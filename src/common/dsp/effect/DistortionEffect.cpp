@@ -1,18 +1,15 @@
 #include "DistortionEffect.h"
-#include <vt_dsp/halfratefilter.h>
 #include "QuadFilterUnit.h"
 
 // feedback can get tricky with packed SSE
 
-const int dist_OS_bits = 2;
-const int distortion_OS = 1 << dist_OS_bits;
+const int dist_OS_bits = 2; // unless the slot asks for another fx_oversampling
 
 DistortionEffect::DistortionEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
-    : Effect(storage, fxdata, pd), band1(storage), band2(storage), lp1(storage), lp2(storage),
-      hr_a(3, false), hr_b(3, true)
+    : Effect(storage, fxdata, pd), band1(storage), band2(storage), lp1(storage), lp2(storage)
 {
-    lp1.setBlockSize(BLOCK_SIZE * distortion_OS);
-    lp2.setBlockSize(BLOCK_SIZE * distortion_OS);
+    lp1.setBlockSize(BLOCK_SIZE << dist_OS_bits);
+    lp2.setBlockSize(BLOCK_SIZE << dist_OS_bits);
     drive.set_blocksize(BLOCK_SIZE);
     outgain.set_blocksize(BLOCK_SIZE);
 }
@@ -26,6 +23,8 @@ void DistortionEffect::init()
     band2.suspend();
     lp1.suspend();
     lp2.suspend();
+    os.setOSFactor(oversampling_bits(dist_OS_bits));
+    os.reset();
     bi = 0.f;
     L = 0.f;
     R = 0.f;
@@ -54,8 +53,10 @@ void DistortionEffect::setvars(bool init)
                            pregain);
         band2.coeff_peakEQ(band2.calc_omega(*f[dist_posteq_freq] / 12.f), *f[dist_posteq_bw],
                            postgain);
-        lp1.coeff_LP2B(lp1.calc_omega((*f[dist_preeq_highcut] / 12.0) - 2.f), 0.707);
-        lp2.coeff_LP2B(lp2.calc_omega((*f[dist_posteq_highcut] / 12.0) - 2.f), 0.707);
+        // the lowpasses run oversampled, so are an octave lower per factor of two
+        int osBits = os.getOSFactor();
+        lp1.coeff_LP2B(lp1.calc_omega((*f[dist_preeq_highcut] / 12.0) - osBits), 0.707);
+        lp2.coeff_LP2B(lp2.calc_omega((*f[dist_posteq_highcut] / 12.0) - osBits), 0.707);
         lp1.coeff_instantize();
         lp2.coeff_instantize();
     }
@@ -64,6 +65,13 @@ void DistortionEffect::setvars(bool init)
 void DistortionEffect::process(float *dataL, float *dataR)
 {
     // TODO fix denormals!
+    int osBits = oversampling_bits(dist_OS_bits);
+    if (osBits != os.getOSFactor())
+    {
+        os.setOSFactor(osBits);
+        bi = 0; // for the lowpass coefficients
+    }
+
     if (bi == 0)
         setvars(false);
     bi = (bi + 1) & slowrate_m1;
@@ -78,21 +86,20 @@ void DistortionEffect::process(float *dataL, float *dataR)
     if (ws < 0 || ws >= n_ws_types)
         ws = 0;
 
-    float bL alignas(16)[BLOCK_SIZE << dist_OS_bits];
-    float bR alignas(16)[BLOCK_SIZE << dist_OS_bits];
-    assert(dist_OS_bits == 2);
+    float *bL = os.leftUp, *bR = os.rightUp;
+    const int osRatio = os.getOSRatio();
 
     drive.multiply_2_blocks(dataL, dataR, BLOCK_SIZE_QUAD);
 
     bool useSSEShaper = (ws + wst_soft == wst_digital || ws + wst_soft == wst_sine);
 
-    auto wsop = GetQFPtrWaveshaper(wst_soft + ws);
+    auto wsop = GetQFPtrWaveshaper(wst_soft + ws, storage->getPatch().tableLookupWaveshapers);
 
     float dD = 0.f;
     float dNow = dS;
     if (useSSEShaper)
     {
-        dD = (dE - dS) / (BLOCK_SIZE * dist_OS_bits);
+        dD = (dE - dS) / (BLOCK_SIZE << osBits);
     }
 
     for (int k = 0; k < BLOCK_SIZE; k++)
@@ -100,7 +107,7 @@ void DistortionEffect::process(float *dataL, float *dataR)
         float a = (k & 16) ? 0.00000001 : -0.00000001; // denormal thingy
         float Lin = dataL[k];
         float Rin = dataR[k];
-        for (int s = 0; s < distortion_OS; s++)
+        for (int s = 0; s < osRatio; s++)
         {
             L = Lin + fb * L;
             R = Rin + fb * R;
@@ -139,15 +146,14 @@ void DistortionEffect::process(float *dataL, float *dataR)
                 lp2.process_sample_nolag(L, R);
             }
 
-            bL[s + (k << dist_OS_bits)] = L;
-            bR[s + (k << dist_OS_bits)] = R;
+            bL[s + (k << osBits)] = L;
+            bR[s + (k << osBits)] = R;
         }
     }
 
-    hr_a.process_block_D2(bL, bR, 128);
-    hr_b.process_block_D2(bL, bR, 64);
+    os.downsample(dataL, dataR);
 
-    outgain.multiply_2_blocks_to(bL, bR, dataL, dataR, BLOCK_SIZE_QUAD);
+    outgain.multiply_2_blocks(dataL, dataR, BLOCK_SIZE_QUAD);
 
     band2.process_block(dataL, dataR);
 }
@@ -20,13 +20,14 @@
 #include "AllpassFilter.h"
 
 #include "VectorizedSvfFilter.h"
+#include "Oversampling.h"
 
-#include <vt_dsp/halfratefilter.h>
 #include <vt_dsp/lipol.h>
 
 class DistortionEffect : public Effect
 {
-    HalfRateFilter hr_a alignas(16), hr_b alignas(16);
+    // the stage down to the base rate is steep; the samples are held rather than upsampled
+    Oversampling<3, BLOCK_SIZE, 3, false, true> os;
     lipol_ps drive alignas(16), outgain alignas(16);
 
   public:
@@ -9,14 +9,96 @@ DualDelayEffect::DualDelayEffect(SurgeStorage *storage, FxStorage *fxdata, pdata
     pan.set_blocksize(BLOCK_SIZE);
     feedback.set_blocksize(BLOCK_SIZE);
     crossfeed.set_blocksize(BLOCK_SIZE);
+
+    buffer[0] = buffer[1] = nullptr;
+    delay_length = 0;
+}
+
+void DualDelayEffect::allocate_memory()
+{
+    if (buffer[0])
+        return;
+
+    // Long enough for the times we start with and never less than a second. Modulation or a
+    // later change past that grows the lines from process.
+    auto isLinked = fxdata->p[dly_time_right].deactivated ? dly_time_left : dly_time_right;
+    float longest = samplerate;
+    for (auto id : {dly_time_left, isLinked})
+    {
+        float t = (fxdata->p[id].temposync ? storage->temposyncratio_inv : 1.f) *
+                  storage->note_to_pitch_ignoring_tuning(12 * fxdata->p[id].val.f);
+        longest = max(longest, samplerate * t);
+    }
+    delay_length = lengthFor(longest);
+    buffer[0] = storage->delayMemory->allocate(2 * (delay_length + FIRipol_N));
+    buffer[1] = buffer[0] + delay_length + FIRipol_N;
+}
+
+DualDelayEffect::~DualDelayEffect()
+{
+    storage->delayMemory->cancel(growth);
+    storage->delayMemory->release(buffer[0]);
+}
+
+int DualDelayEffect::lengthFor(float samples)
+{
+    // the interpolator reads FIRipol_N samples behind the delay time
+    int needed = (int)std::min(samples, (float)max_delay_length) + FIRipol_N + 1;
+    int res = 1 << 12;
+    while (res < needed && res < max_delay_length)
+        res <<= 1;
+    return res;
 }
 
-DualDelayEffect::~DualDelayEffect() {}
+void DualDelayEffect::ensureLength(float samples)
+{
+    // never less than allocate_memory would have given us
+    int len = lengthFor(std::max(samples, samplerate));
+    if (len > delay_length)
+        storage->delayMemory->request(growth, 2 * (len + FIRipol_N));
+}
+
+void DualDelayEffect::adoptGrowth()
+{
+    size_t n = 0;
+    auto *block = storage->delayMemory->collect(growth, n);
+    if (!block)
+        return;
+
+    int len = (int)(n / 2) - FIRipol_N;
+    if (len <= delay_length)
+    {
+        storage->delayMemory->releaseLater(growth, block);
+        return;
+    }
+
+    float *grown[2] = {block, block + len + FIRipol_N};
+    for (int c = 0; c < 2; c++)
+    {
+        if (buffer[c])
+            DelayMemoryPool::carryHistory(grown[c], len, buffer[c], delay_length, wpos, 1);
+        for (int k = 0; k < FIRipol_N; k++)
+            grown[c][k + len] = grown[c][k];
+    }
+
+    storage->delayMemory->releaseLater(growth, buffer[0]);
+    buffer[0] = grown[0];
+    buffer[1] = grown[1];
+    delay_length = len;
+}
+
+size_t DualDelayEffect::get_memory_usage()
+{
+    return object_size + 2 * (delay_length + FIRipol_N) * sizeof(float);
+}
 
 void DualDelayEffect::init()
 {
-    memset(buffer[0], 0, (max_delay_length + FIRipol_N) * sizeof(float));
-    memset(buffer[1], 0, (max_delay_length + FIRipol_N) * sizeof(float));
+    if (buffer[0])
+    {
+        memset(buffer[0], 0, (delay_length + FIRipol_N) * sizeof(float));
+        memset(buffer[1], 0, (delay_length + FIRipol_N) * sizeof(float));
+    }
     wpos = 0;
     lfophase = 0.0;
     ringout_time = 100000;
@@ -128,7 +210,21 @@ void DualDelayEffect::setvars(bool init)
 
 void DualDelayEffect::process(float *dataL, float *dataR)
 {
+    adoptGrowth();
     setvars(false);
+    ensureLength(max(timeL.target_v, timeR.target_v));
+
+    if (!buffer[0])
+    {
+        // Silent until the pool delivers our first lines: on a send slot the input is the send,
+        // which must not come back through the return. Fully wet, the empty lines then fade
+        // the dry part in.
+        clear_block(dataL, BLOCK_SIZE_QUAD);
+        clear_block(dataR, BLOCK_SIZE_QUAD);
+        mix.set_target(1.f);
+        mix.instantize();
+        return;
+    }
 
     int k;
     float tbufferL alignas(16)[BLOCK_SIZE], wbL alignas(16)[BLOCK_SIZE]; // wb = write-buffer
@@ -139,11 +235,11 @@ void DualDelayEffect::process(float *dataL, float *dataR)
         timeL.process();
         timeR.process();
 
-        int i_dtimeL = max(BLOCK_SIZE, min((int)timeL.v, max_delay_length - FIRipol_N - 1));
-        int i_dtimeR = max(BLOCK_SIZE, min((int)timeR.v, max_delay_length - FIRipol_N - 1));
+        int i_dtimeL = max(BLOCK_SIZE, min((int)timeL.v, delay_length - FIRipol_N - 1));
+        int i_dtimeR = max(BLOCK_SIZE, min((int)timeR.v, delay_length - FIRipol_N - 1));
 
-        int rpL = ((wpos - i_dtimeL + k) - FIRipol_N) & (max_delay_length - 1);
-        int rpR = ((wpos - i_dtimeR + k) - FIRipol_N) & (max_delay_length - 1);
+        int rpL = ((wpos - i_dtimeL + k) - FIRipol_N) & (delay_length - 1);
+        int rpR = ((wpos - i_dtimeR + k) - FIRipol_N) & (delay_length - 1);
 
         int sincL = FIRipol_N * limit_range((int)(FIRipol_M * (float(i_dtimeL + 1) - timeL.v)), 0,
                                             FIRipol_M - 1);
@@ -184,12 +280,12 @@ void DualDelayEffect::process(float *dataL, float *dataR)
     feedback.MAC_2_blocks_to(tbufferL, tbufferR, wbL, wbR, BLOCK_SIZE_QUAD);
     crossfeed.MAC_2_blocks_to(tbufferL, tbufferR, wbR, wbL, BLOCK_SIZE_QUAD);
 
-    if (wpos + BLOCK_SIZE >= max_delay_length)
+    if (wpos + BLOCK_SIZE >= delay_length)
     {
         for (k = 0; k < BLOCK_SIZE; k++)
         {
-            buffer[0][(wpos + k) & (max_delay_length - 1)] = wbL[k];
-            buffer[1][(wpos + k) & (max_delay_length - 1)] = wbR[k];
+            buffer[0][(wpos + k) & (delay_length - 1)] = wbL[k];
+            buffer[1][(wpos + k) & (delay_length - 1)] = wbR[k];
         }
     }
     else
@@ -202,9 +298,9 @@ void DualDelayEffect::process(float *dataL, float *dataR)
     {
         for (k = 0; k < FIRipol_N; k++)
         {
-            buffer[0][k + max_delay_length] =
+            buffer[0][k + delay_length] =
                 buffer[0][k]; // copy buffer so FIR-core doesn't have to wrap
-            buffer[1][k + max_delay_length] = buffer[1][k];
+            buffer[1][k + delay_length] = buffer[1][k];
         }
     }
 
@@ -217,7 +313,7 @@ void DualDelayEffect::process(float *dataL, float *dataR)
     mix.fade_2_blocks_to(dataL, tbufferL, dataR, tbufferR, dataL, dataR, BLOCK_SIZE_QUAD);
 
     wpos += BLOCK_SIZE;
-    wpos = wpos & (max_delay_length - 1);
+    wpos = wpos & (delay_length - 1);
 }
 
 void DualDelayEffect::suspend() { init(); }
@@ -20,6 +20,7 @@
 #include "AllpassFilter.h"
 
 #include "VectorizedSvfFilter.h"
+#include "DelayMemoryPool.h"
 
 #include <vt_dsp/halfratefilter.h>
 #include <vt_dsp/lipol.h>
@@ -28,12 +29,17 @@ class DualDelayEffect : public Effect
 {
     lipol_ps feedback alignas(16), crossfeed alignas(16), aligpan alignas(16), pan alignas(16),
         mix alignas(16), width alignas(16);
-    float buffer alignas(16)[2][max_delay_length + FIRipol_N];
+
+    // two lines of delay_length + FIRipol_N floats from storage->delayMemory, see ensureLength
+    float *buffer[2];
+    int delay_length;
+    DelayMemoryPool::Growth growth;
 
   public:
     DualDelayEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
     virtual ~DualDelayEffect();
     virtual const char *get_effectname() override { return "dualdelay"; }
+    virtual void allocate_memory() override;
     virtual void init() override;
     virtual void process(float *dataL, float *dataR) override;
     virtual void suspend() override;
@@ -43,6 +49,7 @@ class DualDelayEffect : public Effect
     virtual const char *group_label(int id) override;
     virtual int group_label_ypos(int id) override;
     virtual int get_ringout_decay() override { return ringout_time; }
+    virtual size_t get_memory_usage() override;
 
     virtual void handleStreamingMismatches(int streamingRevision,
                                            int currentSynthStreamingRevision) override;
@@ -64,6 +71,10 @@ class DualDelayEffect : public Effect
     };
 
   private:
+    static int lengthFor(float samples);
+    void ensureLength(float samples);
+    void adoptGrowth();
+
     lag<float, true> timeL, timeR;
     bool inithadtempo;
     float envf;
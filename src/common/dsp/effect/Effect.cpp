@@ -26,6 +26,13 @@
 
 using namespace std;
 
+template <typename T> static Effect *spawn(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
+{
+    auto *res = new T(storage, fxdata, pd);
+    res->object_size = sizeof(T);
+    return res;
+}
+
 Effect *spawn_effect(int id, SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
 {
     // std::cout << "Spawn Effect " << _D(id) << std::endl;
@@ -33,65 +40,85 @@ Effect *spawn_effect(int id, SurgeStorage *storage, FxStorage *fxdata, pdata *pd
     switch (id)
     {
     case fxt_delay:
-        return new DualDelayEffect(storage, fxdata, pd);
+        return spawn<DualDelayEffect>(storage, fxdata, pd);
     case fxt_eq:
-        return new Eq3BandEffect(storage, fxdata, pd);
+        return spawn<Eq3BandEffect>(storage, fxdata, pd);
     case fxt_phaser:
-        return new PhaserEffect(storage, fxdata, pd);
+        return spawn<PhaserEffect>(storage, fxdata, pd);
     case fxt_rotaryspeaker:
-        return new RotarySpeakerEffect(storage, fxdata, pd);
+        return spawn<RotarySpeakerEffect>(storage, fxdata, pd);
     case fxt_distortion:
-        return new DistortionEffect(storage, fxdata, pd);
+        return spawn<DistortionEffect>(storage, fxdata, pd);
     case fxt_reverb:
-        return new Reverb1Effect(storage, fxdata, pd);
+        return spawn<Reverb1Effect>(storage, fxdata, pd);
     case fxt_reverb2:
-        return new Reverb2Effect(storage, fxdata, pd);
+        return spawn<Reverb2Effect>(storage, fxdata, pd);
     case fxt_freqshift:
-        return new FreqshiftEffect(storage, fxdata, pd);
+        return spawn<FreqshiftEffect>(storage, fxdata, pd);
     case fxt_conditioner:
-        return new ConditionerEffect(storage, fxdata, pd);
+        return spawn<ConditionerEffect>(storage, fxdata, pd);
     case fxt_chorus4:
-        return new ChorusEffect<4>(storage, fxdata, pd);
+        return spawn<ChorusEffect<4>>(storage, fxdata, pd);
     case fxt_vocoder:
-        return new VocoderEffect(storage, fxdata, pd);
+        return spawn<VocoderEffect>(storage, fxdata, pd);
     case fxt_flanger:
-        return new FlangerEffect(storage, fxdata, pd);
+        return spawn<FlangerEffect>(storage, fxdata, pd);
     case fxt_ringmod:
-        return new RingModulatorEffect(storage, fxdata, pd);
+        return spawn<RingModulatorEffect>(storage, fxdata, pd);
     case fxt_airwindows:
-        return new AirWindowsEffect(storage, fxdata, pd);
+        return spawn<AirWindowsEffect>(storage, fxdata, pd);
     case fxt_neuron:
-        return new chowdsp::NeuronEffect(storage, fxdata, pd);
+        return spawn<chowdsp::NeuronEffect>(storage, fxdata, pd);
     case fxt_geq11:
-        return new GEQ11Effect(storage, fxdata, pd);
+        return spawn<GEQ11Effect>(storage, fxdata, pd);
     case fxt_resonator:
-        return new ResonatorEffect(storage, fxdata, pd);
+        return spawn<ResonatorEffect>(storage, fxdata, pd);
     case fxt_combulator:
-        return new CombulatorEffect(storage, fxdata, pd);
+        return spawn<CombulatorEffect>(storage, fxdata, pd);
     case fxt_chow:
-        return new chowdsp::CHOWEffect(storage, fxdata, pd);
+        return spawn<chowdsp::CHOWEffect>(storage, fxdata, pd);
     case fxt_nimbus:
-        return new NimbusEffect(storage, fxdata, pd);
+        return spawn<NimbusEffect>(storage, fxdata, pd);
     case fxt_exciter:
-        return new chowdsp::ExciterEffect(storage, fxdata, pd);
+        return spawn<chowdsp::ExciterEffect>(storage, fxdata, pd);
     case fxt_tape:
-        return new chowdsp::TapeEffect(storage, fxdata, pd);
+        return spawn<chowdsp::TapeEffect>(storage, fxdata, pd);
     case fxt_ensemble:
-        return new BBDEnsembleEffect(storage, fxdata, pd);
+        return spawn<BBDEnsembleEffect>(storage, fxdata, pd);
     case fxt_treemonster:
-        return new TreemonsterEffect(storage, fxdata, pd);
+        return spawn<TreemonsterEffect>(storage, fxdata, pd);
     default:
         return 0;
     };
 }
 
+bool fx_type_has_oversampling(int id)
+{
+    switch (id)
+    {
+    case fxt_distortion:
+    case fxt_neuron:
+    case fxt_chow:
+    case fxt_exciter:
+    case fxt_tape:
+        return true;
+    default:
+        return false;
+    }
+}
+
 Effect::Effect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
 {
     // assert(storage);
-    this->fxdata = fxdata;
     this->storage = storage;
-    this->pd = pd;
     ringout = 10000000;
+    bind(fxdata, pd);
+}
+
+void Effect::bind(FxStorage *fxdata, pdata *pd)
+{
+    this->fxdata = fxdata;
+    this->pd = pd;
     if (pd)
     {
         for (int i = 0; i < n_fx_params; i++)
@@ -102,6 +129,23 @@ Effect::Effect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
     }
 }
 
+void *Effect::operator new(size_t sz)
+{
+    void *p = ::operator new(sz);
+    memset(p, 0, sz);
+    return p;
+}
+
+void Effect::operator delete(void *p) { ::operator delete(p); }
+
+int Effect::oversampling_bits(int defaultBits) const
+{
+    auto os = fxdata->type.deform_type;
+    if (os <= fxos_default || os >= n_fx_oversampling)
+        return defaultBits;
+    return os - fxos_1x;
+}
+
 bool Effect::process_ringout(float *dataL, float *dataR, bool indata_present)
 {
     if (indata_present)
@@ -31,8 +31,28 @@ class alignas(16) Effect
     Effect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
     virtual ~Effect() { return; }
 
+    /*
+     * Effects embed their delay lines so can be megabytes. Allocations are zeroed so the pages
+     * are faulted in by the thread which builds the effect (see FxSpawner) rather than by the
+     * first init on the audio thread.
+     */
+    static void *operator new(size_t sz);
+    static void operator delete(void *p);
+
+    // Point the effect at the FxStorage and parameter data it runs with. FxSpawner builds
+    // effects against a private copy and loadFx binds them to the patch.
+    void bind(FxStorage *fxdata, pdata *pd);
+
     virtual const char *get_effectname() { return 0; }
 
+    /*
+     * Effects with delay lines take them from storage->delayMemory here, not in their
+     * constructor, which also runs for throwaway instances and on the audio thread. FxSpawner
+     * calls this on its helper thread before init, as does anyone spawning an effect to run
+     * off the audio thread. An effect which never got its memory asks the pool's helper for it
+     * from process and is silent until it arrives.
+     */
+    virtual void allocate_memory() {}
     virtual void init(){};
     virtual void init_ctrltypes();
     virtual void init_default_values(){};
@@ -61,6 +81,11 @@ class alignas(16) Effect
     // virtual void processSSE3(float *dataL, float *dataR){ return; }
     // virtual void processT<int architecture>(float *dataL, float *dataR){ return; }
     virtual void suspend() { return; }
+
+    // Bytes this effect holds: the object as spawned plus any delay lines it allocated
+    virtual size_t get_memory_usage() { return object_size; }
+    size_t object_size = 0; // set by spawn_effect
+
     float vu[KNumVuSlots]; // stereo pairs, just use every other when mono
 
     virtual void handleStreamingMismatches(int streamingRevision, int currentSynthStreamingRevision)
@@ -76,6 +101,9 @@ class alignas(16) Effect
     }
 
   protected:
+    // log2 of the oversampling the slot asks for, or defaultBits if it leaves it to the effect
+    int oversampling_bits(int defaultBits) const;
+
     SurgeStorage *storage;
     FxStorage *fxdata;
     pdata *pd;
@@ -92,3 +120,5 @@ const int slowrate = 8;
 const int slowrate_m1 = slowrate - 1;
 
 Effect *spawn_effect(int id, SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
+// Whether the effect takes its oversampling from its slot's fx_oversampling
+bool fx_type_has_oversampling(int id);
@@ -191,9 +191,9 @@ void FlangerEffect::process(float *dataL, float *dataR)
             // OK so biggest tap = delaybase[c][i].v * ( 1.0 + lfoval[c][i].v * depth.v ) + 1;
             // Assume lfoval is [-1,1] and depth is known
             float maxtap = nv * (1.0 + depth_val) + 1;
-            if (maxtap >= InterpDelay::DELAY_SIZE)
+            if (maxtap >= InterpDelay::comb_size)
             {
-                nv = nv * 0.999 * InterpDelay::DELAY_SIZE / maxtap;
+                nv = nv * 0.999 * InterpDelay::comb_size / maxtap;
             }
             delaybase[c][i].newValue(nv);
 
@@ -310,19 +310,21 @@ void FlangerEffect::process(float *dataL, float *dataR)
     {
         for (int c = 0; c < 2; ++c)
         {
-            combs[c][b] = 0;
+            // the taps read back from the sample before the next write, with the weights
+            // zeroing the combs which aren't playing
+            float taps alignas(16)[COMBS_PER_CHANNEL];
             for (int i = 0; i < COMBS_PER_CHANNEL; ++i)
             {
-                if (vweights[c][i] > 0)
-                {
-                    auto tap = delaybase[c][i].v * (1.0 + lfoval[c][i].v * depth.v) + 1;
-                    auto v = idels[c].value(tap);
-                    combs[c][b] += vweights[c][i] * v;
-                }
+                auto tap = delaybase[c][i].v * (1.0 + lfoval[c][i].v * depth.v) + 1;
+                taps[i] = std::min((float)tap, (float)(InterpDelay::comb_size - 2)) + 1;
 
                 lfoval[c][i].process();
                 delaybase[c][i].process();
             }
+
+            auto v = _mm_mul_ps(idels[c].readTaps<InterpDelay::LINEAR, COMBS_PER_CHANNEL>(taps),
+                                _mm_load_ps(vweights[c]));
+            _mm_store_ss(&combs[c][b], sum_ps_to_ss(v));
         }
         // softclip the feedback to avoid explosive runaways
         float fbl = 0.f;
@@ -346,8 +348,8 @@ void FlangerEffect::process(float *dataL, float *dataR)
 
         auto vl = dataL[b] - fbl;
         auto vr = dataR[b] - fbr;
-        idels[0].push(vl);
-        idels[1].push(vr);
+        idels[0].write(vl);
+        idels[1].write(vr);
 
         auto origw = 1.f;
         if (mode == flm_doppler || mode == flm_arp_solo)
@@ -403,23 +405,6 @@ void FlangerEffect::process(float *dataL, float *dataR)
     decodeMS(M, S, dataL, dataR, BLOCK_SIZE_QUAD);
 }
 
-float FlangerEffect::InterpDelay::value(float delayBy)
-{
-    // so if delayBy is 19.2
-    int itap = (int)std::min(delayBy, (float)(DELAY_SIZE - 2)); // this is 19
-    float fractap = delayBy - itap;                             // this is .2
-    int k0 = (k + DELAY_SIZE - itap - 1) & DELAY_SIZE_MASK;     // this is 20 back
-    int k1 = (k + DELAY_SIZE - itap) & DELAY_SIZE_MASK;         // this is 19 back
-    // std::cout << "KDATUM" << k << "," << delayBy << "," << itap << "," << k0 << "," << k1 << ","
-    // << fractap << std::endl; so the result is
-    float result =
-        line[k0] * fractap + line[k1] * (1.0 - fractap); // FIXME move to the one mul form
-    // std::cout << "id::value " << _D(delayBy) << _D(itap) << _D(fractap) << _D(k) << _D(k0) <<
-    // _D(k1) << _D(result) << _D(line[k0]) << _D(line[k1]) << std::endl;
-
-    return result;
-}
-
 void FlangerEffect::suspend() { init(); }
 
 const char *FlangerEffect::group_label(int id)
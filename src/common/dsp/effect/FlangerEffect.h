@@ -18,6 +18,7 @@
 #include "BiquadFilter.h"
 #include "DspUtilities.h"
 #include "AllpassFilter.h"
+#include "SSESincDelayLine.h"
 
 #include "VectorizedSvfFilter.h"
 
@@ -67,27 +68,10 @@ class FlangerEffect : public Effect
     };
 
     static const int COMBS_PER_CHANNEL = 4;
-    struct InterpDelay
-    {
-        // OK so lets say we want lowest tunable frequency to be 23.5hz at 96k
-        // 96000/23.5 = 4084
-        // And lets future proof a bit and make it a power of 2 so we can use & properly
-        static const int DELAY_SIZE = 32768, DELAY_SIZE_MASK = DELAY_SIZE - 1;
-        float line[DELAY_SIZE];
-        int k = 0;
-        InterpDelay() { reset(); }
-        void reset()
-        {
-            memset(line, 0, DELAY_SIZE * sizeof(float));
-            k = 0;
-        }
-        float value(float delayBy);
-        void push(float nv)
-        {
-            k = (k + 1) & DELAY_SIZE_MASK;
-            line[k] = nv;
-        }
-    };
+    // OK so lets say we want lowest tunable frequency to be 23.5hz at 96k
+    // 96000/23.5 = 4084
+    // And lets future proof a bit and make it a power of 2 so we can use & properly
+    using InterpDelay = SSESincDelayLine<32768>;
 
   public:
     FlangerEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
@@ -118,7 +102,7 @@ class FlangerEffect : public Effect
     lipol<float, true> feedback, fb_lf_damping;
     lag<float> vzeropitch;
     float lfosandhtarget[2][COMBS_PER_CHANNEL];
-    float vweights[2][COMBS_PER_CHANNEL];
+    float vweights alignas(16)[2][COMBS_PER_CHANNEL];
 
     lipol_ps width;
     bool haveProcessed = false;
@@ -0,0 +1,191 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#include "FxChain.h"
+
+#include <cstring>
+
+FxChain::FxChain(SurgeStorage *storage, FxStorage *params) : storage(storage), params(params)
+{
+    for (int s = 0; s < n_slots; ++s)
+    {
+        latest[s] = nullptr;
+        unpublished[s] = false;
+        mailbox[s] = nullptr;
+        active[s] = nullptr;
+    }
+}
+
+FxChain::~FxChain()
+{
+    // by now the audio thread is gone, so everything is ours
+    freeRetired();
+    for (int s = 0; s < n_slots; ++s)
+    {
+        Node *nodes[3] = {active[s], mailbox[s].exchange(nullptr),
+                          unpublished[s] ? latest[s] : nullptr};
+        for (auto *n : nodes)
+        {
+            if (n)
+            {
+                delete n->fx;
+                delete n;
+            }
+        }
+    }
+}
+
+FxStorage *FxChain::prepare(int slot, int type)
+{
+    if (slot < 0 || slot >= n_slots)
+        return nullptr;
+
+    freeRetired();
+
+    auto *node = new Node;
+    node->type = type;
+
+    // A private copy of the slot's parameters. The ids point the effect's parameter data at
+    // node->pd, which process refreshes from the values each block.
+    memcpy((void *)&node->fxdata, (void *)&params[slot], sizeof(FxStorage));
+    node->fxdata.type.val.i = type;
+    node->fxdata.return_level.id = -1;
+    for (int i = 0; i < n_fx_params; ++i)
+    {
+        node->fxdata.p[i].set_type(ct_none);
+        node->fxdata.p[i].id = i;
+        node->pd[i] = node->fxdata.p[i].val;
+    }
+
+    node->fx = spawn_effect(type, storage, &node->fxdata, node->pd);
+    if (node->fx)
+    {
+        node->fx->init_ctrltypes();
+        node->fx->init_default_values();
+        for (int i = 0; i < n_fx_params; ++i)
+            node->pd[i] = node->fxdata.p[i].val;
+        node->fx->allocate_memory();
+        node->fx->init();
+    }
+    else
+    {
+        node->type = fxt_off;
+    }
+
+    if (unpublished[slot])
+    {
+        delete latest[slot]->fx;
+        delete latest[slot];
+    }
+    latest[slot] = node;
+    unpublished[slot] = true;
+    return &node->fxdata;
+}
+
+void FxChain::publish(int slot)
+{
+    if (slot < 0 || slot >= n_slots || !unpublished[slot])
+        return;
+
+    freeRetired();
+
+    auto *stale = mailbox[slot].exchange(latest[slot], std::memory_order_acq_rel);
+    if (stale)
+    {
+        // published earlier but never picked up, so the audio thread hasn't seen it
+        delete stale->fx;
+        delete stale;
+    }
+    unpublished[slot] = false;
+}
+
+int FxChain::getType(int slot) const
+{
+    return (slot >= 0 && slot < n_slots && latest[slot]) ? latest[slot]->type : fxt_off;
+}
+
+FxStorage *FxChain::getStorage(int slot)
+{
+    return (slot >= 0 && slot < n_slots && latest[slot]) ? &latest[slot]->fxdata : nullptr;
+}
+
+void FxChain::takePublished()
+{
+    for (int s = 0; s < n_slots; ++s)
+    {
+        if (!mailbox[s].load(std::memory_order_relaxed))
+            continue;
+
+        // with nowhere to send the old effect, keep it running until the ring drains
+        int h = retireHead.load(std::memory_order_relaxed);
+        int next = (h + 1) % retireCapacity;
+        if (active[s] && next == retireTail.load(std::memory_order_acquire))
+            continue;
+
+        auto *n = mailbox[s].exchange(nullptr, std::memory_order_acq_rel);
+        if (!n)
+            continue;
+
+        if (active[s])
+        {
+            retired[h] = active[s];
+            retireHead.store(next, std::memory_order_release);
+        }
+        active[s] = n;
+    }
+}
+
+int FxChain::runningType(int slot) const
+{
+    return (slot >= 0 && slot < n_slots && active[slot]) ? active[slot]->type : fxt_off;
+}
+
+FxStorage *FxChain::runningStorage(int slot)
+{
+    return (slot >= 0 && slot < n_slots && active[slot] && active[slot]->fx)
+               ? &active[slot]->fxdata
+               : nullptr;
+}
+
+void FxChain::process(float *dataL, float *dataR)
+{
+    for (int s = 0; s < n_slots; ++s)
+    {
+        auto *n = active[s];
+        if (!n || !n->fx)
+            continue;
+
+        for (int i = 0; i < n_fx_params; ++i)
+            n->pd[i].i = n->fxdata.p[i].val.i;
+        n->fx->process(dataL, dataR);
+    }
+}
+
+const Effect *FxChain::running(int slot) const
+{
+    return (slot >= 0 && slot < n_slots && active[slot]) ? active[slot]->fx : nullptr;
+}
+
+void FxChain::freeRetired()
+{
+    int t = retireTail.load(std::memory_order_relaxed);
+    while (t != retireHead.load(std::memory_order_acquire))
+    {
+        delete retired[t]->fx;
+        delete retired[t];
+        t = (t + 1) % retireCapacity;
+        retireTail.store(t, std::memory_order_release);
+    }
+}
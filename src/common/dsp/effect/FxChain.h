@@ -0,0 +1,102 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#pragma once
+
+#include "Effect.h"
+
+#include <atomic>
+
+/*
+ * A few effects run in series over one stereo signal, sharing a SurgeStorage. The effects
+ * bank uses it for the effects chained after its main one.
+ *
+ * Each effect comes with its own FxStorage, so changing a slot's type never retypes the
+ * parameters of an effect the audio thread is still running. The message thread builds the
+ * new effect with prepare, sets its values and hands it over with publish through a per slot
+ * mailbox. The audio thread picks it up in takePublished and sends the effect it replaces back
+ * through a ring, which the message thread empties on its next prepare or publish.
+ * Nothing on the audio thread blocks, allocates or frees.
+ */
+class FxChain
+{
+  public:
+    static constexpr int n_slots = 3;
+
+    // params[slot] is what the effects built for slot start from; the chain never changes it
+    FxChain(SurgeStorage *storage, FxStorage *params);
+    ~FxChain();
+
+    /*
+     * Message thread. Builds an effect of type for slot, initialised with its default values,
+     * and returns its parameters so the caller can set them before publish. fxt_off empties
+     * the slot. A second prepare before publish replaces the first.
+     */
+    FxStorage *prepare(int slot, int type);
+    void publish(int slot);
+    void setType(int slot, int type)
+    {
+        prepare(slot, type);
+        publish(slot);
+    }
+
+    /*
+     * Message thread. The type and parameters last prepared for slot, or fxt_off and null.
+     * Once published the audio thread reads the values, so change values, never the types.
+     */
+    int getType(int slot) const;
+    FxStorage *getStorage(int slot);
+
+    /*
+     * Audio thread. Swaps in the published effects, then process runs the chain in place.
+     * runningType lags getType until the swap, so check it before copying values meant for
+     * the newest effect into runningStorage.
+     */
+    void takePublished();
+    int runningType(int slot) const;
+    FxStorage *runningStorage(int slot);
+    void process(float *dataL, float *dataR);
+
+    // The effect the audio thread runs in slot. For tests.
+    const Effect *running(int slot) const;
+
+  private:
+    struct Node
+    {
+        int type;
+        Effect *fx; // null for fxt_off
+        FxStorage fxdata;
+        pdata pd[n_fx_params];
+    };
+
+    void freeRetired();
+
+    SurgeStorage *storage;
+    FxStorage *params;
+
+    // message thread; the newest node for each slot and whether it still waits for publish
+    Node *latest[n_slots];
+    bool unpublished[n_slots];
+
+    std::atomic<Node *> mailbox[n_slots];
+
+    // audio thread
+    Node *active[n_slots];
+
+    // single producer (the audio thread), single consumer (the message thread)
+    static constexpr int retireCapacity = 16;
+    Node *retired[retireCapacity];
+    std::atomic<int> retireHead{0}, retireTail{0};
+};
@@ -0,0 +1,203 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#include "FxSpawner.h"
+
+#include <chrono>
+#include <cstring>
+
+FxSpawner::FxSpawner(SurgeStorage *storage, FxStorage *params) : storage(storage), params(params)
+{
+    for (int i = 0; i < n_fx_slots; ++i)
+    {
+        requested[i] = -1;
+        ready[i] = nullptr;
+        writing[i] = 0;
+        pending[i] = 1;
+        reading[i] = 2;
+    }
+    worker = std::thread([this]() { run(); });
+}
+
+FxSpawner::~FxSpawner()
+{
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    worker.join();
+
+    drainRetired();
+    for (int i = 0; i < n_fx_slots; ++i)
+    {
+        auto *p = ready[i].exchange(nullptr);
+        if (p)
+        {
+            delete p->fx;
+            delete p;
+        }
+    }
+}
+
+void FxSpawner::prepare(int slot, int type, bool defaults)
+{
+    if (slot < 0 || slot >= n_fx_slots)
+        return;
+
+    // copy the parameters here, since the helper mustn't read them while they are being edited
+    auto &r = requests[slot][writing[slot]];
+    r.type = type;
+    r.defaults = defaults;
+    memcpy((void *)&r.fxdata, (void *)&params[slot], sizeof(FxStorage));
+
+    // the helper picks this up on its next poll; a later prepare for the slot supersedes it
+    requested[slot] = type;
+    writing[slot] = pending[slot].exchange(writing[slot] | fresh) & ~fresh;
+}
+
+bool FxSpawner::isPreparing(int slot, int type) const { return requested[slot] == type; }
+
+Effect *FxSpawner::take(int slot, int type)
+{
+    auto *p = ready[slot].exchange(nullptr);
+    if (!p)
+        return nullptr;
+
+    if (p->type != type)
+    {
+        // stale, e.g. the type changed again before it was used
+        retireNode(p->fx, p);
+        return nullptr;
+    }
+
+    auto *fx = p->fx;
+    retireNode(nullptr, p);
+    return fx;
+}
+
+const Effect *FxSpawner::peek(int slot) const
+{
+    auto *p = ready[slot].load();
+    return p ? p->fx : nullptr;
+}
+
+void FxSpawner::retire(Effect *fx)
+{
+    if (fx)
+        retireNode(fx, nullptr);
+}
+
+void FxSpawner::retireNode(Effect *fx, Prepared *node)
+{
+    int h = retireHead.load(std::memory_order_relaxed);
+    int next = (h + 1) % retireCapacity;
+    if (next == retireTail.load(std::memory_order_acquire))
+    {
+        // the helper is way behind; better a glitch than a leak
+        delete fx;
+        delete node;
+        return;
+    }
+    retired[h] = {fx, node};
+    retireHead.store(next, std::memory_order_release);
+}
+
+void FxSpawner::drainRetired()
+{
+    int t = retireTail.load(std::memory_order_relaxed);
+    while (t != retireHead.load(std::memory_order_acquire))
+    {
+        delete retired[t].fx;
+        delete retired[t].node;
+        t = (t + 1) % retireCapacity;
+        retireTail.store(t, std::memory_order_release);
+    }
+}
+
+FxSpawner::Prepared *FxSpawner::build(const Request &r)
+{
+    auto *node = new Prepared;
+    node->type = r.type;
+
+    // A private copy, so init_ctrltypes and init don't race the audio thread over the patch.
+    // The ids point the effect's parameter data at node->pd until loadFx binds it for real.
+    memcpy((void *)&node->fxdata, (void *)&r.fxdata, sizeof(FxStorage));
+    for (int i = 0; i < n_fx_params; ++i)
+    {
+        node->fxdata.p[i].id = i;
+        node->pd[i] = node->fxdata.p[i].val;
+    }
+
+    node->fx = spawn_effect(r.type, storage, &node->fxdata, node->pd);
+    if (!node->fx)
+    {
+        delete node;
+        return nullptr;
+    }
+
+    node->fx->init_ctrltypes();
+    if (r.defaults)
+    {
+        // loadFx puts the same defaults into the patch when it binds the effect
+        node->fx->init_default_values();
+        for (int i = 0; i < n_fx_params; ++i)
+            node->pd[i] = node->fxdata.p[i].val;
+    }
+    node->fx->allocate_memory();
+    node->fx->init();
+    return node;
+}
+
+void FxSpawner::run()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> g(mutex);
+            // neither prepare nor the retirements signal, so poll for both
+            cv.wait_for(g, std::chrono::milliseconds(5), [this]() { return stopping; });
+            if (stopping)
+                return;
+        }
+
+        drainRetired();
+
+        for (int slot = 0; slot < n_fx_slots; ++slot)
+        {
+            if (!(pending[slot] & fresh))
+                continue;
+
+            reading[slot] = pending[slot].exchange(reading[slot]) & ~fresh;
+            const auto &r = requests[slot][reading[slot]];
+            auto *node = build(r);
+            if (node)
+            {
+                auto *old = ready[slot].exchange(node);
+                if (old)
+                {
+                    delete old->fx;
+                    delete old;
+                }
+            }
+
+            // unless a later prepare for the slot came in while we built; one for the same type
+            // which we race past here is built on the next poll
+            int expected = r.type;
+            if (!(pending[slot] & fresh))
+                requested[slot].compare_exchange_strong(expected, -1);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+#pragma once
+
+#include "Effect.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*
+ * Builds effects on a helper thread so that changing an FX type doesn't allocate, fault in
+ * megabytes of delay line or initialise on the audio thread, and deletes the effects the audio
+ * thread is done with.
+ *
+ * Whoever edits fxsync calls prepare, which copies params[slot] into the slot's request on the
+ * caller's thread, so the helper never reads fxsync while the UI or loadFx writes it. The helper
+ * thread polls for requests, spawns the effect against its copy, runs init_ctrltypes and init on
+ * it and leaves it in a per slot mailbox, which loadFx empties with take and binds to the patch.
+ * Effects leaving the audio thread go back through retire. prepare, take, retire and isPreparing
+ * never block, allocate or free, so prepare is safe on the audio thread too.
+ */
+class FxSpawner
+{
+  public:
+    // params[slot] holds the parameters an effect prepared for slot starts from (fxsync)
+    FxSpawner(SurgeStorage *storage, FxStorage *params);
+    ~FxSpawner();
+
+    /*
+     * With defaults, the effect starts from its default values rather than those in params.
+     * Call it from the thread which edits params, one at a time like the edits themselves.
+     */
+    void prepare(int slot, int type, bool defaults = false);
+
+    // true from prepare until the effect for slot and type is waiting in the mailbox
+    bool isPreparing(int slot, int type) const;
+
+    /*
+     * The prepared effect for slot if it is of type, else nullptr. Caller owns the result,
+     * which is initialised but still bound to the spawner's copy of the parameters; bind it
+     * before use.
+     */
+    Effect *take(int slot, int type);
+
+    // The effect waiting in slot's mailbox, still owned by the spawner. For tests.
+    const Effect *peek(int slot) const;
+
+    // Delete fx on the helper thread
+    void retire(Effect *fx);
+
+  private:
+    struct Request
+    {
+        int type;
+        bool defaults;
+        // params[slot] as prepare saw it
+        FxStorage fxdata;
+    };
+
+    struct Prepared
+    {
+        int type;
+        Effect *fx;
+        // what fx was built and initialised against, with the parameter ids made local
+        FxStorage fxdata;
+        pdata pd[n_fx_params];
+    };
+
+    struct Retired
+    {
+        Effect *fx;
+        Prepared *node;
+    };
+
+    void run();
+    Prepared *build(const Request &r);
+    void retireNode(Effect *fx, Prepared *node);
+    void drainRetired();
+
+    SurgeStorage *storage;
+    FxStorage *params;
+
+    // the latest type asked for per slot, or -1 once it is built
+    std::atomic<int> requested[n_fx_slots];
+    std::atomic<Prepared *> ready[n_fx_slots];
+
+    /*
+     * A triple buffer of requests per slot: prepare fills requests[slot][writing[slot]] and
+     * swaps it with the one in pending, flagged fresh; the helper swaps a fresh one for its
+     * requests[slot][reading[slot]]. Neither side ever touches the buffer the other holds.
+     */
+    static constexpr int fresh = 4;
+    Request requests[n_fx_slots][3];
+    std::atomic<int> pending[n_fx_slots];
+    int writing[n_fx_slots], reading[n_fx_slots];
+
+    // single producer (whichever thread runs loadFx), single consumer (the helper thread)
+    static constexpr int retireCapacity = 64;
+    Retired retired[retireCapacity];
+    std::atomic<int> retireHead{0}, retireTail{0};
+
+    // only the helper thread and the destructor take these
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::thread worker;
+};
@@ -14,7 +14,7 @@
 */
 
 #include "NimbusEffect.h"
-#include "samplerate.h"
+#include "DelayMemoryPool.h"
 #include "DebugHelpers.h"
 
 #ifdef _MSC_VER
@@ -24,43 +24,71 @@
 #define TEST // remember this is how you tell the eurorack code to use dsp not hardware
 #include "clouds/dsp/granular_processor.h"
 
+#include <new>
+
+static constexpr size_t round16(size_t n) { return (n + 15) & ~(size_t)15; }
+
 NimbusEffect::NimbusEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
-    : Effect(storage, fxdata, pd)
+    : Effect(storage, fxdata, pd), surgeSR_to_euroSR(samplerate, processor_sr),
+      euroSR_to_surgeSR(processor_sr, samplerate), designer(storage)
 {
-    const int memLen = 118784;
-    const int ccmLen = 65536 - 128;
-    block_mem = new uint8_t[memLen]();
-    block_ccm = new uint8_t[ccmLen]();
-    processor = new clouds::GranularProcessor();
-    memset(processor, 0, sizeof(*processor));
-
-    processor->Init(block_mem, memLen, block_ccm, ccmLen);
     mix.set_blocksize(BLOCK_SIZE);
 
-    int error;
-    surgeSR_to_euroSR = src_new(SRC_SINC_FASTEST, 2, &error);
-    if (error != 0)
-    {
-        surgeSR_to_euroSR = nullptr;
-    }
-
-    euroSR_to_surgeSR = src_new(SRC_SINC_FASTEST, 2, &error);
-    if (error != 0)
-    {
-        euroSR_to_surgeSR = nullptr;
-    }
+    reset_resamplers();
 }
 
 NimbusEffect::~NimbusEffect()
 {
-    delete[] block_mem;
-    delete[] block_ccm;
-    delete processor;
-
-    if (surgeSR_to_euroSR)
-        surgeSR_to_euroSR = src_delete(surgeSR_to_euroSR);
-    if (euroSR_to_surgeSR)
-        euroSR_to_surgeSR = src_delete(euroSR_to_surgeSR);
+    if (processor)
+        processor->~GranularProcessor();
+    storage->delayMemory->cancel(growth);
+    storage->delayMemory->release(arena);
+}
+
+size_t NimbusEffect::arenaFloats()
+{
+    auto bytes = round16(sizeof(clouds::GranularProcessor)) + round16(memLen) + round16(ccmLen);
+    return bytes / sizeof(float);
+}
+
+void NimbusEffect::adoptArena(float *block)
+{
+    // the pool zeroes the block, which the processor and both memories expect
+    arena = block;
+    arena_bytes = arenaFloats() * sizeof(float);
+    auto *base = (uint8_t *)arena;
+    processor = new (base) clouds::GranularProcessor();
+    block_mem = base + round16(sizeof(clouds::GranularProcessor));
+    block_ccm = block_mem + round16(memLen);
+
+    processor->Init(block_mem, memLen, block_ccm, ccmLen);
+}
+
+void NimbusEffect::allocate_memory()
+{
+    if (!arena)
+        adoptArena(storage->delayMemory->allocate(arenaFloats()));
+}
+
+size_t NimbusEffect::get_memory_usage() { return object_size + arena_bytes; }
+
+void NimbusEffect::reset_resamplers()
+{
+    surgeSR_to_euroSR.reset(samplerate, processor_sr);
+    euroSR_to_surgeSR.reset(processor_sr, samplerate);
+    resampler_sr = samplerate;
+    primed = false;
+    hasStubInput = false;
+
+    // a 4 pole Butterworth a little under the 16k Nyquist of the Clouds side
+    antialias.suspend();
+    const double butterworthQ[2] = {0.5412, 1.3066};
+    for (int i = 0; i < 2; ++i)
+    {
+        designer.coeff_LP(BiquadFilter::calc_omega_from_Hz(0.45 * processor_sr), butterworthQ[i]);
+        antialias.set_coef(i, designer);
+        antialias.set_enabled(i, samplerate > processor_sr);
+    }
 }
 
 void NimbusEffect::init()
@@ -68,12 +96,7 @@ void NimbusEffect::init()
     mix.set_target(1.f);
     mix.instantize();
 
-    memset(resampled_output, 0, raw_out_sz * 2 * sizeof(float));
-
-    consumed = 0;
-    created = 0;
-    resampReadPtr = 0;
-    resampWritePtr = 1; // why 1? well while we are stalling we want to output 0 so write 1 ahead
+    reset_resamplers();
 }
 
 void NimbusEffect::setvars(bool init) {}
@@ -82,30 +105,44 @@ void NimbusEffect::process(float *dataL, float *dataR)
 {
     setvars(false);
 
-    if (!surgeSR_to_euroSR || !euroSR_to_surgeSR)
+    if (!processor)
+    {
+        // spawned without allocate_memory; ask the pool and stay silent until it's here
+        size_t n = 0;
+        auto *block = storage->delayMemory->collect(growth, n);
+        if (block)
+            adoptArena(block);
+        else
+            storage->delayMemory->request(growth, arenaFloats());
+    }
+    if (!processor)
+    {
+        clear_block(dataL, BLOCK_SIZE_QUAD);
+        clear_block(dataR, BLOCK_SIZE_QUAD);
+        // fully wet, and the granulator starts empty, so the output fades in from silence
+        mix.set_target(1.f);
+        mix.instantize();
         return;
+    }
+
+    if (samplerate != resampler_sr)
+        reset_resamplers();
 
-    /* Resample Temp Buffers */
-    float resample_this[BLOCK_SIZE << 3][2];
-    float resample_into[BLOCK_SIZE << 3][2];
+    float inL alignas(16)[BLOCK_SIZE], inR alignas(16)[BLOCK_SIZE];
+    copy_block(dataL, inL, BLOCK_SIZE_QUAD);
+    copy_block(dataR, inR, BLOCK_SIZE_QUAD);
+    antialias.process_block(inL, inR);
 
     for (int i = 0; i < BLOCK_SIZE; ++i)
-    {
-        resample_this[i][0] = dataL[i];
-        resample_this[i][1] = dataR[i];
-    }
+        surgeSR_to_euroSR.push(inL[i], inR[i]);
+
+    // leave room for the stub sample in front
+    static constexpr int max_euro_block = (BLOCK_SIZE << 3) - 1;
+    float euroL alignas(16)[max_euro_block], euroR alignas(16)[max_euro_block];
+    int euroSz = surgeSR_to_euroSR.populateNext(euroL, euroR, max_euro_block);
+    surgeSR_to_euroSR.renormalizePhases();
 
-    SRC_DATA sdata;
-    sdata.end_of_input = 0;
-    sdata.src_ratio = processor_sr * samplerate_inv;
-    sdata.data_in = &(resample_this[0][0]);
-    sdata.data_out = &(resample_into[0][0]);
-    sdata.input_frames = BLOCK_SIZE;
-    sdata.output_frames = (BLOCK_SIZE << 3);
-    auto res = src_process(surgeSR_to_euroSR, &sdata);
-    consumed += sdata.input_frames_used;
-
-    if (sdata.output_frames_gen)
+    if (euroSz)
     {
         clouds::ShortFrame input[BLOCK_SIZE << 3];
         clouds::ShortFrame output[BLOCK_SIZE << 3];
@@ -119,13 +156,13 @@ void NimbusEffect::process(float *dataL, float *dataR)
         }
         hasStubInput = false;
 
-        for (int i = 0; i < sdata.output_frames_gen; ++i)
+        for (int i = 0; i < euroSz; ++i)
         {
-            input[i + sp].l = (short)(clamp1bp(resample_into[i][0]) * 32767.0f);
-            input[i + sp].r = (short)(clamp1bp(resample_into[i][1]) * 32767.0f);
+            input[i + sp].l = (short)(clamp1bp(euroL[i]) * 32767.0f);
+            input[i + sp].r = (short)(clamp1bp(euroR[i]) * 32767.0f);
         }
 
-        int inputSz = sdata.output_frames_gen + sp;
+        int inputSz = euroSz + sp;
 
         processor->set_playback_mode(
             (clouds::PlaybackMode)((int)clouds::PLAYBACK_MODE_GRANULAR + *pdata_ival[nmb_mode]));
@@ -170,41 +207,27 @@ void NimbusEffect::process(float *dataL, float *dataR)
         processor->Process(input, output, inputSz);
 
         for (int i = 0; i < inputSz; ++i)
-        {
-            resample_this[i][0] = output[i].l / 32767.0f;
-            resample_this[i][1] = output[i].r / 32767.0f;
-        }
-
-        SRC_DATA odata;
-        odata.end_of_input = 0;
-        odata.src_ratio = processor_sr_inv * samplerate;
-        odata.data_in = &(resample_this[0][0]);
-        odata.data_out = &(resample_into[0][0]);
-        odata.input_frames = inputSz;
-        odata.output_frames = BLOCK_SIZE << 3;
-        auto reso = src_process(euroSR_to_surgeSR, &odata);
-        created += odata.output_frames_gen;
-
-        size_t w = resampWritePtr;
-        for (int i = 0; i < odata.output_frames_gen; ++i)
-        {
-            resampled_output[w][0] = resample_into[i][0];
-            resampled_output[w][1] = resample_into[i][1];
-            w = (w + 1U) & (raw_out_sz - 1U);
-        }
-        resampWritePtr = w;
+            euroSR_to_surgeSR.push(output[i].l / 32767.0f, output[i].r / 32767.0f);
     }
 
-    bool rpi = (created) > (BLOCK_SIZE + 8); // leave some buffer
+    /*
+     * Output silence until the 32k side holds a block and a little more, so the rounding of how
+     * many samples each block makes (and the held stub sample) never leaves us short after.
+     */
+    if (!primed)
+        primed =
+            euroSR_to_surgeSR.inputsRequiredToGenerateOutputs(BLOCK_SIZE + output_headroom) == 0;
 
-    size_t rp = resampReadPtr;
-    for (int i = 0; i < BLOCK_SIZE; ++i)
+    int made = 0;
+    if (primed)
+        made = euroSR_to_surgeSR.populateNext(L, R, BLOCK_SIZE);
+    euroSR_to_surgeSR.renormalizePhases();
+
+    for (int i = made; i < BLOCK_SIZE; ++i)
     {
-        L[i] = resampled_output[rp][0];
-        R[i] = resampled_output[rp][1];
-        rp = (rp + rpi) & (raw_out_sz - 1);
+        L[i] = made ? L[made - 1] : 0.f;
+        R[i] = made ? R[made - 1] : 0.f;
     }
-    resampReadPtr = rp;
 
     mix.set_target_smoothed(clamp01(*f[nmb_mix]));
     mix.fade_2_blocks_to(dataL, L, dataR, R, dataL, dataR, BLOCK_SIZE_QUAD);
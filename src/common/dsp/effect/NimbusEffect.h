@@ -17,6 +17,9 @@
 #define SURGE_NIMBUSEFFECT_H
 
 #include "Effect.h"
+#include "LanczosResampler.h"
+#include "BiquadCascade.h"
+#include "DelayMemoryPool.h"
 
 #include <memory>
 #include <vt_dsp/lipol.h>
@@ -26,8 +29,6 @@ namespace clouds
 class GranularProcessor;
 }
 
-struct SRC_STATE_tag;
-
 class NimbusEffect : public Effect
 {
     enum nmb_params
@@ -58,6 +59,7 @@ class NimbusEffect : public Effect
     NimbusEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
     virtual ~NimbusEffect();
     virtual const char *get_effectname() override { return "Nimbus"; }
+    virtual void allocate_memory() override;
     virtual void init() override;
     virtual void process(float *dataL, float *dataR) override;
     virtual void suspend() override;
@@ -69,22 +71,41 @@ class NimbusEffect : public Effect
     virtual int group_label_ypos(int id) override;
 
     virtual int get_ringout_decay() override { return -1; }
+    virtual size_t get_memory_usage() override;
 
   private:
-    uint8_t *block_mem, *block_ccm;
-    clouds::GranularProcessor *processor;
+    /*
+     * The processor and its work memory are carved out of one block from storage->delayMemory:
+     * the processor, then block_mem, then block_ccm. processor stays null until the block is
+     * here, from allocate_memory or else a growth process asks for.
+     */
+    static constexpr size_t memLen = 118784;
+    static constexpr size_t ccmLen = 65536 - 128;
+    float *arena = nullptr;
+    size_t arena_bytes = 0;
+    uint8_t *block_mem = nullptr, *block_ccm = nullptr;
+    clouds::GranularProcessor *processor = nullptr;
+    DelayMemoryPool::Growth growth;
+    static size_t arenaFloats();
+    void adoptArena(float *block);
     static constexpr int processor_sr = 32000;
     static constexpr float processor_sr_inv = 1.f / 32000;
     int old_nmb_mode = 0;
 
-    SRC_STATE_tag *surgeSR_to_euroSR, *euroSR_to_surgeSR;
+    // Clouds runs at a fixed 32k, so both directions are a fixed ratio from the synth's rate
+    LanczosResampler surgeSR_to_euroSR, euroSR_to_surgeSR;
+    float resampler_sr = 0; // the synth's rate the resamplers were set up for
+    void reset_resamplers();
+
+    // The Lanczos kernel doesn't band limit, so going down to 32k the input is lowpassed first
+    BiquadCascade<2> antialias;
+    BiquadFilter designer;
 
-    static constexpr int raw_out_sz = BLOCK_SIZE_OS << 3; // power of 2 pls
-    float resampled_output[raw_out_sz][2];                // at sr
-    size_t resampReadPtr = 0, resampWritePtr = 1;         // see comment in init
-    float stub_input[2];                                  // This is the extra sample we ahve around
+    // output waits until the 32k side has this many samples beyond a block in hand
+    static constexpr int output_headroom = 8;
+    bool primed = false;
+    float stub_input[2]; // This is the extra sample we ahve around
     bool hasStubInput = false;
-    int consumed = 0, created = 0;
 };
 
 #endif // SURGE_NIMBUSEFFECT_H
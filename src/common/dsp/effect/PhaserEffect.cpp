@@ -5,27 +5,15 @@ using namespace vt_dsp;
 float bend(float x, float b) { return (1.f + b) * x - b * x * x * x; }
 
 PhaserEffect::PhaserEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd)
-    : Effect(storage, fxdata, pd)
+    : Effect(storage, fxdata, pd), designer(storage)
 {
-    for (int i = 0; i < n_bq_units; i++)
-    {
-        biquad[i] = (BiquadFilter *)_aligned_malloc(sizeof(BiquadFilter), 16);
-        memset(biquad[i], 0, sizeof(BiquadFilter));
-        new (biquad[i]) BiquadFilter(storage);
-    }
-
-    n_bq_units_initialised = n_bq_units;
     feedback.setBlockSize(BLOCK_SIZE * slowrate);
     width.set_blocksize(BLOCK_SIZE);
     mix.set_blocksize(BLOCK_SIZE);
     bi = 0;
 }
 
-PhaserEffect::~PhaserEffect()
-{
-    for (int i = 0; i < n_bq_units_initialised; i++)
-        _aligned_free(biquad[i]);
-}
+PhaserEffect::~PhaserEffect() {}
 
 void PhaserEffect::init()
 {
@@ -33,10 +21,7 @@ void PhaserEffect::init()
     dL = 0;
     dR = 0;
 
-    for (int i = 0; i < n_bq_units_initialised; i++)
-    {
-        biquad[i]->suspend();
-    }
+    stages.suspend();
 
     clear_block(L, BLOCK_SIZE_QUAD);
     clear_block(R, BLOCK_SIZE_QUAD);
@@ -48,27 +33,18 @@ void PhaserEffect::init()
 
 inline void PhaserEffect::init_stages()
 {
-    n_stages = fxdata->p[ph_stages].val.i;
-    n_bq_units = n_stages * 2;
+    int n = limit_range(fxdata->p[ph_stages].val.i, 1, (int)max_stages);
 
-    if (n_bq_units_initialised < n_bq_units)
-    {
-        // we need to increase the number of stages
-        for (int k = n_bq_units_initialised; k < n_bq_units; k++)
-        {
-            biquad[k] = (BiquadFilter *)_aligned_malloc(sizeof(BiquadFilter), 16);
-            memset(biquad[k], 0, sizeof(BiquadFilter));
-            new (biquad[k]) BiquadFilter(storage);
-        }
+    // Stages coming into use start from silence at their new frequency rather than replaying
+    // what they held when they were last dropped. setvars designs their coefficients right after.
+    for (int i = n_stages; i < n; i++)
+        stages.reset(i);
 
-        n_bq_units_initialised = n_bq_units;
-    }
+    n_stages = n;
 }
 
 void PhaserEffect::process_only_control()
 {
-    init_stages();
-
     modLFOL.post_process();
     modLFOR.post_process();
 }
@@ -106,12 +82,14 @@ void PhaserEffect::setvars()
         // 4 stages in original phaser mode
         for (int i = 0; i < 2; i++)
         {
-            double omega = biquad[2 * i]->calc_omega(2 * *f[ph_center] + legacy_freq[i] +
-                                                     legacy_span[i] * modLFOL.value());
-            biquad[2 * i]->coeff_APF(omega, 1.0 + 0.8 * *f[ph_sharpness]);
-            omega = biquad[2 * i + 1]->calc_omega(2 * *f[ph_center] + legacy_freq[i] +
-                                                  legacy_span[i] * modLFOR.value());
-            biquad[2 * i + 1]->coeff_APF(omega, 1.0 + 0.8 * *f[ph_sharpness]);
+            double omega = designer.calc_omega(2 * *f[ph_center] + legacy_freq[i] +
+                                               legacy_span[i] * modLFOL.value());
+            designer.coeff_APF(omega, 1.0 + 0.8 * *f[ph_sharpness]);
+            stages.set_coef(i, 0, designer);
+            omega = designer.calc_omega(2 * *f[ph_center] + legacy_freq[i] +
+                                        legacy_span[i] * modLFOR.value());
+            designer.coeff_APF(omega, 1.0 + 0.8 * *f[ph_sharpness]);
+            stages.set_coef(i, 1, designer);
         }
     }
     else
@@ -119,12 +97,14 @@ void PhaserEffect::setvars()
         for (int i = 0; i < n_stages; i++)
         {
             double center = powf(2, (i + 1.0) * 2 / n_stages);
-            double omega = biquad[2 * i]->calc_omega(2 * *f[ph_center] + *f[ph_spread] * center +
-                                                     2.0 / (i + 1) * modLFOL.value());
-            biquad[2 * i]->coeff_APF(omega, 1.0 + 0.8 * *f[ph_sharpness]);
-            omega = biquad[2 * i + 1]->calc_omega(2 * *f[ph_center] + *f[ph_spread] * center +
-                                                  (2.0 / (i + 1) * modLFOR.value()));
-            biquad[2 * i + 1]->coeff_APF(omega, 1.0 + 0.8 * *f[ph_sharpness]);
+            double omega = designer.calc_omega(2 * *f[ph_center] + *f[ph_spread] * center +
+                                               2.0 / (i + 1) * modLFOL.value());
+            designer.coeff_APF(omega, 1.0 + 0.8 * *f[ph_sharpness]);
+            stages.set_coef(i, 0, designer);
+            omega = designer.calc_omega(2 * *f[ph_center] + *f[ph_spread] * center +
+                                        (2.0 / (i + 1) * modLFOR.value()));
+            designer.coeff_APF(omega, 1.0 + 0.8 * *f[ph_sharpness]);
+            stages.set_coef(i, 1, designer);
         }
     }
 
@@ -149,11 +129,7 @@ void PhaserEffect::process(float *dataL, float *dataR)
         dL = limit_range(dL, -32.f, 32.f);
         dR = limit_range(dR, -32.f, 32.f);
 
-        for (int curr_stage = 0; curr_stage < n_stages; curr_stage++)
-        {
-            dL = biquad[2 * curr_stage]->process_sample(dL);
-            dR = biquad[2 * curr_stage + 1]->process_sample(dR);
-        }
+        stages.process_sample(dL, dR, n_stages);
 
         L[i] = dL;
         R[i] = dR;
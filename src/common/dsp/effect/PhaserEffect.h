@@ -16,6 +16,7 @@
 #pragma once
 #include "Effect.h"
 #include "BiquadFilter.h"
+#include "BiquadCascade.h"
 #include "DspUtilities.h"
 #include "AllpassFilter.h"
 #include "VectorizedSvfFilter.h"
@@ -68,11 +69,11 @@ class PhaserEffect : public Effect
     static const int max_stages = 16;
     static const int default_stages = 4;
     int n_stages = default_stages;
-    int n_bq_units = default_stages << 1;
-    int n_bq_units_initialised = 0;
     float dL, dR;
-    BiquadFilter *biquad[max_stages * 2];
-    int bi; // block increment (to keep track of events not occurring every n blocks)
+    // one section per stage with the left and right allpasses in its two lanes
+    BiquadCascade<max_stages> stages;
+    BiquadFilter designer; // computes the coefficients for stages
+    int bi;                // block increment (to keep track of events not occurring every n blocks)
     void init_stages();
 
     // before stages/spread added parameters we had 4 stages at fixed frequencies and modulation
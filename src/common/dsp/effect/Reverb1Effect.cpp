@@ -8,9 +8,85 @@ Reverb1Effect::Reverb1Effect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd
     : Effect(storage, fxdata, pd), band1(storage), locut(storage), hicut(storage)
 {
     b = 0;
+    predelay = delay = nullptr;
+    delay_rows = wanted_rows = 0;
 }
 
-Reverb1Effect::~Reverb1Effect() {}
+Reverb1Effect::~Reverb1Effect()
+{
+    storage->delayMemory->cancel(growth);
+    storage->delayMemory->release(predelay);
+}
+
+void Reverb1Effect::allocate_memory()
+{
+    if (predelay)
+        return;
+
+    // Long enough for the shape and room size we start with. A larger room grows the lines
+    // from process.
+    setTapTimes(fxdata->p[rev1_shape].val.i, fxdata->p[rev1_roomsize].val.f);
+    int max_lag = 0;
+    for (int t = 0; t < rev_taps; t++)
+        max_lag = max(max_lag, delay_time[t] >> 8);
+    delay_rows = rowsFor(max_lag);
+    predelay = storage->delayMemory->allocate(max_rev_dly + rev_taps * delay_rows);
+    delay = predelay + max_rev_dly;
+}
+
+int Reverb1Effect::rowsFor(int lag)
+{
+    int res = 1 << 10;
+    while (res <= lag && res < max_rev_dly)
+        res <<= 1;
+    return res;
+}
+
+void Reverb1Effect::update_taps()
+{
+    int max_lag = 0;
+    for (int t = 0; t < rev_taps; t++)
+    {
+        int lag = delay_time[t] >> 8;
+        max_lag = max(max_lag, lag);
+        tap_lag[t] = min(lag, delay_rows - 1);
+    }
+
+    wanted_rows = rowsFor(max_lag);
+}
+
+void Reverb1Effect::adoptGrowth()
+{
+    size_t n = 0;
+    auto *block = storage->delayMemory->collect(growth, n);
+    if (!block)
+        return;
+
+    int rows = (int)((n - max_rev_dly) / rev_taps);
+    if (rows <= delay_rows)
+    {
+        storage->delayMemory->releaseLater(growth, block);
+        return;
+    }
+
+    auto *grown = block + max_rev_dly;
+    if (predelay)
+    {
+        memcpy(block, predelay, max_rev_dly * sizeof(float));
+        DelayMemoryPool::carryHistory(grown, rows, delay, delay_rows, delay_pos + 1, rev_taps);
+    }
+
+    storage->delayMemory->releaseLater(growth, predelay);
+    predelay = block;
+    delay = grown;
+    delay_rows = rows;
+    update_taps();
+}
+
+size_t Reverb1Effect::get_memory_usage()
+{
+    return object_size + (predelay ? max_rev_dly + rev_taps * delay_rows : 0) * sizeof(float);
+}
 
 void Reverb1Effect::init()
 {
@@ -55,8 +131,11 @@ void Reverb1Effect::setvars(bool init) {}
 
 void Reverb1Effect::clear_buffers()
 {
+    if (!predelay)
+        return;
+
     clear_block(predelay, max_rev_dly >> 2);
-    clear_block(delay, (rev_taps * max_rev_dly) >> 2);
+    clear_block(delay, (rev_taps * delay_rows) >> 2);
 }
 
 void Reverb1Effect::loadpreset(int id)
@@ -64,7 +143,14 @@ void Reverb1Effect::loadpreset(int id)
     shape = id;
 
     clear_buffers();
+    setTapTimes(id, *f[rev1_roomsize]);
+    lastf[rev1_roomsize] = *f[rev1_roomsize];
+    update_taps();
+    update_rtime();
+}
 
+void Reverb1Effect::setTapTimes(int id, float roomsize)
+{
     switch (id)
     {
     case 0:
@@ -147,10 +233,8 @@ void Reverb1Effect::loadpreset(int id)
         // float rbp = storage->rand_pm1();
         // float a = 256.f * (3000.f * (1.f + rbp * rbp * *f[rev1_variation]))*(1.f + 1.f *
         // *f[rev1_roomsize]); delay_time[t] = (int)a;
-        delay_time[t] = (int)((float)(2.f * *f[rev1_roomsize]) * delay_time[t]);
+        delay_time[t] = (int)((float)(2.f * roomsize) * delay_time[t]);
     }
-    lastf[rev1_roomsize] = *f[rev1_roomsize];
-    update_rtime();
 }
 
 void Reverb1Effect::update_rtime()
@@ -182,6 +266,8 @@ void Reverb1Effect::process(float *dataL, float *dataR)
 {
     float wetL alignas(16)[BLOCK_SIZE], wetR alignas(16)[BLOCK_SIZE];
 
+    adoptGrowth();
+
     if (fxdata->p[rev1_shape].val.i != shape)
         loadpreset(fxdata->p[rev1_shape].val.i);
     if ((b == 0) && (fabs(*f[rev1_roomsize] - lastf[rev1_roomsize]) > 0.001f))
@@ -190,6 +276,20 @@ void Reverb1Effect::process(float *dataL, float *dataR)
     if (fabs(*f[rev1_decaytime] - lastf[rev1_decaytime]) > 0.001f)
         update_rtime();
 
+    if (wanted_rows > delay_rows)
+        storage->delayMemory->request(growth, max_rev_dly + rev_taps * wanted_rows);
+
+    if (!predelay)
+    {
+        // no lines yet, so silent like any effect without its memory; the mix starts wet (and
+        // empty) as it does after init
+        clear_block(dataL, BLOCK_SIZE_QUAD);
+        clear_block(dataR, BLOCK_SIZE_QUAD);
+        mix.set_target(1.f);
+        mix.instantize();
+        return;
+    }
+
     // do more seldom
     if (b == 0)
     {
@@ -218,16 +318,16 @@ void Reverb1Effect::process(float *dataL, float *dataR)
     {
         for (int t = 0; t < rev_taps; t += 4)
         {
-            int dp = (delay_pos - (delay_time[t] >> 8));
-            // float newa = delay[t + ((dp & (max_rev_dly-1))<<rev_tap_bits)];
-            __m128 newa = _mm_load_ss(&delay[t + ((dp & (max_rev_dly - 1)) << rev_tap_bits)]);
-            dp = (delay_pos - (delay_time[t + 1] >> 8));
-            __m128 newb = _mm_load_ss(&delay[t + 1 + ((dp & (max_rev_dly - 1)) << rev_tap_bits)]);
-            dp = (delay_pos - (delay_time[t + 2] >> 8));
+            int dp = (delay_pos - tap_lag[t]);
+            // float newa = delay[t + ((dp & (delay_rows-1))<<rev_tap_bits)];
+            __m128 newa = _mm_load_ss(&delay[t + ((dp & (delay_rows - 1)) << rev_tap_bits)]);
+            dp = (delay_pos - tap_lag[t + 1]);
+            __m128 newb = _mm_load_ss(&delay[t + 1 + ((dp & (delay_rows - 1)) << rev_tap_bits)]);
+            dp = (delay_pos - tap_lag[t + 2]);
             newa = _mm_unpacklo_ps(newa, newb); // a,b,0,0
-            __m128 newc = _mm_load_ss(&delay[t + 2 + ((dp & (max_rev_dly - 1)) << rev_tap_bits)]);
-            dp = (delay_pos - (delay_time[t + 3] >> 8));
-            __m128 newd = _mm_load_ss(&delay[t + 3 + ((dp & (max_rev_dly - 1)) << rev_tap_bits)]);
+            __m128 newc = _mm_load_ss(&delay[t + 2 + ((dp & (delay_rows - 1)) << rev_tap_bits)]);
+            dp = (delay_pos - tap_lag[t + 3]);
+            __m128 newd = _mm_load_ss(&delay[t + 3 + ((dp & (delay_rows - 1)) << rev_tap_bits)]);
             newc = _mm_unpacklo_ps(newc, newd);      // c,d,0,0
             __m128 new4 = _mm_movelh_ps(newa, newc); // a,b,c,d
 
@@ -262,7 +362,7 @@ void Reverb1Effect::process(float *dataL, float *dataR)
             __m128 ot = _mm_load_ps(&out_tap[t]);
             __m128 dfb = _mm_load_ps(&delay_fb[t]);
             __m128 a = _mm_mul_ps(dfb, _mm_add_ps(fb4, ot));
-            _mm_store_ps(&delay[(delay_pos << rev_tap_bits) + t], a);
+            _mm_store_ps(&delay[((delay_pos & (delay_rows - 1)) << rev_tap_bits) + t], a);
             L = _mm_add_ps(L, _mm_mul_ps(ot, _mm_load_ps(&delay_pan_L[t])));
             R = _mm_add_ps(R, _mm_mul_ps(ot, _mm_load_ps(&delay_pan_R[t])));
         }
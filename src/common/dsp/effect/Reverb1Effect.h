@@ -20,6 +20,7 @@
 #include "AllpassFilter.h"
 
 #include "VectorizedSvfFilter.h"
+#include "DelayMemoryPool.h"
 
 #include <vt_dsp/halfratefilter.h>
 #include <vt_dsp/lipol.h>
@@ -49,16 +50,25 @@ class Reverb1Effect : public Effect
 
     float delay_pan_L alignas(16)[rev_taps], delay_pan_R alignas(16)[rev_taps];
     float delay_fb alignas(16)[rev_taps];
-    float delay alignas(16)[rev_taps * max_rev_dly];
     float out_tap alignas(16)[rev_taps];
-    float predelay alignas(16)[max_rev_dly];
     int delay_time alignas(16)[rev_taps];
+    // delay_time in samples, clamped to the rows we have until a growth lands
+    int tap_lag alignas(16)[rev_taps];
+
+    // One block from storage->delayMemory: the max_rev_dly sample predelay, then delay_rows rows
+    // of rev_taps interleaved taps (delay), a power of two no longer than max_rev_dly
+    float *predelay, *delay;
+    int delay_rows;
+    // the rows the taps ask for, grown to in process
+    int wanted_rows;
+    DelayMemoryPool::Growth growth;
     lipol_ps mix alignas(16), width alignas(16);
 
   public:
     Reverb1Effect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd);
     virtual ~Reverb1Effect();
     virtual const char *get_effectname() override { return "reverb"; }
+    virtual void allocate_memory() override;
     virtual void init() override;
     virtual void process(float *dataL, float *dataR) override;
     virtual void suspend() override;
@@ -68,6 +78,7 @@ class Reverb1Effect : public Effect
     virtual const char *group_label(int id) override;
     virtual int group_label_ypos(int id) override;
     virtual int get_ringout_decay() override { return ringout_time; }
+    virtual size_t get_memory_usage() override;
 
     virtual void handleStreamingMismatches(int streamingRevision,
                                            int currentSynthStreamingRevision) override;
@@ -77,6 +88,10 @@ class Reverb1Effect : public Effect
     void update_rsize();
     void clear_buffers();
     void loadpreset(int id);
+    void setTapTimes(int id, float roomsize);
+    static int rowsFor(int lag);
+    void update_taps();
+    void adoptGrowth();
     /*int delay_time_mod[rev_taps];
     int delay_time_dv[rev_taps];*/
     int delay_pos;
@@ -82,7 +82,7 @@ void RingModulatorEffect::process(float *dataL, float *dataR)
 #if OVERSAMPLE
     // Now upsample
     float dataOS alignas(16)[2][BLOCK_SIZE_OS];
-    halfbandIN.process_block_U2(dataL, dataR, dataOS[0], dataOS[1]);
+    halfbandIN.process_block_U2(dataL, dataR, dataOS[0], dataOS[1], BLOCK_SIZE_OS);
     sri = dsamplerate_os_inv;
     ub = BLOCK_SIZE_OS;
 #else
@@ -157,7 +157,7 @@ void RingModulatorEffect::process(float *dataL, float *dataR)
     }
 
 #if OVERSAMPLE
-    halfbandOUT.process_block_D2(dataOS[0], dataOS[1]);
+    halfbandOUT.process_block_D2(dataOS[0], dataOS[1], BLOCK_SIZE_OS);
     copy_block(dataOS[0], wetL, BLOCK_SIZE_QUAD);
     copy_block(dataOS[1], wetR, BLOCK_SIZE_QUAD);
 #endif
@@ -14,9 +14,7 @@ RotarySpeakerEffect::~RotarySpeakerEffect() {}
 
 void RotarySpeakerEffect::init()
 {
-    memset(buffer, 0, max_delay_length * sizeof(float));
-
-    wpos = 0;
+    hornDelay.clear();
 
     xover.suspend();
     lowbass.suspend();
@@ -43,10 +41,9 @@ void RotarySpeakerEffect::setvars(bool init)
 
 void RotarySpeakerEffect::suspend()
 {
-    memset(buffer, 0, max_delay_length * sizeof(float));
+    hornDelay.clear();
     xover.suspend();
     lowbass.suspend();
-    wpos = 0;
 }
 
 void RotarySpeakerEffect::init_default_values()
@@ -251,7 +248,7 @@ void RotarySpeakerEffect::process(float *dataL, float *dataR)
 
     bool useSSEShaper = (ws + wst_soft == wst_digital || ws + wst_soft == wst_sine);
 
-    auto wsop = GetQFPtrWaveshaper(wst_soft + ws);
+    auto wsop = GetQFPtrWaveshaper(wst_soft + ws, storage->getPatch().tableLookupWaveshapers);
 
     for (k = 0; k < BLOCK_SIZE; k++)
     {
@@ -289,35 +286,55 @@ void RotarySpeakerEffect::process(float *dataL, float *dataR)
 
     xover.process_block(lower);
 
+    const bool legacyTaps = storage->getPatch().legacyRotaryHornTaps;
+
     for (k = 0; k < BLOCK_SIZE; k++)
     {
         // feed delay input
-        int wp = (wpos + k) & (max_delay_length - 1);
         lower_sub[k] = lower[k];
         upper[k] -= lower[k];
-        buffer[wp] = upper[k];
+        hornDelay.write(upper[k]);
 
-        int i_dtimeL = max(BLOCK_SIZE, min((int)dL.v, max_delay_length - FIRipol_N - 1));
-        int i_dtimeR = max(BLOCK_SIZE, min((int)dR.v, max_delay_length - FIRipol_N - 1));
+        if (legacyTaps)
+        {
+            // the pre revision 19 read, one coefficient late; rp is the sample just written
+            int i_dtimeL = max(BLOCK_SIZE, min((int)dL.v, max_delay_length - FIRipol_N - 1));
+            int i_dtimeR = max(BLOCK_SIZE, min((int)dR.v, max_delay_length - FIRipol_N - 1));
 
-        int rpL = (wpos - i_dtimeL + k);
-        int rpR = (wpos - i_dtimeR + k);
+            int rpL = hornDelay.wp - 1 - i_dtimeL;
+            int rpR = hornDelay.wp - 1 - i_dtimeR;
 
-        int sincL = FIRipol_N *
-                    limit_range((int)(FIRipol_M * (float(i_dtimeL + 1) - dL.v)), 0, FIRipol_M - 1);
-        int sincR = FIRipol_N *
-                    limit_range((int)(FIRipol_M * (float(i_dtimeR + 1) - dR.v)), 0, FIRipol_M - 1);
+            int sincL = FIRipol_N * limit_range((int)(FIRipol_M * (float(i_dtimeL + 1) - dL.v)),
+                                                0, FIRipol_M - 1);
+            int sincR = FIRipol_N * limit_range((int)(FIRipol_M * (float(i_dtimeR + 1) - dR.v)),
+                                                0, FIRipol_M - 1);
 
-        // get delay output
-        tbufferL[k] = 0;
-        tbufferR[k] = 0;
-        for (int i = 0; i < FIRipol_N; i++)
-        {
-            tbufferL[k] +=
-                buffer[(rpL - i) & (max_delay_length - 1)] * sinctable1X[sincL + FIRipol_N - i];
-            tbufferR[k] +=
-                buffer[(rpR - i) & (max_delay_length - 1)] * sinctable1X[sincR + FIRipol_N - i];
+            tbufferL[k] = 0;
+            tbufferR[k] = 0;
+            for (int i = 0; i < FIRipol_N; i++)
+            {
+                tbufferL[k] += hornDelay.buffer[(rpL - i) & (max_delay_length - 1)] *
+                               sinctable1X[sincL + FIRipol_N - i];
+                tbufferR[k] += hornDelay.buffer[(rpR - i) & (max_delay_length - 1)] *
+                               sinctable1X[sincR + FIRipol_N - i];
+            }
+
+            dL.process();
+            dR.process();
+            continue;
         }
+
+        // the sample just written is one back from the next write
+        const float lim = max_delay_length - FIRipol_N - 1;
+        float dtime alignas(16)[2] = {limit_range(dL.v, (float)BLOCK_SIZE, lim) + FIRoffset + 1,
+                                      limit_range(dR.v, (float)BLOCK_SIZE, lim) + FIRoffset + 1};
+
+        // get delay output
+        float o alignas(16)[4];
+        _mm_store_ps(o, hornDelay.readTaps<Delay::SINC_1X, 2>(dtime));
+        tbufferL[k] = o[0];
+        tbufferR[k] = o[1];
+
         dL.process();
         dR.process();
     }
@@ -345,9 +362,6 @@ void RotarySpeakerEffect::process(float *dataL, float *dataR)
     decodeMS(M, S, wbL, wbR, BLOCK_SIZE_QUAD);
 
     mix.fade_2_blocks_to(dataL, wbL, dataR, wbR, dataL, dataR, BLOCK_SIZE_QUAD);
-
-    wpos += BLOCK_SIZE;
-    wpos = wpos & (max_delay_length - 1);
 }
 
 void RotarySpeakerEffect::handleStreamingMismatches(int streamingRevision,
@@ -18,6 +18,7 @@
 #include "BiquadFilter.h"
 #include "DspUtilities.h"
 #include "AllpassFilter.h"
+#include "SSESincDelayLine.h"
 
 #include "VectorizedSvfFilter.h"
 
@@ -61,8 +62,8 @@ class RotarySpeakerEffect : public Effect
     };
 
   protected:
-    float buffer[max_delay_length];
-    int wpos;
+    using Delay = SSESincDelayLine<max_delay_length>;
+    Delay hornDelay; // the upper band, which the horn plays
     // filter *lp[2],*hp[2];
     // biquadunit rotor_lpL,rotor_lpR;
     BiquadFilter xover, lowbass;
@@ -15,9 +15,10 @@
 // vocoder_freq_vsm201[n_vocoder_bands] = {170, 240, 340, 440, 560, 680, 820, 970, 1150, 1370, 1605,
 // 1850, 2150, 2500, 2900, 3400, 4050, 4850, 5850, 7500};
 
-const float vocoder_freq_vsm201[n_vocoder_bands] = {180,  219,  266,  324,  394,  480,  584,
-                                                    711,  865,  1053, 1281, 1559, 1898, 2309,
-                                                    2810, 3420, 4162, 5064, 6163, 7500};
+const float vocoder_freq_vsm201[n_vocoder_default_bands] = {180,  219,  266,  324,  394,
+                                                            480,  584,  711,  865,  1053,
+                                                            1281, 1559, 1898, 2309, 2810,
+                                                            3420, 4162, 5064, 6163, 7500};
 
 //------------------------------------------------------------------------------------------------
 
@@ -29,7 +30,7 @@ VocoderEffect::VocoderEffect(SurgeStorage *storage, FxStorage *fxdata, pdata *pd
     mVoicedLevel = 0.f;
     mUnvoicedLevel = 0.f;*/
 
-    active_bands = n_vocoder_bands;
+    active_bands = n_vocoder_default_bands;
     mGain.set_blocksize(BLOCK_SIZE);
     mGainR.set_blocksize(BLOCK_SIZE);
     for (int i = 0; i < voc_vector_size; i++)
@@ -58,8 +59,12 @@ void VocoderEffect::setvars(bool init)
     const float Q = 20.f * (1.f + 0.5f * *f[voc_q]);
     const float Spread = 0.4f / Q;
 
-    active_bands = *pdata_ival[voc_num_bands];
-    active_bands = active_bands - (active_bands % 4); // FIXME - adjust the UI to be chunks of 4
+    // the parameter's range follows Extend Range (see Parameter::set_extend_range), this only
+    // keeps the DSP inside it
+    int max_bands =
+        fxdata->p[voc_num_bands].extend_range ? n_vocoder_bands : n_vocoder_default_bands;
+    active_bands = limit_range(*pdata_ival[voc_num_bands], 4, max_bands);
+    active_bands = active_bands - (active_bands % 4);
 
     // We need to clamp these in reasonable ranges
     float flo = limit_range(*f[voc_minfreq], -36.f, 36.f);
@@ -214,6 +219,13 @@ void VocoderEffect::process(float *dataL, float *dataR)
             dataR[i] = rand11;
          }*/
 
+    /*
+     * The groups of 4 bands are independent, so running all of them for each sample (rather than
+     * each group over the block) lets their filters overlap in the pipeline. The envelope
+     * followers run in the same loop so the modulator output never leaves registers.
+     */
+    const int groups = std::min(active_bands >> 2, voc_vector_size);
+
     if (modulator_mode == vim_mono || modulator_mode == vim_left || modulator_mode == vim_right)
     {
         float *input;
@@ -237,7 +249,7 @@ void VocoderEffect::process(float *dataL, float *dataR)
             vFloat LeftSum = vZero;
             vFloat RightSum = vZero;
 
-            for (int j = 0; (j < (active_bands >> 2)) && (j < voc_vector_size); j++)
+            for (int j = 0; j < groups; j++)
             {
                 vFloat Mod = mModulator[j].CalcBPF(In);
                 Mod = vMin(vMul(Mod, Mod), MaxLevel);
@@ -266,7 +278,7 @@ void VocoderEffect::process(float *dataL, float *dataR)
             vFloat LeftSum = vZero;
             vFloat RightSum = vZero;
 
-            for (int j = 0; j < (active_bands >> 2) && j < (n_vocoder_bands >> 2); j++)
+            for (int j = 0; j < groups; j++)
             {
                 vFloat ModL = mModulator[j].CalcBPF(InL);
                 vFloat ModR = mModulatorR[j].CalcBPF(InR);
@@ -304,11 +316,11 @@ void VocoderEffect::init_default_values()
     fxdata->p[voc_envfollow].val.f = 0.f;
     fxdata->p[voc_q].val.f = 0.f;
 
-    fxdata->p[voc_num_bands].val.i = n_vocoder_bands;
+    fxdata->p[voc_num_bands].val.i = n_vocoder_default_bands;
 
     fxdata->p[voc_minfreq].val.f = 12.f * log(vocoder_freq_vsm201[0] / 440.f) / log(2.f);
     fxdata->p[voc_maxfreq].val.f =
-        12.f * log(vocoder_freq_vsm201[n_vocoder_bands - 1] / 440.f) / log(2.f);
+        12.f * log(vocoder_freq_vsm201[n_vocoder_default_bands - 1] / 440.f) / log(2.f);
 
     fxdata->p[voc_mod_range].val.f = 0.f;
     fxdata->p[voc_mod_center].val.f = 0.f;
@@ -385,6 +397,7 @@ void VocoderEffect::init_ctrltypes()
 
     fxdata->p[voc_num_bands].set_name("Bands");
     fxdata->p[voc_num_bands].set_type(ct_vocoder_bandcount);
+    fxdata->p[voc_num_bands].set_extend_range(fxdata->p[voc_num_bands].extend_range);
     fxdata->p[voc_num_bands].posy_offset = 3;
 
     fxdata->p[voc_minfreq].set_name("Min Frequency");
@@ -417,11 +430,11 @@ void VocoderEffect::handleStreamingMismatches(int streamingRevision,
 {
     if (streamingRevision <= 10)
     {
-        fxdata->p[voc_num_bands].val.i = n_vocoder_bands;
+        fxdata->p[voc_num_bands].val.i = n_vocoder_default_bands;
 
         fxdata->p[voc_minfreq].val.f = 12.f * log(vocoder_freq_vsm201[0] / 440.f) / log(2.f);
         fxdata->p[voc_maxfreq].val.f =
-            12.f * log(vocoder_freq_vsm201[n_vocoder_bands - 1] / 440.f) / log(2.f);
+            12.f * log(vocoder_freq_vsm201[n_vocoder_default_bands - 1] / 440.f) / log(2.f);
 
         fxdata->p[voc_mod_range].val.f = 0.f;
         fxdata->p[voc_mod_center].val.f = 0.f;
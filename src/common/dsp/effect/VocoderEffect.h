@@ -24,7 +24,7 @@
 #include <vt_dsp/halfratefilter.h>
 #include <vt_dsp/lipol.h>
 
-const int n_vocoder_bands = 20;
+// processed 4 bands to a register, see n_vocoder_bands
 const int voc_vector_size = n_vocoder_bands >> 2;
 
 class VocoderEffect : public Effect
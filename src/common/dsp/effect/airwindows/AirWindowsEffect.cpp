@@ -238,7 +238,10 @@ void AirWindowsEffect::process(float *dataL, float *dataR)
         out[0] = &(outL[0]) + subb * QBLOCK;
         out[1] = &(outR[0]) + subb * QBLOCK;
 
-        airwin->processReplacing(in, out, QBLOCK);
+        if (stereo)
+            stereo->processReplacing(airwin.get(), in, out, QBLOCK);
+        else
+            airwin->processReplacing(in, out, QBLOCK);
     }
 
     copy_block(outL, dataL, BLOCK_SIZE_QUAD);
@@ -260,6 +263,7 @@ void AirWindowsEffect::setupSubFX(int sfx, bool useStreamedValues)
 
     char fxname[1024];
     airwin->getEffectName(fxname);
+    stereo = AirWindowsStereo::create(fxname);
     lastSelected = sfx;
     resetCtrlTypes(useStreamedValues);
 
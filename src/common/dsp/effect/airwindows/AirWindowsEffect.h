@@ -4,6 +4,7 @@
 
 #include "../Effect.h"
 #include "airwindows/AirWinBaseClass.h"
+#include "AirWindowsStereo.h"
 
 #include <vector>
 #include "UserDefaults.h"
@@ -49,6 +50,8 @@ class alignas(16) AirWindowsEffect : public Effect
 
     void setupSubFX(int awfx, bool useStreamedValues);
     std::unique_ptr<AirWinBaseClass> airwin;
+    // runs airwin's channels in SIMD lanes, for the algorithms which have one
+    std::unique_ptr<AirWindowsStereo::Kernel> stereo;
     int lastSelected = -1;
 
     std::vector<AirWinBaseClass::Registration> fxreg;
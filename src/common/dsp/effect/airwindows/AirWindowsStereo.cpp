@@ -0,0 +1,252 @@
+#include "AirWindowsStereo.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <emmintrin.h>
+
+namespace AirWindowsStereo
+{
+static inline __m128d load(float **in, int i)
+{
+    return _mm_cvtps_pd(_mm_unpacklo_ps(_mm_load_ss(in[0] + i), _mm_load_ss(in[1] + i)));
+}
+
+static inline void store(float **out, int i, __m128d v)
+{
+    __m128 r = _mm_cvtpd_ps(v);
+    _mm_store_ss(out[0] + i, r);
+    _mm_store_ss(out[1] + i, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1)));
+}
+
+// mask ? a : b, lane by lane
+static inline __m128d select(__m128d mask, __m128d a, __m128d b)
+{
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+// int products wrap, as they do in the airwindows code
+static inline int wrapsq(int a) { return (int)((uint32_t)a * (uint32_t)a); }
+
+/*
+ * The older airwindows replace digital silence with a -300dB noise from a static counter in
+ * processReplacing. Each lane here keeps its own counter rather than sharing one between every
+ * instance, which changes nothing audible.
+ */
+static double residue(int &noisesource)
+{
+    noisesource = noisesource % 1700021;
+    noisesource++;
+    int residue = wrapsq(noisesource);
+    residue = residue % 170003;
+    residue = wrapsq(residue);
+    residue = residue % 17011;
+    residue = wrapsq(residue);
+    residue = residue % 1709;
+    residue = wrapsq(residue);
+    residue = residue % 173;
+    residue = wrapsq(residue);
+    residue = residue % 17;
+    double applyresidue = residue;
+    applyresidue *= 0.00000001;
+    applyresidue *= 0.00000001;
+    return applyresidue;
+}
+
+static inline void fixDenormals(__m128d &x, int noisesource[2])
+{
+    const __m128d tiny = _mm_set1_pd(1.2e-38);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d m = _mm_and_pd(_mm_cmplt_pd(x, tiny), _mm_cmplt_pd(_mm_xor_pd(x, sign), tiny));
+    int bits = _mm_movemask_pd(m);
+    if (bits)
+    {
+        double d alignas(16)[2];
+        _mm_store_pd(d, x);
+        for (int c = 0; c < 2; ++c)
+            if (bits & (1 << c))
+                d[c] = residue(noisesource[c]);
+        x = _mm_load_pd(d);
+    }
+}
+
+// airwindows' slew clamp: x moves at most threshold from last
+static inline __m128d slewClamp(__m128d x, __m128d last, __m128d thr, __m128d nthr)
+{
+    __m128d clamp = _mm_sub_pd(x, last);
+    x = select(_mm_cmpgt_pd(clamp, thr), _mm_add_pd(last, thr), x);
+    return select(_mm_cmplt_pd(clamp, nthr), _mm_sub_pd(last, thr), x);
+}
+
+struct Slew2 : Kernel
+{
+    __m128d last1 = _mm_setzero_pd(), last2 = _mm_setzero_pd(), last3 = _mm_setzero_pd();
+    __m128d ataA = _mm_setzero_pd(), ataB = _mm_setzero_pd();
+    __m128d prevDiff = _mm_setzero_pd(), lastSample = _mm_setzero_pd();
+    bool flip = false; // the two channels' flips always agree
+    int noisesource[2] = {0, 0};
+
+    // the antialiasing step, returning the new C
+    inline __m128d antialias(__m128d c, __m128d decay)
+    {
+        if (flip)
+        {
+            ataA = _mm_add_pd(_mm_mul_pd(ataA, decay), c);
+            ataB = _mm_sub_pd(_mm_mul_pd(ataB, decay), c);
+            c = ataA;
+        }
+        else
+        {
+            ataB = _mm_add_pd(_mm_mul_pd(ataB, decay), c);
+            ataA = _mm_sub_pd(_mm_mul_pd(ataA, decay), c);
+            c = ataB;
+        }
+        flip = !flip;
+        return c;
+    }
+
+    void processReplacing(AirWinBaseClass *aw, float **in, float **out, int n) override
+    {
+        float A = aw->getParameter(0);
+
+        double overallscale = 2.0;
+        overallscale /= 44100.0;
+        overallscale *= aw->getSampleRate();
+        double threshold = pow((1 - A), 4) / overallscale;
+        __m128d thr = _mm_set1_pd(threshold), nthr = _mm_set1_pd(-threshold);
+
+        const __m128d tweak = _mm_set1_pd(0.0414213562373095048801688);
+        const __m128d decay = _mm_set1_pd(0.915965594177219015);
+        const __m128d two = _mm_set1_pd(2.0), scale = _mm_set1_pd(0.734);
+
+        for (int i = 0; i < n; ++i)
+        {
+            __m128d x = load(in, i);
+            fixDenormals(x, noisesource);
+            __m128d dry = x;
+
+            __m128d halfDry = _mm_add_pd(_mm_add_pd(x, last1),
+                                         _mm_mul_pd(_mm_sub_pd(last3, last2), tweak));
+            halfDry = _mm_div_pd(halfDry, two);
+            last3 = last2;
+            last2 = last1;
+            last1 = x;
+
+            // airwindows clamps the halfway sample against the half dry sample, which it
+            // equals, so it passes through
+            __m128d halfway = halfDry;
+            lastSample = halfway;
+            __m128d halfDiff = antialias(_mm_sub_pd(halfway, halfDry), decay);
+            halfDiff = _mm_mul_pd(halfDiff, decay);
+
+            // and the input sample
+            x = slewClamp(x, lastSample, thr, nthr);
+            lastSample = x;
+            __m128d diff = _mm_mul_pd(antialias(_mm_sub_pd(x, dry), decay), decay);
+
+            __m128d sum = _mm_add_pd(_mm_add_pd(diff, halfDiff), prevDiff);
+            x = _mm_add_pd(dry, _mm_div_pd(sum, scale));
+            prevDiff = _mm_div_pd(diff, two);
+
+            store(out, i, x);
+        }
+    }
+};
+
+struct Capacitor : Kernel
+{
+    // the six poles of each filter, of which each sample passes through three
+    __m128d iirHighpass[6], iirLowpass[6];
+    int count = 0;
+
+    double lowpassChase = 0.0, highpassChase = 0.0, wetChase = 0.0;
+    double lowpassAmount = 1.0, highpassAmount = 0.0, wet = 1.0;
+    double lastLowpass = 1000.0, lastHighpass = 1000.0, lastWet = 1000.0;
+    double fpNShape[2] = {0.0, 0.0};
+    int noisesource[2] = {0, 0};
+
+    Capacitor()
+    {
+        for (int p = 0; p < 6; ++p)
+            iirHighpass[p] = iirLowpass[p] = _mm_setzero_pd();
+    }
+
+    static inline __m128d pole(__m128d &hp, __m128d &lp, __m128d x, __m128d hpAmt,
+                               __m128d invHp, __m128d lpAmt, __m128d invLp)
+    {
+        hp = _mm_add_pd(_mm_mul_pd(hp, invHp), _mm_mul_pd(x, hpAmt));
+        x = _mm_sub_pd(x, hp);
+        lp = _mm_add_pd(_mm_mul_pd(lp, invLp), _mm_mul_pd(x, lpAmt));
+        return lp;
+    }
+
+    void processReplacing(AirWinBaseClass *aw, float **in, float **out, int n) override
+    {
+        float A = aw->getParameter(0), B = aw->getParameter(1), C = aw->getParameter(2);
+
+        lowpassChase = pow(A, 2);
+        highpassChase = pow(B, 2);
+        wetChase = C;
+        double lowpassSpeed = 300 / (fabs(lastLowpass - lowpassChase) + 1.0);
+        double highpassSpeed = 300 / (fabs(lastHighpass - highpassChase) + 1.0);
+        double wetSpeed = 300 / (fabs(lastWet - wetChase) + 1.0);
+        lastLowpass = lowpassChase;
+        lastHighpass = highpassChase;
+        lastWet = wetChase;
+
+        for (int i = 0; i < n; ++i)
+        {
+            __m128d x = load(in, i);
+            fixDenormals(x, noisesource);
+            __m128d drySample = _mm_cvtps_pd(_mm_cvtpd_ps(x)); // airwindows keeps it as a float
+
+            lowpassAmount =
+                (((lowpassAmount * lowpassSpeed) + lowpassChase) / (lowpassSpeed + 1.0));
+            highpassAmount =
+                (((highpassAmount * highpassSpeed) + highpassChase) / (highpassSpeed + 1.0));
+            wet = (((wet * wetSpeed) + wetChase) / (wetSpeed + 1.0));
+            double dry = 1.0 - wet;
+
+            __m128d lpAmt = _mm_set1_pd(lowpassAmount), invLp = _mm_set1_pd(1.0 - lowpassAmount);
+            __m128d hpAmt = _mm_set1_pd(highpassAmount);
+            __m128d invHp = _mm_set1_pd(1.0 - highpassAmount);
+
+            count++;
+            if (count > 5)
+                count = 0;
+
+            // pole A always, then B or C alternately, then D, E and F in turn
+            int second = 1 + (count & 1), third = 3 + count % 3;
+            x = pole(iirHighpass[0], iirLowpass[0], x, hpAmt, invHp, lpAmt, invLp);
+            x = pole(iirHighpass[second], iirLowpass[second], x, hpAmt, invHp, lpAmt, invLp);
+            x = pole(iirHighpass[third], iirLowpass[third], x, hpAmt, invHp, lpAmt, invLp);
+
+            x = _mm_add_pd(_mm_mul_pd(drySample, _mm_set1_pd(dry)),
+                           _mm_mul_pd(x, _mm_set1_pd(wet)));
+
+            // the dither draws from rand, L then R, so it stays scalar
+            double s alignas(16)[2];
+            _mm_store_pd(s, x);
+            for (int c = 0; c < 2; ++c)
+            {
+                int expon;
+                frexpf((float)s[c], &expon);
+                double dither =
+                    (rand() / (RAND_MAX * 7.737125245533627e+25)) * std::ldexp(1.0, expon + 62);
+                s[c] += (dither - fpNShape[c]);
+                fpNShape[c] = dither;
+                out[c][i] = s[c];
+            }
+        }
+    }
+};
+
+std::unique_ptr<Kernel> create(const std::string &name)
+{
+    if (name == "Capacitor")
+        return std::make_unique<Capacitor>();
+    if (name == "Slew2")
+        return std::make_unique<Slew2>();
+    return nullptr;
+}
+} // namespace AirWindowsStereo
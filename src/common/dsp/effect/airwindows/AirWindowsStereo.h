@@ -0,0 +1,32 @@
+// -*-c++-*-
+
+#pragma once
+
+#include "airwindows/AirWinBaseClass.h"
+
+#include <memory>
+#include <string>
+
+/*
+ * Some airwindows run their left and right channels through identical code, with identical
+ * control flow, sample by sample. For those a Kernel runs both channels in the two lanes of an
+ * SSE2 double register instead.
+ *
+ * A Kernel keeps its own copy of the algorithm's state, set up as the algorithm's constructor
+ * does, and reads the parameters from the AirWinBaseClass it stands in for, so the owner keeps
+ * setting parameters on that as before and calls the Kernel's processReplacing in place of its.
+ *
+ * The results match the scalar code exactly except where the scalar code keeps a sample in a
+ * long double. On x87 that is wider than a double, and the output can differ in the last bit.
+ */
+namespace AirWindowsStereo
+{
+struct Kernel
+{
+    virtual ~Kernel() = default;
+    virtual void processReplacing(AirWinBaseClass *aw, float **in, float **out, int n) = 0;
+};
+
+// A Kernel for the effect getEffectName calls name, or nullptr if it doesn't have one
+std::unique_ptr<Kernel> create(const std::string &name);
+} // namespace AirWindowsStereo
@@ -29,6 +29,8 @@ CHOWEffect::~CHOWEffect() {}
 
 void CHOWEffect::init()
 {
+    os.setOSFactor(oversampling_bits(default_os_bits));
+    cur_os = os.getOSFactor() > 0;
     os.reset();
     makeup.set_target(1.0f);
     mix.set_target(1.0f);
@@ -59,6 +61,8 @@ static inline float chowProcess(float x, const float threshGain, const float rat
 
 void CHOWEffect::process(float *dataL, float *dataR)
 {
+    os.setOSFactor(oversampling_bits(default_os_bits));
+    cur_os = os.getOSFactor() > 0;
     set_params();
 
     for (int i = 0; i < BLOCK_SIZE; i++)
@@ -111,7 +115,8 @@ void CHOWEffect::process_block(float *dataL, float *dataR)
 
 void CHOWEffect::process_block_os(float *dataL, float *dataR)
 {
-    os.upsample(dataL, dataR);
+    // at the level the makeup gain expects
+    os.upsample(dataL, dataR, os.upGain(default_os_bits));
 
     float cur_thresh, cur_ratio;
     bool cur_flip;
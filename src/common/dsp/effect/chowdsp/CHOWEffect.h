@@ -16,7 +16,7 @@
 #pragma once
 #include "../Effect.h"
 #include "shared/SmoothedValue.h"
-#include "shared/Oversampling.h"
+#include "Oversampling.h"
 #include <vt_dsp/lipol.h>
 
 namespace chowdsp
@@ -65,10 +65,11 @@ class CHOWEffect : public Effect
         SmoothSteps = 200,
     };
 
+    static constexpr int default_os_bits = 2;
     bool cur_os = true;
     float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
     lipol_ps makeup alignas(16), mix alignas(16);
-    Oversampling<2, BLOCK_SIZE> os;
+    Oversampling<3, BLOCK_SIZE> os;
     SmoothedValue<float, ValueSmoothingTypes::Multiplicative> thresh_smooth, ratio_smooth;
 };
 
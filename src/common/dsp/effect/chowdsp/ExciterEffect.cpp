@@ -40,7 +40,10 @@ void ExciterEffect::init()
     toneFilter.coeff_HP(M_PI, q_val);
     toneFilter.coeff_instantize();
 
-    levelDetector.reset(samplerate);
+    os.setOSFactor(oversampling_bits(default_os_bits));
+    os.reset();
+    // the detector's times were voiced running at the default factor
+    levelDetector.reset(samplerate * os.upGain(default_os_bits));
 
     drive_gain.set_target(1.0f);
     wet_gain.set_target(0.0f);
@@ -48,14 +51,21 @@ void ExciterEffect::init()
 
 void ExciterEffect::process(float *dataL, float *dataR)
 {
+    int osBits = oversampling_bits(default_os_bits);
+    if (osBits != os.getOSFactor())
+    {
+        os.setOSFactor(osBits);
+        levelDetector.reset(samplerate * os.upGain(default_os_bits));
+    }
+
     set_params();
 
     // copy dry signal
     copy_block(dataL, dryL, BLOCK_SIZE_QUAD);
     copy_block(dataR, dryR, BLOCK_SIZE_QUAD);
 
-    drive_gain.multiply_2_blocks(dataL, dataR, BLOCK_SIZE_QUAD * os.getOSRatio());
-    os.upsample(dataL, dataR);
+    drive_gain.multiply_2_blocks(dataL, dataR, BLOCK_SIZE_QUAD);
+    os.upsample(dataL, dataR, os.upGain(default_os_bits));
 
     for (int k = 0; k < os.getUpBlockSize(); k++)
         process_sample(os.leftUp[k], os.rightUp[k]);
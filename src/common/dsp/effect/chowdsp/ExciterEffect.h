@@ -16,7 +16,7 @@
 #pragma once
 #include <dsp/effect/Effect.h>
 #include "BiquadFilter.h"
-#include "shared/Oversampling.h"
+#include "Oversampling.h"
 #include "exciter/LevelDetector.h"
 #include <vt_dsp/basic_dsp.h>
 #include <vt_dsp/lipol.h>
@@ -69,7 +69,8 @@ class ExciterEffect : public Effect
         r = std::tanh(r) * levelR;
     }
 
-    Oversampling<1, BLOCK_SIZE> os;
+    static constexpr int default_os_bits = 1;
+    Oversampling<3, BLOCK_SIZE> os;
     BiquadFilter toneFilter;
     LevelDetector levelDetector;
 
@@ -39,6 +39,7 @@ void NeuronEffect::init()
     delay1Smooth.reset(numSteps);
     delay2Smooth.reset(numSteps);
 
+    os.setOSFactor(oversampling_bits(default_os_bits));
     os.reset();
 
     delay1.prepare(dsamplerate * os.getOSRatio(), BLOCK_SIZE);
@@ -61,9 +62,25 @@ void NeuronEffect::init()
 
 void NeuronEffect::process(float *dataL, float *dataR)
 {
+    int osBits = oversampling_bits(default_os_bits);
+    bool osChanged = osBits != os.getOSFactor();
+    if (osChanged)
+    {
+        os.setOSFactor(osBits);
+        delay1.reset();
+        delay2.reset();
+    }
+
     set_params();
 
-    os.upsample(dataL, dataR);
+    if (osChanged)
+    {
+        // the delay times are in samples at the new rate, so jump rather than glide to them
+        delay1Smooth.reset(numSteps);
+        delay2Smooth.reset(numSteps);
+    }
+
+    os.upsample(dataL, dataR, os.upGain(default_os_bits));
     process_internal(os.leftUp, os.rightUp, os.getUpBlockSize());
     os.downsample(dataL, dataR);
 
@@ -19,7 +19,7 @@
 #include "BiquadFilter.h"
 #include "shared/DelayLine.h"
 #include "dsp/effect/ModControl.h"
-#include "shared/Oversampling.h"
+#include "Oversampling.h"
 #include "shared/SmoothedValue.h"
 
 #include <vt_dsp/lipol.h>
@@ -106,7 +106,8 @@ class NeuronEffect : public Effect
     lipol_ps makeup alignas(16), width alignas(16), outgain alignas(16);
     chowdsp::DelayLine<float, chowdsp::DelayLineInterpolationTypes::Linear> delay1{1 << 18, 2};
     chowdsp::DelayLine<float, chowdsp::DelayLineInterpolationTypes::Linear> delay2{1 << 18, 2};
-    Oversampling<2, BLOCK_SIZE> os;
+    static constexpr int default_os_bits = 2;
+    Oversampling<3, BLOCK_SIZE> os;
 
     Surge::ModControl modLFO;
 };
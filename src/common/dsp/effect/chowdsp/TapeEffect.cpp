@@ -30,6 +30,7 @@ TapeEffect::~TapeEffect() {}
 
 void TapeEffect::init()
 {
+    hysteresis.set_os_factor(oversampling_bits(HysteresisProcessor::default_os_bits));
     hysteresis.reset(samplerate);
     toneControl.prepare(samplerate);
     lossFilter.prepare(samplerate, BLOCK_SIZE);
@@ -59,6 +60,7 @@ void TapeEffect::process(float *dataL, float *dataR)
         auto thb = clamp01(*f[tape_bias]);
         auto tht = clamp1bp(*f[tape_tone]);
 
+        hysteresis.set_os_factor(oversampling_bits(HysteresisProcessor::default_os_bits));
         hysteresis.set_params(thd, ths, thb);
         toneControl.set_params(tht);
 
@@ -16,9 +16,25 @@ void HysteresisProcessor::reset(double sample_rate)
     dc_blocker.coeff_HP(35.0f / sample_rate, 0.707);
     dc_blocker.coeff_instantize();
 
+    fs = sample_rate;
     for (size_t ch = 0; ch < 2; ++ch)
     {
-        hProcs[ch].setSampleRate(sample_rate);
+        // the solver was voiced with the base rate at the default factor, so it keeps the
+        // same steps per input sample at the others
+        hProcs[ch].setSampleRate(fs * os.upGain(default_os_bits));
+        hProcs[ch].reset();
+    }
+}
+
+void HysteresisProcessor::set_os_factor(int bits)
+{
+    if (bits == os.getOSFactor())
+        return;
+
+    os.setOSFactor(bits);
+    for (size_t ch = 0; ch < 2; ++ch)
+    {
+        hProcs[ch].setSampleRate(fs * os.upGain(default_os_bits));
         hProcs[ch].reset();
     }
 }
@@ -43,7 +59,7 @@ void HysteresisProcessor::process_block(float *dataL, float *dataR)
 {
     bool needsSmoothing = drive.isSmoothing() || width.isSmoothing() || sat.isSmoothing();
 
-    os.upsample(dataL, dataR);
+    os.upsample(dataL, dataR, os.upGain(default_os_bits));
 
     if (needsSmoothing)
         process_internal_smooth(os.leftUp, os.rightUp, os.getUpBlockSize());
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "../shared/SmoothedValue.h"
-#include "../shared/Oversampling.h"
+#include "Oversampling.h"
 #include "BiquadFilter.h"
 #include "HysteresisProcessing.h"
 
@@ -15,6 +15,10 @@ class HysteresisProcessor
 
     void reset(double sample_rate);
 
+    // The oversampling is 2^bits, default_os_bits unless the slot asks otherwise
+    static constexpr int default_os_bits = 2;
+    void set_os_factor(int bits);
+
     void set_params(float drive, float sat, float bias);
     void process_block(float *dataL, float *dataR);
 
@@ -33,7 +37,8 @@ class HysteresisProcessor
     SmoothedValue<float, ValueSmoothingTypes::Multiplicative> makeup;
 
     HysteresisProcessing hProcs[2];
-    Oversampling<2, BLOCK_SIZE> os;
+    Oversampling<3, BLOCK_SIZE> os;
+    double fs = 48000.0;
     BiquadFilter dc_blocker;
 };
 
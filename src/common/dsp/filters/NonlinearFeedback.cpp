@@ -32,53 +32,27 @@ enum Saturator
     SAT_SINE
 };
 
-// sine each element of a __m128 by breaking it into floats then reassembling
-static inline __m128 fastsin_ps(const __m128 in) noexcept
-{
-    float f[4];
-    _mm_storeu_ps(f, in);
-    f[0] = Surge::DSP::fastsin(f[0]);
-    f[1] = Surge::DSP::fastsin(f[1]);
-    f[2] = Surge::DSP::fastsin(f[2]);
-    f[3] = Surge::DSP::fastsin(f[3]);
-    return _mm_load_ps(f);
-}
-
-// waveshaper from https://github.com/JanosGit/Schrammel_OJD/blob/master/Source/Waveshaper.h
-static inline float ojd_waveshaper(float in) noexcept
-{
-    if (in <= -1.7f)
-    {
-        return -1.0f;
-    }
-    else if ((in > -1.7f) && (in < -0.3f))
-    {
-        in += 0.3f;
-        return in + (in * in) / (4.0f * (1.0f - 0.3f)) - 0.3f;
-    }
-    else if ((in > 0.9f) && (in < 1.1f))
-    {
-        in -= 0.9f;
-        return in - (in * in) / (4.0f * (1.0f - 0.9f)) + 0.9f;
-    }
-    else if (in > 1.1f)
-    {
-        return 1.0f;
-    }
-
-    return in;
-};
-
-// asinh each element of a __m128 by breaking it into floats then reassembling
+// waveshaper from https://github.com/JanosGit/Schrammel_OJD/blob/master/Source/Waveshaper.h,
+// with its branches as lane masks. The bounds are compared as the original does, so 1.1 itself
+// passes through unchanged
 static inline __m128 ojd_waveshaper_ps(const __m128 in) noexcept
 {
-    float f[4];
-    _mm_storeu_ps(f, in);
-    f[0] = ojd_waveshaper(f[0]);
-    f[1] = ojd_waveshaper(f[1]);
-    f[2] = ojd_waveshaper(f[2]);
-    f[3] = ojd_waveshaper(f[3]);
-    return _mm_load_ps(f);
+    const __m128 lo = _mm_add_ps(in, F(0.3f));
+    const __m128 hi = _mm_sub_ps(in, F(0.9f));
+    const __m128 loShaped = S(A(lo, _mm_div_ps(M(lo, lo), F(4.0f * (1.0f - 0.3f)))), F(0.3f));
+    const __m128 hiShaped = A(S(hi, _mm_div_ps(M(hi, hi), F(4.0f * (1.0f - 0.9f)))), F(0.9f));
+
+    const __m128 isMinus = _mm_cmple_ps(in, F(-1.7f));
+    const __m128 isLo = _mm_and_ps(_mm_cmpgt_ps(in, F(-1.7f)), _mm_cmplt_ps(in, F(-0.3f)));
+    const __m128 isHi = _mm_and_ps(_mm_cmpgt_ps(in, F(0.9f)), _mm_cmplt_ps(in, F(1.1f)));
+    const __m128 isPlus = _mm_cmpgt_ps(in, F(1.1f));
+
+    __m128 out = _mm_andnot_ps(_mm_or_ps(_mm_or_ps(isMinus, isLo), _mm_or_ps(isHi, isPlus)), in);
+    out = _mm_or_ps(out, _mm_and_ps(isMinus, F(-1.0f)));
+    out = _mm_or_ps(out, _mm_and_ps(isLo, loShaped));
+    out = _mm_or_ps(out, _mm_and_ps(isHi, hiShaped));
+    out = _mm_or_ps(out, _mm_and_ps(isPlus, F(1.0f)));
+    return out;
 }
 
 static inline __m128 doNLFilter(const __m128 input, const __m128 a1, const __m128 a2,
@@ -102,7 +76,7 @@ static inline __m128 doNLFilter(const __m128 input, const __m128 a1, const __m12
         nf = ojd_waveshaper_ps(out);
         break;
     default: // SAT_SINE
-        nf = fastsin_ps(out);
+        nf = Surge::DSP::fastsinSSE(out);
         break;
     }
 
@@ -23,6 +23,7 @@
 #include "SurgeStorage.h"
 #include "DebugHelpers.h"
 #include "FilterCoefficientMaker.h"
+#include "FastMath.h"
 
 namespace ObxdFilter
 {
@@ -57,8 +58,6 @@ enum Params
     s4,
 };
 
-static constexpr int ssew = 4;
-
 const __m128 zero = _mm_set1_ps(0.0f);
 const __m128 nine_two_zero = _mm_set1_ps(0.00920833f);
 const __m128 zero_zero_five = _mm_set1_ps(0.05f);
@@ -258,18 +257,9 @@ __m128 process_4_pole(QuadFilterUnitState *__restrict f, __m128 sample)
     // f->R[s1] =atan(s1*rcor24)*rcor24inv;
     __m128 s1_rcor24 = _mm_mul_ps(f->R[s1], f->C[rcor24]);
 
-    float s1_rcor24_arr[ssew];
-    _mm_store_ps(s1_rcor24_arr, s1_rcor24);
-
-    for (int i = 0; i < ssew; i++)
-    {
-        if (f->active[i])
-            s1_rcor24_arr[i] = atan(s1_rcor24_arr[i]);
-        else
-            s1_rcor24_arr[i] = 0.f;
-    }
-
-    s1_rcor24 = _mm_load_ps(s1_rcor24_arr);
+    // the idle lanes stay at zero
+    s1_rcor24 = _mm_and_ps(Surge::DSP::fastatanSSE(s1_rcor24),
+                           _mm_loadu_ps((const float *)f->active));
     f->R[s1] = _mm_mul_ps(s1_rcor24, f->C[rcor24inv]);
 
     // float y1 = res;
@@ -58,7 +58,13 @@ static inline int _stricmp(const char *s1, const char *s2) { return strcasecmp(s
 const int BASE_WINDOW_SIZE_X = 904;
 const int BASE_WINDOW_SIZE_Y = 569;
 const int NAMECHARS = 64;
+#ifdef SURGE_COMPILE_BLOCK_SIZE
+const int BLOCK_SIZE = SURGE_COMPILE_BLOCK_SIZE; // see SURGE_COMPILE_BLOCK_SIZE in CMakeLists.txt
+#else
 const int BLOCK_SIZE = 32;
+#endif
+static_assert(BLOCK_SIZE >= 16 && BLOCK_SIZE <= 128 && !(BLOCK_SIZE & (BLOCK_SIZE - 1)),
+              "the block functions in vt_dsp need a power of two block size from 16 to 128");
 const int OSC_OVERSAMPLING = 2;
 const int BLOCK_SIZE_OS = OSC_OVERSAMPLING * BLOCK_SIZE;
 const int BLOCK_SIZE_QUAD = BLOCK_SIZE >> 2;
@@ -93,7 +93,7 @@ void CLFOGui::draw(CDrawContext *dc)
         CGraphicsPath *eupath = dc->createGraphicsPath();
         CGraphicsPath *edpath = dc->createGraphicsPath();
 
-        pdata tp[n_scene_params], tpd[n_scene_params];
+        pdata tp[n_scene_params] = {};
         {
             tp[lfodata->delay.param_id_in_scene].i = lfodata->delay.val.i;
             tp[lfodata->attack.param_id_in_scene].i = lfodata->attack.val.i;
@@ -145,33 +145,11 @@ void CLFOGui::draw(CDrawContext *dc)
             lfoEnvelopeDAHDTime + std::min(pow(2.0f, lfodata->release.val.f), 4.f) +
             0.5; // susTime; this is now 0.5 to keep the envelope fixed in gate mode
 
-        LfoModulationSource *tlfo = new LfoModulationSource();
-        LfoModulationSource *tFullWave = nullptr;
-        tlfo->assign(storage, lfodata, tp, 0, ss, ms, fs, true);
-        tlfo->attack();
-
-        LFOStorage deactivateStorage;
-        bool hasFullWave = false, waveIsAmpWave = false;
+        auto fullWave = Surge::ModulatorPreview::LFOCurveSpec::NO_FULL_WAVE;
+        bool waveIsAmpWave = false;
         if (lfodata->rate.deactivated)
         {
-            hasFullWave = true;
-            memcpy((void *)(&deactivateStorage), (void *)lfodata, sizeof(LFOStorage));
-            memcpy((void *)tpd, (void *)tp, n_scene_params * sizeof(pdata));
-
-            auto desiredRate = log2(1.f / totalEnvTime);
-            if (lfodata->shape.val.i == lt_mseg)
-            {
-                desiredRate = log2(ms->totalDuration / totalEnvTime);
-            }
-
-            deactivateStorage.rate.deactivated = false;
-            deactivateStorage.rate.val.f = desiredRate;
-            deactivateStorage.start_phase.val.f = 0;
-            tpd[lfodata->start_phase.param_id_in_scene].f = 0;
-            tpd[lfodata->rate.param_id_in_scene].f = desiredRate;
-            tFullWave = new LfoModulationSource();
-            tFullWave->assign(storage, &deactivateStorage, tpd, 0, ss, ms, fs, true);
-            tFullWave->attack();
+            fullWave = Surge::ModulatorPreview::LFOCurveSpec::DEACTIVATED_RATE;
         }
         else if (lfodata->magnitude.val.f != lfodata->magnitude.val_max.f &&
                  skin->getVersion() >= 2)
@@ -180,16 +158,8 @@ void CLFOGui::draw(CDrawContext *dc)
                 Surge::Storage::getUserDefaultValue(storage, "showGhostedLFOWaveReference", 1);
             if (useAmpWave)
             {
-                hasFullWave = true;
+                fullWave = Surge::ModulatorPreview::LFOCurveSpec::FULL_MAGNITUDE;
                 waveIsAmpWave = true;
-                memcpy((void *)(&deactivateStorage), (void *)lfodata, sizeof(LFOStorage));
-                memcpy((void *)tpd, (void *)tp, n_scene_params * sizeof(pdata));
-
-                deactivateStorage.magnitude.val.f = 1.f;
-                tpd[lfodata->magnitude.param_id_in_scene].f = 1.f;
-                tFullWave = new LfoModulationSource();
-                tFullWave->assign(storage, &deactivateStorage, tpd, 0, ss, ms, fs, true);
-                tFullWave->attack();
             }
         }
         CRect boxo(maindisp);
@@ -219,65 +189,43 @@ void CLFOGui::draw(CDrawContext *dc)
         int averagingWindow = (int)(totalSamples / 1000.0) + 1;
 
         float valScale = 100.0;
-        int susCountdown = -1;
 
+        Surge::ModulatorPreview::LFOCurveSpec spec;
+        spec.lfo = *lfodata;
+        spec.ss = *ss;
+        if (ms)
+            spec.ms = *ms;
+        spec.localcopy.assign(tp, tp + n_scene_params);
+        spec.totalSamples = totalSamples;
+        spec.averagingWindow = averagingWindow;
+        spec.susTime = susTime;
+        spec.fullWave = fullWave;
+        spec.totalEnvTime = totalEnvTime;
+
+        auto curve = findCurve(spec);
+
+        int nPoints = curve ? curve->mean.size() : 0;
         float priorval = 0.f, priorwval = 0.f;
-        for (int i = 0; i < totalSamples; i += averagingWindow)
+        for (int p = 0; p < nPoints; ++p)
         {
-            float val = 0;
-            float wval = 0;
-            float eval = 0;
-            float minval = 1000000, minwval = 1000000;
-            float maxval = -1000000, maxwval = -1000000;
-            float firstval;
-            float lastval;
-            for (int s = 0; s < averagingWindow; s++)
-            {
-                tlfo->process_block();
-                if (tFullWave)
-                    tFullWave->process_block();
-                if (susCountdown < 0 && tlfo->env_state == lenv_stuck)
-                {
-                    susCountdown = susTime * samplerate / BLOCK_SIZE;
-                }
-                else if (susCountdown == 0 && tlfo->env_state == lenv_stuck)
-                {
-                    tlfo->release();
-                    if (tFullWave)
-                        tFullWave->release();
-                }
-                else if (susCountdown > 0)
-                {
-                    susCountdown--;
-                }
-
-                val += tlfo->output;
-                if (tFullWave)
-                {
-                    auto v = tFullWave->output;
-                    minwval = std::min(v, minwval);
-                    maxwval = std::max(v, maxwval);
-                    wval += v;
-                }
-                if (s == 0)
-                    firstval = tlfo->output;
-                if (s == averagingWindow - 1)
-                    lastval = tlfo->output;
-                minval = std::min(tlfo->output, minval);
-                maxval = std::max(tlfo->output, maxval);
-                eval += tlfo->env_val * lfodata->magnitude.get_extended(lfodata->magnitude.val.f);
-            }
-            val = val / averagingWindow;
-            wval = wval / averagingWindow;
-            eval = eval / averagingWindow;
+            float val = curve->mean[p];
+            float eval = curve->env[p];
+            float minval = curve->min[p];
+            float maxval = curve->max[p];
             val = ((-val + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
-            wval = ((-wval + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
-            minwval = ((-minwval + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
-            maxwval = ((-maxwval + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
             float euval = ((-eval + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
             float edval = ((eval + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
 
-            float xc = valScale * i / totalSamples;
+            float wval = 0, minwval = 0, maxwval = 0;
+            if (curve->hasFullWave)
+            {
+                wval = ((-curve->waveMean[p] + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
+                minwval = ((-curve->waveMin[p] + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
+                maxwval = ((-curve->waveMax[p] + 1.0f) * 0.5 * 0.8 + 0.1) * valScale;
+            }
+
+            int i = p * curve->averagingWindow;
+            float xc = valScale * i / curve->totalSamples;
 
             if (i == 0)
             {
@@ -287,7 +235,7 @@ void CLFOGui::draw(CDrawContext *dc)
                     (lfodata->shape.val.i != lt_function)) // TODO FIXME: When function LFO type is
                                                            // added, remove it from this condition!
                     edpath->beginSubpath(xc, edval);
-                if (tFullWave)
+                if (curve->hasFullWave)
                 {
                     deactPath->beginSubpath(xc, wval);
                 }
@@ -307,15 +255,15 @@ void CLFOGui::draw(CDrawContext *dc)
                     firstval = maxval;
                     secondval = minval;
                 }
-                path->addLine(xc - 0.1 * valScale / totalSamples, firstval);
-                path->addLine(xc + 0.1 * valScale / totalSamples, secondval);
+                path->addLine(xc - 0.1 * valScale / curve->totalSamples, firstval);
+                path->addLine(xc + 0.1 * valScale / curve->totalSamples, secondval);
 
                 priorval = val;
                 eupath->addLine(xc, euval);
                 edpath->addLine(xc, edval);
 
                 // We can skip the ordering thing since we know we have set rate here to a low rate
-                if (tFullWave)
+                if (curve->hasFullWave)
                 {
                     firstval = minwval;
                     secondval = maxwval;
@@ -324,15 +272,12 @@ void CLFOGui::draw(CDrawContext *dc)
                         firstval = maxwval;
                         secondval = minwval;
                     }
-                    deactPath->addLine(xc - 0.1 * valScale / totalSamples, firstval);
-                    deactPath->addLine(xc + 0.1 * valScale / totalSamples, secondval);
+                    deactPath->addLine(xc - 0.1 * valScale / curve->totalSamples, firstval);
+                    deactPath->addLine(xc + 0.1 * valScale / curve->totalSamples, secondval);
                     priorwval = wval;
                 }
             }
         }
-        delete tlfo;
-        if (tFullWave)
-            delete tFullWave;
 
         VSTGUI::CGraphicsTransform tf =
             VSTGUI::CGraphicsTransform()
@@ -465,7 +410,7 @@ void CLFOGui::draw(CDrawContext *dc)
         dc->setLineWidth(1.3);
 #endif
 
-        if (hasFullWave)
+        if (curve && curve->hasFullWave)
         {
             dc->saveGlobalState();
 
@@ -701,6 +646,26 @@ void CLFOGui::draw(CDrawContext *dc)
     setDirty(false);
 }
 
+Surge::ModulatorPreview::LFOCurveCache::result_t
+CLFOGui::findCurve(const Surge::ModulatorPreview::LFOCurveSpec &spec)
+{
+    if (!storage->lfoPreviews)
+        storage->lfoPreviews = std::make_unique<Surge::ModulatorPreview::LFOCurveCache>(storage);
+
+    auto key = Surge::ModulatorPreview::lfoCurveKey(storage, spec);
+    auto curve = storage->lfoPreviews->find(key);
+    if (curve)
+    {
+        lastCurve = curve;
+    }
+    else
+    {
+        storage->lfoPreviews->request(key, lfodata, spec);
+        curve = lastCurve;
+    }
+    return curve;
+}
+
 void CLFOGui::drawStepSeq(VSTGUI::CDrawContext *dc, VSTGUI::CRect &maindisp,
                           VSTGUI::CRect &leftpanel)
 {
@@ -963,7 +928,7 @@ void CLFOGui::drawStepSeq(VSTGUI::CDrawContext *dc, VSTGUI::CRect &maindisp,
     // code above but with very different scaling in time since we need to match the steps no
     // matter the rate
 
-    pdata tp[n_scene_params];
+    pdata tp[n_scene_params] = {};
     tp[lfodata->delay.param_id_in_scene].i = lfodata->delay.val.i;
     tp[lfodata->attack.param_id_in_scene].i = lfodata->attack.val.i;
     tp[lfodata->hold.param_id_in_scene].i = lfodata->hold.val.i;
@@ -1016,9 +981,6 @@ void CLFOGui::drawStepSeq(VSTGUI::CDrawContext *dc, VSTGUI::CRect &maindisp,
     float totalSampleTime = cyclesec * n_stepseqsteps;
     float susTime = 4.0 * cyclesec;
 
-    LfoModulationSource *tlfo = new LfoModulationSource();
-    tlfo->assign(storage, lfodata, tp, 0, ss, ms, fs, true);
-    tlfo->attack();
     CRect boxo(rect_steps);
 
     int minSamples = (1 << 3) * (int)(boxo.right - boxo.left);
@@ -1033,47 +995,28 @@ void CLFOGui::drawStepSeq(VSTGUI::CDrawContext *dc, VSTGUI::CRect &maindisp,
 #else
     float valScale = 100.0;
 #endif
-    int susCountdown = -1;
+
+    Surge::ModulatorPreview::LFOCurveSpec spec;
+    spec.lfo = *lfodata;
+    spec.ss = *ss;
+    if (ms)
+        spec.ms = *ms;
+    spec.localcopy.assign(tp, tp + n_scene_params);
+    spec.totalSamples = totalSamples;
+    spec.averagingWindow = averagingWindow;
+    spec.susTime = susTime;
+
+    auto curve = findCurve(spec);
 
     CGraphicsPath *path = dc->createGraphicsPath();
     CGraphicsPath *eupath = dc->createGraphicsPath();
     CGraphicsPath *edpath = dc->createGraphicsPath();
 
-    for (int i = 0; i < totalSamples; i += averagingWindow)
+    int nPoints = curve ? curve->mean.size() : 0;
+    for (int p = 0; p < nPoints; ++p)
     {
-        float val = 0;
-        float eval = 0;
-        float minval = 1000000;
-        float maxval = -1000000;
-        float firstval;
-        float lastval;
-        for (int s = 0; s < averagingWindow; s++)
-        {
-            tlfo->process_block();
-            if (susCountdown < 0 && tlfo->env_state == lenv_stuck)
-            {
-                susCountdown = susTime * samplerate / BLOCK_SIZE;
-            }
-            else if (susCountdown == 0 && tlfo->env_state == lenv_stuck)
-            {
-                tlfo->release();
-            }
-            else if (susCountdown > 0)
-            {
-                susCountdown--;
-            }
-
-            val += tlfo->output;
-            if (s == 0)
-                firstval = tlfo->output;
-            if (s == averagingWindow - 1)
-                lastval = tlfo->output;
-            minval = std::min(tlfo->output, minval);
-            maxval = std::max(tlfo->output, maxval);
-            eval += tlfo->env_val * lfodata->magnitude.get_extended(lfodata->magnitude.val.f);
-        }
-        val = val / averagingWindow;
-        eval = eval / averagingWindow;
+        float val = curve->mean[p];
+        float eval = curve->env[p];
 
         if (lfodata->unipolar.val.b)
             val = val * 2.0 - 1.0;
@@ -1082,6 +1025,7 @@ void CLFOGui::drawStepSeq(VSTGUI::CDrawContext *dc, VSTGUI::CRect &maindisp,
         float euval = ((-eval + 1.0f) * 0.5) * valScale;
         float edval = ((eval + 1.0f) * 0.5) * valScale;
 
+        int i = p * curve->averagingWindow;
         float xc = valScale * i / (cycleSamples * n_stepseqsteps);
         if (i == 0)
         {
@@ -1097,7 +1041,6 @@ void CLFOGui::drawStepSeq(VSTGUI::CDrawContext *dc, VSTGUI::CRect &maindisp,
             edpath->addLine(xc, edval);
         }
     }
-    delete tlfo;
 
     auto q = boxo;
 #if LINUX && !TARGET_JUCE_UI
@@ -23,6 +23,7 @@
 #include "SurgeBitmaps.h"
 #include "CScalableBitmap.h"
 #include "CursorControlGuard.h"
+#include "ModulatorPreview.h"
 
 class CScalableBitmap;
 
@@ -88,6 +89,13 @@ class CLFOGui : public VSTGUI::CControl,
     virtual void draw(VSTGUI::CDrawContext *dc) override;
     void drawStepSeq(VSTGUI::CDrawContext *dc, VSTGUI::CRect &maindisp, VSTGUI::CRect &leftpanel);
 
+    /*
+     * The curve for spec from the background cache. On a miss this requests a render and
+     * returns the last curve we drew (or null) until the idle loop redraws us.
+     */
+    Surge::ModulatorPreview::LFOCurveCache::result_t
+    findCurve(const Surge::ModulatorPreview::LFOCurveSpec &spec);
+
     void invalidateIfIdIsInRange(int id);
     void invalidateIfAnythingIsTemposynced();
 
@@ -138,5 +146,7 @@ class CLFOGui : public VSTGUI::CControl,
     int lfo_type_hover = -1;
     CScalableBitmap *typeImg, *typeImgHover, *typeImgHoverOn;
 
+    Surge::ModulatorPreview::LFOCurveCache::result_t lastCurve;
+
     CLASS_METHODS(CLFOGui, VSTGUI::CControl)
 };
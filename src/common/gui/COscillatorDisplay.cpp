@@ -16,6 +16,7 @@
 #include "SurgeGUIEditor.h"
 #include "COscillatorDisplay.h"
 #include "Oscillator.h"
+#include "OscillatorPreview.h"
 #include <time.h>
 #include "unitconversion.h"
 #include "UserInteractions.h"
@@ -55,11 +56,11 @@ void COscillatorDisplay::draw(CDrawContext *dc)
     }
 
     pdata tp[2][n_scene_params]; // 0 is orange, 1 is blue
-    Oscillator *osces[2];
+    bool hasTrace[2];
     std::string olabel;
     for (int c = 0; c < 2; ++c)
     {
-        osces[c] = nullptr;
+        hasTrace[c] = false;
 
 #if OSC_MOD_ANIMATION
         if (!is_mod && c > 0)
@@ -139,7 +140,7 @@ void COscillatorDisplay::draw(CDrawContext *dc)
         }
 #endif
 
-        osces[c] = spawn_osc(oscdata->type.val.i, storage, oscdata, tp[c]);
+        hasTrace[c] = true;
     }
 
     float h = getHeight();
@@ -165,9 +166,8 @@ void COscillatorDisplay::draw(CDrawContext *dc)
     for (int c = 1; c >= 0; --c) // backwards so we draw blue first
     {
         bool use_display = false;
-        Oscillator *osc = osces[c];
         CGraphicsPath *path = dc->createGraphicsPath();
-        if (osc)
+        if (hasTrace[c])
         {
             float disp_pitch_rs = disp_pitch + 12.0 * log2(dsamplerate / 44100.0);
             if (!storage->isStandardTuning)
@@ -197,61 +197,56 @@ void COscillatorDisplay::draw(CDrawContext *dc)
                     // punt
                 }
             }
-            use_display = osc->allow_display();
 
-            // Mis-install check #2
-            if (uses_wavetabledata(oscdata->type.val.i) && storage->wt_list.size() == 0)
-                use_display = false;
+            /*
+             * Rendering the trace means running the oscillator, which is expensive for wide
+             * unison and the physical models, so it happens on the preview worker. On a miss
+             * we keep drawing the last trace and SurgeGUIEditor::idle redraws us once the
+             * worker is done.
+             */
+            if (!storage->oscillatorPreviews)
+                storage->oscillatorPreviews =
+                    std::make_unique<Surge::Oscillator::PreviewCache>(storage);
+
+            auto key = Surge::Oscillator::previewKey(storage, oscdata, oscdata->type.val.i,
+                                                     tp[c], disp_pitch_rs, totalSamples,
+                                                     averagingWindow);
+            auto trace = storage->oscillatorPreviews->find(key);
+            if (trace)
+            {
+                lastTrace[c] = trace;
+            }
+            else
+            {
+                storage->oscillatorPreviews->request(key, oscdata, oscdata->type.val.i, tp[c],
+                                                     disp_pitch_rs, totalSamples, averagingWindow);
+                trace = lastTrace[c];
+            }
 
-            if (use_display)
-                osc->init(disp_pitch_rs, true, true);
+            use_display = trace && !trace->empty();
 
-            int block_pos = BLOCK_SIZE_OS;
-            for (int i = 0; i < totalSamples; i += averagingWindow)
+            if (use_display)
             {
-                if (use_display && (block_pos >= BLOCK_SIZE_OS))
+                int n = trace->size();
+                for (int p = 0; p < n; ++p)
                 {
-                    if (uses_wavetabledata(oscdata->type.val.i))
+                    float val = (*trace)[p];
+                    val =
+                        ((-val + 1.0f) * 0.5f * (1.0 - scaleDownBy) + 0.5 * scaleDownBy) * valScale;
+                    float xc = valScale * p * averagingWindow / totalSamples;
+
+                    // OK so val is now a value between 0 and valScale, and xc is a value between
+                    // 0 and valScale
+                    if (p == 0)
                     {
-                        storage->waveTableDataMutex.lock();
-                        osc->process_block(disp_pitch_rs);
-                        block_pos = 0;
-                        storage->waveTableDataMutex.unlock();
+                        path->beginSubpath(xc, val);
                     }
                     else
                     {
-                        osc->process_block(disp_pitch_rs);
-                        block_pos = 0;
-                    }
-                }
-
-                float val = 0.f;
-                if (use_display)
-                {
-                    for (int j = 0; j < averagingWindow; ++j)
-                    {
-                        val += osc->output[block_pos];
-                        block_pos++;
+                        path->addLine(xc, val);
                     }
-                    val = val / averagingWindow;
-                    val =
-                        ((-val + 1.0f) * 0.5f * (1.0 - scaleDownBy) + 0.5 * scaleDownBy) * valScale;
-                }
-                block_pos++;
-                float xc = valScale * i / totalSamples;
-
-                // OK so val is now a value between 0 and valScale, and xc is a value between 0 and
-                // valScale
-                if (i == 0)
-                {
-                    path->beginSubpath(xc, val);
-                }
-                else
-                {
-                    path->addLine(xc, val);
                 }
             }
-            // srand( (unsigned)time( NULL ) );
         }
         // OK so now we need to figure out how to transfer the box with is [0,valscale] x
         // [0,valscale] to our coords. So scale then position
@@ -334,7 +329,7 @@ void COscillatorDisplay::draw(CDrawContext *dc)
             }
 
             // OK so now the label
-            if (osces[1])
+            if (hasTrace[1])
             {
                 dc->setFontColor(skin->getColor(Colors::Osc::Display::AnimatedWave));
                 dc->setFont(displayFont);
@@ -367,8 +362,6 @@ void COscillatorDisplay::draw(CDrawContext *dc)
         dc->restoreGlobalState();
 
         path->forget();
-
-        delete osces[c];
     }
 
     if (uses_wavetabledata(oscdata->type.val.i))
@@ -156,6 +156,9 @@ class COscillatorDisplay : public VSTGUI::CControl,
 
     static constexpr float scaleDownBy = 0.235;
 
+    // the traces drawn last time, kept on screen while a new one renders
+    std::shared_ptr<const std::vector<float>> lastTrace[2];
+
 #if OSC_MOD_ANIMATION
     bool is_mod = false;
     modsources modsource = ms_original;
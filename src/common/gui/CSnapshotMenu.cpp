@@ -453,6 +453,9 @@ void CFxMenu::draw(CDrawContext *dc)
 
 void CFxMenu::loadSnapshot(int type, TiXmlElement *e, int idx)
 {
+    // presets don't carry an oversampling choice; a new type starts from its own default
+    fxbuffer->type.deform_type = fxos_default;
+
     if (!type)
         fxbuffer->type.val.i = type;
 
@@ -475,6 +478,12 @@ void CFxMenu::loadSnapshot(int type, TiXmlElement *e, int idx)
             double d;
             int j;
             char lbl[TXT_SIZE], sublbl[TXT_SIZE];
+
+            // first, as it can widen the range the value is clamped to
+            snprintf(sublbl, TXT_SIZE, "p%i_extend_range", i);
+            fxbuffer->p[i].set_extend_range(
+                (e->QueryIntAttribute(sublbl, &j) == TIXML_SUCCESS) && (j == 1));
+
             snprintf(lbl, TXT_SIZE, "p%i", i);
             if (fxbuffer->p[i].valtype == vt_float)
             {
@@ -490,9 +499,6 @@ void CFxMenu::loadSnapshot(int type, TiXmlElement *e, int idx)
             snprintf(sublbl, TXT_SIZE, "p%i_temposync", i);
             fxbuffer->p[i].temposync =
                 ((e->QueryIntAttribute(sublbl, &j) == TIXML_SUCCESS) && (j == 1));
-            snprintf(sublbl, TXT_SIZE, "p%i_extend_range", i);
-            fxbuffer->p[i].extend_range =
-                ((e->QueryIntAttribute(sublbl, &j) == TIXML_SUCCESS) && (j == 1));
             snprintf(sublbl, TXT_SIZE, "p%i_deactivated", i);
             fxbuffer->p[i].deactivated =
                 ((e->QueryIntAttribute(sublbl, &j) == TIXML_SUCCESS) && (j == 1));
@@ -737,6 +743,24 @@ void CFxMenu::populate()
 
     this->addSeparator();
 
+    if (fx_type_has_oversampling(fx->type.val.i))
+    {
+        /*
+        ** The effect reads this from the slot each block, and it streams with the patch
+        */
+        COptionMenu *osMenu = new COptionMenu(getViewSize(), 0, 0, 0, 0, kNoDrawStyle);
+        for (int i = 0; i < n_fx_oversampling; ++i)
+        {
+            auto osItem = new CCommandMenuItem(CCommandMenuItem::Desc(fx_oversampling_names[i]));
+            osItem->setActions([this, i](CCommandMenuItem *item) { fx->type.deform_type = i; });
+            osItem->setChecked(fx->type.deform_type == i);
+            osMenu->addEntry(osItem);
+        }
+        this->addEntry(osMenu, "Oversampling");
+
+        this->addSeparator();
+    }
+
     if (fx->type.val.i != fxt_off)
     {
         auto saveItem = new CCommandMenuItem(
@@ -800,6 +824,7 @@ void CFxMenu::pasteFX()
     }
 
     fxbuffer->type.val.i = (int)fxCopyPaste[0];
+    fxbuffer->type.deform_type = fxos_default;
 
     Effect *t_fx = spawn_effect(fxbuffer->type.val.i, storage, fxbuffer, 0);
     if (t_fx)
@@ -838,7 +863,7 @@ void CFxMenu::pasteFX()
             break;
         }
         fxbuffer->p[i].temposync = (int)fxCopyPaste[tp];
-        fxbuffer->p[i].extend_range = (int)fxCopyPaste[xp];
+        fxbuffer->p[i].set_extend_range((int)fxCopyPaste[xp]);
         fxbuffer->p[i].deactivated = (int)fxCopyPaste[dp];
     }
 
@@ -947,6 +972,7 @@ void CFxMenu::saveFXIn(const std::string &s)
 void CFxMenu::loadUserPreset(const UserPreset &p)
 {
     fxbuffer->type.val.i = p.type;
+    fxbuffer->type.deform_type = fxos_default;
 
     Effect *t_fx = spawn_effect(fxbuffer->type.val.i, storage, fxbuffer, 0);
 
@@ -973,7 +999,7 @@ void CFxMenu::loadUserPreset(const UserPreset &p)
             break;
         }
         fxbuffer->p[i].temposync = (int)p.ts[i];
-        fxbuffer->p[i].extend_range = (int)p.er[i];
+        fxbuffer->p[i].set_extend_range((int)p.er[i]);
         fxbuffer->p[i].deactivated = (int)p.da[i];
     }
 
@@ -15,6 +15,7 @@
 
 #include "MSEGEditor.h"
 #include "MSEGModulationHelper.h"
+#include "ModulatorPreview.h"
 #include "guihelpers.h"
 #include "DebugHelpers.h"
 #include "SkinColors.h"
@@ -1091,10 +1092,17 @@ struct MSEGCanvas : public CControl,
             }
         }
 
-        Surge::MSEG::EvaluatorState es, esdf;
-        es.seed(
-            8675309); // This is different from the number in LFOMS::assign in draw mode on purpose
-        esdf.seed(8675309);
+        /*
+         * The curve only changes with the model, the deform and the zoom, so hovering and
+         * moving the mouse around redraw from the last evaluation. A model change bumps the
+         * MSEG version so we re-evaluate here, in step with the handles being dragged.
+         */
+        std::vector<float> curveTimes(drawArea.getWidth() + 1);
+        for (int q = 0; q < (int)curveTimes.size(); ++q)
+            curveTimes[q] = pxt(q + drawArea.left);
+
+        if (!curve.matches(ms, lfodata->deform.val.f, curveTimes))
+            curve = Surge::ModulatorPreview::renderMSEGCurve(ms, lfodata->deform.val.f, curveTimes);
 
         CGraphicsPath *path = dc->createGraphicsPath();
         CGraphicsPath *highlightPath = dc->createGraphicsPath();
@@ -1118,96 +1126,82 @@ struct MSEGCanvas : public CControl,
 
         float pathFirstY, pathLastX, pathLastY, pathLastDef;
 
-        bool drawnLast =
-            false; // this slightly odd construct means we always draw beyond the last point
         int priorEval = 0;
 
-        for (int q = 0; q <= drawArea.getWidth(); ++q)
+        // the curve stops one point past the end of the MSEG
+        for (int q = 0; q < (int)curve.value.size(); ++q)
         {
-            float up = pxt(q + drawArea.left);
+            float up = curveTimes[q];
             int i = q;
-            if (!drawnLast)
-            {
-                float iup = (int)up;
+            int lastEval = curve.segment[q];
 
-                float fup = up - iup;
-                float v = Surge::MSEG::valueAt(iup, fup, 0, ms, &es, true);
-                float vdef = Surge::MSEG::valueAt(iup, fup, lfodata->deform.val.f, ms, &esdf, true);
+            float v = valpx(curve.value[q]);
+            float vdef = valpx(curve.deformed[q]);
 
-                v = valpx(v);
-                vdef = valpx(vdef);
-                // Brownian doesn't deform and the second display is confusing since it is
-                // indepdently random
-                if (es.lastEval >= 0 && es.lastEval <= ms->n_activeSegments - 1 &&
-                    ms->segments[es.lastEval].type == MSEGStorage::segment::Type::BROWNIAN)
-                    vdef = v;
+            int compareWith = lastEval;
+            if (up >= ms->totalDuration)
+                compareWith = ms->n_activeSegments - 1;
 
-                int compareWith = es.lastEval;
-                if (up >= ms->totalDuration)
-                    compareWith = ms->n_activeSegments - 1;
-
-                if (compareWith != priorEval)
+            if (compareWith != priorEval)
+            {
+                // OK so make sure that priorEval nv1 is in there
+                addP(path, i, valpx(ms->segments[priorEval].nv1));
+                for (int ns = priorEval + 1; ns <= compareWith; ns++)
                 {
-                    // OK so make sure that priorEval nv1 is in there
-                    addP(path, i, valpx(ms->segments[priorEval].nv1));
-                    for (int ns = priorEval + 1; ns <= compareWith; ns++)
-                    {
-                        // Special case - hold draws endpoint
-                        if (ns > 0 && ms->segments[ns - 1].type == MSEGStorage::segment::HOLD)
-                            addP(path, i, valpx(ms->segments[ns - 1].v0));
-                        addP(path, i, valpx(ms->segments[ns].v0));
-                    }
-
-                    if (priorEval == hoveredSegment && hlpathUsed)
-                    {
-                        addP(highlightPath, i, valpx(ms->segments[priorEval].nv1));
-                    }
-                    priorEval = es.lastEval;
+                    // Special case - hold draws endpoint
+                    if (ns > 0 && ms->segments[ns - 1].type == MSEGStorage::segment::HOLD)
+                        addP(path, i, valpx(ms->segments[ns - 1].v0));
+                    addP(path, i, valpx(ms->segments[ns].v0));
                 }
 
-                if (es.lastEval == hoveredSegment)
+                if (priorEval == hoveredSegment && hlpathUsed)
                 {
-                    bool skipThisAdd = false;
-                    // edge case when you go exactly up to 1 evenly. See #3940
-                    if (up < ms->segmentStart[es.lastEval] || up > ms->segmentEnd[es.lastEval])
-                        skipThisAdd = true;
-                    if (!hlpathUsed)
-                    {
-                        // We always want to hit the start
-                        if (ms->segmentStart[hoveredSegment] >= ms->axisStart)
-                            beginP(highlightPath, i, valpx(ms->segments[hoveredSegment].v0));
-                        else
-                        {
-                            skipThisAdd = true;
-                            beginP(highlightPath, i, v);
-                            beginP(highlightPath, i, v);
-                        }
-                        hlpathUsed = true;
-                    }
-                    if (!skipThisAdd)
-                    {
-                        addP(highlightPath, i, v);
-                    }
+                    addP(highlightPath, i, valpx(ms->segments[priorEval].nv1));
                 }
+                priorEval = lastEval;
+            }
 
-                if (i == 0)
+            if (lastEval == hoveredSegment)
+            {
+                bool skipThisAdd = false;
+                // edge case when you go exactly up to 1 evenly. See #3940
+                if (up < ms->segmentStart[lastEval] || up > ms->segmentEnd[lastEval])
+                    skipThisAdd = true;
+                if (!hlpathUsed)
                 {
-                    beginP(path, i, v);
-                    beginP(defpath, i, vdef);
-                    beginP(fillpath, i, v);
-                    pathFirstY = v;
+                    // We always want to hit the start
+                    if (ms->segmentStart[hoveredSegment] >= ms->axisStart)
+                        beginP(highlightPath, i, valpx(ms->segments[hoveredSegment].v0));
+                    else
+                    {
+                        skipThisAdd = true;
+                        beginP(highlightPath, i, v);
+                        beginP(highlightPath, i, v);
+                    }
+                    hlpathUsed = true;
                 }
-                else
+                if (!skipThisAdd)
                 {
-                    addP(path, i, v);
-                    addP(defpath, i, vdef);
-                    addP(fillpath, i, v);
+                    addP(highlightPath, i, v);
                 }
-                pathLastX = i;
-                pathLastY = v;
-                pathLastDef = vdef;
             }
-            drawnLast = up > ms->totalDuration;
+
+            if (i == 0)
+            {
+                beginP(path, i, v);
+                beginP(defpath, i, vdef);
+                beginP(fillpath, i, v);
+                pathFirstY = v;
+            }
+            else
+            {
+                addP(path, i, v);
+                addP(defpath, i, vdef);
+                addP(fillpath, i, v);
+            }
+            pathLastX = i;
+            pathLastY = v;
+            pathLastDef = vdef;
         }
 
         int uniLimit = 0;
@@ -2492,6 +2486,7 @@ struct MSEGCanvas : public CControl,
     }
 
     int hoveredSegment = -1;
+    Surge::ModulatorPreview::MSEGCurve curve;
     MSEGStorage *ms;
     MSEGEditor::State *eds;
     LFOStorage *lfodata;
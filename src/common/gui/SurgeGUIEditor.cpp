@@ -21,6 +21,8 @@
 #include "CParameterTooltip.h"
 #include "CPatchBrowser.h"
 #include "COscillatorDisplay.h"
+#include "OscillatorPreview.h"
+#include "ModulatorPreview.h"
 #include "CVerticalLabel.h"
 #include "CModulationSourceButton.h"
 #include "CSnapshotMenu.h"
@@ -603,6 +605,20 @@ void SurgeGUIEditor::idle()
             }
         }
 
+        if (synth->storage.oscillatorPreviews &&
+            synth->storage.oscillatorPreviews->consumeNewResults() && oscdisplay)
+        {
+            oscdisplay->setDirty(true);
+            oscdisplay->invalid();
+        }
+
+        if (synth->storage.lfoPreviews && synth->storage.lfoPreviews->consumeNewResults() &&
+            lfodisplay)
+        {
+            lfodisplay->setDirty(true);
+            lfodisplay->invalid();
+        }
+
         if (typeinResetCounter > 0)
         {
             typeinResetCounter--;
@@ -3310,6 +3326,18 @@ int32_t SurgeGUIEditor::controlModifierClicked(CControl *control, CButtonState b
                             m->setChecked(synth->storage.getPatch().correctlyTuneCombFilter);
                         }
 
+                        if (p->ctrltype == ct_wstype)
+                        {
+                            contextMenu->addSeparator();
+                            auto m = addCallbackMenu(
+                                contextMenu, Surge::UI::toOSCaseForMenu("Legacy Lookup Tables"),
+                                [this]() {
+                                    synth->storage.getPatch().tableLookupWaveshapers =
+                                        !synth->storage.getPatch().tableLookupWaveshapers;
+                                });
+                            m->setChecked(synth->storage.getPatch().tableLookupWaveshapers);
+                        }
+
                         if (p->ctrltype == ct_polymode &&
                             (p->val.i == pm_mono || p->val.i == pm_mono_st ||
                              p->val.i == pm_mono_fp || p->val.i == pm_mono_st_fp))
@@ -3653,6 +3681,9 @@ int32_t SurgeGUIEditor::controlModifierClicked(CControl *control, CButtonState b
                         case ct_twist_aux_mix:
                             txt = "Pan Main and Auxilliary Signals";
                             break;
+                        case ct_vocoder_bandcount:
+                            txt = "Allow Up to 64 Bands";
+                            break;
                         default:
                             break;
                         }
@@ -3661,7 +3692,7 @@ int32_t SurgeGUIEditor::controlModifierClicked(CControl *control, CButtonState b
                         {
                             auto ee = addCallbackMenu(contextMenu, Surge::UI::toOSCaseForMenu(txt),
                                                       [this, p]() {
-                                                          p->extend_range = !p->extend_range;
+                                                          p->set_extend_range(!p->extend_range);
                                                           this->synth->refresh_editor = true;
                                                       });
                             contextMenu->checkEntry(eid, p->extend_range);
@@ -4685,6 +4716,7 @@ void SurgeGUIEditor::valueChanged(CControl *control)
     break;
     case tag_fx_menu:
     {
+        synth->prepareFx(current_fx & 7);
         synth->load_fx_needed = true;
         // queue_refresh = true;
         synth->fx_reload[current_fx & 7] = true;
@@ -6713,6 +6745,33 @@ VSTGUI::COptionMenu *SurgeGUIEditor::makeUserSettingsMenu(VSTGUI::CRect &menuRec
         });
     menuItem->setChecked(patchJogWrap);
 
+    // sine kernel for the FM2/FM3 operators
+    auto *fmSineMenu = new COptionMenu(menuRect, 0, 0, 0, 0,
+                                       VSTGUI::COptionMenu::kNoDrawStyle |
+                                           VSTGUI::COptionMenu::kMultipleCheckStyle);
+
+    auto addFMSine = [this, fmSineMenu](const char *label, SurgeStorage::FMSinePrecision fp) {
+        auto me = addCallbackMenu(fmSineMenu, Surge::UI::toOSCaseForMenu(label), [this, fp]() {
+            this->synth->storage.fmSinePrecision = fp;
+            Surge::Storage::updateUserDefaultValue(&(this->synth->storage), "fmSinePrecision",
+                                                   (int)fp);
+        });
+        me->setChecked(synth->storage.fmSinePrecision == fp);
+    };
+    addFMSine("Accurate", SurgeStorage::FM_SINE_ACCURATE);
+    addFMSine("Fast", SurgeStorage::FM_SINE_FAST);
+    addFMSine("Legacy (libm)", SurgeStorage::FM_SINE_LIBM);
+    fmSineMenu->addSeparator();
+
+    menuItem = addCallbackMenu(
+        fmSineMenu, Surge::UI::toOSCaseForMenu("Use Legacy Sine in This Patch"), [this]() {
+            synth->storage.getPatch().libmFMSine = !synth->storage.getPatch().libmFMSine;
+        });
+    menuItem->setChecked(synth->storage.getPatch().libmFMSine);
+
+    wfMenu->addEntry(fmSineMenu, Surge::UI::toOSCaseForMenu("FM2/FM3 Operator Sine"));
+    fmSineMenu->forget();
+
     uiOptionsMenu->addEntry(wfMenu, Surge::UI::toOSCaseForMenu("Workflow"));
     wfMenu->forget();
 
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Fold the hash of v into seed, for building cache keys out of several values
+template <typename T> inline void hashCombine(size_t &seed, const T &v)
+{
+    seed ^= std::hash<T>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+/*
+ * A small cache of display renders which are made on a worker thread. The UI looks its key up
+ * with find and on a miss calls request and keeps drawing what it had; consumeNewResults tells
+ * the UI idle loop when a redraw will find something new. Each request names an owner (the
+ * storage being drawn) and only the newest pending request for an owner is rendered.
+ *
+ * render functions must only touch data they own or which outlives the cache.
+ */
+template <typename T> class BackgroundRenderCache
+{
+  public:
+    typedef std::shared_ptr<const T> result_t;
+
+    BackgroundRenderCache(size_t maxEntries = 64) : maxEntries(maxEntries)
+    {
+        worker = std::thread([this]() { run(); });
+    }
+
+    ~BackgroundRenderCache()
+    {
+        {
+            std::lock_guard<std::mutex> g(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    result_t find(size_t key)
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->first == key)
+            {
+                entries.splice(entries.begin(), entries, it);
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    void request(size_t key, const void *owner, std::function<T()> render)
+    {
+        {
+            std::lock_guard<std::mutex> g(mutex);
+            pending.remove_if([owner](const Job &j) { return j.owner == owner; });
+            pending.push_back({key, owner, std::move(render)});
+        }
+        cv.notify_one();
+    }
+
+    bool consumeNewResults() { return newResults.exchange(false); }
+
+  private:
+    struct Job
+    {
+        size_t key;
+        const void *owner;
+        std::function<T()> render;
+    };
+
+    void run()
+    {
+        while (true)
+        {
+            Job j;
+            {
+                std::unique_lock<std::mutex> g(mutex);
+                cv.wait(g, [this]() { return stopping || !pending.empty(); });
+                if (stopping)
+                    return;
+                j = std::move(pending.front());
+                pending.pop_front();
+            }
+
+            auto res = std::make_shared<const T>(j.render());
+
+            {
+                std::lock_guard<std::mutex> g(mutex);
+                entries.remove_if(
+                    [&j](const std::pair<size_t, result_t> &e) { return e.first == j.key; });
+                entries.emplace_front(j.key, res);
+                if (entries.size() > maxEntries)
+                    entries.pop_back();
+            }
+            newResults = true;
+        }
+    }
+
+    size_t maxEntries;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::list<Job> pending;
+    std::list<std::pair<size_t, result_t>> entries; // most recently used first
+    std::atomic<bool> newResults{false};
+    bool stopping = false;
+    std::thread worker;
+};
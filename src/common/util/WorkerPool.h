@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * A fixed set of worker threads which live as long as the pool, for splitting loader side work
+ * (wavetable mip builds and the like) without creating threads for each job. forEachRange blocks
+ * until every range is done, running one of them on the calling thread. Several threads may
+ * share a pool; their ranges just queue up behind each other.
+ *
+ * Not for the audio thread: posting takes a mutex.
+ */
+class WorkerPool
+{
+  public:
+    explicit WorkerPool(int nThreads)
+    {
+        for (int i = 0; i < nThreads; ++i)
+            workers.emplace_back([this]() { run(); });
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> g(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto &w : workers)
+            w.join();
+    }
+
+    int threads() const { return (int)workers.size(); }
+
+    // Run f(begin, end) over [0, n) in up to threads() + 1 contiguous ranges
+    template <typename F> void forEachRange(int n, F f)
+    {
+        int nr = std::min(threads() + 1, n);
+        if (nr < 2)
+        {
+            if (n > 0)
+                f(0, n);
+            return;
+        }
+
+        std::mutex doneMutex;
+        std::condition_variable doneCv;
+        int outstanding = 0;
+
+        int chunk = (n + nr - 1) / nr;
+        {
+            std::lock_guard<std::mutex> g(mutex);
+            for (int b = chunk; b < n; b += chunk)
+            {
+                int e = std::min(n, b + chunk);
+                ++outstanding;
+                jobs.emplace_back([&, b, e]() {
+                    f(b, e);
+                    std::lock_guard<std::mutex> dg(doneMutex);
+                    if (--outstanding == 0)
+                        doneCv.notify_one();
+                });
+            }
+        }
+        cv.notify_all();
+
+        f(0, std::min(n, chunk));
+
+        std::unique_lock<std::mutex> dg(doneMutex);
+        doneCv.wait(dg, [&outstanding]() { return outstanding == 0; });
+    }
+
+  private:
+    void run()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> g(mutex);
+                cv.wait(g, [this]() { return stopping || !jobs.empty(); });
+                if (stopping)
+                    return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
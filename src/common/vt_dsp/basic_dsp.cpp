@@ -308,16 +308,12 @@ void copy_block(float *__restrict src, float *__restrict dst, unsigned int nquad
     fdst = (float *)dst;
     fsrc = (float *)src;
 
-    for (unsigned int i = 0; i < (nquads << 2); i += (8 << 2))
+    for (unsigned int i = 0; i < (nquads << 2); i += (4 << 2))
     {
         _mm_store_ps(&fdst[i], _mm_load_ps(&fsrc[i]));
         _mm_store_ps(&fdst[i + 4], _mm_load_ps(&fsrc[i + 4]));
         _mm_store_ps(&fdst[i + 8], _mm_load_ps(&fsrc[i + 8]));
         _mm_store_ps(&fdst[i + 12], _mm_load_ps(&fsrc[i + 12]));
-        _mm_store_ps(&fdst[i + 16], _mm_load_ps(&fsrc[i + 16]));
-        _mm_store_ps(&fdst[i + 20], _mm_load_ps(&fsrc[i + 20]));
-        _mm_store_ps(&fdst[i + 24], _mm_load_ps(&fsrc[i + 24]));
-        _mm_store_ps(&fdst[i + 28], _mm_load_ps(&fsrc[i + 28]));
     }
 }
 
@@ -327,16 +323,12 @@ void copy_block_US(float *__restrict src, float *__restrict dst, unsigned int nq
     fdst = (float *)dst;
     fsrc = (float *)src;
 
-    for (unsigned int i = 0; i < (nquads << 2); i += (8 << 2))
+    for (unsigned int i = 0; i < (nquads << 2); i += (4 << 2))
     {
         _mm_store_ps(&fdst[i], _mm_loadu_ps(&fsrc[i]));
         _mm_store_ps(&fdst[i + 4], _mm_loadu_ps(&fsrc[i + 4]));
         _mm_store_ps(&fdst[i + 8], _mm_loadu_ps(&fsrc[i + 8]));
         _mm_store_ps(&fdst[i + 12], _mm_loadu_ps(&fsrc[i + 12]));
-        _mm_store_ps(&fdst[i + 16], _mm_loadu_ps(&fsrc[i + 16]));
-        _mm_store_ps(&fdst[i + 20], _mm_loadu_ps(&fsrc[i + 20]));
-        _mm_store_ps(&fdst[i + 24], _mm_loadu_ps(&fsrc[i + 24]));
-        _mm_store_ps(&fdst[i + 28], _mm_loadu_ps(&fsrc[i + 28]));
     }
 }
 
@@ -346,16 +338,12 @@ void copy_block_UD(float *__restrict src, float *__restrict dst, unsigned int nq
     fdst = (float *)dst;
     fsrc = (float *)src;
 
-    for (unsigned int i = 0; i < (nquads << 2); i += (8 << 2))
+    for (unsigned int i = 0; i < (nquads << 2); i += (4 << 2))
     {
         _mm_storeu_ps(&fdst[i], _mm_load_ps(&fsrc[i]));
         _mm_storeu_ps(&fdst[i + 4], _mm_load_ps(&fsrc[i + 4]));
         _mm_storeu_ps(&fdst[i + 8], _mm_load_ps(&fsrc[i + 8]));
         _mm_storeu_ps(&fdst[i + 12], _mm_load_ps(&fsrc[i + 12]));
-        _mm_storeu_ps(&fdst[i + 16], _mm_load_ps(&fsrc[i + 16]));
-        _mm_storeu_ps(&fdst[i + 20], _mm_load_ps(&fsrc[i + 20]));
-        _mm_storeu_ps(&fdst[i + 24], _mm_load_ps(&fsrc[i + 24]));
-        _mm_storeu_ps(&fdst[i + 28], _mm_load_ps(&fsrc[i + 28]));
     }
 }
 void copy_block_USUD(float *__restrict src, float *__restrict dst, unsigned int nquads)
@@ -364,16 +352,12 @@ void copy_block_USUD(float *__restrict src, float *__restrict dst, unsigned int
     fdst = (float *)dst;
     fsrc = (float *)src;
 
-    for (unsigned int i = 0; i < (nquads << 2); i += (8 << 2))
+    for (unsigned int i = 0; i < (nquads << 2); i += (4 << 2))
     {
         _mm_storeu_ps(&fdst[i], _mm_loadu_ps(&fsrc[i]));
         _mm_storeu_ps(&fdst[i + 4], _mm_loadu_ps(&fsrc[i + 4]));
         _mm_storeu_ps(&fdst[i + 8], _mm_loadu_ps(&fsrc[i + 8]));
         _mm_storeu_ps(&fdst[i + 12], _mm_loadu_ps(&fsrc[i + 12]));
-        _mm_storeu_ps(&fdst[i + 16], _mm_loadu_ps(&fsrc[i + 16]));
-        _mm_storeu_ps(&fdst[i + 20], _mm_loadu_ps(&fsrc[i + 20]));
-        _mm_storeu_ps(&fdst[i + 24], _mm_loadu_ps(&fsrc[i + 24]));
-        _mm_storeu_ps(&fdst[i + 28], _mm_loadu_ps(&fsrc[i + 28]));
     }
 }
 
@@ -1,7 +1,7 @@
 #include "halfratefilter.h"
 #include "assert.h"
+#include <algorithm>
 
-const unsigned int hr_BLOCK_SIZE = 256;
 const __m128 half = _mm_set_ps1(0.5f);
 
 HalfRateFilter::HalfRateFilter(int M, bool steep)
@@ -15,6 +15,13 @@ HalfRateFilter::HalfRateFilter(int M, bool steep)
 
 void HalfRateFilter::process_block(float *__restrict floatL, float *__restrict floatR, int N)
 {
+    if (N > (int)hr_BLOCK_SIZE)
+    {
+        for (int s = 0; s < N; s += hr_BLOCK_SIZE)
+            process_block(floatL + s, floatR + s, std::min(N - s, (int)hr_BLOCK_SIZE));
+        return;
+    }
+
     __m128 *__restrict L = (__m128 *)floatL;
     __m128 *__restrict R = (__m128 *)floatR;
     __m128 o[hr_BLOCK_SIZE];
@@ -143,6 +150,16 @@ void HalfRateFilter::process_block(float * __restrict floatL, float * __restrict
 void HalfRateFilter::process_block_D2(float *floatL, float *floatR, int nsamples, float *outL,
                                       float *outR)
 {
+    if (nsamples > (int)hr_BLOCK_SIZE)
+    {
+        // each piece writes its half below its own input, over input already used
+        float *dL = outL ? outL : floatL, *dR = outR ? outR : floatR;
+        for (int s = 0; s < nsamples; s += hr_BLOCK_SIZE)
+            process_block_D2(floatL + s, floatR + s, std::min(nsamples - s, (int)hr_BLOCK_SIZE),
+                             dL + s / 2, dR + s / 2);
+        return;
+    }
+
     __m128 *L = (__m128 *)floatL;
     __m128 *R = (__m128 *)floatR;
     __m128 o[hr_BLOCK_SIZE];
@@ -269,9 +286,163 @@ void HalfRateFilter::process_block_D2(float *floatL, float *floatR, int nsamples
     }
 }
 
+// One allpass stage of a filter, as process_block_D2 runs it
+struct HalfRateFilter::AllpassStage
+{
+    __m128 tx0, tx1, tx2, ty0, ty1, ty2, ta;
+
+    AllpassStage(const HalfRateFilter *f, int j)
+        : tx0(f->vx0[j]), tx1(f->vx1[j]), tx2(f->vx2[j]), ty0(f->vy0[j]), ty1(f->vy1[j]),
+          ty2(f->vy2[j]), ta(f->va[j])
+    {
+    }
+
+    inline __m128 process(__m128 in)
+    {
+        // shuffle inputs
+        tx2 = tx1;
+        tx1 = tx0;
+        tx0 = in;
+        // shuffle outputs
+        ty2 = ty1;
+        ty1 = ty0;
+        // allpass filter 1
+        ty0 = _mm_add_ps(tx2, _mm_mul_ps(_mm_sub_ps(tx0, ty2), ta));
+        return ty0;
+    }
+
+    void store(HalfRateFilter *f, int j) const
+    {
+        f->vx0[j] = tx0;
+        f->vx1[j] = tx1;
+        f->vx2[j] = tx2;
+        f->vy0[j] = ty0;
+        f->vy1[j] = ty1;
+        f->vy2[j] = ty2;
+    }
+};
+
+template <int N>
+void HalfRateFilter::process_block_D2_fused(HalfRateFilter **f, D2Block *b, int offset,
+                                            int nsamples)
+{
+    __m128 o[N][hr_BLOCK_SIZE];
+
+    for (int n = 0; n < N; n++)
+    {
+        __m128 *L = (__m128 *)(b[n].L + offset);
+        __m128 *R = (__m128 *)(b[n].R + offset);
+        const __m128 cmax = _mm_set1_ps(b[n].clipIn);
+        const __m128 cmin = _mm_set1_ps(-b[n].clipIn);
+        const bool clip = b[n].clipIn > 0.f;
+
+        for (int k = 0; k < nsamples; k += 4)
+        {
+            __m128 l = L[k >> 2], r = R[k >> 2];
+            if (clip)
+            {
+                l = _mm_max_ps(_mm_min_ps(l, cmax), cmin);
+                r = _mm_max_ps(_mm_min_ps(r, cmax), cmin);
+            }
+            //[o3,o2,o1,o0] = [L0,L0,R0,R0]
+            o[n][k] = _mm_shuffle_ps(l, r, _MM_SHUFFLE(0, 0, 0, 0));
+            o[n][k + 1] = _mm_shuffle_ps(l, r, _MM_SHUFFLE(1, 1, 1, 1));
+            o[n][k + 2] = _mm_shuffle_ps(l, r, _MM_SHUFFLE(2, 2, 2, 2));
+            o[n][k + 3] = _mm_shuffle_ps(l, r, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+    }
+
+    // process filters, stage j of each in turn. The second filter's state is in locals of its
+    // own rather than an array, so the compiler keeps both in registers
+    for (int j = 0; j < f[0]->M; j++)
+    {
+        AllpassStage s0(f[0], j), s1(f[N - 1], j);
+
+        for (int k = 0; k < nsamples; k += 2)
+        {
+            o[0][k] = s0.process(o[0][k]);
+            if (N == 2)
+                o[N - 1][k] = s1.process(o[N - 1][k]);
+            o[0][k + 1] = s0.process(o[0][k + 1]);
+            if (N == 2)
+                o[N - 1][k + 1] = s1.process(o[N - 1][k + 1]);
+        }
+
+        s0.store(f[0], j);
+        if (N == 2)
+            s1.store(f[N - 1], j);
+    }
+
+    for (int n = 0; n < N; n++)
+    {
+        __m128 *L = (__m128 *)(b[n].L + offset / 2);
+        __m128 *R = (__m128 *)(b[n].R + offset / 2);
+        const __m128 cmax = _mm_set1_ps(b[n].clipOut);
+        const __m128 cmin = _mm_set1_ps(-b[n].clipOut);
+        const bool clip = b[n].clipOut > 0.f;
+        const __m128 *on = o[n];
+
+        // L is (o[2i] lane 1 + o[2i+1] lane 0) / 2 and R (o[2i] lane 3 + o[2i+1] lane 2) / 2,
+        // as in process_block_D2
+        for (int k = 0; k < nsamples; k += 8)
+        {
+            __m128 e0 = _mm_shuffle_ps(on[k], on[k + 2], _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 e1 = _mm_shuffle_ps(on[k + 4], on[k + 6], _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 d0 = _mm_shuffle_ps(on[k + 1], on[k + 3], _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 d1 = _mm_shuffle_ps(on[k + 5], on[k + 7], _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 s0 = _mm_add_ps(e0, d0); // L0 R0 L1 R1
+            __m128 s1 = _mm_add_ps(e1, d1); // L2 R2 L3 R3
+
+            __m128 l = _mm_mul_ps(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0)), half);
+            __m128 r = _mm_mul_ps(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1)), half);
+            if (clip)
+            {
+                l = _mm_max_ps(_mm_min_ps(l, cmax), cmin);
+                r = _mm_max_ps(_mm_min_ps(r, cmax), cmin);
+            }
+            L[k >> 3] = l;
+            R[k >> 3] = r;
+        }
+    }
+}
+
+void HalfRateFilter::process_block_D2_fused(HalfRateFilter **filters, D2Block *blocks, int n,
+                                            int nsamples)
+{
+    // longer blocks go in pieces, each landing below its input as in process_block_D2
+    for (int s = 0; s < nsamples; s += hr_BLOCK_SIZE)
+    {
+        int ns = std::min(nsamples - s, (int)hr_BLOCK_SIZE);
+        int i = 0;
+        while (i < n)
+        {
+            if (i + 1 < n && filters[i]->M == filters[i + 1]->M)
+            {
+                process_block_D2_fused<2>(&filters[i], &blocks[i], s, ns);
+                i += 2;
+            }
+            else
+            {
+                process_block_D2_fused<1>(&filters[i], &blocks[i], s, ns);
+                i++;
+            }
+        }
+    }
+}
+
 void HalfRateFilter::process_block_U2(float *floatL_in, float *floatR_in, float *floatL,
                                       float *floatR, int nsamples)
 {
+    if (nsamples > (int)hr_BLOCK_SIZE)
+    {
+        // a piece would write over the input of the next, so longer blocks can't be in place
+        assert(floatL_in != floatL && floatR_in != floatR);
+        for (int s = 0; s < nsamples; s += hr_BLOCK_SIZE)
+            process_block_U2(floatL_in + s / 2, floatR_in + s / 2, floatL + s, floatR + s,
+                             std::min(nsamples - s, (int)hr_BLOCK_SIZE));
+        return;
+    }
+
     __m128 *L = (__m128 *)floatL;
     __m128 *R = (__m128 *)floatR;
     __m128 *L_in = (__m128 *)floatL_in;
@@ -2,6 +2,9 @@
 #include "shared.h"
 
 const unsigned int halfrate_max_M = 6;
+// The process calls take blocks of any length, working through longer ones in pieces of this
+// many samples. process_block_U2 can only run in place on blocks up to this size.
+const unsigned int hr_BLOCK_SIZE = 256;
 
 class alignas(16) HalfRateFilter
 {
@@ -21,11 +24,32 @@ class alignas(16) HalfRateFilter
     void process_block_D2(float *L, float *R, int nsamples = 64, float *outL = 0,
                           float *outR = 0); // process in-place. the new block will be half the size
     void process_block_U2(float *L_in, float *R_in, float *L, float *R, int nsamples = 64);
+
+    // A stereo block for process_block_D2_fused, decimated in place
+    struct D2Block
+    {
+        float *L, *R;
+        float clipIn = 0.f, clipOut = 0.f; // clamp to +-clip before and after; 0 skips that
+    };
+
+    /*
+     * process_block_D2 for n filters and blocks, with the hard clips before and after folded
+     * into the passes which interleave and deinterleave the channels. Filters of the same order
+     * are run in pairs, with their allpass chains interleaved so each hides the other's
+     * latency. The result is bit exact with clipping, process_block_D2 and clipping again.
+     */
+    static void process_block_D2_fused(HalfRateFilter **filters, D2Block *blocks, int n,
+                                       int nsamples = 64);
     void load_coefficients();
     void set_coefficients(float *cA, float *cB);
     void reset();
 
   private:
+    struct AllpassStage;
+    template <int N>
+    static void process_block_D2_fused(HalfRateFilter **filters, D2Block *blocks, int offset,
+                                       int nsamples);
+
     int M;
     bool steep;
     float oldoutL, oldoutR;
@@ -1,10 +1,26 @@
 #include "HeadlessUtils.h"
 #include "Player.h"
+#include "OscillatorPreview.h"
+#include "BiquadCascade.h"
+#include "effect/PhaserEffect.h"
+#include "effect/BBDEnsembleEffect.h"
+#include "SSESincDelayLine.h"
+#include "QuadFilterUnit.h"
+#include "FilterCoefficientMaker.h"
+#include "LanczosResampler.h"
+#include "effect/airwindows/AirWindowsStereo.h"
+#include "samplerate.h"
 #include "filesystem/import.h"
+#include "UnitTestUtilities.h"
 #include <iostream>
 #include <sstream>
 #include <chrono>
 #include <deque>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <thread>
 
 namespace Surge
 {
@@ -31,6 +47,21 @@ void restreamTemplatesWithModifications()
             std::cout << "  Fixing Comb Filter" << std::endl;
             surge->storage.getPatch().correctlyTuneCombFilter = true;
         }
+        if (oR < 17)
+        {
+            std::cout << "  Computing Waveshapers" << std::endl;
+            surge->storage.getPatch().tableLookupWaveshapers = false;
+        }
+        if (oR < 18)
+        {
+            std::cout << "  Computing FM Sine" << std::endl;
+            surge->storage.getPatch().libmFMSine = false;
+        }
+        if (oR < 19)
+        {
+            std::cout << "  Aligning Rotary Horn Taps" << std::endl;
+            surge->storage.getPatch().legacyRotaryHornTaps = false;
+        }
 
         if (oR == ff_revision)
         {
@@ -503,11 +534,80 @@ void middleCSawIntoFilterVsReso(int ft, int sft, std::ostream &os)
     os << "[END]" << std::endl;
 }
 
+void filterUnitCost(int ft, int sft, std::ostream &os)
+{
+    /*
+     * The time the filter unit takes per sample for a full quad of voices, driven hard with
+     * noise so the saturating paths run, against resonance
+     */
+    auto fu = GetQFPtrFilterUnit(ft, sft);
+    if (!fu)
+        return;
+
+    auto surge = Surge::Headless::createSurge(48000);
+    const int nSamples = 4096, nRuns = 100;
+    std::vector<__m128> in(nSamples);
+    std::mt19937 gen(22);
+    std::uniform_real_distribution<float> noise(-2.f, 2.f);
+    for (auto &s : in)
+        s = _mm_set_ps(noise(gen), noise(gen), noise(gen), noise(gen));
+
+    std::vector<float> dbuf(4 * (MAX_FB_COMB + FIRipol_N), 0.f);
+    std::vector<float> resonances, nsPerSample;
+    for (float res = 0; res <= 1.0; res += 0.2)
+    {
+        res = limit_range(res, 0.f, 0.99f);
+
+        QuadFilterUnitState Q;
+        memset(&Q, 0, sizeof(Q));
+        FilterCoefficientMaker cm[4];
+        FilterCoefficientMaker *cms[4];
+        float freq[4], reso[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            Q.active[i] = 0xffffffff;
+            Q.DB[i] = &dbuf[i * (MAX_FB_COMB + FIRipol_N)];
+            cms[i] = &cm[i];
+            freq[i] = 12.f * i;
+            reso[i] = res;
+        }
+        if (ft != fut_comb_pos && ft != fut_comb_neg)
+            Q.WP[0] = sft;
+        FilterCoefficientMaker::MakeCoeffsQuad(cms, freq, reso, ft, sft, &surge->storage, false,
+                                               Q);
+
+        auto sum = _mm_setzero_ps();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < nRuns; ++r)
+            for (int s = 0; s < nSamples; ++s)
+                sum = _mm_add_ps(sum, fu(&Q, in[s]));
+        auto end = std::chrono::high_resolution_clock::now();
+
+        float sums[4];
+        _mm_storeu_ps(sums, sum);
+        if (!std::isfinite(sums[0] + sums[1] + sums[2] + sums[3]))
+            std::cout << "Non-finite output at res " << res << std::endl;
+
+        resonances.push_back(res);
+        nsPerSample.push_back(std::chrono::duration<double, std::nano>(end - start).count() /
+                              (nRuns * nSamples));
+    }
+
+    os << "[BEGIN]" << std::endl;
+    os << "[SECTION]Cost of a quad of voices (" << fut_names[ft] << ")[/SECTION]" << std::endl;
+    os << "[YLAB]ns / sample[/YLAB]" << std::endl;
+    os << "Resonance, ns" << std::endl;
+    for (size_t i = 0; i < resonances.size(); ++i)
+        os << resonances[i] << ", " << nsPerSample[i] << std::endl;
+    os << "[END]" << std::endl;
+}
+
 void filterAnalyzer(int ft, int sft, std::ostream &os)
 {
     standardCutoffCurve(ft, sft, os);
     middleCSawIntoFilterVsCutoff(ft, sft, os);
     middleCSawIntoFilterVsReso(ft, sft, os);
+    filterUnitCost(ft, sft, os);
 }
 
 [[noreturn]] void performancePlay(const std::string &patchName, int mode)
@@ -715,6 +815,660 @@ void generateNLFeedbackNorms()
               << "      if (useNormalization) normNumerator = lpNormTable[subtype];\n";
 }
 
+void fmOperatorBenchmark()
+{
+    /*
+     * Play 64 voices of FM2 and FM3 with and without operator feedback (which forces the
+     * operator sine to run one sample at a time) and time each sine precision against the
+     * scalar libm kernel.
+     */
+    const int n_voices = 64;
+    const int n_blocks = 4000;
+    std::vector<std::pair<SurgeStorage::FMSinePrecision, std::string>> precisions = {
+        {SurgeStorage::FM_SINE_LIBM, "libm"},
+        {SurgeStorage::FM_SINE_ACCURATE, "accurate"},
+        {SurgeStorage::FM_SINE_FAST, "fast"}};
+
+    for (auto ot : {ot_FM2, ot_FM3})
+    {
+        for (auto fb : {0.5f, 0.75f})
+        {
+            double libmTime = 0;
+            for (auto p : precisions)
+            {
+                auto surge = Surge::Headless::createSurge(48000);
+                surge->storage.fmSinePrecision = p.first;
+                surge->storage.getPatch().polylimit.val.i = n_voices;
+
+                auto &osc = surge->storage.getPatch().scene[0].osc[0];
+                osc.queue_type = ot;
+                for (int i = 0; i < 10; ++i)
+                    surge->process();
+
+                osc.p[0].set_value_f01(0.6);
+                osc.p[2].set_value_f01(0.4);
+                osc.p[6].set_value_f01(fb);
+                // Hold the voices so they all sound for the whole measurement
+                surge->storage.getPatch().scene[0].adsr[0].s.set_value_f01(1.0);
+
+                for (int n = 0; n < n_voices; ++n)
+                    surge->playNote(0, 30 + n, 100, 0);
+                for (int i = 0; i < 10; ++i)
+                    surge->process();
+
+                auto st = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < n_blocks; ++i)
+                    surge->process();
+                auto et = std::chrono::high_resolution_clock::now();
+                auto us = std::chrono::duration_cast<std::chrono::microseconds>(et - st).count();
+
+                if (p.first == SurgeStorage::FM_SINE_LIBM)
+                    libmTime = us;
+
+                std::cout << osc_type_names[ot] << " feedback=" << (fb == 0.5f ? "off" : "on")
+                          << " sine=" << p.second << " voices=" << surge->getNonReleasedVoices(0)
+                          << " : " << 1.0 * us / n_blocks << "us/block ; " << libmTime / us
+                          << "x libm" << std::endl;
+            }
+        }
+    }
+}
+
+void wavetableBuildBenchmark()
+{
+    /*
+     * Load every factory and user wavetable and report how long conversion, mip generation
+     * and publishing takes. The lock is only held for publish, so the time the audio thread
+     * could be blocked is reported separately.
+     */
+    auto surge = Surge::Headless::createSurge(48000);
+    auto &storage = surge->storage;
+
+    auto wt = std::make_unique<Wavetable>();
+    auto scratch = std::make_unique<Wavetable>();
+    double total = 0, worst = 0, lockTotal = 0;
+    std::string worstName;
+
+    for (int i = 0; i < storage.wt_list.size(); ++i)
+    {
+        auto st = std::chrono::high_resolution_clock::now();
+        storage.load_wt(i, wt.get(), nullptr);
+        auto et = std::chrono::high_resolution_clock::now();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(et - st).count();
+
+        st = std::chrono::high_resolution_clock::now();
+        {
+            // publish twice so wt keeps the table just built
+            std::lock_guard<std::mutex> g(storage.waveTableDataMutex);
+            wt->publish(*scratch);
+            wt->publish(*scratch);
+        }
+        et = std::chrono::high_resolution_clock::now();
+        lockTotal += std::chrono::duration_cast<std::chrono::microseconds>(et - st).count() / 2.0;
+
+        total += us;
+        if (us > worst)
+        {
+            worst = us;
+            worstName = storage.wt_list[i].name;
+        }
+    }
+
+    auto n = std::max((size_t)1, storage.wt_list.size());
+    std::cout << "Built " << storage.wt_list.size() << " wavetables on "
+              << std::thread::hardware_concurrency() << " threads in " << total / 1000.0
+              << "ms ; mean " << total / n << "us ; worst " << worst << "us (" << worstName
+              << ") ; mean time under lock " << lockTotal / n << "us" << std::endl;
+}
+
+void oscillatorPreviewBenchmark()
+{
+    /*
+     * Time rendering the oscillator display trace for every oscillator type at max unison,
+     * which the display used to do on every redraw, against a preview cache hit.
+     */
+    auto surge = Surge::Headless::createSurge(48000);
+    auto &oscdata = surge->storage.getPatch().scene[0].osc[0];
+    const int totalSamples = 16 * 140, averagingWindow = 4, n_iter = 50;
+    const float pitch = 42.15;
+
+    Surge::Oscillator::PreviewCache cache(&surge->storage);
+
+    for (int ot = 0; ot < n_osc_types; ++ot)
+    {
+        oscdata.queue_type = ot;
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        for (int i = 0; i < n_osc_params; ++i)
+            if (oscdata.p[i].ctrltype == ct_osccount || oscdata.p[i].ctrltype == ct_osccountWT)
+                oscdata.p[i].val.i = oscdata.p[i].val_max.i;
+
+        pdata tp[n_scene_params];
+        tp[oscdata.pitch.param_id_in_scene].f = 0;
+        for (int i = 0; i < n_osc_params; i++)
+            tp[oscdata.p[i].param_id_in_scene].i = oscdata.p[i].val.i;
+
+        auto st = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < n_iter; ++i)
+            Surge::Oscillator::renderPreview(&surge->storage, &oscdata, ot, tp, pitch,
+                                             totalSamples, averagingWindow);
+        auto et = std::chrono::high_resolution_clock::now();
+        auto renderUs = std::chrono::duration_cast<std::chrono::microseconds>(et - st).count();
+
+        auto key = Surge::Oscillator::previewKey(&surge->storage, &oscdata, ot, tp, pitch,
+                                                 totalSamples, averagingWindow);
+        cache.request(key, &oscdata, ot, tp, pitch, totalSamples, averagingWindow);
+        while (!cache.find(key))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        st = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < n_iter; ++i)
+        {
+            key = Surge::Oscillator::previewKey(&surge->storage, &oscdata, ot, tp, pitch,
+                                                totalSamples, averagingWindow);
+            cache.find(key);
+        }
+        et = std::chrono::high_resolution_clock::now();
+        auto hitUs = std::chrono::duration_cast<std::chrono::microseconds>(et - st).count();
+
+        std::cout << osc_type_names[ot] << " : render " << 1.0 * renderUs / n_iter
+                  << "us ; cache hit " << 1.0 * hitUs / n_iter << "us" << std::endl;
+    }
+}
+
+void biquadBenchmark()
+{
+    /*
+     * Run the 11 peaking sections of the graphic EQ one sample at a time through scalar
+     * BiquadFilters, a block at a time through their SSE2 stereo path, and through a
+     * BiquadCascade, then time the GEQ11 and Phaser effects which use the cascade.
+     */
+    const int n_blocks = 100000;
+    const int n_sections = 11;
+    auto surge = Surge::Headless::createSurge(48000);
+    auto *storage = &surge->storage;
+
+    float noise alignas(16)[2][BLOCK_SIZE];
+    for (int k = 0; k < BLOCK_SIZE; ++k)
+    {
+        noise[0][k] = storage->rand_pm1();
+        noise[1][k] = storage->rand_pm1();
+    }
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+
+    auto timeBlocks = [&](std::function<void()> f) {
+        auto st = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < n_blocks; ++i)
+        {
+            memcpy(L, noise[0], sizeof(L));
+            memcpy(R, noise[1], sizeof(R));
+            f();
+        }
+        auto et = std::chrono::high_resolution_clock::now();
+        return 1.0 * std::chrono::duration_cast<std::chrono::microseconds>(et - st).count() /
+               n_blocks;
+    };
+
+    std::vector<BiquadFilter> bq(n_sections, BiquadFilter(storage));
+    BiquadCascade<n_sections> cascade;
+    for (int i = 0; i < n_sections; ++i)
+    {
+        bq[i].coeff_peakEQ(bq[i].calc_omega_from_Hz(30.0 * pow(2.0, i)), 0.5, 6.0);
+        cascade.set_coef(i, bq[i]);
+    }
+
+    auto scalar = timeBlocks([&]() {
+        for (auto &b : bq)
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+                b.process_sample(L[k], R[k], L[k], R[k]);
+    });
+    auto stereo = timeBlocks([&]() {
+        for (auto &b : bq)
+            b.process_block(L, R);
+    });
+    auto cascaded = timeBlocks([&]() { cascade.process_block(L, R); });
+
+    std::cout << n_sections << " sections : scalar " << scalar << "us/block ; stereo SSE2 "
+              << stereo << "us/block (" << scalar / stereo << "x) ; cascade " << cascaded
+              << "us/block (" << scalar / cascaded << "x)" << std::endl;
+
+    for (auto t : {fxt_geq11, fxt_phaser})
+    {
+        auto &fxs = storage->getPatch().fx[0];
+        fxs.type.val.i = t;
+        std::unique_ptr<Effect> fx(
+            spawn_effect(t, storage, &fxs, storage->getPatch().globaldata));
+        fx->init_ctrltypes();
+        fx->allocate_memory();
+        fx->init_default_values();
+        storage->getPatch().copy_globaldata(storage->getPatch().globaldata);
+        fx->init();
+
+        if (t == fxt_phaser)
+        {
+            for (auto n : {4, 16})
+            {
+                fxs.p[PhaserEffect::ph_stages].val.i = n;
+                auto us = timeBlocks([&]() { fx->process(L, R); });
+                std::cout << fx_type_names[t] << " stages=" << n << " : " << us << "us/block"
+                          << std::endl;
+            }
+        }
+        else
+        {
+            auto us = timeBlocks([&]() { fx->process(L, R); });
+            std::cout << fx_type_names[t] << " : " << us << "us/block" << std::endl;
+        }
+    }
+}
+
+void resamplerBenchmark()
+{
+    /*
+     * Nimbus runs Clouds at 32k, and used to get there and back with two libsamplerate
+     * SINC_FASTEST states and a ring buffer. Run that glue and the lowpass and LanczosResampler
+     * glue which replaced it with Clouds left out, timing a block and finding where an impulse
+     * comes out.
+     */
+    const int n_blocks = 20000;
+    const int euro_sr = 32000;
+    const int max_euro = BLOCK_SIZE << 3;
+
+    for (auto sr : {44100, 48000, 96000})
+    {
+        // for the sample rate globals the lowpass design uses
+        auto surge = Surge::Headless::createSurge(sr);
+
+        // each returns the glue's output for an impulse at the start of a silent input
+        auto runSRC = [&](int blocks, bool impulse) {
+            std::vector<float> res;
+            int error;
+            auto *in = src_new(SRC_SINC_FASTEST, 2, &error);
+            auto *out = src_new(SRC_SINC_FASTEST, 2, &error);
+
+            static constexpr int raw_out_sz = BLOCK_SIZE_OS << 3;
+            float ring[raw_out_sz][2] = {};
+            size_t rp = 0, wp = 1;
+            int created = 0;
+
+            for (int b = 0; b < blocks; ++b)
+            {
+                float a[max_euro][2] = {}, e[max_euro][2];
+                if (impulse && b == 0)
+                    a[0][0] = a[0][1] = 1;
+                if (!impulse)
+                    for (int i = 0; i < BLOCK_SIZE; ++i)
+                        a[i][0] = a[i][1] = sin(0.01 * (b * BLOCK_SIZE + i));
+
+                SRC_DATA d;
+                d.end_of_input = 0;
+                d.src_ratio = 1.0 * euro_sr / sr;
+                d.data_in = &a[0][0];
+                d.data_out = &e[0][0];
+                d.input_frames = BLOCK_SIZE;
+                d.output_frames = max_euro;
+                src_process(in, &d);
+
+                SRC_DATA o;
+                o.end_of_input = 0;
+                o.src_ratio = 1.0 * sr / euro_sr;
+                o.data_in = &e[0][0];
+                o.data_out = &a[0][0];
+                o.input_frames = d.output_frames_gen;
+                o.output_frames = max_euro;
+                src_process(out, &o);
+                created += o.output_frames_gen;
+
+                for (int i = 0; i < o.output_frames_gen; ++i)
+                {
+                    ring[wp][0] = a[i][0];
+                    ring[wp][1] = a[i][1];
+                    wp = (wp + 1) & (raw_out_sz - 1);
+                }
+
+                bool rpi = created > (BLOCK_SIZE + 8);
+                for (int i = 0; i < BLOCK_SIZE; ++i)
+                {
+                    if (impulse)
+                        res.push_back(ring[rp][0]);
+                    rp = (rp + rpi) & (raw_out_sz - 1);
+                }
+            }
+
+            src_delete(in);
+            src_delete(out);
+            return res;
+        };
+
+        auto runLanczos = [&](int blocks, bool impulse) {
+            std::vector<float> res;
+            auto in = std::make_unique<LanczosResampler>(sr, euro_sr);
+            auto out = std::make_unique<LanczosResampler>(euro_sr, sr);
+            bool primed = false;
+
+            BiquadCascade<2> antialias;
+            BiquadFilter designer(&surge->storage);
+            designer.coeff_LP(BiquadFilter::calc_omega_from_Hz(0.45 * euro_sr), 0.5412);
+            antialias.set_coef(0, designer);
+            designer.coeff_LP(BiquadFilter::calc_omega_from_Hz(0.45 * euro_sr), 1.3066);
+            antialias.set_coef(1, designer);
+
+            for (int b = 0; b < blocks; ++b)
+            {
+                float aL alignas(16)[BLOCK_SIZE], aR alignas(16)[BLOCK_SIZE];
+                for (int i = 0; i < BLOCK_SIZE; ++i)
+                    aL[i] = aR[i] = impulse ? (b == 0 && i == 0) : sin(0.01 * (b * BLOCK_SIZE + i));
+                antialias.process_block(aL, aR);
+                for (int i = 0; i < BLOCK_SIZE; ++i)
+                    in->push(aL[i], aR[i]);
+
+                float eL alignas(16)[max_euro], eR alignas(16)[max_euro];
+                auto n = in->populateNext(eL, eR, max_euro);
+                in->renormalizePhases();
+                for (int i = 0; i < n; ++i)
+                    out->push(eL[i], eR[i]);
+
+                float L alignas(16)[BLOCK_SIZE] = {}, R alignas(16)[BLOCK_SIZE] = {};
+                if (!primed)
+                    primed = out->inputsRequiredToGenerateOutputs(BLOCK_SIZE + 8) == 0;
+                if (primed)
+                    out->populateNext(L, R, BLOCK_SIZE);
+                out->renormalizePhases();
+
+                if (impulse)
+                    res.insert(res.end(), L, L + BLOCK_SIZE);
+            }
+            return res;
+        };
+
+        auto time = [&](std::function<std::vector<float>(int, bool)> f) {
+            auto st = std::chrono::high_resolution_clock::now();
+            f(n_blocks, false);
+            auto et = std::chrono::high_resolution_clock::now();
+            return 1.0 * std::chrono::duration_cast<std::chrono::microseconds>(et - st).count() /
+                   n_blocks;
+        };
+        auto latency = [&](std::function<std::vector<float>(int, bool)> f) {
+            auto r = f(100, true);
+            return std::max_element(r.begin(), r.end()) - r.begin();
+        };
+
+        auto srcUs = time(runSRC), lancUs = time(runLanczos);
+        std::cout << sr << "Hz <-> 32kHz : libsamplerate " << srcUs << "us/block, "
+                  << latency(runSRC) << " samples latency ; Lanczos " << lancUs << "us/block ("
+                  << srcUs / lancUs << "x), " << latency(runLanczos) << " samples latency"
+                  << std::endl;
+    }
+}
+
+void airwindowsBenchmark()
+{
+    /*
+     * A CPU table of the airwindows algorithms, each at its default parameters on noise in the
+     * quarter blocks AirWindowsEffect runs them in, and for those with one, of the stereo kernel
+     * which AirWindowsEffect uses in its place.
+     */
+    _mm_setcsr(_mm_getcsr() | 0x8040); // FTZ and DAZ, as the synth runs
+    const int n_blocks = 20000;
+    const int qblock = BLOCK_SIZE >> 3;
+    const double sr = 48000;
+
+    float L[BLOCK_SIZE], R[BLOCK_SIZE], oL[BLOCK_SIZE], oR[BLOCK_SIZE];
+    std::minstd_rand gen(17);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (int i = 0; i < BLOCK_SIZE; ++i)
+    {
+        L[i] = dist(gen);
+        R[i] = dist(gen);
+    }
+
+    auto time = [&](std::function<void(float **, float **)> f) {
+        auto st = std::chrono::high_resolution_clock::now();
+        for (int b = 0; b < n_blocks; ++b)
+        {
+            for (int q = 0; q < BLOCK_SIZE; q += qblock)
+            {
+                float *in[2] = {L + q, R + q}, *out[2] = {oL + q, oR + q};
+                f(in, out);
+            }
+        }
+        auto et = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>(et - st).count() / n_blocks;
+    };
+
+    std::cout << std::left << std::setw(24) << "Airwindows" << std::right << std::setw(12)
+              << "ns/block" << std::setw(12) << "stereo" << std::endl;
+
+    for (auto &r : AirWinBaseClass::pluginRegistry())
+    {
+        auto aw = r.create(r.id, sr, 2);
+        char name[1024];
+        aw->getEffectName(name);
+
+        auto scalar = time([&](float **in, float **out) { aw->processReplacing(in, out, qblock); });
+        std::cout << std::left << std::setw(24) << r.name << std::right << std::setw(12)
+                  << std::setprecision(0) << std::fixed << scalar;
+
+        auto kernel = AirWindowsStereo::create(name);
+        if (kernel)
+        {
+            auto st = time([&](float **in, float **out) {
+                kernel->processReplacing(aw.get(), in, out, qblock);
+            });
+            std::cout << std::setw(12) << st << " (" << std::setprecision(2) << scalar / st
+                      << "x)";
+        }
+        std::cout << std::endl;
+    }
+}
+
+
+void modulatedDelayBenchmark()
+{
+    /*
+     * Read four moving taps a sample from a delay line one at a time and with readTaps, for each
+     * interpolation, then time the effects which read their modulated delays with readTaps.
+     */
+    _mm_setcsr(_mm_getcsr() | 0x8040); // FTZ and DAZ, as the synth runs
+    const int n_blocks = 100000;
+    auto surge = Surge::Headless::createSurge(48000);
+    auto *storage = &surge->storage;
+
+    float noise alignas(16)[2][BLOCK_SIZE];
+    for (int k = 0; k < BLOCK_SIZE; ++k)
+    {
+        noise[0][k] = storage->rand_pm1();
+        noise[1][k] = storage->rand_pm1();
+    }
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+
+    auto timeBlocks = [&](std::function<void()> f) {
+        auto st = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < n_blocks; ++i)
+        {
+            memcpy(L, noise[0], sizeof(L));
+            memcpy(R, noise[1], sizeof(R));
+            f();
+        }
+        auto et = std::chrono::high_resolution_clock::now();
+        return 1.0 * std::chrono::duration_cast<std::chrono::microseconds>(et - st).count() /
+               n_blocks;
+    };
+
+    using Delay = SSESincDelayLine<8192>;
+    static Delay line; // too big for the stack
+    float taps alignas(16)[4] = {1000.3f, 1500.6f, 2200.1f, 3100.9f};
+    float sum = 0.f; // keeps the reads from being optimised away
+
+    auto timeReads = [&](std::function<float(float)> one, std::function<__m128()> four) {
+        auto single = timeBlocks([&]() {
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                line.write(L[k]);
+                for (int t = 0; t < 4; ++t)
+                    sum += one(taps[t] + 0.01f * k);
+            }
+        });
+        auto vec = timeBlocks([&]() {
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                line.write(L[k]);
+                float o alignas(16)[4];
+                _mm_store_ps(o, four());
+                sum += o[0] + o[1] + o[2] + o[3];
+            }
+        });
+        return std::make_pair(single, vec);
+    };
+
+    auto lin = timeReads([&](float d) { return line.readLinear(d); },
+                         [&]() { return line.readTaps<Delay::LINEAR>(taps); });
+    auto sinc = timeReads([&](float d) { return line.read(d); },
+                          [&]() { return line.readTaps<Delay::SINC>(taps); });
+    auto lag = timeReads([&](float d) { return line.readLinear(d); },
+                         [&]() { return line.readTaps<Delay::LAGRANGE>(taps); }).second;
+
+    std::cout << "4 taps, linear : readLinear " << lin.first << "us/block ; readTaps " << lin.second
+              << "us/block (" << lin.first / lin.second << "x)" << std::endl;
+    std::cout << "4 taps, sinc : read " << sinc.first << "us/block ; readTaps " << sinc.second
+              << "us/block (" << sinc.first / sinc.second << "x)" << std::endl;
+    std::cout << "4 taps, lagrange : readTaps " << lag << "us/block" << std::endl;
+
+    for (auto t : {fxt_chorus4, fxt_flanger, fxt_ensemble, fxt_rotaryspeaker})
+    {
+        auto &fxs = storage->getPatch().fx[0];
+        fxs.type.val.i = t;
+        std::unique_ptr<Effect> fx(
+            spawn_effect(t, storage, &fxs, storage->getPatch().globaldata));
+        fx->init_ctrltypes();
+        fx->allocate_memory();
+        fx->init_default_values();
+        if (t == fxt_ensemble)
+            fxs.p[BBDEnsembleEffect::ens_delay_type].val.i = BBDEnsembleEffect::ens_sinc;
+        storage->getPatch().copy_globaldata(storage->getPatch().globaldata);
+        fx->init();
+
+        auto us = timeBlocks([&]() { fx->process(L, R); });
+        std::cout << fx_type_names[t] << " : " << us << "us/block" << std::endl;
+    }
+
+    if (sum == 1234.5f)
+        std::cout << std::endl;
+}
+
+void oversamplingBenchmark()
+{
+    /*
+     * Run each oversampled effect at each factor, and print the time per block along with how
+     * much of its output, for a sine centered on an FFT bin, lies away from the harmonics of
+     * that sine. That is mostly aliasing, so it falls as the factor rises.
+     */
+    _mm_setcsr(_mm_getcsr() | 0x8040); // FTZ and DAZ, as the synth runs
+    const int n_blocks = 20000;
+    const int fft_size = 4096, bin = 301; // 301 * 48000 / 4096 is about 3.5kHz
+    auto surge = Surge::Headless::createSurge(48000);
+    auto *storage = &surge->storage;
+
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+    std::vector<float> sine(fft_size), out(fft_size);
+    for (int i = 0; i < fft_size; ++i)
+        sine[i] = 0.7 * sin(2.0 * M_PI * bin * i / fft_size);
+
+    // fraction, in dB, of the windowed output's power which isn't within 3 bins of a harmonic
+    auto inharmonic = [&]() {
+        double total = 0, away = 0;
+        for (int b = 1; b < fft_size / 2; ++b)
+        {
+            double re = 0, im = 0;
+            for (int i = 0; i < fft_size; ++i)
+            {
+                double w = 0.5 - 0.5 * cos(2.0 * M_PI * i / fft_size);
+                re += w * out[i] * cos(2.0 * M_PI * b * i / fft_size);
+                im -= w * out[i] * sin(2.0 * M_PI * b * i / fft_size);
+            }
+            auto pw = re * re + im * im;
+            total += pw;
+            int nearest = ((b + bin / 2) / bin) * bin;
+            if (nearest == 0 || abs(b - nearest) > 3)
+                away += pw;
+        }
+        return 10.0 * log10(std::max(away, 1e-30) / std::max(total, 1e-30));
+    };
+
+    for (auto t : {fxt_distortion, fxt_neuron, fxt_chow, fxt_exciter, fxt_tape})
+    {
+        auto &fxs = storage->getPatch().fx[0];
+        fxs.type.val.i = t;
+        std::unique_ptr<Effect> fx(
+            spawn_effect(t, storage, &fxs, storage->getPatch().globaldata));
+        fx->init_ctrltypes();
+        fx->allocate_memory();
+        fx->init_default_values();
+        storage->getPatch().copy_globaldata(storage->getPatch().globaldata);
+
+        for (int os = fxos_default; os < n_fx_oversampling; ++os)
+        {
+            fxs.type.deform_type = os;
+            fx->init();
+
+            // settle on the sine for a second, then keep one FFT frame of the output
+            int pos = 0;
+            for (int b = 0; b < 48000 / BLOCK_SIZE + fft_size / BLOCK_SIZE; ++b)
+            {
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                    L[k] = R[k] = sine[(pos + k) % fft_size];
+                fx->process(L, R);
+                int frame = b - 48000 / BLOCK_SIZE;
+                if (frame >= 0)
+                    std::copy(L, L + BLOCK_SIZE, out.begin() + frame * BLOCK_SIZE);
+                pos = (pos + BLOCK_SIZE) % fft_size;
+            }
+            auto db = inharmonic();
+
+            auto st = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < n_blocks; ++i)
+            {
+                memcpy(L, &sine[(i * BLOCK_SIZE) % fft_size], sizeof(L));
+                memcpy(R, L, sizeof(R));
+                fx->process(L, R);
+            }
+            auto et = std::chrono::high_resolution_clock::now();
+            auto us = 1.0 * std::chrono::duration_cast<std::chrono::microseconds>(et - st).count() /
+                      n_blocks;
+
+            std::cout << fx_type_names[t] << " " << fx_oversampling_names[os] << " : " << us
+                      << "us/block ; inharmonic " << db << "dB" << std::endl;
+        }
+    }
+}
+
+void blockSizeStats(const std::string &path)
+{
+    /*
+     * Write the stats "A Patch Renders Alike At Two Block Sizes" compares, to path or stdout.
+     * Run it from a build at another block size and pass the file to the unit tests in
+     * SURGE_BLOCK_SIZE_STATS.
+     */
+    auto stats = Surge::Test::blockSizeStats();
+    if (stats.windowRMS.empty())
+    {
+        std::cout << "Couldn't find the Init Saw patch" << std::endl;
+        return;
+    }
+
+    if (path.empty())
+    {
+        Surge::Test::writeBlockSizeStats(std::cout, stats);
+        return;
+    }
+
+    std::ofstream of(path);
+    Surge::Test::writeBlockSizeStats(of, stats);
+    std::cout << "Wrote the stats at block size " << stats.blockSize << " to " << path
+              << std::endl;
+}
+
 } // namespace NonTest
 } // namespace Headless
 } // namespace Surge
@@ -1,5 +1,6 @@
 #pragma once
 #include <iostream>
+#include <string>
 
 namespace Surge
 {
@@ -12,6 +13,15 @@ void statsFromPlayingEveryPatch();
 void playSomeBach();
 void filterAnalyzer(int ft, int fst, std::ostream &os);
 void generateNLFeedbackNorms();
+void fmOperatorBenchmark();
+void wavetableBuildBenchmark();
+void oscillatorPreviewBenchmark();
+void biquadBenchmark();
+void resamplerBenchmark();
+void airwindowsBenchmark();
+void modulatedDelayBenchmark();
+void oversamplingBenchmark();
+void blockSizeStats(const std::string &path);
 [[noreturn]] void performancePlay(const std::string &patchName, int mode);
 } // namespace NonTest
 } // namespace Headless
@@ -0,0 +1,568 @@
+/*
+** Surge Synthesizer is Free and Open Source Software
+**
+** Surge is made available under the Gnu General Public License, v3.0
+** https://www.gnu.org/licenses/gpl-3.0.en.html
+**
+** Copyright 2004-2020 by various individuals as described by the Git transaction log
+**
+** All source at: https://github.com/surge-synthesizer/surge.git
+**
+** Surge was a commercial product from 2004-2018, with Copyright and ownership
+** in that period held by Claes Johanson at Vember Audio. Claes made Surge
+** open source in September 2018.
+*/
+
+/*
+ * surge-bench times the DSP building blocks the engine runs per voice, at 1, 4, 16 and 64
+ * voices, along with every effect, and writes the results as JSON in the layout Google
+ * Benchmark uses, so its tools/compare.py can diff two runs. An iteration is one block, so
+ * real_time is the time per block, and ns_per_sample divides that by the samples in the block
+ * at the rate the unit runs at (the oversampled rate for the voice units). Effects don't scale
+ * with the voice count, so they run once and carry no "voices" field.
+ *
+ * Usage: surge-bench [--benchmark_filter=substring] [--benchmark_out=file.json]
+ *                    [--benchmark_min_time=seconds]
+ */
+
+#include "HeadlessUtils.h"
+#include "BiquadFilter.h"
+#include "QuadFilterChain.h"
+#include "QuadFilterUnit.h"
+#include "FilterCoefficientMaker.h"
+#include "Oscillator.h"
+#include "effect/Effect.h"
+#include "version.h"
+#include <vt_dsp/halfratefilter.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const int voiceCounts[] = {1, 4, 16, 64};
+
+struct Options
+{
+    std::string filter, out;
+    double minTime = 0.1;
+};
+
+struct Result
+{
+    std::string name;
+    int voices; // 0 for the effects
+    int64_t iterations;
+    double nsPerBlock;
+    int samplesPerBlock;
+};
+
+std::string jsonEscape(const std::string &s)
+{
+    std::ostringstream oss;
+    for (auto c : s)
+    {
+        if (c == '"' || c == '\\')
+            oss << '\\' << c;
+        else if ((unsigned char)c < 0x20)
+            oss << "\\u00" << std::hex << std::setw(2) << std::setfill('0') << (int)c << std::dec;
+        else
+            oss << c;
+    }
+    return oss.str();
+}
+
+/*
+ * Runs f, which processes one block, in doubling batches until a batch takes minTime, after a
+ * few blocks to settle caches and branch predictors. Returns the time per block in ns.
+ */
+template <typename F> double timeBlocks(F &&f, double minTime, int64_t &iterations)
+{
+    for (int i = 0; i < 16; ++i)
+        f();
+
+    iterations = 64;
+    while (true)
+    {
+        auto st = std::chrono::high_resolution_clock::now();
+        for (int64_t i = 0; i < iterations; ++i)
+            f();
+        auto et = std::chrono::high_resolution_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(et - st).count();
+        if (ns >= minTime * 1e9 || iterations >= (int64_t(1) << 30))
+            return ns / iterations;
+        iterations *= 2;
+    }
+}
+
+class Bench
+{
+  public:
+    explicit Bench(const Options &o) : opts(o) {}
+
+    bool wanted(const std::string &name) const
+    {
+        return opts.filter.empty() || name.find(opts.filter) != std::string::npos;
+    }
+
+    template <typename F> void run(const std::string &name, int voices, int samplesPerBlock, F &&f)
+    {
+        Result r;
+        r.name = name;
+        r.voices = voices;
+        r.samplesPerBlock = samplesPerBlock;
+        r.nsPerBlock = timeBlocks(f, opts.minTime, r.iterations);
+        std::cerr << name << " : " << r.nsPerBlock / samplesPerBlock << " ns/sample" << std::endl;
+        results.push_back(r);
+    }
+
+    void write(std::ostream &os) const
+    {
+        os << "{\n"
+           << "  \"context\": {\n"
+           << "    \"executable\": \"surge-bench\",\n"
+           << "    \"surge_version\": \"" << jsonEscape(Surge::Build::FullVersionStr) << "\",\n"
+           << "    \"samplerate\": 48000,\n"
+           << "    \"block_size\": " << BLOCK_SIZE << ",\n"
+           << "    \"block_size_os\": " << BLOCK_SIZE_OS << ",\n"
+#if BUILD_IS_DEBUG
+           << "    \"library_build_type\": \"debug\"\n"
+#else
+           << "    \"library_build_type\": \"release\"\n"
+#endif
+           << "  },\n"
+           << "  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            auto &r = results[i];
+            auto name = jsonEscape(r.name);
+            os << (i ? ",\n" : "\n") << "    {\n"
+               << "      \"name\": \"" << name << "\",\n"
+               << "      \"run_name\": \"" << name << "\",\n"
+               << "      \"run_type\": \"iteration\",\n"
+               << "      \"iterations\": " << r.iterations << ",\n"
+               << "      \"real_time\": " << r.nsPerBlock << ",\n"
+               << "      \"cpu_time\": " << r.nsPerBlock << ",\n"
+               << "      \"time_unit\": \"ns\",\n";
+            if (r.voices > 0)
+                os << "      \"voices\": " << r.voices << ",\n";
+            os << "      \"samples_per_block\": " << r.samplesPerBlock << ",\n"
+               << "      \"ns_per_sample\": " << r.nsPerBlock / r.samplesPerBlock << "\n"
+               << "    }";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+  private:
+    Options opts;
+    std::vector<Result> results;
+};
+
+std::string withVoices(const std::string &name, int voices)
+{
+    return name + "/voices:" + std::to_string(voices);
+}
+
+/*
+ * Sets up the quads for a voice count the way SurgeVoice does: whole quads of live lanes, and
+ * the lanes past the last voice masked off, with each lane at its own cutoff.
+ */
+void setupFilterQuad(QuadFilterUnitState &Q, float *dbuf, int lanes, int ft, int sft,
+                     SurgeStorage *storage)
+{
+    FilterCoefficientMaker cm[4];
+    FilterCoefficientMaker *cms[4];
+    float freq[4], reso[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        Q.active[i] = (i < lanes) ? 0xffffffff : 0;
+        Q.DB[i] = dbuf + i * (MAX_FB_COMB + FIRipol_N);
+        cms[i] = &cm[i];
+        freq[i] = 12.f * i - 6.f;
+        reso[i] = 0.5f;
+    }
+    if (ft != fut_comb_pos && ft != fut_comb_neg)
+        Q.WP[0] = sft;
+    FilterCoefficientMaker::MakeCoeffsQuad(cms, freq, reso, ft, sft, storage, false, Q);
+}
+
+struct QuadBuffers
+{
+    explicit QuadBuffers(int voices) : quads((voices + 3) >> 2)
+    {
+        std::mt19937 gen(22);
+        std::uniform_real_distribution<float> noise(-1.f, 1.f);
+        for (auto &s : in)
+            s = _mm_set_ps(noise(gen), noise(gen), noise(gen), noise(gen));
+    }
+    int quads;
+    __m128 in[BLOCK_SIZE_OS];
+};
+
+void benchFilters(Bench &b, SurgeStorage *storage)
+{
+    std::vector<float> dbuf(MAX_VOICES * (MAX_FB_COMB + FIRipol_N), 0.f);
+    for (int ft = fut_none + 1; ft < n_fu_types; ++ft)
+    {
+        for (int sft = 0; sft < std::max(1, fut_subcount[ft]); ++sft)
+        {
+            auto fu = GetQFPtrFilterUnit(ft, sft);
+            auto name = std::string("filter/") + fut_names[ft] + "/" + std::to_string(sft);
+            if (!fu)
+                continue;
+
+            for (auto voices : voiceCounts)
+            {
+                if (!b.wanted(withVoices(name, voices)))
+                    continue;
+
+                QuadBuffers buf(voices);
+                std::vector<QuadFilterUnitState> Q(buf.quads);
+                std::fill(dbuf.begin(), dbuf.end(), 0.f);
+                for (int q = 0; q < buf.quads; ++q)
+                {
+                    memset(&Q[q], 0, sizeof(QuadFilterUnitState));
+                    setupFilterQuad(Q[q], &dbuf[q * 4 * (MAX_FB_COMB + FIRipol_N)],
+                                    voices - 4 * q, ft, sft, storage);
+                }
+
+                auto sum = _mm_setzero_ps();
+                b.run(withVoices(name, voices), voices, BLOCK_SIZE_OS, [&]() {
+                    for (int q = 0; q < buf.quads; ++q)
+                        for (int k = 0; k < BLOCK_SIZE_OS; ++k)
+                            sum = _mm_add_ps(sum, fu(&Q[q], buf.in[k]));
+                });
+                float s alignas(16)[4];
+                _mm_store_ps(s, sum);
+                if (!std::isfinite(s[0] + s[1] + s[2] + s[3]))
+                    std::cerr << name << " : non-finite output" << std::endl;
+            }
+        }
+    }
+}
+
+void benchWaveshapers(Bench &b)
+{
+    for (int wt = wst_none + 1; wt < n_ws_types; ++wt)
+    {
+        // older patches interpolate a table for some shapes, so time that too where it differs
+        for (auto tableLookup : {false, true})
+        {
+            auto ws = GetQFPtrWaveshaper(wt, tableLookup);
+            auto name = std::string("waveshaper/") + wst_names[wt];
+            if (!ws || (tableLookup && ws == GetQFPtrWaveshaper(wt, false)))
+                continue;
+            if (tableLookup)
+                name += "/table";
+
+            for (auto voices : voiceCounts)
+            {
+                if (!b.wanted(withVoices(name, voices)))
+                    continue;
+
+                QuadBuffers buf(voices);
+                auto drive = _mm_set1_ps(2.f);
+                auto sum = _mm_setzero_ps();
+                b.run(withVoices(name, voices), voices, BLOCK_SIZE_OS, [&]() {
+                    for (int q = 0; q < buf.quads; ++q)
+                        for (int k = 0; k < BLOCK_SIZE_OS; ++k)
+                            sum = _mm_add_ps(sum, ws(buf.in[k], drive));
+                });
+                float s alignas(16)[4];
+                _mm_store_ps(s, sum);
+                if (!std::isfinite(s[0] + s[1] + s[2] + s[3]))
+                    std::cerr << name << " : non-finite output" << std::endl;
+            }
+        }
+    }
+}
+
+/*
+ * Each filter block configuration with both filters and the waveshaper in, as a scene with the
+ * default patch's LP 24 and soft waveshaper and some feedback would run them.
+ */
+void benchFilterBlocks(Bench &b, SurgeStorage *storage)
+{
+    const int ft = fut_lp24, sft = 0;
+    fbq_global g;
+    g.FU1ptr = GetQFPtrFilterUnit(ft, sft);
+    g.FU2ptr = GetQFPtrFilterUnit(ft, sft);
+    g.WSptr = GetQFPtrWaveshaper(wst_soft, false);
+
+    std::vector<float> dbuf(MAX_VOICES * 4 * (MAX_FB_COMB + FIRipol_N), 0.f);
+    auto *FBQ = (QuadFilterChainState *)_aligned_malloc(
+        (MAX_VOICES >> 2) * sizeof(QuadFilterChainState), 16);
+
+    for (int config = 0; config < n_filter_configs; ++config)
+    {
+        auto name = std::string("filterblock/") + fbc_names[config];
+        auto fbq = GetFBQPointer(config, true, true, true);
+
+        for (auto voices : voiceCounts)
+        {
+            if (!b.wanted(withVoices(name, voices)))
+                continue;
+
+            QuadBuffers buf(voices);
+            std::fill(dbuf.begin(), dbuf.end(), 0.f);
+            for (int q = 0; q < buf.quads; ++q)
+            {
+                auto &Q = FBQ[q];
+                InitQuadFilterChainStateToZero(&Q);
+                for (int u = 0; u < 4; ++u)
+                {
+                    auto *db = &dbuf[(q * 4 + u) * 4 * (MAX_FB_COMB + FIRipol_N)];
+                    setupFilterQuad(Q.FU[u], db, voices - 4 * q, ft, sft, storage);
+                }
+                Q.Gain = _mm_set1_ps(1.f);
+                Q.FB = _mm_set1_ps(0.3f);
+                Q.Mix1 = Q.Mix2 = _mm_set1_ps(0.5f);
+                Q.Drive = _mm_set1_ps(2.f);
+                Q.OutL = Q.OutR = Q.Out2L = Q.Out2R = _mm_set1_ps(0.5f);
+                for (int k = 0; k < BLOCK_SIZE_OS; ++k)
+                {
+                    Q.DL[k] = buf.in[k];
+                    Q.DR[k] = buf.in[BLOCK_SIZE_OS - 1 - k];
+                }
+            }
+
+            float outL alignas(16)[BLOCK_SIZE_OS], outR alignas(16)[BLOCK_SIZE_OS];
+            memset(outL, 0, sizeof(outL));
+            memset(outR, 0, sizeof(outR));
+            b.run(withVoices(name, voices), voices, BLOCK_SIZE_OS, [&]() {
+                for (int q = 0; q < buf.quads; ++q)
+                    fbq(FBQ[q], g, outL, outR);
+            });
+            if (!std::isfinite(outL[0] + outR[0]))
+                std::cerr << name << " : non-finite output" << std::endl;
+        }
+    }
+
+    _aligned_free(FBQ);
+}
+
+/*
+ * The decimation of both scenes' output, in the fused pass the engine runs and as the separate
+ * clip and halfband passes it replaced. Per voice counts don't apply.
+ */
+void benchSceneHalfbands(Bench &b)
+{
+    std::vector<std::unique_ptr<HalfRateFilter>> hb;
+    for (int i = 0; i < 2 * n_scenes; ++i)
+        hb.push_back(std::make_unique<HalfRateFilter>(6, true));
+    float buf alignas(16)[n_scenes][2][BLOCK_SIZE_OS];
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> noise(-1.f, 1.f);
+    float src alignas(16)[BLOCK_SIZE_OS];
+    for (auto &f : src)
+        f = noise(gen);
+
+    auto fill = [&]() {
+        for (int s = 0; s < n_scenes; ++s)
+            for (int c = 0; c < 2; ++c)
+                memcpy(buf[s][c], src, sizeof(src));
+    };
+
+    if (b.wanted("halfband/scenes/fused"))
+        b.run("halfband/scenes/fused", 0, BLOCK_SIZE, [&]() {
+            fill();
+            HalfRateFilter *f[n_scenes];
+            HalfRateFilter::D2Block blocks[n_scenes];
+            for (int s = 0; s < n_scenes; ++s)
+            {
+                f[s] = hb[s].get();
+                blocks[s].L = buf[s][0];
+                blocks[s].R = buf[s][1];
+                blocks[s].clipIn = blocks[s].clipOut = 8.f;
+            }
+            HalfRateFilter::process_block_D2_fused(f, blocks, n_scenes, BLOCK_SIZE_OS);
+        });
+
+    if (b.wanted("halfband/scenes/separate"))
+        b.run("halfband/scenes/separate", 0, BLOCK_SIZE, [&]() {
+            fill();
+            for (int s = 0; s < n_scenes; ++s)
+            {
+                hardclip_block8(buf[s][0], BLOCK_SIZE_OS_QUAD);
+                hardclip_block8(buf[s][1], BLOCK_SIZE_OS_QUAD);
+                hb[n_scenes + s]->process_block_D2(buf[s][0], buf[s][1], BLOCK_SIZE_OS);
+                hardclip_block8(buf[s][0], BLOCK_SIZE_QUAD);
+                hardclip_block8(buf[s][1], BLOCK_SIZE_QUAD);
+            }
+        });
+}
+
+void benchSceneLowcut(Bench &b, SurgeStorage *storage)
+{
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+    for (int k = 0; k < BLOCK_SIZE; ++k)
+        L[k] = R[k] = storage->rand_pm1();
+
+    // an unmodulated lowcut, which is the common case
+    const float freq = -24.f;
+
+    if (b.wanted("lowcut/scene/cached"))
+    {
+        SceneLowcutFilter lowcut(storage);
+        b.run("lowcut/scene/cached", 0, BLOCK_SIZE, [&]() { lowcut.process_block(L, R, freq); });
+    }
+
+    if (b.wanted("lowcut/scene/recompute"))
+    {
+        BiquadFilter hp(storage);
+        b.run("lowcut/scene/recompute", 0, BLOCK_SIZE, [&]() {
+            hp.coeff_HP(hp.calc_omega(freq / 12.0), 0.4);
+            hp.process_block(L, R);
+        });
+    }
+}
+
+void benchOscillators(Bench &b, SurgeSynthesizer *surge)
+{
+    auto *storage = &surge->storage;
+    auto &oscdata = storage->getPatch().scene[0].osc[0];
+    static pdata localcopy[n_scene_params];
+
+    for (int ot = 0; ot < n_osc_types; ++ot)
+    {
+        auto name = std::string("oscillator/") + osc_type_names[ot];
+
+        // let the synth switch the type over, so its parameters take their defaults
+        oscdata.queue_type = ot;
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+        storage->getPatch().copy_scenedata(localcopy, 0);
+
+        // "single" renders each voice on its own, to show what process_block_batch buys
+        for (auto voices : voiceCounts)
+        {
+            for (auto single : {false, true})
+            {
+                auto bname = withVoices(single ? name + "/single" : name, voices);
+                if (!b.wanted(bname))
+                    continue;
+
+                std::vector<std::unique_ptr<Oscillator>> oscs;
+                std::vector<Oscillator *> op(voices);
+                std::vector<float> pitch(voices), drift(voices, 0.f), fmdepth(voices, 0.f);
+                for (int i = 0; i < voices; ++i)
+                {
+                    pitch[i] = 36 + (i * 7) % 48;
+                    oscs.emplace_back(spawn_osc(ot, storage, &oscdata, localcopy));
+                    oscs.back()->init(pitch[i]);
+                    op[i] = oscs.back().get();
+                }
+
+                b.run(bname, voices, BLOCK_SIZE_OS, [&]() {
+                    if (single)
+                        for (int i = 0; i < voices; ++i)
+                            op[i]->process_block(pitch[i], drift[i], false, false, fmdepth[i]);
+                    else
+                        op[0]->process_block_batch(op.data(), voices, pitch.data(), drift.data(),
+                                                   false, false, fmdepth.data());
+                });
+            }
+        }
+    }
+}
+
+void benchEffects(Bench &b, SurgeStorage *storage)
+{
+    float noise alignas(16)[2][BLOCK_SIZE];
+    for (int k = 0; k < BLOCK_SIZE; ++k)
+    {
+        noise[0][k] = storage->rand_pm1();
+        noise[1][k] = storage->rand_pm1();
+    }
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+
+    for (int t = fxt_off + 1; t < n_fx_types; ++t)
+    {
+        auto name = std::string("effect/") + fx_type_names[t];
+        if (!b.wanted(name))
+            continue;
+
+        auto &fxs = storage->getPatch().fx[0];
+        fxs.type.val.i = t;
+        std::unique_ptr<Effect> fx(
+            spawn_effect(t, storage, &fxs, storage->getPatch().globaldata));
+        if (!fx)
+            continue;
+        fx->init_ctrltypes();
+        fx->allocate_memory();
+        fx->init_default_values();
+        storage->getPatch().copy_globaldata(storage->getPatch().globaldata);
+        fx->init();
+
+        b.run(name, 0, BLOCK_SIZE, [&]() {
+            memcpy(L, noise[0], sizeof(L));
+            memcpy(R, noise[1], sizeof(R));
+            fx->process(L, R);
+        });
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string a = argv[i];
+        auto value = [&a](const char *key) -> const char * {
+            auto n = strlen(key);
+            return (a.compare(0, n, key) == 0) ? a.c_str() + n : nullptr;
+        };
+
+        if (auto v = value("--benchmark_filter="))
+            opts.filter = v;
+        else if (auto v = value("--benchmark_out="))
+            opts.out = v;
+        else if (auto v = value("--benchmark_min_time="))
+            opts.minTime = std::atof(v);
+        else
+        {
+            std::cerr << "Usage: surge-bench [--benchmark_filter=substring] "
+                         "[--benchmark_out=file.json] [--benchmark_min_time=seconds]\n";
+            return (a == "--help") ? 0 : 1;
+        }
+    }
+
+    _mm_setcsr(_mm_getcsr() | 0x8040); // FTZ and DAZ, as the synth runs
+
+    auto surge = Surge::Headless::createSurge(48000);
+    auto *storage = &surge->storage;
+
+    Bench b(opts);
+    benchFilters(b, storage);
+    benchWaveshapers(b);
+    benchFilterBlocks(b, storage);
+    benchSceneHalfbands(b);
+    benchSceneLowcut(b, storage);
+    benchOscillators(b, surge.get());
+    benchEffects(b, storage);
+
+    if (opts.out.empty())
+    {
+        b.write(std::cout);
+    }
+    else
+    {
+        std::ofstream ofs(opts.out);
+        if (!ofs)
+        {
+            std::cerr << "Unable to open " << opts.out << std::endl;
+            return 1;
+        }
+        b.write(ofs);
+    }
+    return 0;
+}
@@ -1,10 +1,16 @@
 #include <memory>
 #include "SurgeSynthesizer.h"
 #include "Player.h"
+#include "UnitTestUtilities.h"
 #include "catch2/catch2.hpp"
 #include <iostream>
 #include <cstdio>
 #include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
 
 namespace Surge
 {
@@ -197,6 +203,121 @@ std::shared_ptr<SurgeSynthesizer> surgeOnPatch(const std::string &otp)
 std::shared_ptr<SurgeSynthesizer> surgeOnSine() { return surgeOnPatch("Init Sine"); }
 std::shared_ptr<SurgeSynthesizer> surgeOnSaw() { return surgeOnPatch("Init Saw"); }
 
+BlockSizeStats blockSizeStats()
+{
+    BlockSizeStats res;
+    res.blockSize = BLOCK_SIZE;
+
+    auto surge = surgeOnSaw();
+    if (!surge)
+        return res;
+
+    auto &sc = surge->storage.getPatch().scene[0];
+    auto &aeg = sc.adsr[0], &feg = sc.adsr[1];
+    aeg.a.val.f = log2(0.2f);
+    aeg.d.val.f = log2(0.2f);
+    aeg.s.val.f = 0.6f;
+    aeg.r.val.f = log2(0.1f);
+    aeg.mode.val.b = false;
+    feg.a.val.f = log2(0.05f);
+    feg.d.val.f = log2(0.3f);
+    feg.s.val.f = 0.2f;
+    feg.mode.val.b = false;
+    sc.filterunit[0].type.val.i = fut_lp24;
+    sc.filterunit[0].subtype.val.i = 0;
+    sc.filterunit[0].cutoff.val.f = -24.f;
+    sc.filterunit[0].envmod.val.f = 48.f;
+
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    // hold and length are whole blocks at every block size up to 128
+    const int hold = 128 * 207, length = 128 * 414, window = 2048;
+    const double sr = dsamplerate;
+    std::vector<float> out;
+    surge->playNote(0, 60, 127, 0);
+    while ((int)out.size() < length)
+    {
+        if ((int)out.size() == hold)
+            surge->releaseNote(0, 60, 0);
+        surge->process();
+        out.insert(out.end(), surge->output[0], surge->output[0] + BLOCK_SIZE);
+    }
+
+    for (int w = 0; w + window <= length; w += window)
+    {
+        double ms = 0;
+        for (int i = w; i < w + window; ++i)
+            ms += out[i] * out[i];
+        res.windowRMS.push_back(sqrt(ms / window));
+    }
+
+    // The peak over the last 10ms, which spans a few cycles of the saw so doesn't ripple.
+    // Its lag is the same at every block size.
+    const int span = (int)(0.01 * sr);
+    std::vector<float> peak(length);
+    for (int i = 0; i < length; ++i)
+    {
+        float m = 0;
+        for (int j = std::max(0, i - span + 1); j <= i; ++j)
+            m = std::max(m, std::fabs(out[j]));
+        peak[i] = m;
+    }
+
+    float held = *std::max_element(peak.begin(), peak.begin() + hold);
+    int attack = 0;
+    while (attack < hold && peak[attack] < 0.5f * held)
+        attack++;
+    int release = hold;
+    while (release < length && peak[release] >= 0.1f * peak[hold - 1])
+        release++;
+
+    res.attackSeconds = attack / sr;
+    res.releaseSeconds = (release - hold) / sr;
+    return res;
+}
+
+void writeBlockSizeStats(std::ostream &os, const BlockSizeStats &stats)
+{
+    os << std::setprecision(9) << "block_size " << stats.blockSize << "\n"
+       << "attack " << stats.attackSeconds << "\n"
+       << "release " << stats.releaseSeconds << "\n"
+       << "rms " << stats.windowRMS.size();
+    for (auto r : stats.windowRMS)
+        os << " " << r;
+    os << "\n";
+}
+
+bool readBlockSizeStats(std::istream &is, BlockSizeStats &stats)
+{
+    std::string k0, k1, k2, k3;
+    size_t n = 0;
+    is >> k0 >> stats.blockSize >> k1 >> stats.attackSeconds;
+    is >> k2 >> stats.releaseSeconds >> k3 >> n;
+    if (!is || k0 != "block_size" || k1 != "attack" || k2 != "release" || k3 != "rms")
+        return false;
+
+    stats.windowRMS.resize(n);
+    for (auto &r : stats.windowRMS)
+        is >> r;
+    return (bool)is;
+}
+
+bool setFXType(std::shared_ptr<SurgeSynthesizer> surge, int slot, int type)
+{
+    auto *pt = &(surge->storage.getPatch().fx[slot].type);
+    surge->setParameter01(surge->idForParameter(pt),
+                          1.f * type / (pt->val_max.i - pt->val_min.i), false);
+
+    // the new effect is built on the spawner thread, so give it real time to arrive
+    for (int w = 0; w < 500 && pt->val.i != type; ++w)
+    {
+        surge->process();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return pt->val.i == type;
+}
+
 void makePlotPNGFromData(std::string pngFileName, std::string plotTitle, float *buffer, int nS,
                          int nC, int startSample, int endSample)
 {
@@ -5,6 +5,9 @@
 
 #include "SurgeSynthesizer.h"
 
+#include <iostream>
+#include <vector>
+
 namespace Surge
 {
 namespace Test
@@ -36,8 +39,29 @@ void setupStorageRanges(Parameter *start, Parameter *endIncluding, int &storage_
 void makePlotPNGFromData(std::string pngFileName, std::string plotTitle, float *buffer, int nS,
                          int nC, int startSample = -1, int endSample = -1);
 
+/*
+** Switch an FX slot to type the way a host does, through setParameter01, and run the
+** synth until the type change has loaded. Returns false if it never did.
+*/
+bool setFXType(std::shared_ptr<SurgeSynthesizer> surge, int slot, int type);
+
 std::shared_ptr<SurgeSynthesizer> surgeOnPatch(const std::string &patchName);
 std::shared_ptr<SurgeSynthesizer> surgeOnSine();
 std::shared_ptr<SurgeSynthesizer> surgeOnSaw();
+
+/*
+** The loudness and envelope timing of one patch, a saw through a swept filter, held and
+** released at the same times in seconds whatever the block size. The block size is a build
+** option, so builds at two sizes write these (--non-test --block-size-stats) to be compared.
+*/
+struct BlockSizeStats
+{
+    int blockSize = 0;
+    double attackSeconds = 0, releaseSeconds = 0;
+    std::vector<double> windowRMS;
+};
+BlockSizeStats blockSizeStats();
+void writeBlockSizeStats(std::ostream &os, const BlockSizeStats &stats);
+bool readBlockSizeStats(std::istream &is, BlockSizeStats &stats);
 } // namespace Test
 } // namespace Surge
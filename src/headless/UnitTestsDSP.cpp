@@ -2,6 +2,8 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <random>
+#include <fstream>
 
 #include "HeadlessUtils.h"
 #include "Player.h"
@@ -19,6 +21,13 @@
 #include <complex>
 
 #include "LanczosResampler.h"
+#include "Oscillator.h"
+#include "OscillatorPreview.h"
+#include "BiquadCascade.h"
+#include "QuadFilterUnit.h"
+#include <vt_dsp/halfratefilter.h>
+#include "Oversampling.h"
+#include <thread>
 
 using namespace Surge::Test;
 
@@ -500,6 +509,27 @@ TEST_CASE("Check FastMath Functions", "[dsp]")
         }
     }
 
+    SECTION("fastatanSSE")
+    {
+        // dense near zero, where the folds switch, then out to where atan is nearly flat
+        for (float x = -1e4; x < 1e4; x += (fabs(x) < 10.f ? 0.0013f : 3.7f))
+        {
+            INFO("Testing fastatanSSE at " << x);
+            float r[4];
+            _mm_storeu_ps(r, Surge::DSP::fastatanSSE(_mm_set_ps1(x)));
+            auto rn = atan((double)x);
+            REQUIRE(r[0] == Approx(rn).epsilon(0).margin(2e-7));
+            REQUIRE(r[0] == Approx(rn).epsilon(3e-7));
+        }
+
+        float r[4];
+        _mm_storeu_ps(r, Surge::DSP::fastatanSSE(_mm_set_ps(INFINITY, -INFINITY, 0.f, 1.f)));
+        REQUIRE(r[0] == Approx(M_PI / 4).epsilon(3e-7));
+        REQUIRE(r[1] == 0.f);
+        REQUIRE(r[2] == Approx(-M_PI / 2).epsilon(3e-7));
+        REQUIRE(r[3] == Approx(M_PI / 2).epsilon(3e-7));
+    }
+
     SECTION("fastexp and fastexpSSE")
     {
         for (float x = -3.9; x < 2.9; x += 0.02)
@@ -571,6 +601,34 @@ TEST_CASE("Check FastMath Functions", "[dsp]")
         }
     }
 
+    SECTION("sinFullRangeSSE")
+    {
+        for (float x = -2000.3; x < 2000.3; x += 0.173)
+        {
+            INFO("Testing full range sine at " << x);
+            auto q = _mm_set_ps1(x);
+            auto r = Surge::DSP::sinFullRangeSSE(q);
+            union
+            {
+                __m128 v;
+                float a[4];
+            } U;
+            U.v = r;
+            REQUIRE(U.a[0] == Approx(sin((double)x)).margin(3e-7));
+        }
+    }
+
+    SECTION("expFullRangeSSE")
+    {
+        for (float x = -86.9; x < 86.9; x += 0.0173)
+        {
+            INFO("Testing full range exp at " << x);
+            float r alignas(16)[4];
+            _mm_store_ps(r, Surge::DSP::expFullRangeSSE(_mm_set_ps1(x)));
+            REQUIRE(r[0] == Approx(exp((double)x)).epsilon(1.2e-7));
+        }
+    }
+
     SECTION("Clamp to -PI,PI SSE")
     {
         for (float f = -800.7; f < 816.4; f += 0.245)
@@ -592,6 +650,221 @@ TEST_CASE("Check FastMath Functions", "[dsp]")
     }
 }
 
+TEST_CASE("Computed Waveshapers Match The Tables", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    SECTION("Shapes")
+    {
+        // the tables' interpolation error, at the step each uses
+        std::vector<std::pair<int, float>> tol = {{wst_asym, 5e-4}, {wst_sine, 2e-5}};
+        for (auto t : tol)
+        {
+            INFO("Waveshaper " << wst_names[t.first]);
+            auto table = GetQFPtrWaveshaper(t.first, true);
+            auto computed = GetQFPtrWaveshaper(t.first, false);
+            REQUIRE(table != computed);
+
+            // the sine table is 4 units wide and the asym one 32, and both clamp past that
+            float range = (t.first == wst_sine) ? 1.99f : 15.9f;
+            for (float x = -range; x < range; x += range * 0.0003f)
+            {
+                INFO("At " << x);
+                float a alignas(16)[4], b alignas(16)[4];
+                auto in = _mm_set_ps(x, 0.5f * x, -x, 0.f);
+                auto drive = _mm_set_ps(1.f, 2.f, 1.f, 1.f);
+                _mm_store_ps(a, table(in, drive));
+                _mm_store_ps(b, computed(in, drive));
+                for (int i = 0; i < 4; ++i)
+                    REQUIRE(b[i] == Approx(a[i]).margin(t.second * std::max(1.f, fabs(a[i]))));
+            }
+        }
+
+        for (auto t : {wst_soft, wst_hard, wst_digital})
+            REQUIRE(GetQFPtrWaveshaper(t, true) == GetQFPtrWaveshaper(t, false));
+    }
+
+    SECTION("Older Patches Keep The Tables")
+    {
+        REQUIRE(!surge->storage.getPatch().tableLookupWaveshapers);
+        REQUIRE(surge->loadPatchByPath("test-data/patches/Church.fxp", -1, "Test"));
+        REQUIRE(surge->storage.getPatch().tableLookupWaveshapers);
+    }
+}
+
+TEST_CASE("Fused Halfband Decimation Matches The Separate Passes", "[dsp]")
+{
+    // clip, decimate and clip each scene as the engine used to, against the fused pass, over
+    // blocks which change the clip levels, skip the clip after and run the scenes alone
+    std::mt19937 gen(61);
+    std::uniform_real_distribution<float> dist(-12.f, 12.f);
+    HalfRateFilter sepA(6, true), sepB(6, true), fusA(6, true), fusB(6, true);
+    const float clips[3] = {8.f, 1.f, 0.f};
+
+    auto clip = [](float *x, float c) {
+        if (c == 8.f)
+            hardclip_block8(x, BLOCK_SIZE_OS_QUAD);
+        else if (c == 1.f)
+            hardclip_block(x, BLOCK_SIZE_OS_QUAD);
+    };
+
+    for (int blk = 0; blk < 500; ++blk)
+    {
+        float sep alignas(16)[4][BLOCK_SIZE_OS], fus alignas(16)[4][BLOCK_SIZE_OS];
+        float scale = (blk % 3 == 0) ? 0.01f : 1.f;
+        for (int c = 0; c < 4; ++c)
+            for (int k = 0; k < BLOCK_SIZE_OS; ++k)
+                sep[c][k] = fus[c][k] = scale * dist(gen);
+
+        float cA = clips[blk % 3], cB = clips[(blk / 3) % 3];
+        bool clipAfterA = blk % 5 != 0;
+        bool together = blk % 7 != 0;
+
+        clip(sep[0], cA);
+        clip(sep[1], cA);
+        clip(sep[2], cB);
+        clip(sep[3], cB);
+        sepA.process_block_D2(sep[0], sep[1], BLOCK_SIZE_OS);
+        sepB.process_block_D2(sep[2], sep[3], BLOCK_SIZE_OS);
+        if (clipAfterA)
+        {
+            clip(sep[0], cA);
+            clip(sep[1], cA);
+        }
+        clip(sep[2], cB);
+        clip(sep[3], cB);
+
+        HalfRateFilter *f[2] = {&fusA, &fusB};
+        HalfRateFilter::D2Block b[2];
+        b[0].L = fus[0];
+        b[0].R = fus[1];
+        b[0].clipIn = cA;
+        b[0].clipOut = clipAfterA ? cA : 0.f;
+        b[1].L = fus[2];
+        b[1].R = fus[3];
+        b[1].clipIn = b[1].clipOut = cB;
+        if (together)
+        {
+            HalfRateFilter::process_block_D2_fused(f, b, 2, BLOCK_SIZE_OS);
+        }
+        else
+        {
+            HalfRateFilter::process_block_D2_fused(&f[0], &b[0], 1, BLOCK_SIZE_OS);
+            HalfRateFilter::process_block_D2_fused(&f[1], &b[1], 1, BLOCK_SIZE_OS);
+        }
+
+        for (int c = 0; c < 4; ++c)
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                INFO("Block " << blk << " channel " << c << " sample " << k);
+                REQUIRE(fus[c][k] == sep[c][k]);
+            }
+    }
+}
+
+TEST_CASE("Halfband Filters Take Blocks Longer Than Their Scratch", "[dsp]")
+{
+    // Each stage sees the same stream whatever the block size, so 128 sample blocks at 8x,
+    // whose top stages run 1024 samples, match 16 sample blocks bit for bit
+    std::mt19937 gen(67);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+
+    SECTION("Oversampling At Every Factor")
+    {
+        auto osLong = std::make_unique<Oversampling<3, 128>>();
+        auto osShort = std::make_unique<Oversampling<3, 16>>();
+
+        for (int factor = 0; factor <= 3; ++factor)
+        {
+            osLong->setOSFactor(factor);
+            osShort->setOSFactor(factor);
+            osLong->reset();
+            osShort->reset();
+
+            for (int blk = 0; blk < 20; ++blk)
+            {
+                float L alignas(16)[128], R alignas(16)[128];
+                float sL alignas(16)[128], sR alignas(16)[128];
+                for (int k = 0; k < 128; ++k)
+                {
+                    L[k] = sL[k] = dist(gen);
+                    R[k] = sR[k] = dist(gen);
+                }
+
+                // a nonlinearity between, so the up and down passes can't cancel
+                auto shape = [](float *x, int n) {
+                    for (int k = 0; k < n; ++k)
+                        x[k] = x[k] - x[k] * x[k] * x[k] / 3.f;
+                };
+
+                osLong->upsample(L, R, 0.5f);
+                shape(osLong->leftUp, osLong->getUpBlockSize());
+                shape(osLong->rightUp, osLong->getUpBlockSize());
+                osLong->downsample(L, R);
+
+                for (int s = 0; s < 128; s += 16)
+                {
+                    osShort->upsample(sL + s, sR + s, 0.5f);
+                    shape(osShort->leftUp, osShort->getUpBlockSize());
+                    shape(osShort->rightUp, osShort->getUpBlockSize());
+                    osShort->downsample(sL + s, sR + s);
+                }
+
+                for (int k = 0; k < 128; ++k)
+                {
+                    INFO("Factor " << factor << " block " << blk << " sample " << k);
+                    REQUIRE(std::isfinite(L[k]));
+                    REQUIRE(L[k] == sL[k]);
+                    REQUIRE(R[k] == sR[k]);
+                }
+            }
+        }
+    }
+
+    SECTION("Fused Decimation")
+    {
+        const int n = 4 * hr_BLOCK_SIZE;
+        HalfRateFilter longA(6, true), longB(6, false), shortA(6, true), shortB(6, false);
+
+        for (int blk = 0; blk < 10; ++blk)
+        {
+            float lb alignas(16)[4][n], sb alignas(16)[4][n];
+            for (int c = 0; c < 4; ++c)
+                for (int k = 0; k < n; ++k)
+                    lb[c][k] = sb[c][k] = 4.f * dist(gen);
+
+            HalfRateFilter *f[2] = {&longA, &longB};
+            HalfRateFilter::D2Block b[2];
+            b[0].L = lb[0];
+            b[0].R = lb[1];
+            b[1].L = lb[2];
+            b[1].R = lb[3];
+            b[0].clipIn = b[0].clipOut = b[1].clipIn = 1.f;
+            HalfRateFilter::process_block_D2_fused(f, b, 2, n);
+
+            for (int s = 0; s < n; s += 64)
+            {
+                hardclip_block(sb[0] + s, 16);
+                hardclip_block(sb[1] + s, 16);
+                hardclip_block(sb[2] + s, 16);
+                hardclip_block(sb[3] + s, 16);
+                shortA.process_block_D2(sb[0] + s, sb[1] + s, 64, sb[0] + s / 2, sb[1] + s / 2);
+                shortB.process_block_D2(sb[2] + s, sb[3] + s, 64, sb[2] + s / 2, sb[3] + s / 2);
+            }
+            hardclip_block(sb[0], n / 8);
+            hardclip_block(sb[1], n / 8);
+
+            for (int c = 0; c < 4; ++c)
+                for (int k = 0; k < n / 2; ++k)
+                {
+                    INFO("Block " << blk << " channel " << c << " sample " << k);
+                    REQUIRE(lb[c][k] == sb[c][k]);
+                }
+        }
+    }
+}
+
 TEST_CASE("Sinc Delay Line", "[dsp]")
 {
     // This requires SurgeStorate to initialize its tables. Easiest way
@@ -664,6 +937,55 @@ TEST_CASE("Sinc Delay Line", "[dsp]")
         }
     }
 
+    SECTION("Read Taps")
+    {
+        using DL = SSESincDelayLine<4096>;
+        float val = 0;
+        float dRamp = 0.01;
+        DL up, down;
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            up.write(val);
+            down.write(-val);
+            val += dRamp;
+        }
+
+        DL *lines[4] = {&up, &down, &up, &down};
+        for (int i = 0; i < 5000; ++i)
+        {
+            INFO("Iteration " << i);
+            float taps alignas(16)[4] = {174.3f + i * 0.013f, 1732.4f, 3987.2f - i * 0.1f, 256.0f};
+            float lin alignas(16)[4], lag alignas(16)[4], sinc alignas(16)[4],
+                two alignas(16)[4];
+            _mm_store_ps(lin, DL::readTaps<DL::LINEAR>(lines, taps));
+            _mm_store_ps(lag, DL::readTaps<DL::LAGRANGE>(lines, taps));
+            _mm_store_ps(sinc, DL::readTaps<DL::SINC>(lines, taps));
+            _mm_store_ps(two, up.readTaps<DL::SINC, 2>(taps));
+
+            auto cval = val - dRamp;
+            for (int t = 0; t < 4; ++t)
+            {
+                auto *l = lines[t];
+                float sign = (t & 1) ? -1 : 1;
+
+                // the same arithmetic as the single reads, but for the summation order
+                REQUIRE(lin[t] == l->readLinear(taps[t]));
+                REQUIRE(sinc[t] == Approx(l->read(taps[t])).margin(1e-5));
+                // a cubic through a ramp is the ramp
+                REQUIRE(lag[t] == Approx(sign * (cval - (taps[t] - 1) * dRamp)).margin(1e-3));
+            }
+            REQUIRE(two[0] == Approx(up.read(taps[0])).margin(1e-5));
+            REQUIRE(two[1] == Approx(up.read(taps[1])).margin(1e-5));
+            REQUIRE(two[2] == 0);
+            REQUIRE(two[3] == 0);
+
+            up.write(val);
+            down.write(-val);
+            val += dRamp;
+        }
+    }
+
 #if 0
 // This prints output I used for debugging
     SECTION( "Generate Output" )
@@ -808,6 +1130,588 @@ TEST_CASE("Every Oscillator Plays", "[dsp]")
     }
 }
 
+TEST_CASE("Each Scene Plays On Its Own", "[dsp]")
+{
+    for (int sc = 0; sc < n_scenes; ++sc)
+    {
+        DYNAMIC_SECTION("Scene " << sc)
+        {
+            auto surge = Surge::Headless::createSurge(44100);
+            surge->storage.getPatch().scenemode.val.i = sm_single;
+            surge->storage.getPatch().scene_active.val.i = sc;
+
+            for (int q = 0; q < 10; ++q)
+                surge->process();
+
+            float sumAbsOut = 0, sumAbsOther = 0;
+            surge->playNote(0, 60, 127, 0);
+            for (int q = 0; q < 50; ++q)
+            {
+                surge->process();
+                for (int s = 0; s < n_scenes; ++s)
+                {
+                    INFO("Block " << q << " scene " << s);
+                    REQUIRE(surge->voices[s].empty() == (s != sc));
+                    if (s != sc)
+                        for (int k = 0; k < BLOCK_SIZE; ++k)
+                            sumAbsOther += fabs(surge->sceneout[s][0][k]);
+                }
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                    sumAbsOut += fabs(surge->output[0][k]);
+            }
+            REQUIRE(sumAbsOut > 1);
+            REQUIRE(sumAbsOther < 1e-4);
+        }
+    }
+}
+
+TEST_CASE("FM Operator Sine Precision", "[dsp]")
+{
+    auto render = [](int ot, SurgeStorage::FMSinePrecision p, float feedback) {
+        auto surge = Surge::Headless::createSurge(44100);
+        surge->storage.fmSinePrecision = p;
+
+        auto &osc = surge->storage.getPatch().scene[0].osc[0];
+        osc.queue_type = ot;
+        for (int q = 0; q < 10; ++q)
+            surge->process();
+
+        osc.retrigger.val.b = true;
+        osc.p[0].set_value_f01(0.6);
+        osc.p[2].set_value_f01(0.4);
+        osc.p[6].set_value_f01(feedback);
+
+        std::vector<float> res;
+        surge->playNote(0, 60, 127, 0);
+        for (int q = 0; q < 50; ++q)
+        {
+            surge->process();
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+                res.push_back(surge->output[0][s]);
+        }
+        return res;
+    };
+
+    for (auto ot : {ot_FM2, ot_FM3})
+    {
+        for (auto fb : {0.5f, 0.7f})
+        {
+            DYNAMIC_SECTION("Oscillator " << osc_type_names[ot] << " feedback " << fb)
+            {
+                auto ref = render(ot, SurgeStorage::FM_SINE_LIBM, fb);
+                auto acc = render(ot, SurgeStorage::FM_SINE_ACCURATE, fb);
+                auto fast = render(ot, SurgeStorage::FM_SINE_FAST, fb);
+
+                REQUIRE(ref.size() == acc.size());
+                float sumAbs = 0;
+                for (int i = 0; i < ref.size(); ++i)
+                {
+                    INFO("Sample " << i);
+                    REQUIRE(acc[i] == Approx(ref[i]).margin(1e-4));
+                    REQUIRE(fast[i] == Approx(ref[i]).margin(5e-3));
+                    sumAbs += fabs(ref[i]);
+                }
+                REQUIRE(sumAbs > 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("Older Patches Keep The libm FM Sine", "[dsp]")
+{
+    auto render = [](std::shared_ptr<SurgeSynthesizer> surge) {
+        auto &osc = surge->storage.getPatch().scene[0].osc[0];
+        osc.queue_type = ot_FM2;
+        for (int q = 0; q < 10; ++q)
+            surge->process();
+
+        osc.retrigger.val.b = true;
+        osc.p[0].set_value_f01(0.6);
+        osc.p[6].set_value_f01(0.7);
+
+        std::vector<float> res;
+        surge->playNote(0, 60, 127, 0);
+        for (int q = 0; q < 50; ++q)
+        {
+            surge->process();
+            for (int s = 0; s < BLOCK_SIZE; ++s)
+                res.push_back(surge->output[0][s]);
+        }
+        return res;
+    };
+
+    SECTION("Streaming")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(!surge->storage.getPatch().libmFMSine);
+        REQUIRE(surge->loadPatchByPath("resources/data/patches_factory/Templates/Init FM2.fxp", -1,
+                                       "Templates"));
+        REQUIRE(surge->storage.getPatch().streamingRevision <= 17);
+        REQUIRE(surge->storage.getPatch().libmFMSine);
+
+        for (auto v : {false, true})
+        {
+            auto dest = Surge::Headless::createSurge(44100);
+            dest->storage.getPatch().libmFMSine = !v;
+            surge->storage.getPatch().libmFMSine = v;
+
+            void *d = nullptr;
+            auto sz = surge->saveRaw(&d);
+            dest->loadRaw(d, sz, false);
+            REQUIRE(dest->storage.getPatch().libmFMSine == v);
+        }
+    }
+
+    SECTION("The Patch Flag Selects The libm Path")
+    {
+        auto ref = Surge::Headless::createSurge(44100);
+        ref->storage.fmSinePrecision = SurgeStorage::FM_SINE_LIBM;
+
+        auto legacy = Surge::Headless::createSurge(44100);
+        legacy->storage.fmSinePrecision = SurgeStorage::FM_SINE_ACCURATE;
+        legacy->storage.getPatch().libmFMSine = true;
+
+        auto a = render(ref), b = render(legacy);
+        REQUIRE(a.size() == b.size());
+        for (int i = 0; i < a.size(); ++i)
+        {
+            INFO("Sample " << i);
+            REQUIRE(a[i] == b[i]);
+        }
+    }
+}
+
+TEST_CASE("Batched Oscillators Match Single Voice Rendering", "[dsp]")
+{
+    for (auto ot : {ot_sine, ot_wavetable})
+    {
+        for (auto stereo : {false, true})
+        {
+            DYNAMIC_SECTION("Oscillator " << osc_type_names[ot] << " stereo " << stereo)
+            {
+                auto surge = Surge::Headless::createSurge(44100);
+                auto &oscdata = surge->storage.getPatch().scene[0].osc[0];
+                oscdata.queue_type = ot;
+                for (int q = 0; q < 10; ++q)
+                    surge->process();
+
+                oscdata.retrigger.val.b = true;
+                oscdata.p[0].set_value_f01(0.3);
+
+                pdata localcopy[n_scene_params];
+                surge->storage.getPatch().copy_scenedata(localcopy, 0);
+
+                // six voices so the batch covers a full and a partial set of lanes
+                constexpr int nv = 6;
+                std::vector<std::unique_ptr<Oscillator>> single, batched;
+                Oscillator *bp[nv];
+                float pitch[nv], drift[nv], fmdepth[nv];
+                for (int i = 0; i < nv; ++i)
+                {
+                    pitch[i] = 48 + 5 * i;
+                    drift[i] = 0.f;
+                    fmdepth[i] = 0.f;
+                    for (auto *v : {&single, &batched})
+                    {
+                        v->emplace_back(spawn_osc(ot, &surge->storage, &oscdata, localcopy));
+                        v->back()->init(pitch[i]);
+                    }
+                    bp[i] = batched[i].get();
+                }
+
+                float sumAbs = 0;
+                for (int b = 0; b < 20; ++b)
+                {
+                    for (int i = 0; i < nv; ++i)
+                        single[i]->process_block(pitch[i], drift[i], stereo, false, fmdepth[i]);
+                    bp[0]->process_block_batch(bp, nv, pitch, drift, stereo, false, fmdepth);
+
+                    for (int i = 0; i < nv; ++i)
+                    {
+                        for (int k = 0; k < BLOCK_SIZE_OS; ++k)
+                        {
+                            INFO("Voice " << i << " block " << b << " sample " << k);
+                            REQUIRE(batched[i]->output[k] == single[i]->output[k]);
+                            if (stereo)
+                                REQUIRE(batched[i]->outputR[k] == single[i]->outputR[k]);
+                            sumAbs += fabs(single[i]->output[k]);
+                        }
+                    }
+                }
+                REQUIRE(sumAbs > 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("Oscillator Preview Renders and Caches", "[dsp]")
+{
+    const int totalSamples = 16 * 140, averagingWindow = 4;
+    const float pitch = 42.15;
+
+    auto previewParams = [](OscillatorStorage &oscdata, pdata *tp) {
+        tp[oscdata.pitch.param_id_in_scene].f = 0;
+        for (int i = 0; i < n_osc_params; i++)
+            tp[oscdata.p[i].param_id_in_scene].i = oscdata.p[i].val.i;
+    };
+
+    for (auto ot : {ot_classic, ot_sine, ot_wavetable, ot_FM3, ot_twist})
+    {
+        DYNAMIC_SECTION("Oscillator " << osc_type_names[ot])
+        {
+            auto surge = Surge::Headless::createSurge(44100);
+            auto &oscdata = surge->storage.getPatch().scene[0].osc[0];
+            oscdata.queue_type = ot;
+            for (int q = 0; q < 10; ++q)
+                surge->process();
+
+            pdata tp[n_scene_params];
+            previewParams(oscdata, tp);
+
+            auto direct = Surge::Oscillator::renderPreview(&surge->storage, &oscdata, ot, tp, pitch,
+                                                           totalSamples, averagingWindow);
+            REQUIRE(direct.size() == totalSamples / averagingWindow);
+            float sumAbs = 0;
+            for (auto v : direct)
+                sumAbs += fabs(v);
+            REQUIRE(sumAbs > 1);
+
+            auto key = Surge::Oscillator::previewKey(&surge->storage, &oscdata, ot, tp, pitch,
+                                                     totalSamples, averagingWindow);
+            Surge::Oscillator::PreviewCache cache(&surge->storage);
+            REQUIRE(!cache.find(key));
+            cache.request(key, &oscdata, ot, tp, pitch, totalSamples, averagingWindow);
+
+            Surge::Oscillator::PreviewCache::trace_t cached;
+            for (int w = 0; w < 500 && !cached; ++w)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                cached = cache.find(key);
+            }
+            REQUIRE(cached);
+            REQUIRE(cache.consumeNewResults());
+            REQUIRE(!cache.consumeNewResults());
+            REQUIRE(cached->size() == direct.size());
+            if (ot != ot_twist)
+            {
+                for (int i = 0; i < direct.size(); ++i)
+                    REQUIRE((*cached)[i] == direct[i]);
+            }
+
+            // any parameter change is a different preview
+            oscdata.p[0].set_value_f01(oscdata.p[0].get_value_f01() * 0.5 + 0.1);
+            previewParams(oscdata, tp);
+            REQUIRE(Surge::Oscillator::previewKey(&surge->storage, &oscdata, ot, tp, pitch,
+                                                  totalSamples, averagingWindow) != key);
+
+            // and so is every published wavetable, even when its data lands at the same address
+            if (ot == ot_wavetable)
+            {
+                auto before = Surge::Oscillator::previewKey(&surge->storage, &oscdata, ot, tp,
+                                                            pitch, totalSamples, averagingWindow);
+                auto generation = oscdata.wt.generation;
+                surge->storage.load_wt_wav_portable("test-data/wav/05_BELL.WAV", &oscdata.wt);
+                REQUIRE(oscdata.wt.generation != generation);
+                REQUIRE(Surge::Oscillator::previewKey(&surge->storage, &oscdata, ot, tp, pitch,
+                                                      totalSamples, averagingWindow) != before);
+            }
+        }
+    }
+}
+
+TEST_CASE("Engine Times Do Not Depend On The Block Size", "[dsp]")
+{
+    // the block size is a build option (SURGE_COMPILE_BLOCK_SIZE), and envelope and voice
+    // times are set in seconds, so the same patch should play the same at every block size
+    auto surge = surgeOnSine();
+    REQUIRE(surge);
+    INFO("BLOCK_SIZE is " << BLOCK_SIZE);
+
+    auto &aeg = surge->storage.getPatch().scene[0].adsr[0];
+    aeg.a.val.f = log2(0.2f);
+    aeg.d.val.f = log2(0.2f);
+    aeg.s.val.f = 1.f;
+    aeg.r.val.f = log2(0.1f);
+    aeg.mode.val.b = false;
+
+    auto blockPeak = [&]() {
+        surge->process();
+        float m = 0;
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+            m = std::max(m, std::fabs(surge->output[0][k]));
+        return m;
+    };
+
+    double secondsPerBlock = BLOCK_SIZE * dsamplerate_inv;
+    int oneSecond = (int)(1.0 / secondsPerBlock);
+    std::vector<float> peaks;
+
+    surge->playNote(0, 60, 127, 0);
+    for (int i = 0; i < oneSecond; ++i)
+        peaks.push_back(blockPeak());
+
+    float sustain = peaks.back();
+    REQUIRE(sustain > 0.05f);
+
+    int attackBlocks = 0;
+    while (attackBlocks < (int)peaks.size() && peaks[attackBlocks] < 0.9f * sustain)
+        attackBlocks++;
+    REQUIRE(attackBlocks * secondsPerBlock > 0.05);
+    REQUIRE(attackBlocks * secondsPerBlock < 0.3);
+
+    surge->releaseNote(0, 60, 0);
+    int releaseBlocks = 0;
+    while (releaseBlocks < oneSecond && !surge->voices[0].empty())
+    {
+        blockPeak();
+        releaseBlocks++;
+    }
+    REQUIRE(surge->voices[0].empty());
+    REQUIRE(releaseBlocks * secondsPerBlock > 0.05);
+    REQUIRE(releaseBlocks * secondsPerBlock < 0.5);
+}
+
+TEST_CASE("A Patch Renders Alike At Two Block Sizes", "[dsp]")
+{
+    /*
+     * The block size is fixed when building, so the other size's render comes from a second
+     * build; see the hidden test below. Here just check this build's render is sane and
+     * repeatable.
+     */
+    auto here = Surge::Test::blockSizeStats();
+    INFO("BLOCK_SIZE is " << BLOCK_SIZE);
+    REQUIRE(here.windowRMS.size() == 25);
+    REQUIRE(here.attackSeconds > 0.05);
+    REQUIRE(here.attackSeconds < 0.3);
+    REQUIRE(here.releaseSeconds > 0.01);
+    REQUIRE(here.releaseSeconds < 0.4);
+
+    // the oscillator may start at another phase, which moves the peaks a little
+    auto again = Surge::Test::blockSizeStats();
+    REQUIRE(again.attackSeconds == Approx(here.attackSeconds).margin(0.002));
+    REQUIRE(again.releaseSeconds == Approx(here.releaseSeconds).margin(0.002));
+    for (int w = 0; w < here.windowRMS.size(); ++w)
+        REQUIRE(again.windowRMS[w] == Approx(here.windowRMS[w]).epsilon(0.01).margin(1e-4));
+}
+
+TEST_CASE("A Patch Renders Alike Against Another Block Size Build", "[dsp][.]")
+{
+    /*
+     * Hidden, since it needs the render of a second build at another block size, made with
+     * --non-test --block-size-stats and named by SURGE_BLOCK_SIZE_STATS. CI checks 16 against
+     * 128 by running it by name. The envelopes and filter coefficients step once a block, so the
+     * timing may move by about a block. That shows in the loudness of the windows where it
+     * rises or falls fast, but elsewhere the loudness mustn't move audibly.
+     */
+    auto path = getenv("SURGE_BLOCK_SIZE_STATS");
+    INFO("SURGE_BLOCK_SIZE_STATS names the other build's render");
+    REQUIRE(path);
+
+    auto here = Surge::Test::blockSizeStats();
+    Surge::Test::BlockSizeStats there;
+    std::ifstream is(path);
+    REQUIRE(Surge::Test::readBlockSizeStats(is, there));
+    INFO("BLOCK_SIZE is " << BLOCK_SIZE << ", the other build's is " << there.blockSize);
+    REQUIRE(there.blockSize != BLOCK_SIZE);
+    REQUIRE(there.windowRMS.size() == here.windowRMS.size());
+
+    double blockSeconds = std::max(BLOCK_SIZE, there.blockSize) * dsamplerate_inv;
+    REQUIRE(fabs(here.attackSeconds - there.attackSeconds) <= 1.5 * blockSeconds);
+    REQUIRE(fabs(here.releaseSeconds - there.releaseSeconds) <= 1.5 * blockSeconds);
+
+    for (int w = 0; w < here.windowRMS.size(); ++w)
+    {
+        INFO("Window " << w << " RMS " << here.windowRMS[w] << " against " << there.windowRMS[w]);
+        if (here.windowRMS[w] < 1e-3 && there.windowRMS[w] < 1e-3)
+            continue;
+
+        auto db = [&](int a, int b) {
+            return fabs(20 * log10(here.windowRMS[a] / here.windowRMS[b]));
+        };
+        bool steady = w > 0 && w + 1 < here.windowRMS.size() && db(w, w - 1) < 1 &&
+                      db(w, w + 1) < 1;
+        auto diff = fabs(20 * log10(here.windowRMS[w] / there.windowRMS[w]));
+        REQUIRE(diff < (steady ? 0.25 : 1.5));
+    }
+}
+
+TEST_CASE("Quadrature Oscillator Blocks Match Stepping", "[dsp]")
+{
+    for (auto w : {0.001f, 0.1f, 1.3f, 3.1f})
+    {
+        DYNAMIC_SECTION("Rate " << w)
+        {
+            quadr_osc stepped, blocked;
+            stepped.set_phase(0.7f);
+            blocked.set_phase(0.7f);
+
+            // the rounding differs, so the two drift apart a little over the blocks
+            float r alignas(16)[BLOCK_SIZE_OS];
+            for (int b = 0; b < 20; ++b)
+            {
+                // set_rate renormalises each block, as the FM oscillators call it
+                stepped.set_rate(w);
+                blocked.set_rate(w);
+                blocked.process_block(r, BLOCK_SIZE_OS);
+                for (int k = 0; k < BLOCK_SIZE_OS; ++k)
+                {
+                    stepped.process();
+                    INFO("Block " << b << " sample " << k);
+                    REQUIRE(r[k] == Approx(stepped.r).margin(1e-4));
+                }
+                REQUIRE(blocked.r == Approx(stepped.r).margin(1e-4));
+                REQUIRE(blocked.i == Approx(stepped.i).margin(1e-4));
+            }
+        }
+    }
+}
+
+TEST_CASE("Biquad SIMD Paths Match Scalar", "[dsp]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    auto *storage = &surge->storage;
+
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+    float sL alignas(16)[BLOCK_SIZE], sR alignas(16)[BLOCK_SIZE];
+    auto fill = [&]() {
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            L[k] = sL[k] = storage->rand_pm1();
+            R[k] = sR[k] = storage->rand_pm1();
+        }
+    };
+    auto same = [&]() {
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            INFO("Sample " << k);
+            REQUIRE(L[k] == sL[k]);
+            REQUIRE(R[k] == sR[k]);
+        }
+    };
+
+    SECTION("Stereo Block")
+    {
+        BiquadFilter simd(storage), scalar(storage);
+        for (int b = 0; b < 100; ++b)
+        {
+            // change the coefficients part way so the lag runs too
+            double om = simd.calc_omega_from_Hz(b < 50 ? 1000 : 300);
+            simd.coeff_peakEQ(om, 0.5, b < 50 ? 6 : -9);
+            scalar.coeff_peakEQ(om, 0.5, b < 50 ? 6 : -9);
+
+            fill();
+            simd.process_block(L, R);
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+                scalar.process_sample(sL[k], sR[k], sL[k], sR[k]);
+            same();
+        }
+    }
+
+    SECTION("Cascade Matches Chained Filters")
+    {
+        const int n = 5;
+        BiquadCascade<n> cascade;
+        BiquadFilter designer(storage);
+        std::vector<BiquadFilter> chain(n, BiquadFilter(storage));
+
+        for (int b = 0; b < 100; ++b)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                double om = designer.calc_omega_from_Hz(100.0 * (i + 1) * (b < 50 ? 1 : 2));
+                designer.coeff_peakEQ(om, 0.5, 3.0 * i - 6);
+                chain[i].coeff_peakEQ(om, 0.5, 3.0 * i - 6);
+                cascade.set_coef(i, designer);
+            }
+
+            fill();
+            cascade.process_block(L, R);
+            for (auto &c : chain)
+                c.process_block(sL, sR);
+            same();
+        }
+    }
+
+    SECTION("Cascade With Different Channels")
+    {
+        // as the phaser uses it, with each stage's L and R allpass at their own frequency
+        const int n = 4;
+        BiquadCascade<n> cascade;
+        BiquadFilter designer(storage);
+        std::vector<BiquadFilter> left(n, BiquadFilter(storage)), right(n, BiquadFilter(storage));
+
+        for (int b = 0; b < 100; ++b)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                double omL = designer.calc_omega_from_Hz(200.0 * (i + 1) + b);
+                double omR = designer.calc_omega_from_Hz(250.0 * (i + 1) - b);
+                left[i].coeff_APF(omL, 1.3);
+                right[i].coeff_APF(omR, 1.3);
+                designer.coeff_APF(omL, 1.3);
+                cascade.set_coef(i, 0, designer);
+                designer.coeff_APF(omR, 1.3);
+                cascade.set_coef(i, 1, designer);
+            }
+
+            fill();
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                cascade.process_sample(L[k], R[k], n - 1);
+                for (int i = 0; i < n - 1; ++i)
+                {
+                    sL[k] = left[i].process_sample(sL[k]);
+                    sR[k] = right[i].process_sample(sR[k]);
+                }
+            }
+            same();
+        }
+    }
+
+    SECTION("Disabled Sections Pass Through")
+    {
+        BiquadCascade<3> cascade;
+        BiquadFilter designer(storage);
+        designer.coeff_peakEQ(designer.calc_omega_from_Hz(1000), 0.5, 12);
+        for (int i = 0; i < 3; ++i)
+        {
+            cascade.set_coef(i, designer);
+            cascade.set_enabled(i, false);
+        }
+
+        for (int b = 0; b < 10; ++b)
+        {
+            fill();
+            cascade.process_block(L, R);
+            same();
+        }
+    }
+
+    SECTION("Scene Lowcut Matches Recomputing Every Block")
+    {
+        SceneLowcutFilter lowcut(storage);
+        BiquadFilter scalar(storage);
+
+        for (int b = 0; b < 200; ++b)
+        {
+            // hold, then sweep, then hold again, with a reset in the middle
+            float freq = b < 50 ? -36.f : (b < 100 ? -36.f + 0.3f * (b - 50) : -12.f);
+            if (b == 150)
+            {
+                lowcut.suspend();
+                scalar.suspend();
+            }
+
+            scalar.coeff_HP(scalar.calc_omega(freq / 12.0), 0.4);
+
+            fill();
+            lowcut.process_block(L, R, freq);
+            scalar.process_block(sL, sR);
+            same();
+        }
+    }
+}
+
 TEST_CASE("Untuned is 2^x", "[dsp]")
 {
     auto surge = Surge::Headless::createSurge(44100);
@@ -929,6 +1833,39 @@ TEST_CASE("LanczosResampler", "[dsp]")
 }
 #endif
 
+TEST_CASE("LanczosResampler Reads On Input Samples", "[dsp]")
+{
+    // At these ratios some outputs land exactly on an input sample, the end of the kernel table
+    for (auto rates : {std::make_pair(96000, 32000), std::make_pair(48000, 32000),
+                       std::make_pair(32000, 96000)})
+    {
+        INFO("From " << rates.first << " to " << rates.second);
+        auto lr = std::make_unique<LanczosResampler>(rates.first, rates.second);
+
+        double dp = 100.0 / rates.first;
+        for (int i = 0; i < 2000; ++i)
+        {
+            float v = std::sin(i * dp * 2.0 * M_PI);
+            lr->push(v, v);
+        }
+
+        float L[1000], R[1000];
+        auto gen = lr->populateNext(L, R, 1000);
+        REQUIRE(gen > 100);
+
+        double dq = 100.0 / rates.second;
+        for (int i = 20; i < gen; ++i)
+        {
+            // the resampler's outputs trail its inputs by a sample
+            INFO("Output " << i);
+            REQUIRE(L[i] == Approx(std::sin((i - rates.second * 1.0 / rates.first) * dq *
+                                            2.0 * M_PI))
+                                .margin(5e-3));
+            REQUIRE(R[i] == L[i]);
+        }
+    }
+}
+
 // When we return to #1514 this is a good starting point
 #if 0
 TEST_CASE( "NaN Patch from Issue 1514", "[dsp]" )
@@ -10,6 +10,8 @@
 
 #include "UnitTestUtilities.h"
 #include "FastMath.h"
+#include "FilterCoefficientMaker.h"
+#include "QuadFilterUnit.h"
 
 using namespace Surge::Test;
 
@@ -80,3 +82,276 @@ TEST_CASE("Run Every Waveshaper", "[flt]")
         }
     }
 }
+
+TEST_CASE("Voices Keep Their Filter Lanes", "[flt]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    // a comb, so moving a voice to another lane has to carry its delay line and write position
+    // as well as its registers
+    surge->storage.getPatch().scene[0].filterunit[0].type.val.i = fut_comb_pos;
+    surge->storage.getPatch().scene[0].filterunit[0].subtype.val.i = 0;
+
+    auto checkLanes = [&]() {
+        INFO("Voices " << surge->voices[0].size() << " lanes " << surge->FBQlanes[0]);
+        REQUIRE(surge->FBQlanes[0] == surge->voices[0].size());
+        for (auto v : surge->voices[0])
+        {
+            REQUIRE(v->hasLane());
+            REQUIRE(std::count(surge->FBQvoice[0], surge->FBQvoice[0] + surge->FBQlanes[0], v) ==
+                    1);
+        }
+    };
+
+    auto run = [&](int blocks) {
+        for (int i = 0; i < blocks; ++i)
+        {
+            surge->process();
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                REQUIRE(std::isfinite(surge->output[0][k]));
+                REQUIRE(std::isfinite(surge->output[1][k]));
+            }
+            checkLanes();
+        }
+    };
+
+    for (int n = 0; n < 7; ++n)
+    {
+        surge->playNote(0, 60 + n, 100, 0);
+        run(5);
+    }
+    REQUIRE(surge->voices[0].size() == 7);
+
+    // end voices from the front, middle and back of the bank, so the last lane moves in
+    for (auto n : {60, 63, 66})
+        surge->releaseNote(0, n, 0);
+    for (int i = 0; i < 2000 && surge->voices[0].size() > 4; ++i)
+        run(1);
+    REQUIRE(surge->voices[0].size() == 4);
+
+    surge->playNote(0, 72, 100, 0);
+    run(20);
+    REQUIRE(surge->voices[0].size() == 5);
+
+    for (auto n : {61, 62, 64, 65, 72})
+        surge->releaseNote(0, n, 0);
+    for (int i = 0; i < 2000 && !surge->voices[0].empty(); ++i)
+        run(1);
+    REQUIRE(surge->voices[0].empty());
+    REQUIRE(surge->FBQlanes[0] == 0);
+}
+
+TEST_CASE("Moving Lanes Leaves The Filtered Audio Alone", "[flt]")
+{
+    /*
+     * Five identical voices on five channels, so lanes 0 to 4 over two quads. Ending the voice
+     * in lane 0 moves the one in lane 4 across into it; ending the one in lane 4 moves nothing.
+     * Either way four identical voices survive, so the audio has to be the same sample for
+     * sample, before, during and after the move.
+     */
+    auto render = [](int releaseChannel, int &laneZeroChannel) {
+        auto surge = Surge::Headless::createSurge(44100);
+        auto &sc = surge->storage.getPatch().scene[0];
+        sc.osc[0].queue_type = ot_sine;
+        sc.osc[0].retrigger.val.b = true;
+        // a comb, whose delay line and write position have to move with the voice, into a
+        // resonant low pass
+        sc.filterunit[0].type.val.i = fut_comb_pos;
+        sc.filterunit[0].subtype.val.i = 0;
+        sc.filterunit[1].type.val.i = fut_lp24;
+        sc.filterunit[1].subtype.val.i = 0;
+        sc.filterunit[1].cutoff.set_value_f01(0.6);
+        sc.filterunit[1].resonance.set_value_f01(0.7);
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        for (int ch = 0; ch < 5; ++ch)
+            surge->playNote(ch, 60, 100, 0);
+
+        std::vector<float> res;
+        auto run = [&](int blocks) {
+            for (int i = 0; i < blocks; ++i)
+            {
+                surge->process();
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                {
+                    res.push_back(surge->output[0][k]);
+                    res.push_back(surge->output[1][k]);
+                }
+            }
+        };
+
+        run(50);
+        REQUIRE(surge->FBQlanes[0] == 5);
+        for (int e = 0; e < 5; ++e)
+            REQUIRE(surge->FBQvoice[0][e]->state.channel == e);
+
+        surge->releaseNote(releaseChannel, 60, 0);
+        int blocks = 0;
+        for (; blocks < 2000 && surge->voices[0].size() > 4; ++blocks)
+            run(1);
+        REQUIRE(surge->voices[0].size() == 4);
+        run(2100 - blocks);
+
+        REQUIRE(surge->FBQlanes[0] == 4);
+        laneZeroChannel = surge->FBQvoice[0][0]->state.channel;
+        return res;
+    };
+
+    int movedLaneZero = -1, stayedLaneZero = -1;
+    auto moved = render(0, movedLaneZero);
+    auto stayed = render(4, stayedLaneZero);
+    REQUIRE(movedLaneZero == 4);
+    REQUIRE(stayedLaneZero == 0);
+
+    REQUIRE(moved.size() == stayed.size());
+    float peak = 0.f;
+    for (int i = 0; i < moved.size(); ++i)
+    {
+        INFO("Sample " << i / 2 << " channel " << i % 2);
+        REQUIRE(moved[i] == stayed[i]);
+        peak = std::max(peak, std::fabs(moved[i]));
+    }
+    // and there was something to compare, after the move too
+    REQUIRE(peak > 0.01f);
+    float tail = 0.f;
+    for (int i = moved.size() - 200 * BLOCK_SIZE; i < moved.size(); ++i)
+        tail = std::max(tail, std::fabs(moved[i]));
+    REQUIRE(tail > 0.01f);
+}
+
+TEST_CASE("Quad Filter Coefficients Match The Scalar Makers", "[flt]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    // the types solved four wide. The rest run the scalar makers lane by lane, some of which
+    // leave stack garbage in the coefficients they don't use, so there's nothing to compare
+    srand(4123);
+    for (int fn : {fut_lp12, fut_lp24, fut_hp12, fut_hp24, fut_bp12, fut_bp24, fut_notch12,
+                   fut_notch24, fut_apf})
+    {
+        auto nst = std::max(1, fut_subcount[fn]);
+        for (int fs = 0; fs < nst; ++fs)
+        {
+            DYNAMIC_SECTION("Coefficients " << fut_names[fn] << " st: " << fs)
+            {
+                FilterCoefficientMaker scalar[4], quad[4];
+                FilterCoefficientMaker *cm[4];
+                QuadFilterUnitState Q;
+                for (int i = 0; i < 4; ++i)
+                {
+                    scalar[i].Reset();
+                    quad[i].Reset();
+                    cm[i] = &quad[i];
+                }
+                // an idle lane, as at the end of the filter bank
+                cm[3] = nullptr;
+
+                // the first call sets the coefficients, and the ones after smooth towards them
+                for (int call = 0; call < 20; ++call)
+                {
+                    float freq[4], reso[4];
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        freq[i] = 130.f * rand() / (float)RAND_MAX - 60.f;
+                        reso[i] = 1.f * rand() / (float)RAND_MAX;
+                    }
+
+                    FilterCoefficientMaker::MakeCoeffsQuad(cm, freq, reso, fn, fs, &surge->storage,
+                                                           false, Q);
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        scalar[i].MakeCoeffs(freq[i], reso[i], fn, fs, &surge->storage, false);
+                        for (int c = 0; c < n_cm_coeffs; ++c)
+                        {
+                            INFO("call " << call << " lane " << i << " coeff " << c << " freq "
+                                         << freq[i] << " reso " << reso[i]);
+                            auto tol = std::max(1e-7f, fabs(scalar[i].C[c]) * 1e-6f);
+                            REQUIRE(((float *)&Q.C[c])[i] == Approx(scalar[i].C[c]).margin(tol));
+                            auto dtol = std::max(1e-9f, fabs(scalar[i].dC[c]) * 1e-5f);
+                            REQUIRE(((float *)&Q.dC[c])[i] ==
+                                    Approx(scalar[i].dC[c]).margin(dtol));
+
+                            // and the maker carries the same state into the next block
+                            scalar[i].C[c] = scalar[i].tC[c];
+                            REQUIRE(quad[i].tC[c] == Approx(scalar[i].tC[c]).margin(tol));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Static Filters Share Their Coefficients", "[flt]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto &fu = surge->storage.getPatch().scene[0].filterunit[0];
+    fu.type.val.i = fut_lp24;
+    fu.subtype.val.i = st_Smooth;
+    fu.keytrack.val.f = 0.f;
+    fu.envmod.val.f = 0.f;
+
+    auto run = [&](int blocks) {
+        for (int i = 0; i < blocks; ++i)
+        {
+            surge->process();
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                REQUIRE(std::isfinite(surge->output[0][k]));
+                REQUIRE(std::isfinite(surge->output[1][k]));
+            }
+        }
+    };
+
+    // whether every lane in use has the coefficients of the first
+    auto lanesAgree = [&]() {
+        for (int e = 1; e < surge->FBQlanes[0]; ++e)
+        {
+            auto &Q = surge->FBQ[0][e >> 2].FU[0];
+            for (int c = 0; c < n_cm_coeffs; ++c)
+            {
+                if (((float *)&Q.C[c])[e & 3] != ((float *)&surge->FBQ[0][0].FU[0].C[c])[0])
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    for (int n = 0; n < 6; ++n)
+    {
+        surge->playNote(0, 48 + 5 * n, 100, 0);
+        run(3);
+    }
+    run(10);
+    REQUIRE(surge->FBQlanes[0] == 6);
+    REQUIRE(surge->sharedFilterCoeffs[0][0].active);
+    REQUIRE(lanesAgree());
+
+    // keytrack spreads the cutoffs over the notes
+    fu.keytrack.val.f = 1.f;
+    run(10);
+    REQUIRE(!surge->sharedFilterCoeffs[0][0].active);
+    REQUIRE(!lanesAgree());
+
+    fu.keytrack.val.f = 0.f;
+    run(10);
+    REQUIRE(surge->sharedFilterCoeffs[0][0].active);
+
+    // and so does voice modulation of the cutoff
+    REQUIRE(surge->setModulation(fu.cutoff.id, ms_velocity, 0.3f));
+    surge->playNote(0, 80, 20, 0);
+    run(10);
+    REQUIRE(!surge->sharedFilterCoeffs[0][0].active);
+    REQUIRE(!lanesAgree());
+
+    surge->allNotesOff();
+    for (int i = 0; i < 2000 && surge->FBQlanes[0] > 0; ++i)
+        run(1);
+    REQUIRE(surge->FBQlanes[0] == 0);
+}
@@ -10,6 +10,18 @@
 
 #include "UnitTestUtilities.h"
 #include "FastMath.h"
+#include "effect/BlockFifo.h"
+#include "effect/DelayMemoryPool.h"
+#include "effect/DualDelayEffect.h"
+#include "effect/PhaserEffect.h"
+#include "effect/Reverb1Effect.h"
+#include "effect/VocoderEffect.h"
+#include "effect/airwindows/AirWindowsStereo.h"
+#include "effect/Effect.h"
+#include "effect/FxChain.h"
+
+#include <chrono>
+#include <thread>
 
 using namespace Surge::Test;
 
@@ -61,3 +73,838 @@ TEST_CASE("Airwindows Loud", "[fx]")
         }
     }
 }
+
+TEST_CASE("FX Spawner Builds Effects Off Thread", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    auto waitFor = [](FxSpawner &sp, int slot, int type) {
+        for (int w = 0; w < 500 && sp.isPreparing(slot, type); ++w)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return !sp.isPreparing(slot, type);
+    };
+
+    SECTION("Mailbox")
+    {
+        FxSpawner sp(&surge->storage, surge->fxsync);
+        REQUIRE(!sp.take(2, fxt_reverb));
+        REQUIRE(!sp.peek(2));
+
+        sp.prepare(2, fxt_reverb);
+        REQUIRE(waitFor(sp, 2, fxt_reverb));
+        REQUIRE(sp.peek(2));
+
+        // the wrong type is dropped, not handed out
+        REQUIRE(!sp.take(2, fxt_delay));
+        REQUIRE(!sp.take(2, fxt_reverb));
+
+        sp.prepare(2, fxt_reverb);
+        sp.prepare(3, fxt_delay);
+        REQUIRE(waitFor(sp, 2, fxt_reverb));
+        REQUIRE(waitFor(sp, 3, fxt_delay));
+
+        auto *waiting = sp.peek(2);
+        REQUIRE(waiting);
+        auto *fx = sp.take(2, fxt_reverb);
+        REQUIRE(fx == waiting);
+        REQUIRE(!sp.peek(2));
+        REQUIRE(!sp.take(2, fxt_reverb));
+        sp.retire(fx);
+
+        // fxt_off has no effect to build
+        sp.prepare(1, fxt_off);
+        REQUIRE(waitFor(sp, 1, fxt_off));
+        REQUIRE(!sp.take(1, fxt_off));
+    }
+
+    SECTION("Parameters Are Copied When Prepared")
+    {
+        FxSpawner sp(&surge->storage, surge->fxsync);
+        for (int slot : {3, 4})
+            surge->fxsync[slot].p[dly_time_right].deactivated = true;
+
+        // the delay sizes its lines from the times it is built with: a second, then eight
+        surge->fxsync[3].p[dly_time_left].val.f = 0.f;
+        sp.prepare(3, fxt_delay);
+        surge->fxsync[3].p[dly_time_left].val.f = 3.f;
+        surge->fxsync[4].p[dly_time_left].val.f = 3.f;
+        sp.prepare(4, fxt_delay);
+        REQUIRE(waitFor(sp, 3, fxt_delay));
+        REQUIRE(waitFor(sp, 4, fxt_delay));
+
+        // the edit after prepare didn't reach the effect built for it
+        auto *shorter = sp.take(3, fxt_delay);
+        auto *longer = sp.take(4, fxt_delay);
+        REQUIRE(shorter);
+        REQUIRE(longer);
+        REQUIRE(shorter->get_memory_usage() < longer->get_memory_usage());
+        sp.retire(shorter);
+        sp.retire(longer);
+    }
+
+    SECTION("FX Type Changes Use the Prepared Effect")
+    {
+        for (int i = 0; i < 10; ++i)
+            surge->process();
+
+        for (auto t : {fxt_delay, fxt_reverb2, fxt_chorus4, fxt_off, fxt_phaser})
+        {
+            INFO("Switching slot 0 to " << fx_type_names[t]);
+            auto *pt = &(surge->storage.getPatch().fx[0].type);
+            surge->setParameter01(surge->idForParameter(pt),
+                                  1.f * t / (pt->val_max.i - pt->val_min.i), false);
+            REQUIRE(waitFor(*surge->fxSpawner, 0, t));
+            auto *prepared = surge->fxSpawner->peek(0);
+            REQUIRE((bool)prepared == (t != fxt_off));
+
+            for (int i = 0; i < 10; ++i)
+                surge->process();
+
+            // loadFx took the spawner's instance rather than building its own
+            REQUIRE(surge->storage.getPatch().fx[0].type.val.i == t);
+            REQUIRE(surge->fx[0].get() == prepared);
+            REQUIRE(!surge->fxSpawner->peek(0));
+            for (int p = 0; p < BLOCK_SIZE; ++p)
+            {
+                REQUIRE(std::isfinite(surge->output[0][p]));
+                REQUIRE(std::isfinite(surge->output[1][p]));
+            }
+
+            // and the patch and fxsync start from the new type's defaults
+            FxStorage fresh;
+            memcpy((void *)&fresh, (void *)&surge->fxsync[0], sizeof(FxStorage));
+            std::unique_ptr<Effect> d(spawn_effect(t, &surge->storage, &fresh, 0));
+            if (!d)
+                continue;
+            d->init_ctrltypes();
+            d->init_default_values();
+            for (int i = 0; i < n_fx_params; ++i)
+            {
+                INFO("Parameter " << i);
+                REQUIRE(surge->storage.getPatch().fx[0].p[i].val.i == fresh.p[i].val.i);
+                REQUIRE(surge->fxsync[0].p[i].val.i == fresh.p[i].val.i);
+            }
+        }
+    }
+}
+
+TEST_CASE("FX Chain Hands Effects Over Through A Mailbox", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    FxChain chain(&surge->storage, &(surge->storage.getPatch().fx[1]));
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+    auto processBlock = [&]() {
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            L[k] = surge->storage.rand_pm1();
+            R[k] = surge->storage.rand_pm1();
+        }
+        chain.takePublished();
+        chain.process(L, R);
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            REQUIRE(std::isfinite(L[k]));
+            REQUIRE(std::isfinite(R[k]));
+        }
+    };
+
+    SECTION("The Audio Thread Swaps Effects In")
+    {
+        auto *delayStorage = chain.prepare(0, fxt_delay);
+        REQUIRE(delayStorage);
+        REQUIRE(chain.getType(0) == fxt_delay);
+        REQUIRE(!chain.running(0));
+        chain.publish(0);
+        REQUIRE(!chain.running(0));
+
+        processBlock();
+        auto *delay = chain.running(0);
+        REQUIRE(delay);
+        REQUIRE(chain.runningStorage(0) == delayStorage);
+        REQUIRE(chain.runningType(0) == fxt_delay);
+
+        // retyping the slot leaves the running delay and its parameters alone
+        auto ct0 = delayStorage->p[0].ctrltype;
+        auto *reverbStorage = chain.prepare(0, fxt_reverb);
+        chain.publish(0);
+        REQUIRE(reverbStorage != delayStorage);
+        REQUIRE(delayStorage->p[0].ctrltype == ct0);
+        REQUIRE(chain.running(0) == delay);
+        REQUIRE(chain.getType(0) == fxt_reverb);
+        REQUIRE(chain.runningType(0) == fxt_delay);
+
+        processBlock();
+        REQUIRE(chain.running(0) != delay);
+        REQUIRE(chain.runningStorage(0) == reverbStorage);
+        REQUIRE(chain.runningType(0) == fxt_reverb);
+
+        // only the last of several publishes reaches the audio thread
+        chain.setType(0, fxt_chorus4);
+        chain.setType(0, fxt_off);
+        processBlock();
+        REQUIRE(!chain.running(0));
+        REQUIRE(chain.getType(0) == fxt_off);
+    }
+
+    SECTION("Retyping While The Audio Thread Runs")
+    {
+        std::atomic<bool> done{false};
+        std::thread audio([&]() {
+            float aL alignas(16)[BLOCK_SIZE], aR alignas(16)[BLOCK_SIZE];
+            while (!done)
+            {
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                    aL[k] = aR[k] = 0.1f * sinf(0.01f * k);
+                chain.takePublished();
+                chain.process(aL, aR);
+            }
+        });
+
+        int types[] = {fxt_delay, fxt_phaser, fxt_chorus4, fxt_off, fxt_flanger, fxt_eq};
+        for (int i = 0; i < 60; ++i)
+        {
+            chain.setType(i % FxChain::n_slots, types[i % 6]);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        done = true;
+        audio.join();
+
+        processBlock();
+        for (int s = 0; s < FxChain::n_slots; ++s)
+            REQUIRE((chain.running(s) != nullptr) == (chain.getType(s) != fxt_off));
+    }
+}
+
+TEST_CASE("Block FIFO Latency With Odd Host Buffers", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    /*
+     * The same two effect chain runs straight in BLOCK_SIZE steps, and behind a BlockFifo fed
+     * host buffers which are mostly not multiples of 32. The FIFO's output has to be the
+     * straight output, exactly latency samples later.
+     */
+    FxChain direct(&surge->storage, &(surge->storage.getPatch().fx[1]));
+    FxChain fifoed(&surge->storage, &(surge->storage.getPatch().fx[1]));
+    for (auto *c : {&direct, &fifoed})
+    {
+        c->setType(0, fxt_delay);
+        c->setType(1, fxt_phaser);
+    }
+
+    const int blocks = 200, n = blocks * BLOCK_SIZE;
+    std::vector<float> inL(n), inR(n), sideL(n), sideR(n);
+    for (int i = 0; i < n; ++i)
+    {
+        inL[i] = surge->storage.rand_pm1();
+        inR[i] = surge->storage.rand_pm1();
+        sideL[i] = surge->storage.rand_pm1();
+        sideR[i] = surge->storage.rand_pm1();
+    }
+
+    // the block function mixes in the sidechain, so it has to line up too
+    std::vector<float> expL(n), expR(n);
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+    for (int b = 0; b < blocks; ++b)
+    {
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            L[k] = inL[b * BLOCK_SIZE + k] + 0.5f * sideL[b * BLOCK_SIZE + k];
+            R[k] = inR[b * BLOCK_SIZE + k] + 0.5f * sideR[b * BLOCK_SIZE + k];
+        }
+        direct.takePublished();
+        direct.process(L, R);
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            expL[b * BLOCK_SIZE + k] = L[k];
+            expR[b * BLOCK_SIZE + k] = R[k];
+        }
+    }
+
+    BlockFifo fifo;
+    REQUIRE(BlockFifo::latency == BLOCK_SIZE);
+    std::vector<float> outL(inL), outR(inR);
+    int hostSizes[] = {1, 7, 33, 100, 31, 257, 64, 13, 500};
+    int pos = 0, h = 0;
+    while (pos < n)
+    {
+        int sz = std::min(hostSizes[h++ % 9], n - pos);
+        fifo.process(&outL[pos], &outR[pos], &sideL[pos], &sideR[pos], sz, [&]() {
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                fifo.out[0][k] += 0.5f * fifo.side[0][k];
+                fifo.out[1][k] += 0.5f * fifo.side[1][k];
+            }
+            fifoed.takePublished();
+            fifoed.process(fifo.out[0], fifo.out[1]);
+        });
+        pos += sz;
+    }
+
+    for (int i = 0; i < BlockFifo::latency; ++i)
+    {
+        REQUIRE(outL[i] == 0.f);
+        REQUIRE(outR[i] == 0.f);
+    }
+    for (int i = BlockFifo::latency; i < n; ++i)
+    {
+        INFO("sample " << i);
+        REQUIRE(outL[i] == expL[i - BlockFifo::latency]);
+        REQUIRE(outR[i] == expR[i - BlockFifo::latency]);
+    }
+}
+
+TEST_CASE("Delay Lines Come From The Pool", "[fx]")
+{
+    SECTION("Pool")
+    {
+        DelayMemoryPool pool;
+
+        auto *a = pool.allocate(1000);
+        REQUIRE(a);
+        REQUIRE(((size_t)a & 15) == 0);
+        for (int i = 0; i < 1000; ++i)
+            REQUIRE(a[i] == 0);
+        REQUIRE(pool.bytesInUse() == 4000);
+
+        a[17] = 1;
+        pool.release(a);
+        REQUIRE(pool.bytesInUse() == 0);
+        REQUIRE(pool.bytesCached() == 4000);
+
+        DelayMemoryPool::Growth g;
+        pool.request(g, 1000);
+
+        size_t n = 0;
+        float *b = nullptr;
+        for (int w = 0; w < 500 && !(b = pool.collect(g, n)); ++w)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(b);
+        REQUIRE(n == 1000);
+        // the released block is reused, and zeroed again
+        REQUIRE(pool.bytesCached() == 0);
+        REQUIRE(b[17] == 0);
+
+        pool.releaseLater(g, b);
+        pool.cancel(g);
+        REQUIRE(pool.bytesInUse() == 0);
+    }
+
+    SECTION("History Keeps Its Place In A Longer Ring")
+    {
+        // two floats a row; rows before the write position 6 hold their distance behind it
+        float from[8 * 2], to[32 * 2];
+        for (int i = 0; i < 8 * 2; ++i)
+            from[i] = i;
+        for (auto &t : to)
+            t = -1;
+
+        DelayMemoryPool::carryHistory(to, 32, from, 8, 6, 2);
+        for (int back = 1; back <= 8; ++back)
+        {
+            INFO("Row " << back << " behind");
+            int f = (6 - back) & 7, t = (6 - back) & 31;
+            REQUIRE(to[t * 2] == from[f * 2]);
+            REQUIRE(to[t * 2 + 1] == from[f * 2 + 1]);
+        }
+        REQUIRE(to[6 * 2] == -1);
+        REQUIRE(to[(6 - 9 + 32) * 2] == -1);
+    }
+
+    SECTION("Delay Grows With Its Time")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+
+        REQUIRE(setFXType(surge, 0, fxt_delay));
+        REQUIRE(surge->fx[0]);
+        REQUIRE(std::string(surge->fx[0]->get_effectname()) == "dualdelay");
+
+        // the lines used to be two of max_delay_length whatever the time
+        auto before = surge->fx[0]->get_memory_usage();
+        REQUIRE(before < 2 * max_delay_length * sizeof(float));
+
+        auto *dt = &(surge->storage.getPatch().fx[0].p[DualDelayEffect::dly_time_left]);
+        surge->setParameter01(surge->idForParameter(dt), dt->value_to_normalized(3.f), false);
+
+        auto after = before;
+        for (int w = 0; w < 500 && after == before; ++w)
+        {
+            surge->process();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            after = surge->fx[0]->get_memory_usage();
+        }
+        REQUIRE(after > before);
+        REQUIRE(after - surge->fx[0]->object_size >= 2 * max_delay_length * sizeof(float));
+
+        for (int p = 0; p < BLOCK_SIZE; ++p)
+        {
+            REQUIRE(std::isfinite(surge->output[0][p]));
+            REQUIRE(std::isfinite(surge->output[1][p]));
+        }
+    }
+
+    SECTION("Effects Spawned Without Memory Ask The Pool For It")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(surge);
+        auto *storage = &surge->storage;
+
+        for (auto t : {fxt_delay, fxt_reverb, fxt_nimbus})
+        {
+            INFO("Effect " << fx_type_names[t]);
+            auto &fxs = storage->getPatch().fx[1];
+            fxs.type.val.i = t;
+            std::unique_ptr<Effect> fx(
+                spawn_effect(t, storage, &fxs, storage->getPatch().globaldata));
+            REQUIRE(fx);
+
+            // neither the reverb's predelay nor any line lives in the object any more
+            if (t == fxt_reverb)
+                REQUIRE(fx->object_size < max_rev_dly * sizeof(float));
+            REQUIRE(fx->get_memory_usage() == fx->object_size);
+
+            // what the audio thread does with an effect loadFx had to build itself
+            fx->init_ctrltypes();
+            fx->init_default_values();
+            storage->getPatch().copy_globaldata(storage->getPatch().globaldata);
+            fx->init();
+
+            float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+            auto fill = [&]() {
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                    L[k] = R[k] = (k & 1) ? 0.25f : -0.25f;
+            };
+
+            // silent until the memory arrives
+            fill();
+            fx->process(L, R);
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                REQUIRE(L[k] == 0.f);
+                REQUIRE(R[k] == 0.f);
+            }
+
+            for (int w = 0; w < 500 && fx->get_memory_usage() == fx->object_size; ++w)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                fill();
+                fx->process(L, R);
+            }
+            REQUIRE(fx->get_memory_usage() > fx->object_size);
+
+            for (int i = 0; i < 100; ++i)
+            {
+                fill();
+                fx->process(L, R);
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                {
+                    REQUIRE(std::isfinite(L[k]));
+                    REQUIRE(std::isfinite(R[k]));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("A Send Effect Waiting For Its Lines Returns Nothing", "[fx]")
+{
+    for (auto t : {fxt_delay, fxt_reverb})
+    {
+        DYNAMIC_SECTION("FX " << fx_type_names[t])
+        {
+            auto surge = Surge::Headless::createSurge(44100);
+            REQUIRE(surge);
+
+            // the whole scene to send 1 and all of it back, so any leak doubles the output
+            int slot = fxslot_send1;
+            surge->storage.getPatch().scene[0].send_level[0].val.f = 1.f;
+            surge->storage.getPatch().fx[slot].return_level.val.f = 1.f;
+
+            // a high note, so a block holds a few cycles and its RMS barely moves
+            surge->playNote(0, 108, 127, 0);
+            auto blockRMS = [&]() {
+                double sum = 0;
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                    sum += surge->output[0][k] * surge->output[0][k] +
+                           surge->output[1][k] * surge->output[1][k];
+                return sqrt(sum / (2 * BLOCK_SIZE));
+            };
+
+            double before = 0;
+            const int blocks = 200, tail = 50;
+            for (int i = 0; i < blocks; ++i)
+            {
+                surge->process();
+                if (i >= blocks - tail)
+                    before += blockRMS() / tail;
+            }
+            REQUIRE(before > 1e-3);
+
+            // a type change the spawner wasn't asked for, so loadFx builds the effect on the
+            // running engine without its lines, in the same block it processes it
+            surge->audio_processing_active = true;
+            surge->fxsync[slot].type.val.i = t;
+            surge->fx_reload[slot] = true;
+            surge->fx_reload_defaults[slot] = true;
+            surge->load_fx_needed = true;
+            surge->process();
+            surge->audio_processing_active = false;
+
+            REQUIRE(surge->fx[slot]);
+            REQUIRE(surge->fx[slot]->get_memory_usage() == surge->fx[slot]->object_size);
+            INFO("RMS " << blockRMS() << " against " << before << " before the change");
+            REQUIRE(blockRMS() < 1.4 * before);
+        }
+    }
+}
+
+TEST_CASE("Phaser Stage Count Automation", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    REQUIRE(setFXType(surge, 0, fxt_phaser));
+    REQUIRE(surge->fx[0]);
+    REQUIRE(std::string(surge->fx[0]->get_effectname()) == "phaser");
+
+    auto *st = &(surge->storage.getPatch().fx[0].p[PhaserEffect::ph_stages]);
+    auto *fb = &(surge->storage.getPatch().fx[0].p[PhaserEffect::ph_feedback]);
+    fb->val.f = 0.5f;
+
+    surge->playNote(0, 60, 127, 0);
+
+    // the stages used to be allocated as the count rose; now the effect holds all of them
+    auto mem = surge->fx[0]->get_memory_usage();
+    REQUIRE(mem == surge->fx[0]->object_size);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        if (i % 16 == 0)
+            st->val.i = 1 + rand() % 16;
+        surge->process();
+
+        INFO("Block " << i << " with " << st->val.i << " stages");
+        for (int p = 0; p < BLOCK_SIZE; ++p)
+        {
+            REQUIRE(std::isfinite(surge->output[0][p]));
+            REQUIRE(std::isfinite(surge->output[1][p]));
+            REQUIRE(fabs(surge->output[0][p]) < 10.f);
+            REQUIRE(fabs(surge->output[1][p]) < 10.f);
+        }
+    }
+
+    REQUIRE(surge->fx[0]->get_memory_usage() == mem);
+}
+
+TEST_CASE("Vocoder Bands Keep Their Range Unless Extended", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    REQUIRE(setFXType(surge, 0, fxt_vocoder));
+    auto *bands = &(surge->storage.getPatch().fx[0].p[VocoderEffect::voc_num_bands]);
+
+    // Saved patches and host automation see the same 4..20 mapping as before
+    REQUIRE(!bands->extend_range);
+    REQUIRE(bands->val_min.i == 4);
+    REQUIRE(bands->val_max.i == n_vocoder_default_bands);
+    bands->val.i = 12;
+    REQUIRE(bands->get_value_f01() == Approx(0.5));
+    bands->set_value_f01(1.f);
+    REQUIRE(bands->val.i == n_vocoder_default_bands);
+
+    // The toggle sets the range itself, so it works on a bypassed effect too
+    bands->set_extend_range(true);
+    REQUIRE(bands->val_max.i == n_vocoder_bands);
+    bands->set_value_f01(1.f);
+    REQUIRE(bands->val.i == n_vocoder_bands);
+
+    // and the effect only reads it
+    surge->process();
+    surge->fx[0]->init();
+    REQUIRE(bands->val_max.i == n_vocoder_bands);
+    REQUIRE(bands->val.i == n_vocoder_bands);
+
+    // Turning the range back off pulls the count back into 4..20
+    bands->set_extend_range(false);
+    REQUIRE(bands->val_max.i == n_vocoder_default_bands);
+    REQUIRE(bands->val.i == n_vocoder_default_bands);
+}
+
+// A timing printout rather than a check, so only run when asked for by name or with [.]
+TEST_CASE("Vocoder CPU By Band Count", "[.][fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    REQUIRE(setFXType(surge, 0, fxt_vocoder));
+    REQUIRE(surge->fx[0]);
+    REQUIRE(std::string(surge->fx[0]->get_effectname()) == "vocoder");
+
+    auto *bands = &(surge->storage.getPatch().fx[0].p[VocoderEffect::voc_num_bands]);
+    bands->set_extend_range(true);
+    REQUIRE(bands->val_max.i == n_vocoder_bands);
+
+    float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+    const int blocks = 2000;
+    double per20 = 0;
+
+    for (int n = 4; n <= n_vocoder_bands; n += 4)
+    {
+        bands->val.i = n;
+        // let the value reach the effect's parameter data, then take it up
+        surge->process();
+        surge->fx[0]->init();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int b = 0; b < blocks; ++b)
+        {
+            for (int k = 0; k < BLOCK_SIZE; ++k)
+            {
+                surge->storage.audio_in_nonOS[0][k] = surge->storage.rand_pm1();
+                surge->storage.audio_in_nonOS[1][k] = surge->storage.rand_pm1();
+                L[k] = surge->storage.rand_pm1();
+                R[k] = surge->storage.rand_pm1();
+            }
+            surge->fx[0]->process(L, R);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        for (int k = 0; k < BLOCK_SIZE; ++k)
+        {
+            REQUIRE(std::isfinite(L[k]));
+            REQUIRE(std::isfinite(R[k]));
+        }
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / blocks;
+        if (n == n_vocoder_default_bands)
+            per20 = ns;
+        std::cout << "Vocoder " << std::setw(2) << n << " bands: " << std::setw(8)
+                  << std::setprecision(0) << std::fixed << ns << " ns/block";
+        if (per20 > 0)
+            std::cout << " (" << std::setprecision(2) << ns / per20 << "x 20 bands)";
+        std::cout << std::endl;
+    }
+}
+
+TEST_CASE("Rotary Speaker Keeps Its Old Horn Taps For Old Patches", "[fx]")
+{
+    SECTION("Streaming")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        REQUIRE(!surge->storage.getPatch().legacyRotaryHornTaps);
+        REQUIRE(surge->loadPatchByPath("resources/data/patches_factory/Templates/Init FM2.fxp", -1,
+                                       "Templates"));
+        REQUIRE(surge->storage.getPatch().streamingRevision <= 18);
+        REQUIRE(surge->storage.getPatch().legacyRotaryHornTaps);
+
+        for (auto v : {false, true})
+        {
+            auto dest = Surge::Headless::createSurge(44100);
+            dest->storage.getPatch().legacyRotaryHornTaps = !v;
+            surge->storage.getPatch().legacyRotaryHornTaps = v;
+
+            void *d = nullptr;
+            auto sz = surge->saveRaw(&d);
+            dest->loadRaw(d, sz, false);
+            REQUIRE(dest->storage.getPatch().legacyRotaryHornTaps == v);
+        }
+    }
+
+    SECTION("The Flag Selects The Old Read")
+    {
+        auto render = [](bool legacy) {
+            auto surge = Surge::Headless::createSurge(44100);
+            REQUIRE(setFXType(surge, 0, fxt_rotaryspeaker));
+            surge->storage.getPatch().legacyRotaryHornTaps = legacy;
+            surge->fx[0]->init();
+
+            std::vector<float> res;
+            float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+            for (int b = 0; b < 500; ++b)
+            {
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                {
+                    float t = (b * BLOCK_SIZE + k) / 44100.f;
+                    L[k] = 0.5f * sinf(2.f * M_PI * 440.f * t) +
+                           0.3f * sinf(2.f * M_PI * 3100.f * t);
+                    R[k] = L[k];
+                }
+                surge->fx[0]->process(L, R);
+                for (int k = 0; k < BLOCK_SIZE; ++k)
+                {
+                    res.push_back(L[k]);
+                    res.push_back(R[k]);
+                }
+            }
+            return res;
+        };
+
+        auto aligned = render(false), legacy = render(true), legacyAgain = render(true);
+        REQUIRE(aligned.size() == legacy.size());
+
+        float maxd = 0.f;
+        for (int i = 0; i < aligned.size(); ++i)
+        {
+            INFO("Sample " << i);
+            REQUIRE(legacy[i] == legacyAgain[i]);
+            maxd = std::max(maxd, std::fabs(aligned[i] - legacy[i]));
+        }
+
+        // the one coefficient shift is small, but it is there
+        REQUIRE(maxd > 0.f);
+        REQUIRE(maxd < 5e-3);
+    }
+}
+
+TEST_CASE("Airwindows Stereo Kernels Match Scalar", "[fx]")
+{
+    auto reg = AirWinBaseClass::pluginRegistry();
+
+    for (auto name : {"Capacitor", "Slew2"})
+    {
+        DYNAMIC_SECTION("Airwindows " << name)
+        {
+            std::unique_ptr<AirWinBaseClass> aw;
+            for (auto &r : reg)
+            {
+                auto c = r.create(r.id, 48000, 2);
+                char n[1024];
+                c->getEffectName(n);
+                if (std::string(n) == name)
+                    aw = std::move(c);
+            }
+            REQUIRE(aw);
+            auto kernel = AirWindowsStereo::create(name);
+            REQUIRE(kernel);
+
+            // the kernel keeps its own state and reads the parameters from aw
+            const int qblock = 4;
+            float L[qblock], R[qblock], oL[qblock], oR[qblock], kL[qblock], kR[qblock];
+            float *in[2] = {L, R}, *o[2] = {oL, oR}, *k[2] = {kL, kR};
+
+            uint32_t seed = 1;
+            auto noise = [&seed]() {
+                seed = seed * 1664525 + 1013904223;
+                return (seed >> 8) / 16777216.f - 0.5f;
+            };
+
+            for (int b = 0; b < 20000; ++b)
+            {
+                if (b % 500 == 0)
+                    for (int p = 0; p < aw->paramCount; ++p)
+                        aw->setParameter(p, fmod(0.137 * (b / 500) + 0.3 * p, 1.0));
+
+                // loud and quiet, but never digital silence, whose denormal noise comes from
+                // a counter the scalar code shares between instances
+                for (int i = 0; i < qblock; ++i)
+                {
+                    L[i] = noise() * sin(0.001 * (b * qblock + i)) + 1e-4;
+                    R[i] = noise();
+                }
+
+                // Capacitor dithers from rand
+                srand(b);
+                aw->processReplacing(in, o, qblock);
+                srand(b);
+                kernel->processReplacing(aw.get(), in, k, qblock);
+
+                for (int i = 0; i < qblock; ++i)
+                {
+                    INFO("Block " << b << " sample " << i);
+                    if (sizeof(long double) == sizeof(double))
+                    {
+                        REQUIRE(kL[i] == oL[i]);
+                        REQUIRE(kR[i] == oR[i]);
+                    }
+                    else
+                    {
+                        // x87 keeps the scalar code's long doubles wider than our lanes
+                        REQUIRE(kL[i] == Approx(oL[i]).margin(1e-6));
+                        REQUIRE(kR[i] == Approx(oR[i]).margin(1e-6));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Oversampled Effects At Every Factor", "[fx]")
+{
+    for (auto t : {fxt_distortion, fxt_neuron, fxt_chow, fxt_exciter, fxt_tape})
+    {
+        DYNAMIC_SECTION("FX " << fx_type_names[t])
+        {
+            REQUIRE(fx_type_has_oversampling(t));
+
+            auto surge = Surge::Headless::createSurge(48000);
+            REQUIRE(surge);
+
+            REQUIRE(setFXType(surge, 0, t));
+            REQUIRE(surge->fx[0]);
+            auto *pt = &(surge->storage.getPatch().fx[0].type);
+
+            // a loud 440Hz sine, and the RMS out once the effect has settled
+            float L alignas(16)[BLOCK_SIZE], R alignas(16)[BLOCK_SIZE];
+            const int blocks = 400, settle = 200;
+            double rms[n_fx_oversampling];
+
+            for (int os = fxos_default; os < n_fx_oversampling; ++os)
+            {
+                pt->deform_type = os;
+                surge->fx[0]->init();
+
+                double sum = 0;
+                for (int b = 0; b < blocks; ++b)
+                {
+                    for (int k = 0; k < BLOCK_SIZE; ++k)
+                    {
+                        L[k] = 0.7 * sin(2.0 * M_PI * 440.0 * (b * BLOCK_SIZE + k) / 48000.0);
+                        R[k] = L[k];
+                    }
+                    surge->fx[0]->process(L, R);
+
+                    INFO("Oversampling " << fx_oversampling_names[os] << " block " << b);
+                    for (int k = 0; k < BLOCK_SIZE; ++k)
+                    {
+                        REQUIRE(std::isfinite(L[k]));
+                        REQUIRE(std::isfinite(R[k]));
+                        if (b >= settle)
+                            sum += L[k] * L[k] + R[k] * R[k];
+                    }
+                }
+                rms[os] = sqrt(sum / ((blocks - settle) * BLOCK_SIZE * 2));
+                REQUIRE(rms[os] > 1e-3);
+            }
+
+            // the effects keep their level, if not their exact sound, at every factor
+            for (int os = fxos_1x; os < n_fx_oversampling; ++os)
+            {
+                INFO("Oversampling " << fx_oversampling_names[os] << " RMS " << rms[os]
+                                     << " default " << rms[fxos_default]);
+                REQUIRE(rms[os] > 0.5 * rms[fxos_default]);
+                REQUIRE(rms[os] < 2.0 * rms[fxos_default]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Oversampling Choice Does Not Carry To A New FX Type", "[fx]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge);
+
+    REQUIRE(setFXType(surge, 0, fxt_tape));
+    auto *pt = &(surge->storage.getPatch().fx[0].type);
+    pt->deform_type = fxos_8x;
+    for (int i = 0; i < 10; ++i)
+        surge->process();
+
+    REQUIRE(setFXType(surge, 0, fxt_distortion));
+    REQUIRE(pt->deform_type == fxos_default);
+}
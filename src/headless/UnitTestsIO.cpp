@@ -37,6 +37,21 @@ TEST_CASE("We can read a collection of wavetables", "[io]")
         REQUIRE(wt->size == 2048);
         REQUIRE(wt->n_tables == 256);
         REQUIRE((wt->flags & wtf_is_sample) == 0);
+
+        // the table is built off to the side and published, so its pointers must have come along
+        for (int l = 0; l < 11; ++l)
+        {
+            for (int s = 0; s < wt->n_tables; ++s)
+            {
+                INFO("Mip level " << l << " table " << s);
+                auto f = wt->TableF32WeakPointers[l][s];
+                auto i = wt->TableI16WeakPointers[l][s];
+                REQUIRE(f >= wt->TableF32Data);
+                REQUIRE(f + (wt->size >> l) <= wt->TableF32Data + wt->dataSizes);
+                REQUIRE(i >= wt->TableI16Data);
+                REQUIRE(i + (wt->size >> l) <= wt->TableI16Data + wt->dataSizes);
+            }
+        }
     }
 
     SECTION("05_BELL.WAV")
@@ -74,6 +89,109 @@ TEST_CASE("All .wt and .wav factory assets load", "[io]")
     }
 }
 
+TEST_CASE("Wavetable Mips Match The Scalar Decimation", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge.get());
+
+    // The mip chain as MipMapWT computed it before the SSE decimators and the worker pool,
+    // started from the built top level
+    int checked = 0;
+    for (auto p : surge->storage.wt_list)
+    {
+        if (checked == 4)
+            break;
+
+        auto wt = &(surge->storage.getPatch().scene[0].osc[0].wt);
+        surge->storage.load_wt(path_to_string(p.path), wt,
+                               &(surge->storage.getPatch().scene[0].osc[0]));
+        if (wt->flags & wtf_is_sample)
+            continue;
+        checked++;
+
+        INFO("Wavetable " << path_to_string(p.path));
+        int levels = 1;
+        while (((1 << levels) < wt->size) & (levels < max_mipmap_levels))
+            levels++;
+
+        for (int s = 0; s < wt->n_tables; ++s)
+        {
+            std::vector<float> f32(wt->TableF32WeakPointers[0][s],
+                                   wt->TableF32WeakPointers[0][s] + wt->size);
+            std::vector<short> i16(&wt->TableI16WeakPointers[0][s][FIRoffsetI16],
+                                   &wt->TableI16WeakPointers[0][s][FIRoffsetI16] + wt->size);
+
+            for (int l = 1; l < levels; ++l)
+            {
+                int psize = wt->size >> (l - 1);
+                int lsize = wt->size >> l;
+                std::vector<float> nf32(lsize);
+                std::vector<short> ni16(lsize);
+                for (int i = 0; i < lsize; i++)
+                {
+                    nf32[i] = 0;
+                    for (int a = 0; a < 63; a++)
+                        nf32[i] += hrfilter[a] * f32[((i << 1) + a - 31) & (psize - 1)];
+
+                    int ival = 0;
+                    for (int a = 0; a < 63; a++)
+                        ival += HRFilterI16[a] * i16[((i << 1) + a - 31) & (psize - 1)];
+                    ni16[i] = ival >> 16;
+                }
+                f32 = nf32;
+                i16 = ni16;
+
+                INFO("Mip level " << l << " table " << s);
+                REQUIRE(memcmp(wt->TableF32WeakPointers[l][s], f32.data(),
+                               lsize * sizeof(float)) == 0);
+                REQUIRE(memcmp(&wt->TableI16WeakPointers[l][s][FIRoffsetI16], i16.data(),
+                               lsize * sizeof(short)) == 0);
+            }
+        }
+    }
+    REQUIRE(checked == 4);
+}
+
+TEST_CASE("Queued Wavetables Build Alike On The Audio Thread", "[io]")
+{
+    auto surge = Surge::Headless::createSurge(44100);
+    REQUIRE(surge.get());
+
+    // processControl builds queued tables without the mip workers; the mips mustn't differ
+    int checked = 0;
+    for (int id = 0; id < surge->storage.wt_list.size() && checked < 4; ++id)
+    {
+        auto &wt = surge->storage.getPatch().scene[0].osc[0].wt;
+        wt.queue_id = id;
+        surge->process();
+        REQUIRE(wt.current_id == id);
+
+        Wavetable direct;
+        surge->storage.load_wt(id, &direct, nullptr);
+        if (direct.flags & wtf_is_sample)
+            continue;
+        checked++;
+
+        INFO("Wavetable " << path_to_string(surge->storage.wt_list[id].path));
+        REQUIRE(wt.size == direct.size);
+        REQUIRE(wt.n_tables == direct.n_tables);
+        int levels = 1;
+        while (((1 << levels) < wt.size) & (levels < max_mipmap_levels))
+            levels++;
+
+        for (int l = 0; l < levels; ++l)
+        {
+            for (int s = 0; s < wt.n_tables; ++s)
+            {
+                INFO("Mip level " << l << " table " << s);
+                REQUIRE(memcmp(wt.TableF32WeakPointers[l][s], direct.TableF32WeakPointers[l][s],
+                               (wt.size >> l) * sizeof(float)) == 0);
+            }
+        }
+    }
+    REQUIRE(checked == 4);
+}
+
 TEST_CASE("All Patches are Loadable", "[io]")
 {
     auto surge = Surge::Headless::createSurge(44100);
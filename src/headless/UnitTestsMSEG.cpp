@@ -7,6 +7,9 @@
 #include "catch2/catch2.hpp"
 #include "FastMath.h"
 #include "MSEGModulationHelper.h"
+#include "ModulatorPreview.h"
+
+#include <thread>
 
 struct msegObservation
 {
@@ -520,6 +523,111 @@ TEST_CASE("Zero size loops", "[mseg]")
     }
 }
 
+TEST_CASE("MSEG and LFO Display Curves", "[mseg]")
+{
+    SECTION("Edits Bump the MSEG Version")
+    {
+        MSEGStorage ms;
+        Surge::MSEG::createInitVoiceMSEG(&ms);
+        auto v0 = ms.version;
+        REQUIRE(v0 != 0);
+
+        MSEGStorage copy = ms;
+        Surge::MSEG::scaleValues(&ms, 0.5);
+        REQUIRE(ms.version != v0);
+        Surge::MSEG::rebuildCache(&copy);
+        REQUIRE(copy.version != ms.version);
+    }
+
+    SECTION("MSEG Curve Matches the Evaluator")
+    {
+        MSEGStorage ms;
+        Surge::MSEG::createSawMSEG(&ms, 4, 0.3);
+
+        std::vector<float> times;
+        for (int q = 0; q < 300; ++q)
+            times.push_back(q * 0.005);
+
+        auto curve = Surge::ModulatorPreview::renderMSEGCurve(&ms, 0.4, times);
+        REQUIRE(curve.matches(&ms, 0.4, times));
+        REQUIRE(!curve.matches(&ms, 0.5, times));
+
+        // one point past the end and no further
+        REQUIRE(curve.value.size() < times.size());
+        REQUIRE(times[curve.value.size() - 1] > ms.totalDuration);
+        REQUIRE(times[curve.value.size() - 2] <= ms.totalDuration);
+
+        Surge::MSEG::EvaluatorState es, esdf;
+        es.seed(8675309);
+        esdf.seed(8675309);
+        for (int q = 0; q < curve.value.size(); ++q)
+        {
+            float iup = (int)times[q];
+            float fup = times[q] - iup;
+            REQUIRE(curve.value[q] == Surge::MSEG::valueAt(iup, fup, 0, &ms, &es, true));
+            REQUIRE(curve.deformed[q] == Surge::MSEG::valueAt(iup, fup, 0.4, &ms, &esdf, true));
+            REQUIRE(curve.segment[q] == es.lastEval);
+        }
+
+        Surge::MSEG::mirrorMSEG(&ms);
+        REQUIRE(!curve.matches(&ms, 0.4, times));
+    }
+
+    SECTION("LFO Curves Render in the Background")
+    {
+        auto surge = Surge::Headless::createSurge(44100);
+        auto &lfo = surge->storage.getPatch().scene[0].lfo[0];
+        auto *ms = &surge->storage.getPatch().msegs[0][0];
+
+        lfo.shape.val.i = lt_mseg;
+        Surge::MSEG::createSawMSEG(ms, 4, 0.3);
+
+        Surge::ModulatorPreview::LFOCurveSpec spec;
+        spec.lfo = lfo;
+        spec.ss = surge->storage.getPatch().stepsequences[0][0];
+        spec.ms = *ms;
+        spec.localcopy.resize(n_scene_params);
+        for (auto *p = &lfo.rate; p <= &lfo.release; ++p)
+            spec.localcopy[p->param_id_in_scene].i = p->val.i;
+        spec.localcopy[lfo.trigmode.param_id_in_scene].i = lm_keytrigger;
+        spec.totalSamples = 2000;
+        spec.averagingWindow = 3;
+        spec.fullWave = Surge::ModulatorPreview::LFOCurveSpec::FULL_MAGNITUDE;
+
+        auto direct = Surge::ModulatorPreview::renderLFOCurve(&surge->storage, spec);
+        REQUIRE(direct.mean.size() == (2000 + 2) / 3);
+        REQUIRE(direct.hasFullWave);
+        REQUIRE(direct.waveMean.size() == direct.mean.size());
+        for (int i = 0; i < direct.mean.size(); ++i)
+        {
+            REQUIRE(direct.min[i] <= direct.mean[i]);
+            REQUIRE(direct.mean[i] <= direct.max[i]);
+        }
+
+        auto key = Surge::ModulatorPreview::lfoCurveKey(&surge->storage, spec);
+        Surge::ModulatorPreview::LFOCurveCache cache(&surge->storage);
+        REQUIRE(!cache.find(key));
+        cache.request(key, &lfo, spec);
+
+        Surge::ModulatorPreview::LFOCurveCache::result_t cached;
+        for (int w = 0; w < 500 && !cached; ++w)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            cached = cache.find(key);
+        }
+        REQUIRE(cached);
+        REQUIRE(cache.consumeNewResults());
+        REQUIRE(cached->mean == direct.mean);
+        REQUIRE(cached->env == direct.env);
+        REQUIRE(cached->waveMax == direct.waveMax);
+
+        // a segment edit is a new curve
+        Surge::MSEG::scaleValues(ms, 0.5);
+        spec.ms = *ms;
+        REQUIRE(Surge::ModulatorPreview::lfoCurveKey(&surge->storage, spec) != key);
+    }
+}
+
 /*
  * Tests to add
  * - loop point 0 (start = end + 1)
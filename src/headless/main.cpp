@@ -43,6 +43,42 @@ int main(int argc, char **argv)
             Surge::Headless::NonTest::filterAnalyzer(std::atoi(argv[3]), std::atoi(argv[4]),
                                                      std::cout);
         }
+        if (strcmp(argv[2], "--fm-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::fmOperatorBenchmark();
+        }
+        if (strcmp(argv[2], "--wt-build-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::wavetableBuildBenchmark();
+        }
+        if (strcmp(argv[2], "--osc-preview-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::oscillatorPreviewBenchmark();
+        }
+        if (strcmp(argv[2], "--biquad-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::biquadBenchmark();
+        }
+        if (strcmp(argv[2], "--resampler-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::resamplerBenchmark();
+        }
+        if (strcmp(argv[2], "--airwindows-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::airwindowsBenchmark();
+        }
+        if (strcmp(argv[2], "--modulated-delay-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::modulatedDelayBenchmark();
+        }
+        if (strcmp(argv[2], "--oversampling-benchmark") == 0)
+        {
+            Surge::Headless::NonTest::oversamplingBenchmark();
+        }
+        if (strcmp(argv[2], "--block-size-stats") == 0)
+        {
+            Surge::Headless::NonTest::blockSizeStats(argc > 3 ? argv[3] : "");
+        }
         if (strcmp(argv[2], "--performance") == 0)
         {
             Surge::Headless::NonTest::performancePlay(argv[3], std::atoi(argv[4]));
@@ -61,6 +97,19 @@ int main(int argc, char **argv)
                 << "   --non-test --stats-from-every-patch    # play every patch and show RMS\n"
                 << "   --non-test --filter-analyzer ft fst    # analyze filter type/subtype for "
                    "response\n"
+                << "   --non-test --fm-benchmark              # time the FM2/FM3 operator sine "
+                   "kernels\n"
+                << "   --non-test --wt-build-benchmark        # time building every wavetable\n"
+                << "   --non-test --osc-preview-benchmark     # time oscillator display renders\n"
+                << "   --non-test --biquad-benchmark          # time biquads, GEQ11 and Phaser\n"
+                << "   --non-test --resampler-benchmark       # time Nimbus' 32k resampling\n"
+                << "   --non-test --airwindows-benchmark      # time every airwindows algorithm\n"
+                << "   --non-test --modulated-delay-benchmark # time multi-tap delay reads and "
+                   "chorus, flanger, ensemble and rotary\n"
+                << "   --non-test --oversampling-benchmark    # time and measure aliasing of the "
+                   "oversampled FX at each factor\n"
+                << "   --non-test --block-size-stats [file]   # write the stats the block size "
+                   "cross check compares\n"
                 << "\n"
                 << "If you exlude the `--non-test` argument, standard catch2 arguments, below, "
                    "apply\n\n";
@@ -6,6 +6,7 @@
 #include <utility>
 
 #include "SurgeSynthesizer.h"
+#include "effect/DelayMemoryPool.h"
 #include "HeadlessPluginLayerProxy.h"
 #include "version.h"
 #include "filesystem/import.h"
@@ -695,6 +696,21 @@ class SurgeSynthesizerWithPythonExtensions : public SurgeSynthesizer
         return pc.asDict(storage.getPatch());
     }
 
+    py::dict getMemoryUsage()
+    {
+        auto res = py::dict();
+        res["synth"] = sizeof(*this);
+
+        auto fxl = py::list();
+        for (int i = 0; i < n_fx_slots; ++i)
+            fxl.append(fx[i] ? fx[i]->get_memory_usage() : 0);
+        res["fx"] = fxl;
+
+        res["delayMemoryInUse"] = storage.delayMemory->bytesInUse();
+        res["delayMemoryCached"] = storage.delayMemory->bytesCached();
+        return res;
+    }
+
     SurgePyNamedParam surgePyNamedParamById(int id)
     {
         auto s = SurgePyNamedParam();
@@ -933,6 +949,9 @@ PYBIND11_MODULE(surgepy, m)
         .def("getPatch", &SurgeSynthesizerWithPythonExtensions::getPatchAsPy,
              "Get a python dictionary with the Surge parameters laid out in the logical patch "
              "format")
+        .def("getMemoryUsage", &SurgeSynthesizerWithPythonExtensions::getMemoryUsage,
+             "Get the bytes this instance holds: the synth object, each FX slot including its "
+             "delay lines, and the delay line pool in use and kept for reuse")
 
         .def("loadSCLFile", &SurgeSynthesizerWithPythonExtensions::loadSCLFile,
              "Load an SCL tuning file and apply tuning to this instance")
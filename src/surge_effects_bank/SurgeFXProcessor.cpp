@@ -40,6 +40,10 @@ SurgefxAudioProcessor::SurgefxAudioProcessor()
     fxstorage->return_level.id = -1;
     setupStorageRanges((Parameter *)fxstorage, &(fxstorage->p[n_fx_params - 1]));
 
+    // the chained effects each get a copy of fx[slot + 1] to start from
+    chain = std::make_unique<FxChain>(storage.get(), &(storage->getPatch().fx[1]));
+    setLatencySamples(BlockFifo::latency);
+
     for (int i = 0; i < n_fx_params; ++i)
     {
         char lb[256], nm[256];
@@ -68,6 +72,25 @@ SurgefxAudioProcessor::SurgefxAudioProcessor()
         fxBaseParams[i + n_fx_params + 1] = fxParamFeatures[i];
     }
 
+    for (int s = 0; s < n_chained_fx; ++s)
+    {
+        char lb[256], nm[256];
+        snprintf(lb, 256, "chain_fxt_%d", s);
+        snprintf(nm, 256, "Chain %d FX Type", s + 1);
+        addParameter(chainType[s] =
+                         new AudioParameterInt(lb, nm, fxt_off, n_fx_types - 1, fxt_off));
+        chainType[s]->addListener(this);
+        chainTypeChanged[s] = false;
+
+        for (int i = 0; i < n_fx_params; ++i)
+        {
+            snprintf(lb, 256, "chain_fxp_%d_%d", s, i);
+            snprintf(nm, 256, "Chain %d FX Parameter %d", s + 1, i);
+            addParameter(chainParams[s][i] = new AudioParameterFloat(
+                             lb, nm, juce::NormalisableRange<float>(0.0, 1.0), 0.0));
+        }
+    }
+
     for (int i = 0; i < 2 * n_fx_params + 1; ++i)
     {
         fxBaseParams[i]->addListener(this);
@@ -115,6 +138,7 @@ void SurgefxAudioProcessor::changeProgramName(int index, const String &newName)
 void SurgefxAudioProcessor::prepareToPlay(double sr, int samplesPerBlock)
 {
     storage->setSamplerate(sr);
+    fifo.reset();
 }
 
 void SurgefxAudioProcessor::releaseResources()
@@ -131,16 +155,11 @@ bool SurgefxAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts) c
            layouts.getMainInputChannelSet() == AudioChannelSet::stereo();
 }
 
-#define is_aligned(POINTER, BYTE_COUNT) (((uintptr_t)(const void *)(POINTER)) % (BYTE_COUNT) == 0)
-
 void SurgefxAudioProcessor::processBlock(AudioBuffer<float> &buffer, MidiBuffer &midiMessages)
 {
-    if (resettingFx || !surge_effect)
-        return;
-
     ScopedNoDenormals noDenormals;
 
-    if (surge_effect->checkHasInvalidatedUI())
+    if (!resettingFx && surge_effect && surge_effect->checkHasInvalidatedUI())
     {
         resetFxParams(true);
     }
@@ -163,63 +182,67 @@ void SurgefxAudioProcessor::processBlock(AudioBuffer<float> &buffer, MidiBuffer
 
     auto mainInputOutput = getBusBuffer(buffer, true, 0);
     auto sideChainInput = getBusBuffer(buffer, true, 1);
+    auto sideChainBus = getBus(true, 1);
+    bool useSideChain =
+        sideChainBus && sideChainBus->isEnabled() && sideChainInput.getNumChannels() >= 2;
 
     // FIXME: Check: has type changed?
     int pt = *fxType;
 
-    if (effectNum != pt)
+    if (effectNum != pt && !resettingFx)
     {
         effectNum = pt;
         resetFxType(effectNum);
     }
 
+    auto ioL = mainInputOutput.getWritePointer(0);
+    auto ioR = mainInputOutput.getWritePointer(1);
+    auto sideL = useSideChain ? sideChainInput.getReadPointer(0) : nullptr;
+    auto sideR = useSideChain ? sideChainInput.getReadPointer(1) : nullptr;
+
+    fifo.process(ioL, ioR, sideL, sideR, buffer.getNumSamples(),
+                 [this, useSideChain]() { processFifoBlock(useSideChain); });
+}
+
+void SurgefxAudioProcessor::processFifoBlock(bool useSideChain)
+{
+    chain->takePublished();
+
+    // while the effect is being swapped, pass the audio through at the same latency
+    if (resettingFx || !surge_effect)
+        return;
+
     if (audio_thread_surge_effect.get() != surge_effect.get())
     {
         audio_thread_surge_effect = surge_effect;
     }
 
-    for (int outPos = 0; outPos < buffer.getNumSamples() && !resettingFx; outPos += BLOCK_SIZE)
+    if (useSideChain)
     {
-        auto outL = mainInputOutput.getWritePointer(0, outPos);
-        auto outR = mainInputOutput.getWritePointer(1, outPos);
-
-        auto sideChainBus = getBus(true, 1);
-        if (effectNum == fxt_vocoder && sideChainBus && sideChainBus->isEnabled())
-        {
-            auto sideL = sideChainInput.getReadPointer(0, outPos);
-            auto sideR = sideChainInput.getReadPointer(1, outPos);
-
-            memcpy(storage->audio_in_nonOS[0], sideL, BLOCK_SIZE * sizeof(float));
-            memcpy(storage->audio_in_nonOS[1], sideR, BLOCK_SIZE * sizeof(float));
-        }
-
-        for (int i = 0; i < n_fx_params; ++i)
-        {
-            fxstorage->p[fx_param_remap[i]].set_value_f01(*fxParams[i]);
-            paramFeatureOntoParam(&(fxstorage->p[fx_param_remap[i]]), *(fxParamFeatures[i]));
-        }
-        copyGlobaldataSubset(storage_id_start, storage_id_end);
-
-        if (is_aligned(outL, 16) && is_aligned(outR, 16))
-        {
-            audio_thread_surge_effect->process(outL, outR);
-        }
-        else
-        {
-            float bufferL alignas(16)[BLOCK_SIZE], bufferR alignas(16)[BLOCK_SIZE];
+        copy_block(fifo.side[0], storage->audio_in_nonOS[0], BLOCK_SIZE_QUAD);
+        copy_block(fifo.side[1], storage->audio_in_nonOS[1], BLOCK_SIZE_QUAD);
+    }
 
-            auto inL = mainInputOutput.getReadPointer(0, outPos);
-            auto inR = mainInputOutput.getReadPointer(1, outPos);
+    for (int i = 0; i < n_fx_params; ++i)
+    {
+        fxstorage->p[fx_param_remap[i]].set_value_f01(*fxParams[i]);
+        paramFeatureOntoParam(&(fxstorage->p[fx_param_remap[i]]), *(fxParamFeatures[i]));
+    }
+    copyGlobaldataSubset(storage_id_start, storage_id_end);
 
-            memcpy(bufferL, inL, BLOCK_SIZE * sizeof(float));
-            memcpy(bufferR, inR, BLOCK_SIZE * sizeof(float));
+    audio_thread_surge_effect->process(fifo.out[0], fifo.out[1]);
 
-            audio_thread_surge_effect->process(bufferL, bufferR);
+    for (int s = 0; s < n_chained_fx; ++s)
+    {
+        // after a type change the values are the new effect's, so leave the old one until the swap
+        if (chain->runningType(s) != *(chainType[s]))
+            continue;
 
-            memcpy(outL, bufferL, BLOCK_SIZE * sizeof(float));
-            memcpy(outR, bufferR, BLOCK_SIZE * sizeof(float));
-        }
+        auto *fxs = chain->runningStorage(s);
+        for (int i = 0; fxs && i < n_fx_params; ++i)
+            fxs->p[i].set_value_f01(*(chainParams[s][i]));
     }
+    chain->process(fifo.out[0], fifo.out[1]);
 }
 
 //==============================================================================
@@ -251,6 +274,26 @@ void SurgefxAudioProcessor::getStateInformation(MemoryBlock &destData)
     }
     xml->setAttribute("fxt", effectNum);
 
+    for (int s = 0; s < n_chained_fx; ++s)
+    {
+        auto *fxs = chain->getStorage(s);
+        if (!fxs || chain->getType(s) == fxt_off)
+            continue;
+
+        char nm[256];
+        snprintf(nm, 256, "chain_fxt_%d", s);
+        xml->setAttribute(nm, chain->getType(s));
+
+        for (int i = 0; i < n_fx_params; ++i)
+        {
+            snprintf(nm, 256, "chain_fxp_%d_%d", s, i);
+            xml->setAttribute(nm, getChainedFxParam01(s, i));
+
+            snprintf(nm, 256, "chain_fxp_param_features_%d_%d", s, i);
+            xml->setAttribute(nm, paramFeatureFromParam(&(fxs->p[i])));
+        }
+    }
+
     copyXmlToBinary(*xml, destData);
 }
 
@@ -287,6 +330,26 @@ void SurgefxAudioProcessor::setStateInformation(const void *data, int sizeInByte
                     paramFeatureOntoParam(&(fxstorage->p[fx_param_remap[i]]), pf);
                 }
             }
+
+            for (int s = 0; s < n_chained_fx; ++s)
+            {
+                char nm[256];
+                snprintf(nm, 256, "chain_fxt_%d", s);
+                setChainedFxType(s, xmlState->getIntAttribute(nm, fxt_off));
+
+                auto *fxs = chain->getStorage(s);
+                for (int i = 0; i < n_fx_params && chain->getType(s) != fxt_off; ++i)
+                {
+                    snprintf(nm, 256, "chain_fxp_%d_%d", s, i);
+                    if (xmlState->hasAttribute(nm))
+                        setChainedFxParam01(s, i, xmlState->getDoubleAttribute(nm, 0.0));
+
+                    snprintf(nm, 256, "chain_fxp_param_features_%d_%d", s, i);
+                    if (xmlState->hasAttribute(nm))
+                        paramFeatureOntoParam(&(fxs->p[i]), xmlState->getIntAttribute(nm, 0));
+                }
+            }
+
             updateJuceParamsFromStorage();
         }
     }
@@ -360,6 +423,7 @@ void SurgefxAudioProcessor::resetFxType(int type, bool updateJuceParams)
                                     storage->getPatch().globaldata));
     if (surge_effect)
     {
+        surge_effect->allocate_memory();
         surge_effect->init();
         surge_effect->init_ctrltypes();
         surge_effect->init_default_values();
@@ -367,6 +431,23 @@ void SurgefxAudioProcessor::resetFxType(int type, bool updateJuceParams)
     resetFxParams(updateJuceParams);
 }
 
+void SurgefxAudioProcessor::setChainedFxType(int slot, int type)
+{
+    if (slot < 0 || slot >= n_chained_fx)
+        return;
+
+    // The new effect gets its own parameters, so the one the audio thread is running keeps its
+    // types and values until FxChain swaps it out
+    auto *fxs = chain->prepare(slot, type);
+    {
+        SupressGuard sg(&supressParameterUpdates);
+        for (int i = 0; i < n_fx_params; ++i)
+            *(chainParams[slot][i]) = fxs->p[i].get_value_f01();
+        *(chainType[slot]) = chain->getType(slot);
+    }
+    chain->publish(slot);
+}
+
 void SurgefxAudioProcessor::resetFxParams(bool updateJuceParams)
 {
     reorderSurgeParams();
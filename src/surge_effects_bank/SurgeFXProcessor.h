@@ -14,6 +14,8 @@
 #include "SurgeStorage.h"
 #include <functional>
 #include "dsp/effect/Effect.h"
+#include "dsp/effect/BlockFifo.h"
+#include "dsp/effect/FxChain.h"
 
 #if MAC
 #include <execinfo.h>
@@ -131,6 +133,17 @@ class SurgefxAudioProcessor : public AudioProcessor,
         if (supressParameterUpdates)
             return;
 
+        for (int s = 0; s < n_chained_fx; ++s)
+        {
+            if (parameterIndex == chainType[s]->getParameterIndex())
+            {
+                // this can be the audio thread, so build the new effect in handleAsyncUpdate
+                chainTypeChanged[s] = true;
+                triggerAsyncUpdate();
+                return;
+            }
+        }
+
         if (!isUserEditing[parameterIndex])
         {
             // this order does matter
@@ -145,6 +158,9 @@ class SurgefxAudioProcessor : public AudioProcessor,
     virtual void handleAsyncUpdate() override
     {
         paramChangeListener();
+        for (int s = 0; s < n_chained_fx; ++s)
+            if (chainTypeChanged[s].exchange(false) && *(chainType[s]) != chain->getType(s))
+                setChainedFxType(s, *(chainType[s]));
         for (int i = 0; i < n_fx_params; ++i)
             if (wasParamFeatureChanged[i])
             {
@@ -245,6 +261,23 @@ class SurgefxAudioProcessor : public AudioProcessor,
     void resetFxType(int t, bool updateJuceParams = true);
     void resetFxParams(bool updateJuceParams = true);
 
+    /*
+     * The multi-effect graph. Up to n_chained_fx more effects run in series after the main one,
+     * sharing its SurgeStorage, so one instance can stand in for a chain of them. Each slot is
+     * exposed to the host as a "Chain N FX Type" parameter and n_fx_params "Chain N FX
+     * Parameter" ones, after the main effect's parameters. A sidechain, when enabled, feeds
+     * every effect in the chain which listens to audio input (the vocoder).
+     *
+     * slot is 0 to n_chained_fx - 1 and i indexes the effect's FxStorage parameters directly.
+     * fxt_off empties a slot. Call these from the UI or message thread; the audio thread picks
+     * up a new type through FxChain's mailbox.
+     */
+    static constexpr int n_chained_fx = FxChain::n_slots;
+    int getChainedFxType(int slot) { return chain->getType(slot); }
+    void setChainedFxType(int slot, int type);
+    float getChainedFxParam01(int slot, int i) { return *(chainParams[slot][i]); }
+    void setChainedFxParam01(int slot, int i, float f) { *(chainParams[slot][i]) = f; }
+
   private:
     //==============================================================================
     AudioProcessorParameter *fxBaseParams[2 * n_fx_params + 1];
@@ -263,6 +296,10 @@ class SurgefxAudioProcessor : public AudioProcessor,
     };
     AudioParameterInt *fxParamFeatures[n_fx_params];
 
+    AudioParameterInt *chainType[n_chained_fx];
+    AudioParameterFloat *chainParams[n_chained_fx][n_fx_params];
+    std::atomic<bool> chainTypeChanged[n_chained_fx];
+
     std::atomic<bool> changedParams[2 * n_fx_params + 1];
     std::atomic<float> changedParamsValue[2 * n_fx_params + 1];
     std::atomic<bool> isUserEditing[2 * n_fx_params + 1];
@@ -287,6 +324,12 @@ class SurgefxAudioProcessor : public AudioProcessor,
     std::shared_ptr<Effect> surge_effect;
     std::shared_ptr<Effect> audio_thread_surge_effect;
     std::atomic<bool> resettingFx;
+
+    std::unique_ptr<FxChain> chain;
+
+    // Hosts hand us any number of samples, so audio goes through this and we report its latency
+    BlockFifo fifo;
+    void processFifoBlock(bool useSideChain);
     FxStorage *fxstorage;
     int storage_id_start, storage_id_end;
 